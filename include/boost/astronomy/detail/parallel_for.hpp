@@ -0,0 +1,82 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_PARALLEL_FOR_HPP
+#define BOOST_ASTRONOMY_DETAIL_PARALLEL_FOR_HPP
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+
+//returns requested number of threads, or the hardware concurrency when 0 is requested
+inline std::size_t thread_count(std::size_t requested)
+{
+    if (requested != 0)
+    {
+        return requested;
+    }
+    std::size_t hardware = std::thread::hardware_concurrency();
+    return hardware != 0 ? hardware : 1;
+}
+
+/*
+splits [0, count) into one contiguous range per worker and calls
+function(begin, end, worker) for each of them. the calling thread runs the first range,
+the first exception thrown by any worker is rethrown after all workers have joined
+*/
+template <typename Function>
+void parallel_for(std::size_t count, std::size_t threads, Function function)
+{
+    threads = thread_count(threads);
+    if (threads > count)
+    {
+        threads = count != 0 ? count : 1;
+    }
+
+    std::size_t const chunk = count / threads;
+    std::size_t const remainder = count % threads;
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+
+    auto run = [&](std::size_t worker)
+    {
+        std::size_t const begin = worker * chunk + (worker < remainder ? worker : remainder);
+        std::size_t const end = begin + chunk + (worker < remainder ? 1 : 0);
+        try
+        {
+            function(begin, end, worker);
+        }
+        catch (...)
+        {
+            errors[worker] = std::current_exception();
+        }
+    };
+
+    for (std::size_t worker = 1; worker < threads; worker++)
+    {
+        workers.emplace_back(run, worker);
+    }
+    run(0);
+
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+    for (auto const& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_PARALLEL_FOR_HPP
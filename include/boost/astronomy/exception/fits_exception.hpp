@@ -79,6 +79,123 @@ namespace boost
             }
         };
 
+        class column_not_found_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "No column with the given name";
+            }
+        };
+
+        class column_length_mismatch_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Columns used together must have the same number of rows";
+            }
+        };
+
+        class file_io_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Error while reading or writing the file";
+            }
+        };
+
+        class table_truncated_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Table has fewer rows than already consumed";
+            }
+        };
+
+        class invalid_selection_mask_size : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Selection mask size does not match the number of elements";
+            }
+        };
+
+        class invalid_cache_key_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Cache key or cached array name is too long";
+            }
+        };
+
+        class shared_memory_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Error while creating or mapping shared memory";
+            }
+        };
+
+        class cache_type_mismatch_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Cached array has a different element type";
+            }
+        };
+
+        class hdu_not_found_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "File has no HDU with the given index";
+            }
+        };
+
+        class image_size_mismatch_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Images of an expression differ in width or height";
+            }
+        };
+
+        class invalid_kernel_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Kernel is empty or its values do not match its size";
+            }
+        };
+
+        class invalid_fft_size_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Transform length is zero or does not match the spectrum";
+            }
+        };
+
+        class compression_not_supported_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "File is compressed but compression support is not built";
+            }
+        };
+
     } //namespace astronomy
 } //namespace boost
 #endif // !BOOST_ASTRONOMY_EXCEPTION_FITS_EXCEPTION_HPP
@@ -0,0 +1,167 @@
+#ifndef BOOST_ASTRONOMY_IO_ALIGNED_BUFFER_HPP
+#define BOOST_ASTRONOMY_IO_ALIGNED_BUFFER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+#include <boost/type_traits/has_trivial_copy.hpp>
+#include <boost/astronomy/io/memory_resource.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+/*!
+array of trivially copyable values starting on a 64 byte boundary, allocated from the default
+resource of the creating thread. unlike std::vector or std::valarray, reset leaves the values
+uninitialized so a buffer that is read into right away is touched only once
+*/
+template <typename Type>
+struct aligned_buffer
+{
+    //std::is_trivially_copyable is missing from libstdc++ before GCC 5
+    static_assert(boost::has_trivial_copy<Type>::value,
+        "aligned_buffer holds trivially copyable values only");
+
+    //!alignment of the first value in bytes, the width of a cache line and of AVX-512
+    static std::size_t alignment()
+    {
+        return 64;
+    }
+
+private:
+    Type* values = nullptr;
+    std::size_t count = 0;
+    memory_resource* resource_;
+
+public:
+    aligned_buffer() : resource_(get_default_resource()) {}
+
+    explicit aligned_buffer(std::size_t size) : aligned_buffer()
+    {
+        reset(size);
+    }
+
+    //!copies take the default resource of the copying thread, like resource_vector
+    aligned_buffer(aligned_buffer const& other) : aligned_buffer()
+    {
+        reset(other.count);
+        if (count != 0)
+        {
+            std::memcpy(values, other.values, count * sizeof(Type));
+        }
+    }
+
+    aligned_buffer(aligned_buffer&& other) noexcept
+        : values(other.values), count(other.count), resource_(other.resource_)
+    {
+        other.values = nullptr;
+        other.count = 0;
+    }
+
+    aligned_buffer& operator=(aligned_buffer const& other)
+    {
+        if (this != &other)
+        {
+            if (count != other.count)
+            {
+                reset(other.count);
+            }
+            if (count != 0)
+            {
+                std::memcpy(values, other.values, count * sizeof(Type));
+            }
+        }
+        return *this;
+    }
+
+    aligned_buffer& operator=(aligned_buffer&& other)
+    {
+        if (resource_ == other.resource_ || resource_->is_equal(*other.resource_))
+        {
+            std::swap(values, other.values);
+            std::swap(count, other.count);
+            return *this;
+        }
+        return *this = static_cast<aligned_buffer const&>(other);
+    }
+
+    ~aligned_buffer()
+    {
+        reset(0);
+    }
+
+    //!replaces the contents by size uninitialized values
+    void reset(std::size_t size)
+    {
+        if (values != nullptr)
+        {
+            resource_->deallocate(values, count * sizeof(Type), alignment());
+            values = nullptr;
+            count = 0;
+        }
+        if (size != 0)
+        {
+            values = static_cast<Type*>(resource_->allocate(size * sizeof(Type), alignment()));
+            count = size;
+        }
+    }
+
+    std::size_t size() const
+    {
+        return count;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    Type* data()
+    {
+        return values;
+    }
+
+    Type const* data() const
+    {
+        return values;
+    }
+
+    Type* begin()
+    {
+        return values;
+    }
+
+    Type const* begin() const
+    {
+        return values;
+    }
+
+    Type* end()
+    {
+        return values + count;
+    }
+
+    Type const* end() const
+    {
+        return values + count;
+    }
+
+    Type& operator[](std::size_t i)
+    {
+        return values[i];
+    }
+
+    Type const& operator[](std::size_t i) const
+    {
+        return values[i];
+    }
+
+    memory_resource* resource() const
+    {
+        return resource_;
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_ALIGNED_BUFFER_HPP
@@ -3,6 +3,7 @@
 
 #include <valarray>
 #include <fstream>
+#include <istream>
 #include <cstddef>
 #include <algorithm>
 #include <iterator>
@@ -11,6 +12,7 @@
 #include <cmath>
 #include <numeric>
 
+#include <boost/algorithm/string/trim.hpp>
 #include <boost/astronomy/io/column.hpp>
 #include <boost/astronomy/io/column_data.hpp>
 #include <boost/astronomy/io/table_extension.hpp>
@@ -23,27 +25,33 @@ namespace boost { namespace astronomy {  namespace io {
 struct ascii_table : public table_extension
 {
 public:
-    ascii_table(std::fstream &file) : table_extension(file)
+    ascii_table(std::istream &file) : table_extension(file)
     {
         populate_column_data();
-        std::copy_n(std::istream_iterator<char>(file), naxis(1)*naxis(2), std::back_inserter(data));
+        read_table_data(file);
         set_unit_end(file);
     }
 
-    ascii_table(std::fstream &file, hdu const& other) : table_extension(file, other)
+    ascii_table(std::istream &file, hdu const& other) : table_extension(file, other)
     {
         populate_column_data();
-        std::copy_n(std::istream_iterator<char>(file), naxis(1)*naxis(2), std::back_inserter(data));
+        read_table_data(file);
         set_unit_end(file);
     }
 
-    ascii_table(std::fstream &file, std::streampos pos) : table_extension(file, pos)
+    ascii_table(std::istream &file, std::streampos pos) : table_extension(file, pos)
     {
         populate_column_data();
-        std::copy_n(std::istream_iterator<char>(file), naxis(1)*naxis(2), std::back_inserter(data));
+        read_table_data(file);
         set_unit_end(file);
     }
 
+    //!reads only the column layout from an already read header
+    ascii_table(hdu const& other) : table_extension(other)
+    {
+        populate_column_data();
+    }
+
     void populate_column_data()
     {
         for (std::size_t i = 0; i < this->tfields; i++)
@@ -59,9 +67,10 @@ public:
             );
 
             try {
-                col_metadata[i].TTYPE(
-                    value_of<std::string>("TTYPE" + boost::lexical_cast<std::string>(i + 1))
-                );
+                col_metadata[i].TTYPE(boost::trim_copy_if(
+                    value_of<std::string>("TTYPE" + boost::lexical_cast<std::string>(i + 1)),
+                    [](char c) -> bool { return c == '\'' || c == ' '; }
+                ));
 
                 col_metadata[i].comment(
                     value_of<std::string>(col_metadata[i].TTYPE())
@@ -92,14 +101,16 @@ public:
         }
     }
 
-    void read_data(std::fstream &file)
+    void read_data(std::istream &file)
     {
-        file.read(&data[0], naxis(1)*naxis(2));
+        read_table_data(file);
         set_unit_end(file);
     }
 
     std::unique_ptr<column> get_column(std::string name) const
     {
+        BOOST_ASTRONOMY_IO_TRACE("ascii_table::get_column");
+        detail::scoped_timer timer(this->metrics_, detail::io_metric::column_decode_ns);
         for (auto col : col_metadata)
         {
             if (col.TTYPE() == name)
@@ -170,7 +181,7 @@ public:
             }
         }
 
-        std::unique_ptr<column>(nullptr);
+        return std::unique_ptr<column>(nullptr);
     }
 
     std::size_t column_size(std::string format) const
@@ -204,7 +215,7 @@ private:
     template<typename VectorType, typename Lambda>
     void fill_column 
     (
-        std::vector<VectorType> &column_container,
+        resource_vector<VectorType> &column_container,
         std::size_t start,
         std::size_t column_size,
         Lambda lambda
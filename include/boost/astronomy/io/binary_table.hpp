@@ -2,11 +2,13 @@
 #define BOOST_ASTRONOMY_IO_BINARY_TABLE_HPP
 
 #include <fstream>
+#include <istream>
 #include <stdexcept>
 #include <iterator>
 #include <algorithm>
 #include <complex>
 #include <utility>
+#include <memory>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -15,33 +17,46 @@
 #include <boost/astronomy/io/table_extension.hpp>
 #include <boost/astronomy/io/column.hpp>
 #include <boost/astronomy/io/column_data.hpp>
+#include <boost/astronomy/io/bit_column.hpp>
+#include <boost/astronomy/io/column_decode.hpp>
 
 namespace boost { namespace astronomy { namespace io {
 
 struct binary_table_extension : table_extension
 {
 public:
-    binary_table_extension(std::fstream &file) : table_extension(file)
+    binary_table_extension() {}
+
+    binary_table_extension(std::istream &file) : table_extension(file)
     {
         populate_column_data();
-        std::copy_n(std::istream_iterator<char>(file), naxis(1)*naxis(2), std::back_inserter(data));
+        read_table_data(file);
         set_unit_end(file);
     }
 
-    binary_table_extension(std::fstream &file, hdu const& other) : table_extension(file, other)
+    binary_table_extension(std::istream &file, hdu const& other) : table_extension(file, other)
     {
         populate_column_data();
-        std::copy_n(std::istream_iterator<char>(file), naxis(1)*naxis(2), std::back_inserter(data));
+        read_table_data(file);
         set_unit_end(file);
     }
 
-    binary_table_extension(std::fstream &file, std::streampos pos) : table_extension(file, pos)
+    binary_table_extension(std::istream &file, std::streampos pos) : table_extension(file, pos)
     {
         populate_column_data();
-        std::copy_n(std::istream_iterator<char>(file), naxis(1)*naxis(2), std::back_inserter(data));
+        read_table_data(file);
         set_unit_end(file);
     }
 
+    /*!
+    reads only the column layout from an already read header, the data can be read later
+    with read_data or streamed row by row by the caller
+    */
+    binary_table_extension(hdu const& other) : table_extension(other)
+    {
+        populate_column_data();
+    }
+
     void populate_column_data()
     {
         std::size_t start = 0;
@@ -58,9 +73,10 @@ public:
             start += column_size(col_metadata[i].TFORM());
 
             try {
-                col_metadata[i].TTYPE(
-                    value_of<std::string>("TTYPE" + boost::lexical_cast<std::string>(i + 1))
-                );
+                col_metadata[i].TTYPE(boost::trim_copy_if(
+                    value_of<std::string>("TTYPE" + boost::lexical_cast<std::string>(i + 1)),
+                    [](char c) -> bool { return c == '\'' || c == ' '; }
+                ));
 
                 col_metadata[i].comment(
                     value_of<std::string>(col_metadata[i].TTYPE())
@@ -89,6 +105,13 @@ public:
             }
             catch (std::out_of_range e) {/*Do Nothing*/ }
 
+            try {
+                col_metadata[i].TNULL(
+                    value_of<std::int64_t>("TNULL" + boost::lexical_cast<std::string>(i + 1))
+                );
+            }
+            catch (std::out_of_range e) {/*Do Nothing*/ }
+
             try {
                 col_metadata[i].TDISP(
                     value_of<std::string>("TDISP" + boost::lexical_cast<std::string>(i + 1))
@@ -105,18 +128,196 @@ public:
         }
     }
 
-    void read_data(std::fstream &file)
+    void read_data(std::istream &file)
     {
-        file.read(&data[0], naxis(1)*naxis(2));
+        read_table_data(file);
         set_unit_end(file);
     }
 
     std::unique_ptr<column> get_column(std::string name) const
     {
-        for (auto col : col_metadata)
+        return read_column(name, nullptr);
+    }
+
+    //!reads only the rows whose bit is set in selection (one bit per row)
+    std::unique_ptr<column> get_column(std::string name, bit_mask const& selection) const
+    {
+        if (selection.size() != naxis(2))
+        {
+            throw invalid_selection_mask_size();
+        }
+        return read_column(name, &selection);
+    }
+
+    /*!
+    returns 'X' or 'L' column as packed bits, bits_per_row() being the repeat count
+    of the column; nullptr is returned if no column has the given name
+    */
+    std::unique_ptr<bit_column> get_bit_column(std::string const& name) const
+    {
+        BOOST_ASTRONOMY_IO_TRACE("binary_table::get_bit_column");
+        detail::scoped_timer timer(this->metrics_, detail::io_metric::column_decode_ns);
+        for (auto const& col : col_metadata)
+        {
+            if (col.TTYPE() != name)
+            {
+                continue;
+            }
+
+            std::size_t const count = element_count(col.TFORM());
+            char const type = get_type(col.TFORM());
+            if (type != 'X' && type != 'L')
+            {
+                throw invalid_table_colum_format();
+            }
+
+            auto result = std::make_unique<bit_column>(naxis(2), count);
+            static_cast<column&>(*result) = col;
+            std::size_t const field_size = column_size(col.TFORM());
+
+            std::uint64_t packed_row = 0;
+            for (std::size_t row = 0; row < naxis(2); row++)
+            {
+                auto field = reinterpret_cast<std::uint8_t const*>(
+                    this->data.data() + row * naxis(1) + col.TBCOL());
+                //packed rows are decoded into one word and stored with set_row_value
+                std::uint64_t* words = result->packed() ? &packed_row : result->row_words(row);
+                packed_row = 0;
+
+                if (type == 'X')
+                {
+                    //byte k of the field lands in byte k%8 of word k/8 with its bit order reversed
+                    for (std::size_t k = 0; k < field_size; k++)
+                    {
+                        words[k / 8] |= std::uint64_t(detail::reverse_bits(field[k])) <<
+                            (8 * (k % 8));
+                    }
+                    //unused trailing bits of the last byte must not be reported as set
+                    if (count % 64 != 0)
+                    {
+                        words[count / 64] &= (std::uint64_t(1) << (count % 64)) - 1;
+                    }
+                }
+                else
+                {
+                    for (std::size_t k = 0; k < count; k++)
+                    {
+                        words[k / 64] |= std::uint64_t(field[k] == 'T') << (k % 64);
+                    }
+                }
+                if (result->packed())
+                {
+                    result->set_row_value(row, packed_row);
+                }
+            }
+            return result;
+        }
+
+        return std::unique_ptr<bit_column>(nullptr);
+    }
+
+    std::size_t column_size(std::string format) const
+    {
+        std::string form = boost::trim_copy_if(format, [](char c) -> bool {
+                            return c == '\'' || c == ' ';
+                        });
+
+        std::size_t count = form.length() > 1 ?
+            boost::lexical_cast<std::size_t>(form.substr(0, form.length() - 1)) : 1;
+
+        //bits of 'X' column are packed, partial bytes are padded
+        if (form[form.length() - 1] == 'X')
+        {
+            return (count + 7) / 8;
+        }
+        return count * type_size(form[form.length() - 1]);
+    }
+
+    std::size_t element_count(std::string format) const
+    {
+        std::string form = boost::trim_copy_if(format, [](char c) -> bool {
+                            return c == '\'' || c == ' ';
+                        });
+
+        return form.length() > 1 ?
+            boost::lexical_cast<std::size_t>(form.substr(0, form.length() - 1)) :
+            static_cast<std::size_t>(1);
+    }
+
+    char get_type(std::string format) const
+    {
+        std::string form = boost::trim_copy_if(format, [](char c) -> bool {
+                            return c == '\'' || c == ' ';
+                        });
+
+        return form[form.length() - 1];
+    }
+
+    std::size_t type_size(char type) const
+    {
+        switch (type)
+        {
+        case 'L':
+            return 1;
+        case 'X':
+            return 1;
+        case 'B':
+            return 1;
+        case 'I':
+            return 2;
+        case 'J':
+            return 4;
+        case 'K':
+            return 8;
+        case 'A':
+            return 1;
+        case 'E':
+            return 4;
+        case 'D':
+            return 8;
+        case 'C':
+            return 8;
+        case 'M':
+            return 16;
+        case 'P':
+            return 8;
+        default:
+            throw invalid_table_colum_format();
+        }
+    }
+
+private:
+    std::unique_ptr<column> read_column(std::string const& name, bit_mask const* selection) const
+    {
+        BOOST_ASTRONOMY_IO_TRACE("binary_table::get_column");
+        detail::scoped_timer timer(this->metrics_, detail::io_metric::column_decode_ns);
+        for (auto const& col : col_metadata)
         {
             if (col.TTYPE() == name)
             {
+                //numeric types share one decode path for single and repeated elements
+                switch (get_type(col.TFORM()))
+                {
+                case 'B':
+                    return read_integer_column<std::uint8_t>(col, selection);
+                case 'I':
+                    return read_integer_column<std::int16_t>(col, selection);
+                case 'J':
+                    return read_integer_column<std::int32_t>(col, selection);
+                case 'K':
+                    return read_integer_column<std::int64_t>(col, selection);
+                case 'E':
+                    return read_real_column<float>(col, selection);
+                case 'D':
+                    return read_real_column<double>(col, selection);
+                case 'C':
+                    return read_numeric_column(col, selection, complex_decoder<float>());
+                case 'M':
+                    return read_numeric_column(col, selection, complex_decoder<double>());
+                default:
+                    break;
+                }
+
                 if (element_count(col.TFORM()) == 1)
                 {
                     switch (get_type(col.TFORM()))
@@ -124,7 +325,7 @@ public:
                     case 'L':
                     {
                         auto result = std::make_unique<column_data<bool>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
+                        fill_column(result->get_data(), selection, col.TBCOL(), column_size(col.TFORM()),
                             [](char const* element) -> bool {
                                 if (*element == 'T') return true;
                                 else return false;
@@ -135,125 +336,27 @@ public:
                     case 'X':
                     {
                         auto result = std::make_unique<column_data<char>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
+                        fill_column(result->get_data(), selection, col.TBCOL(), column_size(col.TFORM()),
                             [](char const* element) -> char {
                                 return *element;
                             }
                         );
                         return std::move(result);
                     }
-                    case 'B':
-                    {
-                        auto result = std::make_unique<column_data<std::uint8_t>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [](char const* element) -> std::uint8_t {
-                                return static_cast<std::uint8_t>(*element);
-                            }
-                        );
-                        return std::move(result);
-                    }
-                    case 'I':
-                    {
-                        auto result = std::make_unique<column_data<std::int16_t>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [](char const* element) -> std::int16_t {
-                                return boost::endian::big_to_native(*reinterpret_cast<const std::int16_t*>(element));
-                            }
-                        );
-                        return std::move(result);
-                    }
-                    case 'J':
-                    {
-                        auto result = std::make_unique<column_data<std::int32_t>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [](char const* element) -> std::int32_t {
-                                return boost::endian::big_to_native(*reinterpret_cast<const std::int32_t*>(element));
-                            }
-                        );
-                        return std::move(result);
-                    }
                     case 'A':
                     {
                         auto result = std::make_unique<column_data<char>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
+                        fill_column(result->get_data(), selection, col.TBCOL(), column_size(col.TFORM()),
                             [](char const* element) -> char {
                                 return *element;
                             }
                         );
                         return std::move(result);
                     }
-                    case 'E':
-                    {
-                        auto result = std::make_unique<column_data<float>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [](char const* element) -> float {
-                                float result = (element[3] << 0) | (element[2] << 8) |
-                                                (element[1] << 16) | (element[0] << 24);
-                                return result;
-                            }
-                        );
-                        return std::move(result);
-                    }
-                    case 'D':
-                    {
-                        auto result = std::make_unique<column_data<double>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [](char const* element) -> double {
-                                double result = (element[7] << 0) | (element[6] << 8) |
-                                                (element[5] << 16) | (element[4] << 24) |
-                                                (element[3] << 32) | (element[2] << 40) |
-                                                (element[1] << 48) | (element[0] << 56);
-                                return result;
-                            }
-                        );
-                        return std::move(result);
-                    }
-                    case 'C':
-                    {
-                        auto result = std::make_unique<column_data<std::complex<float>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [](char const* element) -> std::complex<float> {
-                                std::complex<float> result;
-                                float temp = (element[3] << 0) | (element[2] << 8) |
-                                                (element[1] << 16) | (element[0] << 24);
-                                result.real(temp);
-
-                                element += 4;
-                                temp = (element[3] << 0) | (element[2] << 8) |
-                                        (element[1] << 16) | (element[0] << 24);
-                                result.imag(temp);
-                                return result;
-                            }
-                        );
-                        return std::move(result);
-                    }
-                    case 'M':
-                    {
-                        auto result = std::make_unique<column_data<std::complex<double>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [](char const* element) -> std::complex<double> {
-                            std::complex<double> result;
-                            double temp = (element[7] << 0) | (element[6] << 8) |
-                                            (element[5] << 16) | (element[4] << 24) |
-                                            (element[3] << 32) | (element[2] << 40) |
-                                            (element[1] << 48) | (element[0] << 56);
-                            result.real(temp);
-
-                            element += 8;
-                            temp = (element[7] << 0) | (element[6] << 8) |
-                                    (element[5] << 16) | (element[4] << 24) |
-                                    (element[3] << 32) | (element[2] << 40) |
-                                    (element[1] << 48) | (element[0] << 56);
-                            result.imag(temp);
-                            return result;
-                            }
-                        );
-                        return std::move(result);
-                    }
                     case 'P':
                     {
                         auto result = std::make_unique<column_data<std::pair<std::int32_t, std::int32_t>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
+                        fill_column(result->get_data(), selection, col.TBCOL(), column_size(col.TFORM()),
                             [](char const* element) -> std::pair<std::int32_t, std::int32_t> {
                                 auto x = boost::endian::big_to_native(*reinterpret_cast<const std::int32_t*>(element));
                                 auto y = boost::endian::big_to_native(*(reinterpret_cast<const std::int32_t*>(element)+1));
@@ -274,13 +377,13 @@ public:
                     case 'L':
                     {
                         auto result = std::make_unique<column_data<std::vector<bool>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
+                        fill_column(result->get_data(), selection, col.TBCOL(), column_size(col.TFORM()),
                             [num_of_element](char const* element) -> std::vector<bool> {
                                 std::vector<bool> values;
                                 values.reserve(num_of_element);
                                 for (std::size_t i = 0; i < num_of_element; i++)
                                 {
-                                    if (*element == 'T') values.emplace_back(true);
+                                    if (element[i] == 'T') values.emplace_back(true);
                                     else values.emplace_back(false);
                                 }
                                 return values;
@@ -290,63 +393,12 @@ public:
                     }
                     case 'X':
                     {
+                        // nX packs n bits into ceil(n/8) bytes, the packed bytes are returned as is
+                        std::size_t const num_of_bytes = column_size(col.TFORM());
                         auto result = std::make_unique<column_data<std::vector<char>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [num_of_element](char const* element) -> std::vector<char> {
-                                return std::vector<char>(element, element + num_of_element);
-                            }
-                        );
-                        return std::move(result);
-                    }
-                    case 'B':
-                    {
-                        auto result = std::make_unique<column_data<std::vector<std::uint8_t>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [num_of_element](char const* element) -> std::vector<std::uint8_t> {
-                                return std::vector<std::uint8_t>(
-                                    reinterpret_cast<const std::uint8_t*>(element), 
-                                    reinterpret_cast<const std::uint8_t*>(element)+ num_of_element
-                                    );
-                            }
-                        );
-                        return std::move(result);
-                    }
-                    case 'I':
-                    {
-                        auto result = std::make_unique<column_data<std::vector<std::int16_t>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [num_of_element](char const* element) -> std::vector<std::int16_t> {
-                                std::vector<std::int16_t> values;
-                                values.reserve(num_of_element);
-                                for (std::size_t i = 0; i < num_of_element; i++)
-                                {
-                                    values.emplace_back(
-                                        boost::endian::big_to_native(
-                                            *(reinterpret_cast<const std::int16_t*>(element) +
-                                             num_of_element
-                                        )));
-                                }
-                                return values;
-                            }
-                        );
-                        return std::move(result);
-                    }
-                    case 'J':
-                    {
-                        auto result = std::make_unique<column_data<std::vector<std::int32_t>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [num_of_element](char const* element) -> std::vector<std::int32_t> {
-                                std::vector<std::int32_t> values;
-                                values.reserve(num_of_element);
-                                for (std::size_t i = 0; i < num_of_element; i++)
-                                {
-                                    values.emplace_back(
-                                        boost::endian::big_to_native(
-                                            *(reinterpret_cast<const std::int32_t*>(element) +
-                                             num_of_element
-                                        )));
-                                }
-                                return values;
+                        fill_column(result->get_data(), selection, col.TBCOL(), num_of_bytes,
+                            [num_of_bytes](char const* element) -> std::vector<char> {
+                                return std::vector<char>(element, element + num_of_bytes);
                             }
                         );
                         return std::move(result);
@@ -354,115 +406,17 @@ public:
                     case 'A':
                     {
                         auto result = std::make_unique<column_data<std::vector<char>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
+                        fill_column(result->get_data(), selection, col.TBCOL(), column_size(col.TFORM()),
                             [num_of_element](char const* element) -> std::vector<char> {
                                 return std::vector<char>(element, element + num_of_element);
                             }
                         );
                         return std::move(result);
                     }
-                    case 'E':
-                    {
-                        auto result = std::make_unique<column_data<std::vector<float>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [num_of_element](char const* element) -> std::vector<float> {
-                                std::vector<float> values(
-                                    reinterpret_cast<const float*>(element), 
-                                    reinterpret_cast<const float*>(element) + num_of_element
-                                );
-
-                                std::transform(
-                                    values.begin(), 
-                                    values.end(), 
-                                    values.begin(), 
-                                    [](float var) -> float{
-                                        char *native = reinterpret_cast<char*>(&var);
-                                        return (native[3] << 0) | (native[2] << 8) |
-                                                (native[1] << 16) | (native[0] << 24);
-                                    });
-                                return values;
-                            }
-                        );
-                        return std::move(result);
-                    }
-                    case 'D':
-                    {
-                        auto result = std::make_unique<column_data<std::vector<double>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [num_of_element](char const* element) -> std::vector<double> {
-                                std::vector<double> values(
-                                    reinterpret_cast<const double*>(element), 
-                                    reinterpret_cast<const double*>(element) + num_of_element
-                                );
-
-                                std::transform(
-                                    values.begin(), 
-                                    values.end(), 
-                                    values.begin(), 
-                                    [](double var) -> float{
-                                        char *native = reinterpret_cast<char*>(&var);
-                                        return (native[7] << 0) | (native[6] << 8) |
-                                                (native[5] << 16) | (native[4] << 24) |
-                                                (native[3] << 32) | (native[2] << 40) |
-                                                (native[1] << 48) | (native[0] << 56);
-                                    });
-                                return values;
-                            }
-                        );
-                        return std::move(result);
-                    }
-                    case 'C':
-                    {
-                        auto result = std::make_unique<column_data<std::vector<std::complex<float>>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [num_of_element](char const* element) -> std::vector<std::complex<float>> {
-                                std::vector<std::complex<float>> values;
-                                values.reserve(num_of_element);
-                                for (auto i = reinterpret_cast<const float*>(element); i != i + num_of_element*2; i+=2)
-                                {
-                                    char const* char_ptr = reinterpret_cast<const char*>(i);
-                                    float real = (char_ptr[3] << 0) | (char_ptr[2] << 8) |
-                                                (char_ptr[1] << 16) | (char_ptr[0] << 24);
-                                    
-                                    char_ptr += 4;
-                                    float img = (char_ptr[3] << 0) | (char_ptr[2] << 8) |
-                                                (char_ptr[1] << 16) | (char_ptr[0] << 24);
-
-                                    values.emplace_back(real, img);
-                                }
-                                return values;
-                            }
-                        );
-                        return std::move(result);
-                    }
-                    case 'M':
-                    {
-                        auto result = std::make_unique<column_data<std::vector<std::complex<double>>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
-                            [num_of_element](char const* element) -> std::vector<std::complex<double>> {
-                            std::vector<std::complex<double>> values;
-                            values.reserve(num_of_element);
-                            for (auto i = reinterpret_cast<const double*>(element); i != i + num_of_element*2; i+=2)
-                                {
-                                    char const* char_ptr = reinterpret_cast<const char*>(i);
-                                    double real = (char_ptr[3] << 0) | (char_ptr[2] << 8) |
-                                                (char_ptr[1] << 16) | (char_ptr[0] << 24);
-                                    
-                                    char_ptr += 4;
-                                    double img = (char_ptr[3] << 0) | (char_ptr[2] << 8) |
-                                                (char_ptr[1] << 16) | (char_ptr[0] << 24);
-
-                                    values.emplace_back(real, img);
-                                }
-                            return values;
-                            }
-                        );
-                        return std::move(result);
-                    }
                     case 'P':
                     {
                         auto result = std::make_unique<column_data<std::vector<std::pair<std::int32_t, std::int32_t>>>>();
-                        fill_column(result->get_data(), col.TBCOL(), column_size(col.TFORM()),
+                        fill_column(result->get_data(), selection, col.TBCOL(), column_size(col.TFORM()),
                             [num_of_element](char const* element) -> std::vector<std::pair<std::int32_t, std::int32_t>> {
                                 std::vector<std::pair<std::int32_t, std::int32_t>> values;
                                 values.reserve(num_of_element);
@@ -487,82 +441,97 @@ public:
             }
         }
 
-        std::unique_ptr<column>(nullptr);
+        return std::unique_ptr<column>(nullptr);
     }
 
-    std::size_t column_size(std::string format) const
+    /*!
+    integer columns come back as their stored type, as the unsigned (or for 'B' signed) type when
+    TZERO follows the sign offset convention, or as double when TSCAL/TZERO scale them
+    */
+    template <typename Raw>
+    std::unique_ptr<column> read_integer_column(column const& col, bit_mask const* selection) const
     {
-        std::string form = boost::trim_copy_if(format, [](char c) -> bool {
-                            return c == '\'' || c == ' ';
-                        });
-
-        return form.length() > 1 ?
-            boost::lexical_cast<std::size_t>(form.substr(0, form.length() - 1)) *
-                type_size(form[form.length() - 1]) :
-            type_size(form[0]);
+        column_scaling scaling(col);
+        if (scaling.template is_sign_offset<Raw>())
+        {
+            return read_numeric_column(col, selection, sign_offset_decoder<Raw>());
+        }
+        if (!scaling.is_identity())
+        {
+            return read_numeric_column(col, selection, scaled_decoder<Raw>(scaling));
+        }
+        return read_numeric_column(col, selection, plain_decoder<Raw>());
     }
 
-    std::size_t element_count(std::string format) const
+    template <typename Raw>
+    std::unique_ptr<column> read_real_column(column const& col, bit_mask const* selection) const
     {
-        std::string form = boost::trim_copy_if(format, [](char c) -> bool {
-                            return c == '\'' || c == ' ';
-                        });
-
-        return form.length() > 1 ?
-            boost::lexical_cast<std::size_t>(form.substr(0, form.length() - 1)) :
-            static_cast<std::size_t>(1);
+        column_scaling scaling(col);
+        if (!scaling.is_identity())
+        {
+            return read_numeric_column(col, selection, scaled_decoder<Raw, Raw>(scaling));
+        }
+        return read_numeric_column(col, selection, plain_decoder<Raw>());
     }
 
-    char get_type(std::string format) const
+    template <typename Decoder>
+    std::unique_ptr<column> read_numeric_column
+    (
+        column const& col,
+        bit_mask const* selection,
+        Decoder const& decoder
+    ) const
     {
-        std::string form = boost::trim_copy_if(format, [](char c) -> bool {
-                            return c == '\'' || c == ' ';
-                        });
-
-        return form[form.length() - 1];
-    }
+        typedef typename Decoder::result_type value_type;
+        std::size_t const count = element_count(col.TFORM());
+        std::size_t const width = column_size(col.TFORM()) / count;
 
-    std::size_t type_size(char type) const
-    {
-        switch (type)
+        if (count == 1)
         {
-        case 'L':
-            return 1;
-        case 'X':
-            return 1;
-        case 'B':
-            return 1;
-        case 'I':
-            return 2;
-        case 'J':
-            return 4;
-        case 'A':
-            return 1;
-        case 'E':
-            return 4;
-        case 'D':
-            return 8;
-        case 'C':
-            return 8;
-        case 'M':
-            return 16;
-        case 'P':
-            return 8;
-        default:
-            throw invalid_table_colum_format();
+            auto result = std::make_unique<column_data<value_type>>();
+            if (selection)
+            {
+                fill_column(result->get_data(), selection, col.TBCOL(), width, decoder);
+            }
+            else
+            {
+                result->get_data().resize(naxis(2));
+                decode_strided(this->data.data() + col.TBCOL(), naxis(1), naxis(2), decoder,
+                    result->get_data().data());
+            }
+            return std::unique_ptr<column>(std::move(result));
         }
+
+        auto result = std::make_unique<column_data<std::vector<value_type>>>();
+        fill_column(result->get_data(), selection, col.TBCOL(), width * count,
+            [&decoder, count, width](char const* element) -> std::vector<value_type> {
+                std::vector<value_type> values(count);
+                decode_strided(element, width, count, decoder, values.data());
+                return values;
+            }
+        );
+        return std::unique_ptr<column>(std::move(result));
     }
 
-private:
     template<typename VectorType, typename Lambda>
     void fill_column 
     (
-        std::vector<VectorType> &column_container,
+        resource_vector<VectorType> &column_container,
+        bit_mask const* selection,
         std::size_t start,
         std::size_t column_size,
         Lambda lambda
     ) const
     {
+        if (selection)
+        {
+            column_container.reserve(selection->count());
+            selection->for_each_set([&](std::size_t i) {
+                column_container.emplace_back(lambda(this->data.data() + (i * naxis(1) + start)));
+            });
+            return;
+        }
+
         column_container.reserve(naxis(2));
         for (std::size_t i = 0; i < naxis(2); i++)
         {
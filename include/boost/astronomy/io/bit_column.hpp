@@ -0,0 +1,493 @@
+#ifndef BOOST_ASTRONOMY_IO_BIT_COLUMN_HPP
+#define BOOST_ASTRONOMY_IO_BIT_COLUMN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <initializer_list>
+
+#include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+namespace detail {
+
+//! number of set bits in a 64 bit word
+inline std::size_t popcount(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_popcountll(word));
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<std::size_t>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+//! index of the lowest set bit of a non zero 64 bit word
+inline std::size_t lowest_bit(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+    return popcount((word & (~word + 1)) - 1);
+#endif
+}
+
+//! reverses the bit order of a byte (FITS stores the first bit in the MSB)
+inline std::uint8_t reverse_bits(std::uint8_t byte)
+{
+    byte = static_cast<std::uint8_t>(((byte & 0xF0) >> 4) | ((byte & 0x0F) << 4));
+    byte = static_cast<std::uint8_t>(((byte & 0xCC) >> 2) | ((byte & 0x33) << 2));
+    byte = static_cast<std::uint8_t>(((byte & 0xAA) >> 1) | ((byte & 0x55) << 1));
+    return byte;
+}
+
+inline std::size_t word_count(std::size_t bits)
+{
+    return (bits + 63) / 64;
+}
+
+} //namespace detail
+
+/*!
+packed set of bits, one bit per element, stored in 64 bit words
+used as row selection mask for table reads and as flag pattern for bit_column queries
+*/
+struct bit_mask
+{
+private:
+    std::vector<std::uint64_t> words_;
+    std::size_t size_ = 0;
+
+public:
+    bit_mask() {}
+
+    //!creates mask of size bits, all set to value
+    explicit bit_mask(std::size_t size, bool value = false)
+        : words_(detail::word_count(size), value ? ~std::uint64_t(0) : 0), size_(size)
+    {
+        clear_padding();
+    }
+
+    //!creates mask of size bits with only the listed bits set
+    bit_mask(std::size_t size, std::initializer_list<std::size_t> set_bits)
+        : bit_mask(size)
+    {
+        for (auto bit : set_bits)
+        {
+            set(bit);
+        }
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    //!returns number of set bits
+    std::size_t count() const
+    {
+        std::size_t total = 0;
+        for (auto word : words_)
+        {
+            total += detail::popcount(word);
+        }
+        return total;
+    }
+
+    bool any() const
+    {
+        for (auto word : words_)
+        {
+            if (word)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool none() const
+    {
+        return !any();
+    }
+
+    bool all() const
+    {
+        return count() == size_;
+    }
+
+    bool test(std::size_t index) const
+    {
+        return (words_[index / 64] >> (index % 64)) & 1;
+    }
+
+    void set(std::size_t index, bool value = true)
+    {
+        std::uint64_t bit = std::uint64_t(1) << (index % 64);
+        if (value)
+        {
+            words_[index / 64] |= bit;
+        }
+        else
+        {
+            words_[index / 64] &= ~bit;
+        }
+    }
+
+    void reset(std::size_t index)
+    {
+        set(index, false);
+    }
+
+    //!calls function with the index of every set bit in increasing order
+    template <typename Function>
+    void for_each_set(Function function) const
+    {
+        for (std::size_t i = 0; i < words_.size(); i++)
+        {
+            std::uint64_t word = words_[i];
+            while (word)
+            {
+                function(i * 64 + detail::lowest_bit(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+    std::vector<std::uint64_t> const& words() const
+    {
+        return words_;
+    }
+
+    std::vector<std::uint64_t>& words()
+    {
+        return words_;
+    }
+
+    bit_mask& operator&=(bit_mask const& other)
+    {
+        check_size(other);
+        for (std::size_t i = 0; i < words_.size(); i++)
+        {
+            words_[i] &= other.words_[i];
+        }
+        return *this;
+    }
+
+    bit_mask& operator|=(bit_mask const& other)
+    {
+        check_size(other);
+        for (std::size_t i = 0; i < words_.size(); i++)
+        {
+            words_[i] |= other.words_[i];
+        }
+        return *this;
+    }
+
+    bit_mask& operator^=(bit_mask const& other)
+    {
+        check_size(other);
+        for (std::size_t i = 0; i < words_.size(); i++)
+        {
+            words_[i] ^= other.words_[i];
+        }
+        return *this;
+    }
+
+    bit_mask operator~() const
+    {
+        bit_mask result(*this);
+        for (auto& word : result.words_)
+        {
+            word = ~word;
+        }
+        result.clear_padding();
+        return result;
+    }
+
+    friend bit_mask operator&(bit_mask lhs, bit_mask const& rhs)
+    {
+        return lhs &= rhs;
+    }
+
+    friend bit_mask operator|(bit_mask lhs, bit_mask const& rhs)
+    {
+        return lhs |= rhs;
+    }
+
+    friend bit_mask operator^(bit_mask lhs, bit_mask const& rhs)
+    {
+        return lhs ^= rhs;
+    }
+
+    friend bool operator==(bit_mask const& lhs, bit_mask const& rhs)
+    {
+        return lhs.size_ == rhs.size_ && lhs.words_ == rhs.words_;
+    }
+
+    friend bool operator!=(bit_mask const& lhs, bit_mask const& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    //!bits past size() in the last word are kept zero so that count() and == stay exact
+    void clear_padding()
+    {
+        if (size_ % 64 != 0)
+        {
+            words_.back() &= (std::uint64_t(1) << (size_ % 64)) - 1;
+        }
+    }
+
+private:
+    void check_size(bit_mask const& other) const
+    {
+        if (other.size_ != size_)
+        {
+            throw invalid_selection_mask_size();
+        }
+    }
+};
+
+
+/*!
+packed storage for 'X' (bit) and 'L' (logical) table columns, bit 0 of a row being the first
+bit of the field in the file. rows of less than 64 bits are packed one after the other, row r
+starting at bit r * bits_per_row() of the storage, so e.g. a 1X flag column takes one bit per
+row. longer rows are padded to whole 64 bit words (see row_words). queries run over whole
+words instead of single elements
+*/
+struct bit_column : public column
+{
+private:
+    std::size_t rows_ = 0;
+    std::size_t bits_per_row_ = 0;
+    std::size_t words_per_row_ = 0; //! 0 when rows are packed
+    std::vector<std::uint64_t> words_;
+
+public:
+    bit_column() {}
+
+    bit_column(std::size_t rows, std::size_t bits_per_row)
+        : rows_(rows), bits_per_row_(bits_per_row),
+        words_per_row_(bits_per_row < 64 ? 0 : detail::word_count(bits_per_row)),
+        words_(bits_per_row < 64 ? detail::word_count(rows * bits_per_row) :
+            rows * detail::word_count(bits_per_row), 0) {}
+
+    std::size_t rows() const
+    {
+        return rows_;
+    }
+
+    std::size_t bits_per_row() const
+    {
+        return bits_per_row_;
+    }
+
+    //!true when rows are packed one after the other instead of padded to whole words
+    bool packed() const
+    {
+        return words_per_row_ == 0;
+    }
+
+    //!number of words of a padded row, 0 when rows are packed
+    std::size_t words_per_row() const
+    {
+        return words_per_row_;
+    }
+
+    //!words of a padded row, only valid when !packed()
+    std::uint64_t const* row_words(std::size_t row) const
+    {
+        return words_.data() + row * words_per_row_;
+    }
+
+    std::uint64_t* row_words(std::size_t row)
+    {
+        return words_.data() + row * words_per_row_;
+    }
+
+    //!bits of a packed row, bit k of the row in bit k of the result
+    std::uint64_t row_value(std::size_t row) const
+    {
+        if (bits_per_row_ == 0)
+        {
+            return 0;
+        }
+        std::size_t const first = row * bits_per_row_;
+        std::size_t const shift = first % 64;
+        std::uint64_t value = words_[first / 64] >> shift;
+        if (shift + bits_per_row_ > 64)
+        {
+            value |= words_[first / 64 + 1] << (64 - shift);
+        }
+        return value & row_mask();
+    }
+
+    //!replaces the bits of a packed row, bits of value past bits_per_row() are ignored
+    void set_row_value(std::size_t row, std::uint64_t value)
+    {
+        if (bits_per_row_ == 0)
+        {
+            return;
+        }
+        value &= row_mask();
+        std::size_t const first = row * bits_per_row_;
+        std::size_t const shift = first % 64;
+        std::uint64_t& low = words_[first / 64];
+        low = (low & ~(row_mask() << shift)) | (value << shift);
+        if (shift + bits_per_row_ > 64)
+        {
+            std::uint64_t& high = words_[first / 64 + 1];
+            high = (high & ~(row_mask() >> (64 - shift))) | (value >> (64 - shift));
+        }
+    }
+
+    bool test(std::size_t row, std::size_t bit = 0) const
+    {
+        std::size_t const index = bit_index(row, bit);
+        return (words_[index / 64] >> (index % 64)) & 1;
+    }
+
+    void set(std::size_t row, std::size_t bit, bool value = true)
+    {
+        std::size_t const index = bit_index(row, bit);
+        std::uint64_t mask = std::uint64_t(1) << (index % 64);
+        if (value)
+        {
+            words_[index / 64] |= mask;
+        }
+        else
+        {
+            words_[index / 64] &= ~mask;
+        }
+    }
+
+    //!returns total number of set bits in the column
+    std::size_t count() const
+    {
+        std::size_t total = 0;
+        for (auto word : words_)
+        {
+            total += detail::popcount(word);
+        }
+        return total;
+    }
+
+    //!returns number of rows in which given bit is set
+    std::size_t count(std::size_t bit) const
+    {
+        std::size_t total = 0;
+        for (std::size_t row = 0; row < rows_; row++)
+        {
+            total += test(row, bit);
+        }
+        return total;
+    }
+
+    //!returns mask of rows in which given bit is set
+    bit_mask select(std::size_t bit = 0) const
+    {
+        bit_mask flags(bits_per_row_);
+        flags.set(bit);
+        return any_of(flags);
+    }
+
+    //!returns mask of rows having at least one of the bits set in flags
+    bit_mask any_of(bit_mask const& flags) const
+    {
+        check_flags(flags);
+        return match<true>(flags);
+    }
+
+    //!returns mask of rows having all the bits set in flags
+    bit_mask all_of(bit_mask const& flags) const
+    {
+        check_flags(flags);
+        return match<false>(flags);
+    }
+
+    //!returns mask of rows having none of the bits set in flags
+    bit_mask none_of(bit_mask const& flags) const
+    {
+        return ~any_of(flags);
+    }
+
+private:
+    std::uint64_t row_mask() const
+    {
+        return bits_per_row_ < 64 ? (std::uint64_t(1) << bits_per_row_) - 1 : ~std::uint64_t(0);
+    }
+
+    std::size_t bit_index(std::size_t row, std::size_t bit) const
+    {
+        return packed() ? row * bits_per_row_ + bit : row * words_per_row_ * 64 + bit;
+    }
+
+    void check_flags(bit_mask const& flags) const
+    {
+        if (flags.size() != bits_per_row_)
+        {
+            throw invalid_selection_mask_size();
+        }
+    }
+
+    /*!
+    builds the row mask 64 rows at a time. with Any a row matches if some word shares a bit
+    with the pattern, otherwise every word has to contain its part of the pattern
+    */
+    template <bool Any>
+    bit_mask match(bit_mask const& flags) const
+    {
+        bit_mask result(rows_);
+        std::vector<std::uint64_t> const& pattern = flags.words();
+
+        for (std::size_t block = 0; block < result.words().size(); block++)
+        {
+            std::size_t const first = block * 64;
+            std::size_t const last = (first + 64 < rows_) ? first + 64 : rows_;
+            std::uint64_t out = 0;
+
+            if (words_per_row_ <= 1)
+            {
+                std::uint64_t const p = pattern.empty() ? 0 : pattern[0];
+                for (std::size_t row = first; row < last; row++)
+                {
+                    std::uint64_t const masked = (packed() ? row_value(row) : words_[row]) & p;
+                    out |= std::uint64_t(Any ? masked != 0 : masked == p) << (row - first);
+                }
+            }
+            else
+            {
+                for (std::size_t row = first; row < last; row++)
+                {
+                    std::uint64_t const* word = row_words(row);
+                    bool matched = !Any;
+                    for (std::size_t w = 0; w < words_per_row_; w++)
+                    {
+                        std::uint64_t const masked = word[w] & pattern[w];
+                        if (Any)
+                        {
+                            matched = matched || masked != 0;
+                        }
+                        else
+                        {
+                            matched = matched && masked == pattern[w];
+                        }
+                    }
+                    out |= std::uint64_t(matched) << (row - first);
+                }
+            }
+            result.words()[block] = out;
+        }
+        return result;
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_BIT_COLUMN_HPP
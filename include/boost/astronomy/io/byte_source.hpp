@@ -0,0 +1,381 @@
+#ifndef BOOST_ASTRONOMY_IO_BYTE_SOURCE_HPP
+#define BOOST_ASTRONOMY_IO_BYTE_SOURCE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+
+#ifdef BOOST_HAS_UNISTD_H
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+/*!
+byte sources of the io layer. every reader (hdu, tables, images, fits) reads from a
+std::istream, the stream buffers below adapt the supported sources to it:
+    memory_stream     contiguous bytes in memory, read in place without copies or syscalls
+    mapped_stream     a file mapped into memory (mapped_file)
+    positional_stream a file or descriptor read with pread (see positional_file.hpp)
+    forward_stream    sequential sources (pipes, sockets, decompressors, any std::istream)
+                      through a buffer, seeking forward by skipping
+readers seek only forward (to the end of a unit) unless a position is given explicitly,
+so all of them work on sequential sources. mapped_file, mapped_stream and descriptor_source
+are only available on POSIX platforms
+*/
+
+namespace boost { namespace astronomy { namespace io {
+
+/*!
+stream buffer over contiguous bytes, the get area is the memory itself so reads copy straight
+from it and seeks only move the read pointer. the memory must outlive the buffer
+*/
+struct memory_streambuf : public std::streambuf
+{
+public:
+    memory_streambuf(char const* data, std::size_t size)
+    {
+        char* first = const_cast<char*>(data); //the get area is never written
+        setg(first, first, first + size);
+    }
+
+    memory_streambuf(memory_streambuf const&) = delete;
+    memory_streambuf& operator=(memory_streambuf const&) = delete;
+
+protected:
+    std::streamsize showmanyc() override
+    {
+        return egptr() > gptr() ? static_cast<std::streamsize>(egptr() - gptr()) : -1;
+    }
+
+    pos_type seekoff
+    (
+        off_type offset,
+        std::ios_base::seekdir direction,
+        std::ios_base::openmode which = std::ios_base::in
+    ) override
+    {
+        if (!(which & std::ios_base::in))
+        {
+            return pos_type(off_type(-1));
+        }
+
+        off_type base = 0;
+        if (direction == std::ios_base::cur)
+        {
+            base = gptr() - eback();
+        }
+        else if (direction == std::ios_base::end)
+        {
+            base = egptr() - eback();
+        }
+
+        off_type const target = base + offset;
+        if (target < 0 || target > egptr() - eback())
+        {
+            return pos_type(off_type(-1));
+        }
+        setg(eback(), eback() + target, egptr());
+        return pos_type(target);
+    }
+
+    pos_type seekpos(pos_type target, std::ios_base::openmode which = std::ios_base::in) override
+    {
+        return seekoff(off_type(target), std::ios_base::beg, which);
+    }
+};
+
+//!input stream over contiguous bytes in memory, zero copy (see memory_streambuf)
+struct memory_stream : public std::istream
+{
+private:
+    memory_streambuf buffer;
+
+public:
+    memory_stream(char const* data, std::size_t size) : std::istream(nullptr), buffer(data, size)
+    {
+        rdbuf(&buffer);
+    }
+
+    explicit memory_stream(std::string const& bytes) : memory_stream(bytes.data(), bytes.size()) {}
+};
+
+#ifdef BOOST_HAS_UNISTD_H
+
+//!read only mapping of a whole file, copies share the mapping
+struct mapped_file
+{
+private:
+    struct mapping
+    {
+        void* address;
+        std::size_t size;
+
+        mapping(void* start, std::size_t length) : address(start), size(length) {}
+
+        mapping(mapping const&) = delete;
+        mapping& operator=(mapping const&) = delete;
+
+        ~mapping()
+        {
+            if (size != 0)
+            {
+                ::munmap(address, size);
+            }
+        }
+    };
+
+    std::shared_ptr<mapping const> map;
+
+public:
+    mapped_file() {}
+
+    explicit mapped_file(std::string const& file_name)
+    {
+        int const fd = ::open(file_name.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd < 0 || ::fstat(fd, &info) != 0)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            throw file_io_exception();
+        }
+
+        std::size_t const size = static_cast<std::size_t>(info.st_size);
+        void* address = nullptr;
+        if (size != 0)
+        {
+            address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (address == MAP_FAILED)
+        {
+            throw file_io_exception();
+        }
+        map = std::make_shared<mapping const>(address, size);
+    }
+
+    char const* data() const
+    {
+        return map ? static_cast<char const*>(map->address) : nullptr;
+    }
+
+    std::size_t size() const
+    {
+        return map ? map->size : 0;
+    }
+};
+
+//!input stream over a mapped_file, keeps the mapping alive
+struct mapped_stream : public std::istream
+{
+private:
+    mapped_file file;
+    memory_streambuf buffer;
+
+public:
+    explicit mapped_stream(mapped_file const& mapped)
+        : std::istream(nullptr), file(mapped), buffer(mapped.data(), mapped.size())
+    {
+        rdbuf(&buffer);
+    }
+
+    explicit mapped_stream(std::string const& file_name) : mapped_stream(mapped_file(file_name)) {}
+};
+
+#endif // BOOST_HAS_UNISTD_H
+
+//!sequential source reading another std::istream, which need not be seekable
+struct istream_source
+{
+    std::istream* stream;
+
+    explicit istream_source(std::istream& input) : stream(&input) {}
+
+    std::size_t read(char* buffer, std::size_t size)
+    {
+        stream->read(buffer, static_cast<std::streamsize>(size));
+        return static_cast<std::size_t>(stream->gcount());
+    }
+};
+
+#ifdef BOOST_HAS_UNISTD_H
+
+//!sequential source reading a descriptor (pipe, socket, ...) with read, it is not closed
+struct descriptor_source
+{
+    int fd;
+
+    explicit descriptor_source(int descriptor) : fd(descriptor) {}
+
+    std::size_t read(char* buffer, std::size_t size)
+    {
+        std::size_t done = 0;
+        while (done < size)
+        {
+            ssize_t const count = ::read(fd, buffer + done, size - done);
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw file_io_exception();
+            }
+            if (count == 0)
+            {
+                break;
+            }
+            done += static_cast<std::size_t>(count);
+        }
+        return done;
+    }
+};
+
+#endif // BOOST_HAS_UNISTD_H
+
+/*!
+stream buffer over a sequential Source (a read(char*, size) member returning the bytes read,
+fewer only at the end). it counts the position so tellg works, seeks forward by skipping and
+backward only within the current buffer
+*/
+template <typename Source>
+struct forward_streambuf : public std::streambuf
+{
+private:
+    Source source;
+    std::vector<char> buffer;
+    std::uint64_t buffer_offset = 0; //! position of the first buffered byte
+
+public:
+    explicit forward_streambuf(Source const& input, std::size_t buffer_size = std::size_t(64) << 10)
+        : source(input), buffer(std::max<std::size_t>(buffer_size, 1))
+    {
+        setg(buffer.data(), buffer.data(), buffer.data());
+    }
+
+    forward_streambuf(forward_streambuf const&) = delete;
+    forward_streambuf& operator=(forward_streambuf const&) = delete;
+
+    //!position of the next byte to be read
+    std::uint64_t position() const
+    {
+        return buffer_offset + static_cast<std::uint64_t>(gptr() - eback());
+    }
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() < egptr())
+        {
+            return traits_type::to_int_type(*gptr());
+        }
+
+        buffer_offset = position();
+        std::size_t const count = source.read(buffer.data(), buffer.size());
+        setg(buffer.data(), buffer.data(), buffer.data() + count);
+        return count == 0 ? traits_type::eof() : traits_type::to_int_type(*gptr());
+    }
+
+    std::streamsize xsgetn(char* destination, std::streamsize count) override
+    {
+        std::streamsize done = 0;
+        while (done < count)
+        {
+            std::streamsize const buffered = std::min<std::streamsize>(egptr() - gptr(),
+                count - done);
+            if (buffered > 0)
+            {
+                std::memcpy(destination + done, gptr(), static_cast<std::size_t>(buffered));
+                gbump(static_cast<int>(buffered));
+                done += buffered;
+                continue;
+            }
+
+            std::size_t const wanted = static_cast<std::size_t>(count - done);
+            if (wanted >= buffer.size())
+            {
+                std::uint64_t const offset = position();
+                std::size_t const read = source.read(destination + done, wanted);
+                buffer_offset = offset + read;
+                setg(buffer.data(), buffer.data(), buffer.data());
+                return done + static_cast<std::streamsize>(read);
+            }
+            if (traits_type::eq_int_type(underflow(), traits_type::eof()))
+            {
+                break;
+            }
+        }
+        return done;
+    }
+
+    pos_type seekoff
+    (
+        off_type offset,
+        std::ios_base::seekdir direction,
+        std::ios_base::openmode which = std::ios_base::in
+    ) override
+    {
+        if (!(which & std::ios_base::in) || direction == std::ios_base::end)
+        {
+            return pos_type(off_type(-1));
+        }
+
+        off_type const target = offset +
+            (direction == std::ios_base::cur ? static_cast<off_type>(position()) : 0);
+        if (target < static_cast<off_type>(buffer_offset))
+        {
+            return pos_type(off_type(-1));
+        }
+
+        std::uint64_t const next = static_cast<std::uint64_t>(target);
+        while (next > buffer_offset + static_cast<std::uint64_t>(egptr() - eback()))
+        {
+            setg(eback(), egptr(), egptr());
+            if (traits_type::eq_int_type(underflow(), traits_type::eof()))
+            {
+                return pos_type(off_type(-1));
+            }
+        }
+        setg(eback(), eback() + (next - buffer_offset), egptr());
+        return pos_type(target);
+    }
+
+    pos_type seekpos(pos_type target, std::ios_base::openmode which = std::ios_base::in) override
+    {
+        return seekoff(off_type(target), std::ios_base::beg, which);
+    }
+};
+
+//!input stream over a sequential Source, see forward_streambuf
+template <typename Source>
+struct forward_stream : public std::istream
+{
+private:
+    forward_streambuf<Source> buffer;
+
+public:
+    explicit forward_stream(Source const& source, std::size_t buffer_size = std::size_t(64) << 10)
+        : std::istream(nullptr), buffer(source, buffer_size)
+    {
+        rdbuf(&buffer);
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_BYTE_SOURCE_HPP
@@ -3,6 +3,8 @@
 
 #include <string>
 #include <sstream>
+#include <limits>
+#include <type_traits>
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/lexical_cast.hpp>
@@ -52,30 +54,7 @@ public:
         std::string const& comment = ""
     )
     {
-        if (key.length() > 8)
-        {
-            throw invalid_key_length_exception();
-        }
-        if ((comment.length() > 0) && (value.length() + comment.length() > 68))
-        {
-            throw invalid_value_length_exception();
-        }
-        else if (value.length() > 70)
-        {
-            throw invalid_value_length_exception();
-        }
-
-        if (comment.length())
-        {
-            this->card_ = std::string(key).append(8 - key.length(), ' ') +
-                "= " + value + " /" + comment +
-                std::string("").append(68 - value.length() + comment.length(), ' ');
-        }
-        else
-        {
-            this->card_ = std::string(key).append(8 - key.length(), ' ') + "= " +
-                std::string(value).append(70 - key.length(), ' ');
-        }
+        create_card(key, value, comment);
     }
 
     //!this overload supports date and string types
@@ -102,30 +81,19 @@ public:
             throw invalid_value_length_exception();
         }
 
+        this->card_ = std::string(key).append(8 - key.length(), ' ') + "= " + value;
         if (comment.length())
         {
-            this->card_ = std::string(key).append(8 - key.length(), ' ') +
-                "= " + value + " /" + comment +
-                std::string("").append(68 - value.length() + comment.length(), ' ');
-        }
-        else
-        {
-            this->card_ = std::string(key).append(8 - key.length(), ' ') +
-                "= " + std::string(value).append(70 - key.length(), ' ');
+            this->card_ += " /" + comment;
         }
+        this->card_.append(80 - this->card_.length(), ' ');
     }
 
     //!create card with boolean value
     void create_card(std::string const& key, bool value, std::string const& comment = "")
     {
-        if (value)
-        {
-            create_card(key, std::string("T").insert(0, ' ', 19), comment);
-        }
-        else
-        {
-            create_card(key, std::string("F").insert(0, ' ', 19), comment);
-        }
+        //logical value is right justified in column 30
+        create_card(key, std::string(19, ' ') + (value ? "T" : "F"), comment);
     }
 
     //!create card with numeric value
@@ -133,10 +101,18 @@ public:
     void create_card(std::string const& key, Value value, std::string const& comment = "")
     {
         std::ostringstream stream;
+        if (std::is_floating_point<Value>::value)
+        {
+            stream.precision(std::numeric_limits<Value>::max_digits10);
+        }
         stream << value;
 
+        //numeric value is right justified in column 30
         std::string val = stream.str();
-        val.insert(0, ' ', 20 - val.length());
+        if (val.length() < 20)
+        {
+            val.insert(0, 20 - val.length(), ' ');
+        }
         create_card(key, val, comment);
     }
 
@@ -172,7 +148,7 @@ public:
         }
 
         this->card_ = std::string(key).append(8 - key.length(), ' ') +
-            "  " + std::string(value).append(70 - key.length(), ' ');
+            "  " + std::string(value).append(70 - value.length(), ' ');
     }
 
     //!if whole value is set to true then string is returned with trailing spaces
@@ -212,7 +188,14 @@ public:
         {
             throw invalid_value_length_exception();
         }
-        this->card_.append(70 - value.length(), ' ');
+        this->card_ = this->card_.substr(0, 10) + value;
+        this->card_.append(80 - this->card_.length(), ' ');
+    }
+
+    //!returns all 80 chars of the card as stored in the file
+    std::string const& raw() const
+    {
+        return this->card_;
     }
 
 private:
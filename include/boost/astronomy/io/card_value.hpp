@@ -0,0 +1,156 @@
+#ifndef BOOST_ASTRONOMY_IO_CARD_VALUE_HPP
+#define BOOST_ASTRONOMY_IO_CARD_VALUE_HPP
+
+#include <algorithm>
+#include <limits>
+
+namespace boost { namespace astronomy { namespace io { namespace detail {
+
+/*!
+in place parsing of the values of raw 80 character cards, for readers that scan headers
+without building card objects (header_harvest.hpp, validate.hpp)
+*/
+
+/*!
+value of a card in place: [first, last) is the value without comment and trailing blanks,
+string values are returned without the quotes and trailing blanks (doubled quotes are left
+for the caller) and quoted is set for them. cards without value indicator have an empty
+value. returns false if a string has no closing quote or is followed by more than a comment
+*/
+inline bool card_value(char const* c, char const*& first, char const*& last, bool& quoted)
+{
+    first = c + 10;
+    last = c + 80;
+    quoted = false;
+    if (c[8] != '=')
+    {
+        first = last;
+        return true;
+    }
+
+    while (first != last && *first == ' ')
+    {
+        ++first;
+    }
+    bool valid = true;
+    if (first != last && *first == '\'')
+    {
+        quoted = true;
+        char const* end = ++first;
+        while (end != last && !(*end == '\'' && (end + 1 == last || end[1] != '\'')))
+        {
+            end += (*end == '\'' && end + 1 != last) ? 2 : 1;
+        }
+
+        char const* rest = end;
+        if (rest != last)
+        {
+            ++rest;
+        }
+        while (rest != last && *rest == ' ')
+        {
+            ++rest;
+        }
+        valid = end != last && (rest == last || *rest == '/');
+        last = end;
+    }
+    else
+    {
+        last = std::find(first, last, '/');
+    }
+
+    while (last != first && last[-1] == ' ')
+    {
+        --last;
+    }
+    return valid;
+}
+
+inline bool card_value(char const* c, char const*& first, char const*& last)
+{
+    bool quoted;
+    return card_value(c, first, last, quoted);
+}
+
+//!parses an integer value in place, returns false if it is not an integer or overflows
+inline bool parse_integer(char const* first, char const* last, long long& value)
+{
+    bool negative = false;
+    if (first != last && (*first == '+' || *first == '-'))
+    {
+        negative = *first == '-';
+        ++first;
+    }
+    if (first == last)
+    {
+        return false;
+    }
+
+    //accumulated negative, the range of long long reaches one further below zero
+    long long const min = std::numeric_limits<long long>::min();
+    long long result = 0;
+    for (; first != last; ++first)
+    {
+        if (*first < '0' || *first > '9')
+        {
+            return false;
+        }
+        int const digit = *first - '0';
+        if (result < (min + digit) / 10)
+        {
+            return false;
+        }
+        result = result * 10 - digit;
+    }
+    if (!negative && result == min)
+    {
+        return false;
+    }
+    value = negative ? result : -result;
+    return true;
+}
+
+//!true if [first, last) is an integer or real number, D exponents as in Fortran
+inline bool is_number(char const* first, char const* last)
+{
+    auto digits = [&first, last]() {
+        char const* const start = first;
+        while (first != last && *first >= '0' && *first <= '9')
+        {
+            ++first;
+        }
+        return first != start;
+    };
+
+    if (first != last && (*first == '+' || *first == '-'))
+    {
+        ++first;
+    }
+    bool mantissa = digits();
+    if (first != last && *first == '.')
+    {
+        ++first;
+        mantissa = digits() || mantissa;
+    }
+    if (!mantissa)
+    {
+        return false;
+    }
+    if (first != last && (*first == 'E' || *first == 'e' || *first == 'D' || *first == 'd'))
+    {
+        ++first;
+        if (first != last && (*first == '+' || *first == '-'))
+        {
+            ++first;
+        }
+        if (!digits())
+        {
+            return false;
+        }
+    }
+    return first == last;
+}
+
+}}}} //namespace boost::astronomy::io::detail
+
+#endif // !BOOST_ASTRONOMY_IO_CARD_VALUE_HPP
@@ -0,0 +1,233 @@
+#ifndef BOOST_ASTRONOMY_IO_CHECKSUM_HPP
+#define BOOST_ASTRONOMY_IO_CHECKSUM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <boost/astronomy/detail/parallel_for.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+namespace detail {
+
+//!folds the carries of a 64 bit sum back into 32 bits (end around carry)
+inline std::uint32_t fold_checksum(std::uint64_t sum)
+{
+    while (sum >> 32)
+    {
+        sum = (sum & 0xFFFFFFFFULL) + (sum >> 32);
+    }
+    return static_cast<std::uint32_t>(sum);
+}
+
+/*!
+sum of big endian 32 bit words. four independent accumulators of 64 bits keep the loop free
+of carry handling so it is vectorized by the compiler, carries are folded once at the end
+*/
+inline std::uint32_t sum_words(unsigned char const* data, std::size_t words)
+{
+    std::uint64_t sums[4] = {0, 0, 0, 0};
+    std::size_t i = 0;
+    for (; i + 4 <= words; i += 4)
+    {
+        for (std::size_t lane = 0; lane < 4; lane++)
+        {
+            unsigned char const* word = data + 4 * (i + lane);
+            sums[lane] += (std::uint64_t(word[0]) << 24) | (std::uint64_t(word[1]) << 16) |
+                (std::uint64_t(word[2]) << 8) | std::uint64_t(word[3]);
+        }
+    }
+    for (; i < words; i++)
+    {
+        unsigned char const* word = data + 4 * i;
+        sums[0] += (std::uint64_t(word[0]) << 24) | (std::uint64_t(word[1]) << 16) |
+            (std::uint64_t(word[2]) << 8) | std::uint64_t(word[3]);
+    }
+
+    std::uint64_t sum = 0;
+    for (auto s : sums)
+    {
+        sum += fold_checksum(s);
+    }
+    return fold_checksum(sum);
+}
+
+} //namespace detail
+
+//!ones' complement addition of two checksums, used to combine sums of word aligned parts
+inline std::uint32_t checksum_add(std::uint32_t lhs, std::uint32_t rhs)
+{
+    return detail::fold_checksum(std::uint64_t(lhs) + rhs);
+}
+
+/*!
+running FITS checksum (32 bit ones' complement sum of the big endian words of a unit),
+bytes can be added in pieces of any size
+*/
+struct checksum_accumulator
+{
+private:
+    std::uint32_t sum = 0;
+    std::size_t bytes = 0;
+
+public:
+    checksum_accumulator() {}
+
+    //!continues the checksum of bytes already summed to value
+    checksum_accumulator(std::uint32_t value, std::size_t size) : sum(value), bytes(size) {}
+
+    void update(char const* data, std::size_t size)
+    {
+        unsigned char const* first = reinterpret_cast<unsigned char const*>(data);
+        unsigned char const* last = first + size;
+
+        std::uint64_t partial = sum;
+        for (; first != last && bytes % 4 != 0; ++first, ++bytes)
+        {
+            partial += std::uint64_t(*first) << (8 * (3 - bytes % 4));
+        }
+
+        std::size_t const words = static_cast<std::size_t>(last - first) / 4;
+        partial += detail::sum_words(first, words);
+        first += 4 * words;
+        bytes += 4 * words;
+
+        for (; first != last; ++first, ++bytes)
+        {
+            partial += std::uint64_t(*first) << (8 * (3 - bytes % 4));
+        }
+        sum = detail::fold_checksum(partial);
+    }
+
+    //!adds size bytes of value, e.g. the padding of a unit
+    void update_fill(char value, std::size_t size)
+    {
+        if (value == '\0')
+        {
+            bytes += size;
+            return;
+        }
+
+        std::string const block(2880, value);
+        for (; size >= block.size(); size -= block.size())
+        {
+            update(block.data(), block.size());
+        }
+        update(block.data(), size);
+    }
+
+    std::uint32_t value() const
+    {
+        return this->sum;
+    }
+
+    //!number of bytes summed so far
+    std::size_t size() const
+    {
+        return this->bytes;
+    }
+};
+
+/*!
+checksum of a buffer starting at a word boundary of its unit. with more than one thread the
+buffer is split into segments of whole 2880 byte blocks that are summed in parallel,
+the partial sums combine exactly as the segments start at word boundaries
+*/
+inline std::uint32_t checksum(char const* data, std::size_t size, std::size_t threads = 1)
+{
+    std::size_t const blocks = size / 2880;
+    std::vector<std::uint32_t> partial(boost::astronomy::detail::thread_count(threads), 0);
+    boost::astronomy::detail::parallel_for(blocks, partial.size(),
+        [&](std::size_t begin, std::size_t end, std::size_t worker)
+        {
+            partial[worker] = detail::sum_words(
+                reinterpret_cast<unsigned char const*>(data) + begin * 2880, (end - begin) * 720);
+        });
+
+    std::uint32_t sum = 0;
+    for (auto p : partial)
+    {
+        sum = checksum_add(sum, p);
+    }
+
+    checksum_accumulator tail(sum, blocks * 2880);
+    tail.update(data + blocks * 2880, size - blocks * 2880);
+    return tail.value();
+}
+
+/*!
+16 character ASCII encoding of CHECKSUM keyword (FITS checksum convention), value is the
+complement of the HDU sum computed with CHECKSUM set to '0000000000000000'
+*/
+inline std::string encode_checksum(std::uint32_t value)
+{
+    static unsigned char const excluded[] = {
+        0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x40, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f, 0x60
+    };
+    auto is_excluded = [](int c) {
+        return std::find(std::begin(excluded), std::end(excluded), c) != std::end(excluded);
+    };
+
+    char encoded[16];
+    for (int i = 0; i < 4; i++)
+    {
+        int const byte = static_cast<int>((value >> (8 * (3 - i))) & 0xFF);
+        int ch[4];
+        std::fill(ch, ch + 4, byte / 4 + 0x30);
+        ch[0] += byte % 4;
+
+        //pairs are moved away from punctuation keeping their sum unchanged
+        bool adjusted = true;
+        while (adjusted)
+        {
+            adjusted = false;
+            for (int j = 0; j < 4; j += 2)
+            {
+                if (is_excluded(ch[j]) || is_excluded(ch[j + 1]))
+                {
+                    ch[j]++;
+                    ch[j + 1]--;
+                    adjusted = true;
+                }
+            }
+        }
+
+        for (int j = 0; j < 4; j++)
+        {
+            encoded[4 * j + i] = static_cast<char>(ch[j]);
+        }
+    }
+
+    //the encoding is rotated by one byte to line up with word boundaries in the card
+    std::string result(16, ' ');
+    for (int i = 0; i < 16; i++)
+    {
+        result[static_cast<std::size_t>(i)] = encoded[(i + 15) % 16];
+    }
+    return result;
+}
+
+//!result of verifying CHECKSUM and DATASUM keywords of one HDU
+struct checksum_status
+{
+    bool has_checksum = false;
+    bool checksum_valid = false; //! whole HDU sums to negative zero
+    bool has_datasum = false;
+    bool datasum_valid = false;  //! data unit sums to DATASUM
+    std::uint32_t header_sum = 0;
+    std::uint32_t data_sum = 0;
+
+    //!true unless a present keyword does not match
+    bool valid() const
+    {
+        return (!has_checksum || checksum_valid) && (!has_datasum || datasum_valid);
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_CHECKSUM_HPP
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <cstddef>
+#include <cstdint>
 
 #include <boost/static_assert.hpp>
 
@@ -17,8 +18,10 @@ private:
     std::size_t start;      //TBCOL
     std::string format;     //TFORM
     std::string unit;       //TUNIT
-    double scale;           //TSCAL
-    double zero;            //TZERO
+    double scale = 1.0;     //TSCAL
+    double zero = 0.0;      //TZERO
+    std::int64_t null_value = 0; //TNULL
+    bool null_defined = false;
     std::string display;    //TDISP
     std::string dimension;   //TDIM
     std::string comment_;
@@ -31,6 +34,9 @@ public:
 
     column(std::string tform) : format(tform) {}
 
+    //!columns are handed out as std::unique_ptr<column> pointing to column_data
+    virtual ~column() {}
+
     void index(std::size_t i)
     {
         index_ = i;
@@ -111,6 +117,23 @@ public:
         zero = tzero;
     }
 
+    std::int64_t TNULL() const
+    {
+        return null_value;
+    }
+
+    void TNULL(std::int64_t tnull)
+    {
+        null_value = tnull;
+        null_defined = true;
+    }
+
+    //!TNULL is optional, returns whether the column defines one
+    bool has_TNULL() const
+    {
+        return null_defined;
+    }
+
     std::string TDISP() const
     {
         return display;
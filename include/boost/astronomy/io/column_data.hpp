@@ -8,6 +8,7 @@
 #include <boost/static_assert.hpp>
 
 #include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/io/memory_resource.hpp>
 
 namespace boost { namespace astronomy { namespace io {
 
@@ -15,15 +16,15 @@ template <typename Type>
 struct column_data: public column
 {
 private:
-    std::vector<Type> column_data_;
+    resource_vector<Type> column_data_; //! allocated from the default resource
 
 public:
-    std::vector<Type> get_data() const
+    resource_vector<Type> get_data() const
     {
         return column_data_;
     }
 
-    std::vector<Type>& get_data()
+    resource_vector<Type>& get_data()
     {
         return column_data_;
     }
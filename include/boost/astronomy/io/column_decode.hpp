@@ -0,0 +1,183 @@
+#ifndef BOOST_ASTRONOMY_IO_COLUMN_DECODE_HPP
+#define BOOST_ASTRONOMY_IO_COLUMN_DECODE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <complex>
+
+#include <boost/endian/conversion.hpp>
+
+#include <boost/astronomy/io/column.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+namespace detail {
+
+//! unsigned integer of the same width, used to byte swap floating point values
+template <std::size_t Size> struct bits_of {};
+template <> struct bits_of<1> { typedef std::uint8_t type; };
+template <> struct bits_of<2> { typedef std::uint16_t type; };
+template <> struct bits_of<4> { typedef std::uint32_t type; };
+template <> struct bits_of<8> { typedef std::uint64_t type; };
+
+//! exact comparison, TSCAL/TZERO conventions only use exactly representable values
+inline bool exactly(double lhs, double rhs)
+{
+    return !(lhs < rhs) && !(rhs < lhs);
+}
+
+} //namespace detail
+
+//!reads one big endian value of type Raw from unaligned memory
+template <typename Raw>
+Raw load_big_endian(char const* field)
+{
+    typedef typename detail::bits_of<sizeof(Raw)>::type bits_type;
+
+    bits_type bits;
+    std::memcpy(&bits, field, sizeof(Raw));
+    bits = boost::endian::big_to_native(bits);
+
+    Raw value;
+    std::memcpy(&value, &bits, sizeof(Raw));
+    return value;
+}
+
+//!TSCALn, TZEROn and TNULLn of a column, physical value = TZERO + TSCAL * raw value
+struct column_scaling
+{
+    double scale = 1.0;
+    double zero = 0.0;
+    bool has_null = false;
+    std::int64_t null_value = 0;
+
+    column_scaling() {}
+
+    explicit column_scaling(column const& col)
+        : scale(col.TSCAL()), zero(col.TZERO()), has_null(col.has_TNULL()),
+        null_value(col.TNULL()) {}
+
+    bool is_identity() const
+    {
+        return detail::exactly(scale, 1.0) && detail::exactly(zero, 0.0);
+    }
+
+    /*!
+    true when TZERO only shifts the sign bit, the convention used to store unsigned 16/32/64 bit
+    integers (TZERO = 2^15, 2^31, 2^63) and signed bytes (TZERO = -128)
+    */
+    template <typename Raw>
+    bool is_sign_offset() const
+    {
+        if (!detail::exactly(scale, 1.0))
+        {
+            return false;
+        }
+        if (std::is_unsigned<Raw>::value)
+        {
+            return detail::exactly(zero, -std::ldexp(1.0, static_cast<int>(8 * sizeof(Raw) - 1)));
+        }
+        return detail::exactly(zero, std::ldexp(1.0, static_cast<int>(8 * sizeof(Raw) - 1)));
+    }
+};
+
+//!decodes big endian value as is
+template <typename Raw>
+struct plain_decoder
+{
+    typedef Raw result_type;
+
+    Raw operator()(char const* field) const
+    {
+        return load_big_endian<Raw>(field);
+    }
+};
+
+/*!
+decodes integers stored with the sign offset convention, flipping the top bit turns the stored
+two's complement value into the physical value of the opposite signedness without any arithmetic
+*/
+template <typename Raw>
+struct sign_offset_decoder
+{
+    typedef typename std::conditional
+    <
+        std::is_signed<Raw>::value,
+        typename std::make_unsigned<Raw>::type,
+        typename std::make_signed<Raw>::type
+    >::type result_type;
+
+    result_type operator()(char const* field) const
+    {
+        typedef typename std::make_unsigned<Raw>::type bits_type;
+        bits_type bits = static_cast<bits_type>(load_big_endian<Raw>(field));
+        bits = static_cast<bits_type>(bits ^ (bits_type(1) << (8 * sizeof(Raw) - 1)));
+
+        result_type value;
+        std::memcpy(&value, &bits, sizeof(Raw));
+        return value;
+    }
+};
+
+//!byte swap, TNULL check and scaling fused into one step, null values become NaN
+template <typename Raw, typename Physical = double>
+struct scaled_decoder
+{
+    typedef Physical result_type;
+
+    column_scaling scaling;
+
+    explicit scaled_decoder(column_scaling const& s) : scaling(s) {}
+
+    Physical operator()(char const* field) const
+    {
+        Raw const raw = load_big_endian<Raw>(field);
+        if (std::is_integral<Raw>::value && scaling.has_null &&
+            static_cast<std::int64_t>(raw) == scaling.null_value)
+        {
+            return std::numeric_limits<Physical>::quiet_NaN();
+        }
+        return static_cast<Physical>(scaling.zero + scaling.scale * static_cast<double>(raw));
+    }
+};
+
+//!decodes complex value stored as big endian real part followed by imaginary part
+template <typename Real>
+struct complex_decoder
+{
+    typedef std::complex<Real> result_type;
+
+    std::complex<Real> operator()(char const* field) const
+    {
+        return std::complex<Real>(load_big_endian<Real>(field),
+            load_big_endian<Real>(field + sizeof(Real)));
+    }
+};
+
+/*!
+runs decoder over count fields that are stride bytes apart, writing contiguous output.
+the loop has no branches besides the decoder's so the compiler is free to vectorize it
+*/
+template <typename Decoder>
+void decode_strided
+(
+    char const* first,
+    std::size_t stride,
+    std::size_t count,
+    Decoder const& decoder,
+    typename Decoder::result_type* out
+)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        out[i] = decoder(first + i * stride);
+    }
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_COLUMN_DECODE_HPP
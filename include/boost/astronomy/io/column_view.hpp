@@ -0,0 +1,262 @@
+#ifndef BOOST_ASTRONOMY_IO_COLUMN_VIEW_HPP
+#define BOOST_ASTRONOMY_IO_COLUMN_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <memory>
+#include <utility>
+
+#include <boost/type.hpp>
+
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/io/column_decode.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+/*!
+typed view of one scalar column of a binary_table_extension, values are decoded from the raw
+table data when accessed so nothing but the requested fields is ever converted.
+supported value types are
+    std::int64_t  for 'B', 'I', 'J' and 'K' columns (unsigned conventions included except
+                  unsigned 'K', TZERO = 2^63, whose values do not fit)
+    std::uint64_t for 'B' columns and unsigned 'I', 'J' and 'K' columns
+    double        for all numeric columns, TSCAL/TZERO applied and TNULL mapped to NaN
+    std::string   for 'A' columns, trailing blanks removed
+the view refers to the table's data, so the table must outlive it
+*/
+template <typename Type>
+struct column_view
+{
+public:
+    typedef Type value_type;
+
+private:
+    typedef Type (*decoder_type)(char const*, column_scaling const&, std::size_t);
+
+    char const* base = nullptr;
+    std::size_t stride = 0;
+    std::size_t row_count = 0;
+    std::size_t width = 0;
+    column_scaling scaling;
+    decoder_type decoder = nullptr;
+    std::shared_ptr<std::vector<std::size_t> const> row_index;
+
+public:
+    column_view() {}
+
+    column_view(binary_table_extension const& table, std::string const& name)
+        : column_view(table, name, table.get_data().data(), table.naxis(2)) {}
+
+    /*!
+    view over count rows stored at rows in the layout of table, used when rows are streamed
+    in blocks instead of being held by the table
+    */
+    column_view
+    (
+        binary_table_extension const& table,
+        std::string const& name,
+        char const* rows,
+        std::size_t count
+    )
+    {
+        column const& info = table.get_column_info(name);
+        char const type = table.get_type(info.TFORM());
+
+        if (type != 'A' && table.element_count(info.TFORM()) != 1)
+        {
+            throw invalid_table_colum_format();
+        }
+
+        base = rows + info.TBCOL();
+        stride = table.naxis(1);
+        row_count = count;
+        width = table.column_size(info.TFORM());
+        scaling = column_scaling(info);
+        decoder = select_decoder(type, scaling, boost::type<Type>());
+    }
+
+    //!number of rows visible through the view
+    std::size_t size() const
+    {
+        return row_index ? row_index->size() : row_count;
+    }
+
+    //!decodes the value of i-th row of the view
+    Type operator[](std::size_t i) const
+    {
+        std::size_t const row = row_index ? (*row_index)[i] : i;
+        return decoder(base + row * stride, scaling, width);
+    }
+
+    //!returns table row backing the i-th element of the view
+    std::size_t table_row(std::size_t i) const
+    {
+        return row_index ? (*row_index)[i] : i;
+    }
+
+    /*!
+    returns a view showing only the given rows (in the given order, repeats allowed),
+    indices are positions in this view so row selections can be chained
+    */
+    column_view at_rows(std::vector<std::size_t> positions) const
+    {
+        if (row_index)
+        {
+            for (auto& position : positions)
+            {
+                position = (*row_index)[position];
+            }
+        }
+
+        column_view result(*this);
+        result.row_index = std::make_shared<std::vector<std::size_t> const>(std::move(positions));
+        return result;
+    }
+
+    //!decodes every value of the view into a vector
+    std::vector<Type> materialize() const
+    {
+        std::vector<Type> values;
+        values.reserve(size());
+        for (std::size_t i = 0; i < size(); i++)
+        {
+            values.emplace_back((*this)[i]);
+        }
+        return values;
+    }
+
+private:
+    template <typename Raw>
+    static Type integer_field(char const* field, column_scaling const&, std::size_t)
+    {
+        return static_cast<Type>(plain_decoder<Raw>()(field));
+    }
+
+    template <typename Raw>
+    static Type sign_offset_field(char const* field, column_scaling const&, std::size_t)
+    {
+        return static_cast<Type>(sign_offset_decoder<Raw>()(field));
+    }
+
+    template <typename Raw>
+    static double real_field(char const* field, column_scaling const& s, std::size_t)
+    {
+        return static_cast<double>(scaled_decoder<Raw>(s)(field));
+    }
+
+    static std::string string_field(char const* field, column_scaling const&, std::size_t size)
+    {
+        while (size > 0 && (field[size - 1] == ' ' || field[size - 1] == '\0'))
+        {
+            size--;
+        }
+        return std::string(field, size);
+    }
+
+    template <typename Raw>
+    static decoder_type integer_decoder(column_scaling const& s)
+    {
+        if (s.template is_sign_offset<Raw>())
+        {
+            return &sign_offset_field<Raw>;
+        }
+        if (!s.is_identity())
+        {
+            throw invalid_table_colum_format();
+        }
+        return &integer_field<Raw>;
+    }
+
+    //!only columns whose physical values are never negative
+    template <typename Raw>
+    static decoder_type unsigned_decoder(column_scaling const& s)
+    {
+        if (std::is_unsigned<Raw>::value && s.is_identity())
+        {
+            return &integer_field<Raw>;
+        }
+        if (std::is_signed<Raw>::value && s.template is_sign_offset<Raw>())
+        {
+            return &sign_offset_field<Raw>;
+        }
+        throw invalid_table_colum_format();
+    }
+
+    static decoder_type select_decoder(char type, column_scaling const& s, boost::type<std::int64_t>)
+    {
+        switch (type)
+        {
+        case 'B':
+            return integer_decoder<std::uint8_t>(s);
+        case 'I':
+            return integer_decoder<std::int16_t>(s);
+        case 'J':
+            return integer_decoder<std::int32_t>(s);
+        case 'K':
+            //values above 2^63 - 1, read them with column_view<std::uint64_t>
+            if (s.template is_sign_offset<std::int64_t>())
+            {
+                throw invalid_table_colum_format();
+            }
+            return integer_decoder<std::int64_t>(s);
+        default:
+            throw invalid_table_colum_format();
+        }
+    }
+
+    static decoder_type select_decoder(char type, column_scaling const& s, boost::type<std::uint64_t>)
+    {
+        switch (type)
+        {
+        case 'B':
+            return unsigned_decoder<std::uint8_t>(s);
+        case 'I':
+            return unsigned_decoder<std::int16_t>(s);
+        case 'J':
+            return unsigned_decoder<std::int32_t>(s);
+        case 'K':
+            return unsigned_decoder<std::int64_t>(s);
+        default:
+            throw invalid_table_colum_format();
+        }
+    }
+
+    static decoder_type select_decoder(char type, column_scaling const&, boost::type<double>)
+    {
+        switch (type)
+        {
+        case 'B':
+            return &real_field<std::uint8_t>;
+        case 'I':
+            return &real_field<std::int16_t>;
+        case 'J':
+            return &real_field<std::int32_t>;
+        case 'K':
+            return &real_field<std::int64_t>;
+        case 'E':
+            return &real_field<float>;
+        case 'D':
+            return &real_field<double>;
+        default:
+            throw invalid_table_colum_format();
+        }
+    }
+
+    static decoder_type select_decoder(char type, column_scaling const&, boost::type<std::string>)
+    {
+        if (type != 'A')
+        {
+            throw invalid_table_colum_format();
+        }
+        return &string_field;
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_COLUMN_VIEW_HPP
@@ -0,0 +1,160 @@
+#ifndef BOOST_ASTRONOMY_IO_COMPRESSED_STREAM_HPP
+#define BOOST_ASTRONOMY_IO_COMPRESSED_STREAM_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <istream>
+#include <string>
+
+//!BOOST_ASTRONOMY_NO_COMPRESSION leaves out compressed_stream, which needs zlib and bzip2
+#ifndef BOOST_ASTRONOMY_NO_COMPRESSION
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#endif
+
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/byte_source.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//!compression of a FITS file as a whole (.fits.gz, .fits.bz2)
+enum class compression
+{
+    none,
+    gzip,
+    bzip2
+};
+
+//!detects the compression from the magic bytes at the current position, which is kept
+inline compression detect_compression(std::istream& stream)
+{
+    std::streampos const start = stream.tellg();
+    char magic[3] = {};
+    stream.read(magic, sizeof(magic));
+    bool const complete = stream.gcount() == sizeof(magic);
+    stream.clear();
+    stream.seekg(start);
+
+    if (complete && magic[0] == '\x1f' && magic[1] == '\x8b')
+    {
+        return compression::gzip;
+    }
+    if (complete && magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h')
+    {
+        return compression::bzip2;
+    }
+    return compression::none;
+}
+
+inline compression detect_compression(std::string const& file_name)
+{
+    std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    if (!file)
+    {
+        throw file_io_exception();
+    }
+    return detect_compression(file);
+}
+
+#ifndef BOOST_ASTRONOMY_NO_COMPRESSION
+
+/*!
+input stream decoding a gzip or bzip2 compressed file on the fly, plain files are passed
+through. only a sliding window of window_size decoded bytes is kept, the readers scan it
+sequentially and seeking forward decodes and drops the bytes skipped, so the uncompressed
+file is never materialized. seeking backward works only within the window
+*/
+struct compressed_stream : public std::istream
+{
+private:
+    std::ifstream file;
+    boost::iostreams::filtering_istream decoded;
+    forward_streambuf<istream_source> window;
+    compression format;
+
+public:
+    explicit compressed_stream
+    (
+        std::string const& file_name,
+        std::size_t window_size = std::size_t(64) << 10
+    ) : std::istream(nullptr),
+        file(file_name, std::ios_base::in | std::ios_base::binary),
+        window(istream_source(decoded), window_size),
+        format(compression::none)
+    {
+        if (!file)
+        {
+            throw file_io_exception();
+        }
+
+        format = detect_compression(file);
+        if (format == compression::gzip)
+        {
+            decoded.push(boost::iostreams::gzip_decompressor());
+        }
+        else if (format == compression::bzip2)
+        {
+            decoded.push(boost::iostreams::bzip2_decompressor());
+        }
+        decoded.push(file);
+        rdbuf(&window);
+    }
+
+    //!compression of the underlying file
+    compression kind() const
+    {
+        return format;
+    }
+};
+
+#endif // !BOOST_ASTRONOMY_NO_COMPRESSION
+
+/*!
+reads the header of the HDU at index (0 is the primary HDU) starting at the current position
+of stream, the data units before it are skipped and nothing after its header is read.
+throws hdu_not_found_exception if the stream ends before
+*/
+inline hdu read_hdu_header(std::istream& stream, std::size_t index)
+{
+    for (std::size_t current = 0; ; current++)
+    {
+        if (stream.peek() == std::istream::traits_type::eof())
+        {
+            throw hdu_not_found_exception();
+        }
+
+        hdu header(stream);
+        if (current == index)
+        {
+            return header;
+        }
+        std::size_t const padded = (header.data_size() + 2879) / 2880 * 2880;
+        stream.seekg(static_cast<std::streamoff>(padded), std::ios_base::cur);
+    }
+}
+
+/*!
+reads the header of the HDU at index of a plain or compressed file. compressed files are
+decoded only up to the end of that header, plain files are read with seeks over the data.
+throws compression_not_supported_exception for compressed files if BOOST_ASTRONOMY_NO_COMPRESSION
+*/
+inline hdu read_hdu_header(std::string const& file_name, std::size_t index)
+{
+    if (detect_compression(file_name) == compression::none)
+    {
+        std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+        return read_hdu_header(file, index);
+    }
+#ifndef BOOST_ASTRONOMY_NO_COMPRESSION
+    compressed_stream file(file_name);
+    return read_hdu_header(file, index);
+#else
+    throw compression_not_supported_exception();
+#endif
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_COMPRESSED_STREAM_HPP
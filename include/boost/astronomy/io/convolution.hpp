@@ -0,0 +1,583 @@
+#ifndef BOOST_ASTRONOMY_IO_CONVOLUTION_HPP
+#define BOOST_ASTRONOMY_IO_CONVOLUTION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/astronomy/detail/parallel_for.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+#include <boost/astronomy/io/aligned_buffer.hpp>
+#include <boost/astronomy/io/fft.hpp>
+#include <boost/astronomy/io/image.hpp>
+
+/*!
+convolution of images with separable kernels (gaussian, box) and general 2D kernels.
+
+the result is out(y, x) = sum k(j, i) * in(y - j + height / 2, x - i + width / 2), the
+kernel centred on its middle tap; pixels outside the image come from the border mode.
+direct convolution works on bands of rows sized to stay in cache, a horizontal pass into a
+band local buffer followed by a vertical pass over blocks of columns, with contiguous inner
+loops the compiler vectorizes. bands are split over threads. large kernels go through the real
+FFT of the border extended image instead
+*/
+
+namespace boost { namespace astronomy { namespace io {
+
+//!how pixels outside the image are made up
+enum class border
+{
+    constant,  //! convolution_options::border_value
+    replicate, //! the nearest edge pixel, aaa|abc|ccc
+    reflect,   //! mirrored without repeating the edge, cb|abc|ba
+    wrap       //! periodic, bc|abc|ab
+};
+
+enum class convolution_method
+{
+    automatic, //! whichever an estimate of the operation count prefers
+    direct,
+    fft
+};
+
+struct convolution_options
+{
+    border mode = border::replicate;
+    double border_value = 0.0;
+    convolution_method method = convolution_method::automatic;
+    std::size_t threads = 1; //! 0 uses one thread per core
+};
+
+//!kernel equal to the outer product of vertical and horizontal taps
+struct separable_kernel
+{
+    std::vector<double> horizontal;
+    std::vector<double> vertical;
+
+    separable_kernel() {}
+
+    //!the same taps in both directions
+    explicit separable_kernel(std::vector<double> const& taps) : horizontal(taps), vertical(taps) {}
+
+    separable_kernel(std::vector<double> horizontal_taps, std::vector<double> vertical_taps)
+        : horizontal(std::move(horizontal_taps)), vertical(std::move(vertical_taps))
+    {}
+};
+
+//!general kernel of height rows with width taps each, stored row by row
+struct convolution_kernel
+{
+private:
+    std::size_t width_;
+    std::size_t height_;
+    std::vector<double> values_;
+
+public:
+    convolution_kernel() : width_(0), height_(0) {}
+
+    convolution_kernel(std::size_t width, std::size_t height, std::vector<double> values)
+        : width_(width), height_(height), values_(std::move(values))
+    {
+        if (width == 0 || height == 0 || values_.size() != width * height)
+        {
+            throw invalid_kernel_exception();
+        }
+    }
+
+    explicit convolution_kernel(separable_kernel const& kernel)
+        : width_(kernel.horizontal.size()), height_(kernel.vertical.size())
+    {
+        values_.reserve(width_ * height_);
+        for (double vertical : kernel.vertical)
+        {
+            for (double horizontal : kernel.horizontal)
+            {
+                values_.push_back(vertical * horizontal);
+            }
+        }
+    }
+
+    std::size_t width() const
+    {
+        return width_;
+    }
+
+    std::size_t height() const
+    {
+        return height_;
+    }
+
+    double operator()(std::size_t y, std::size_t x) const
+    {
+        return values_[y * width_ + x];
+    }
+
+    std::vector<double> const& values() const
+    {
+        return values_;
+    }
+};
+
+//!normalized gaussian, radius 0 picks ceil(3.5 sigma)
+inline separable_kernel gaussian_kernel(double sigma, std::size_t radius = 0)
+{
+    if (!(sigma > 0))
+    {
+        throw invalid_kernel_exception();
+    }
+    if (radius == 0)
+    {
+        radius = static_cast<std::size_t>(std::ceil(3.5 * sigma));
+    }
+
+    std::vector<double> taps(2 * radius + 1);
+    double sum = 0;
+    for (std::size_t i = 0; i < taps.size(); i++)
+    {
+        double const offset = static_cast<double>(i) - static_cast<double>(radius);
+        taps[i] = std::exp(-offset * offset / (2 * sigma * sigma));
+        sum += taps[i];
+    }
+    for (double& tap : taps)
+    {
+        tap /= sum;
+    }
+    return separable_kernel(taps);
+}
+
+//!normalized size x size mean filter
+inline separable_kernel box_kernel(std::size_t size)
+{
+    if (size == 0)
+    {
+        throw invalid_kernel_exception();
+    }
+    return separable_kernel(std::vector<double>(size, 1.0 / static_cast<double>(size)));
+}
+
+namespace detail {
+
+//!float results are computed in float, everything else in double
+template <typename Result>
+struct convolution_work
+{
+    typedef typename std::conditional<std::is_same<Result, float>::value, float, double>::type
+        type;
+};
+
+//!index of the pixel standing in for i in [0, n), -1 for the constant border
+inline std::ptrdiff_t border_index(std::ptrdiff_t i, std::ptrdiff_t n, border mode)
+{
+    if (i >= 0 && i < n)
+    {
+        return i;
+    }
+    switch (mode)
+    {
+    case border::constant:
+        return -1;
+    case border::replicate:
+        return i < 0 ? 0 : n - 1;
+    case border::reflect:
+    {
+        if (n == 1)
+        {
+            return 0;
+        }
+        std::ptrdiff_t const period = 2 * n - 2;
+        i = (i < 0 ? -i : i) % period;
+        return i < n ? i : period - i;
+    }
+    case border::wrap:
+        return ((i % n) + n) % n;
+    }
+    return -1;
+}
+
+/*!
+row y of image (possibly outside) extended by left and right pixels of border, converted to
+Work, into out of width + left + right values
+*/
+template <typename PixelType, typename Work>
+void border_row(image_buffer<PixelType> const& image, std::ptrdiff_t y, std::size_t left,
+    std::size_t right, convolution_options const& options, Work* out)
+{
+    std::ptrdiff_t const width = static_cast<std::ptrdiff_t>(image.get_width());
+    std::ptrdiff_t const source = border_index(y, static_cast<std::ptrdiff_t>(image.get_height()),
+        options.mode);
+    Work const value = static_cast<Work>(options.border_value);
+    std::size_t const count = image.get_width() + left + right;
+    if (source < 0)
+    {
+        std::fill(out, out + count, value);
+        return;
+    }
+
+    PixelType const* row = image.row(static_cast<std::size_t>(source));
+    auto const outside = [&](std::ptrdiff_t x)
+    {
+        std::ptrdiff_t const column = border_index(x, width, options.mode);
+        return column < 0 ? value : static_cast<Work>(row[column]);
+    };
+    for (std::size_t i = 0; i < left; i++)
+    {
+        out[i] = outside(static_cast<std::ptrdiff_t>(i) - static_cast<std::ptrdiff_t>(left));
+    }
+    for (std::size_t x = 0; x < image.get_width(); x++)
+    {
+        out[left + x] = static_cast<Work>(row[x]);
+    }
+    for (std::size_t i = 0; i < right; i++)
+    {
+        out[left + image.get_width() + i] = outside(width + static_cast<std::ptrdiff_t>(i));
+    }
+}
+
+//!columns processed together, so a block of the accumulator stays in L1
+inline std::size_t column_block()
+{
+    return 1024;
+}
+
+//!out[x] += sum taps[k] * source[x + k] for x in [begin, end)
+template <typename Work>
+void correlate_accumulate(Work const* source, Work const* taps, std::size_t count,
+    std::size_t begin, std::size_t end, Work* out)
+{
+    for (std::size_t k = 0; k < count; k++)
+    {
+        Work const tap = taps[k];
+        Work const* shifted = source + k;
+        for (std::size_t x = begin; x < end; x++)
+        {
+            out[x] += tap * shifted[x];
+        }
+    }
+}
+
+//!out[x] = sum taps[k] * rows[k][x]
+template <typename Work>
+void accumulate_rows(Work const* const* rows, Work const* taps, std::size_t count,
+    std::size_t width, Work* out)
+{
+    for (std::size_t begin = 0; begin < width; begin += column_block())
+    {
+        std::size_t const end = std::min(width, begin + column_block());
+        std::fill(out + begin, out + end, Work());
+        for (std::size_t k = 0; k < count; k++)
+        {
+            Work const tap = taps[k];
+            Work const* row = rows[k];
+            for (std::size_t x = begin; x < end; x++)
+            {
+                out[x] += tap * row[x];
+            }
+        }
+    }
+}
+
+//!rows of a band such that the band with its halo takes about a L2 cache
+inline std::size_t band_rows(std::size_t row_bytes, std::size_t halo)
+{
+    std::size_t const cache = 256 * 1024;
+    std::size_t const rows = cache / (row_bytes != 0 ? row_bytes : 1);
+    return std::max<std::size_t>(rows > halo ? rows - halo : 1, 8);
+}
+
+template <typename Work>
+std::vector<Work> reversed_taps(std::vector<double> const& taps)
+{
+    std::vector<Work> result(taps.size());
+    for (std::size_t i = 0; i < taps.size(); i++)
+    {
+        result[i] = static_cast<Work>(taps[taps.size() - 1 - i]);
+    }
+    return result;
+}
+
+template <typename Work, typename Result>
+void store_row(Work const* values, std::size_t width, Result* out)
+{
+    for (std::size_t x = 0; x < width; x++)
+    {
+        out[x] = static_cast<Result>(values[x]);
+    }
+}
+
+template <typename PixelType, typename Result>
+void convolve_separable(image_buffer<PixelType> const& image, separable_kernel const& kernel,
+    image_buffer<Result>& out, convolution_options const& options)
+{
+    typedef typename convolution_work<Result>::type work;
+
+    std::size_t const width = image.get_width();
+    std::size_t const kernel_width = kernel.horizontal.size();
+    std::size_t const kernel_height = kernel.vertical.size();
+    //taps reversed turn the convolution into a correlation over the extended rows
+    std::size_t const left = kernel_width - 1 - kernel_width / 2;
+    std::size_t const right = kernel_width - 1 - left;
+    std::size_t const top = kernel_height - 1 - kernel_height / 2;
+    std::vector<work> const horizontal = reversed_taps<work>(kernel.horizontal);
+    std::vector<work> const vertical = reversed_taps<work>(kernel.vertical);
+    std::size_t const band = band_rows(width * sizeof(work), kernel_height - 1);
+
+    astronomy::detail::parallel_for(image.get_height(), options.threads,
+        [&](std::size_t begin, std::size_t end, std::size_t)
+        {
+            aligned_buffer<work> extended(width + kernel_width - 1);
+            aligned_buffer<work> filtered((band + kernel_height - 1) * width);
+            aligned_buffer<work> result(width);
+            std::vector<work const*> rows(kernel_height);
+
+            for (std::size_t first = begin; first < end; first += band)
+            {
+                std::size_t const last = std::min(end, first + band);
+
+                //horizontal pass over the band and its halo
+                for (std::size_t r = 0; r < last - first + kernel_height - 1; r++)
+                {
+                    std::ptrdiff_t const y = static_cast<std::ptrdiff_t>(first + r) -
+                        static_cast<std::ptrdiff_t>(top);
+                    border_row(image, y, left, right, options, extended.data());
+                    work* target = filtered.data() + r * width;
+                    for (std::size_t x = 0; x < width; x += column_block())
+                    {
+                        std::size_t const stop = std::min(width, x + column_block());
+                        std::fill(target + x, target + stop, work());
+                        correlate_accumulate(static_cast<work const*>(extended.data()),
+                            horizontal.data(), kernel_width, x, stop, target);
+                    }
+                }
+
+                //vertical pass, kernel_height filtered rows per output row
+                for (std::size_t y = first; y < last; y++)
+                {
+                    for (std::size_t k = 0; k < kernel_height; k++)
+                    {
+                        rows[k] = filtered.data() + (y - first + k) * width;
+                    }
+                    accumulate_rows(rows.data(), vertical.data(), kernel_height, width,
+                        result.data());
+                    store_row(static_cast<work const*>(result.data()), width, out.row(y));
+                }
+            }
+        });
+}
+
+template <typename PixelType, typename Result>
+void convolve_direct(image_buffer<PixelType> const& image, convolution_kernel const& kernel,
+    image_buffer<Result>& out, convolution_options const& options)
+{
+    typedef typename convolution_work<Result>::type work;
+
+    std::size_t const width = image.get_width();
+    std::size_t const kernel_width = kernel.width();
+    std::size_t const kernel_height = kernel.height();
+    std::size_t const left = kernel_width - 1 - kernel_width / 2;
+    std::size_t const right = kernel_width - 1 - left;
+    std::size_t const top = kernel_height - 1 - kernel_height / 2;
+    std::size_t const extended_width = width + kernel_width - 1;
+    std::vector<work> const taps = reversed_taps<work>(kernel.values());
+    std::size_t const band = band_rows(extended_width * sizeof(work), kernel_height - 1);
+
+    astronomy::detail::parallel_for(image.get_height(), options.threads,
+        [&](std::size_t begin, std::size_t end, std::size_t)
+        {
+            aligned_buffer<work> extended((band + kernel_height - 1) * extended_width);
+            aligned_buffer<work> result(width);
+
+            for (std::size_t first = begin; first < end; first += band)
+            {
+                std::size_t const last = std::min(end, first + band);
+                for (std::size_t r = 0; r < last - first + kernel_height - 1; r++)
+                {
+                    std::ptrdiff_t const y = static_cast<std::ptrdiff_t>(first + r) -
+                        static_cast<std::ptrdiff_t>(top);
+                    border_row(image, y, left, right, options,
+                        extended.data() + r * extended_width);
+                }
+
+                for (std::size_t y = first; y < last; y++)
+                {
+                    for (std::size_t x = 0; x < width; x += column_block())
+                    {
+                        std::size_t const stop = std::min(width, x + column_block());
+                        std::fill(result.data() + x, result.data() + stop, work());
+                        //taps reversed, row by row from the last
+                        for (std::size_t j = 0; j < kernel_height; j++)
+                        {
+                            correlate_accumulate(
+                                static_cast<work const*>(extended.data()) +
+                                    (y - first + j) * extended_width,
+                                taps.data() + j * kernel_width, kernel_width, x, stop,
+                                result.data());
+                        }
+                    }
+                    store_row(static_cast<work const*>(result.data()), width, out.row(y));
+                }
+            }
+        });
+}
+
+template <typename PixelType, typename Result>
+void convolve_fft(image_buffer<PixelType> const& image, convolution_kernel const& kernel,
+    image_buffer<Result>& out, convolution_options const& options)
+{
+    std::size_t const width = image.get_width();
+    std::size_t const height = image.get_height();
+    std::size_t const left = kernel.width() - 1 - kernel.width() / 2;
+    std::size_t const right = kernel.width() - 1 - left;
+    std::size_t const top = kernel.height() - 1 - kernel.height() / 2;
+    std::size_t const extended_height = height + kernel.height() - 1;
+    std::size_t const fft_width = fft_size(width + kernel.width() - 1);
+    std::size_t const fft_height = fft_size(extended_height);
+
+    //the border extended image, zero padded; the padding is never wrapped into the result
+    image_buffer<double> pixels(fft_width, fft_height);
+    image_buffer<double> taps(fft_width, fft_height);
+    for (std::size_t r = 0; r < fft_height; r++)
+    {
+        std::fill(pixels.row(r), pixels.row(r) + fft_width, 0.0);
+        std::fill(taps.row(r), taps.row(r) + fft_width, 0.0);
+        if (r < extended_height)
+        {
+            border_row(image, static_cast<std::ptrdiff_t>(r) - static_cast<std::ptrdiff_t>(top),
+                left, right, options, pixels.row(r));
+        }
+        for (std::size_t i = 0; r < kernel.height() && i < kernel.width(); i++)
+        {
+            taps.row(r)[i] = kernel(r, i);
+        }
+    }
+
+    image_spectrum spectrum = fft_2d(pixels, options.threads);
+    image_spectrum const kernel_spectrum = fft_2d(taps, options.threads);
+    for (std::size_t v = 0; v < fft_height; v++)
+    {
+        for (std::size_t u = 0; u < spectrum.columns(); u++)
+        {
+            spectrum(v, u) = detail::multiply(spectrum(v, u), kernel_spectrum(v, u));
+        }
+    }
+    inverse_fft_2d(std::move(spectrum), pixels, options.threads);
+
+    double const scale = 1.0 / static_cast<double>(fft_width * fft_height);
+    for (std::size_t y = 0; y < height; y++)
+    {
+        double const* row = pixels.row(y + kernel.height() - 1) + kernel.width() - 1;
+        Result* target = out.row(y);
+        for (std::size_t x = 0; x < width; x++)
+        {
+            target[x] = static_cast<Result>(row[x] * scale);
+        }
+    }
+}
+
+//!true when the FFT is estimated to take fewer operations than taps per pixel directly
+inline bool prefer_fft(std::size_t width, std::size_t height, std::size_t kernel_width,
+    std::size_t kernel_height, std::size_t taps)
+{
+    double const size = static_cast<double>(fft_size(width + kernel_width - 1) *
+        fft_size(height + kernel_height - 1));
+    //three real transforms of about 2.5 n log2 n flops each plus the product
+    double const fft = size * (7.5 * std::log2(size) + 3);
+    double const direct = 2 * static_cast<double>(taps) * static_cast<double>(width * height);
+    return direct > fft;
+}
+
+template <typename PixelType, typename Result>
+bool convolution_into_self(image_buffer<PixelType> const& image, image_buffer<Result> const& out)
+{
+    return static_cast<void const*>(&image) == static_cast<void const*>(&out);
+}
+
+} //namespace detail
+
+//!convolves image with a separable kernel into out, which is resized to the image
+template <typename PixelType, typename Result>
+void convolve(image_buffer<PixelType> const& image, separable_kernel const& kernel,
+    image_buffer<Result>& out, convolution_options const& options = convolution_options())
+{
+    if (kernel.horizontal.empty() || kernel.vertical.empty())
+    {
+        throw invalid_kernel_exception();
+    }
+    if (detail::convolution_into_self(image, out))
+    {
+        image_buffer<Result> result;
+        convolve(image, kernel, result, options);
+        out = std::move(result);
+        return;
+    }
+    out.resize(image.get_width(), image.get_height());
+    if (image.get_width() == 0 || image.get_height() == 0)
+    {
+        return;
+    }
+
+    bool const fft = options.method == convolution_method::fft ||
+        (options.method == convolution_method::automatic &&
+            detail::prefer_fft(image.get_width(), image.get_height(), kernel.horizontal.size(),
+                kernel.vertical.size(), kernel.horizontal.size() + kernel.vertical.size()));
+    if (fft)
+    {
+        detail::convolve_fft(image, convolution_kernel(kernel), out, options);
+    }
+    else
+    {
+        detail::convolve_separable(image, kernel, out, options);
+    }
+}
+
+//!convolves image with a general kernel into out, which is resized to the image
+template <typename PixelType, typename Result>
+void convolve(image_buffer<PixelType> const& image, convolution_kernel const& kernel,
+    image_buffer<Result>& out, convolution_options const& options = convolution_options())
+{
+    if (kernel.width() == 0)
+    {
+        throw invalid_kernel_exception();
+    }
+    if (detail::convolution_into_self(image, out))
+    {
+        image_buffer<Result> result;
+        convolve(image, kernel, result, options);
+        out = std::move(result);
+        return;
+    }
+    out.resize(image.get_width(), image.get_height());
+    if (image.get_width() == 0 || image.get_height() == 0)
+    {
+        return;
+    }
+
+    bool const fft = options.method == convolution_method::fft ||
+        (options.method == convolution_method::automatic &&
+            detail::prefer_fft(image.get_width(), image.get_height(), kernel.width(),
+                kernel.height(), kernel.values().size()));
+    if (fft)
+    {
+        detail::convolve_fft(image, kernel, out, options);
+    }
+    else
+    {
+        detail::convolve_direct(image, kernel, out, options);
+    }
+}
+
+//!returns image convolved with kernel (separable_kernel or convolution_kernel)
+template <typename Result = float, typename PixelType, typename Kernel>
+image_buffer<Result> convolve(image_buffer<PixelType> const& image, Kernel const& kernel,
+    convolution_options const& options = convolution_options())
+{
+    image_buffer<Result> result;
+    convolve(image, kernel, result, options);
+    return result;
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_CONVOLUTION_HPP
@@ -1,6 +1,7 @@
 #ifndef BOOST_ASTRONOMY_IO_EXTENSION_HDU_HPP
 #define BOOST_ASTRONOMY_IO_EXTENSION_HDU_HPP
 
+#include <istream>
 #include <string>
 #include <vector>
 #include <cstddef>
@@ -20,21 +21,29 @@ protected:
 public:
     extension_hdu() {}
 
-    extension_hdu(std::fstream &file) : hdu(file) 
+    extension_hdu(std::istream &file) : hdu(file) 
     {
         gcount = this->value_of<int>("GCOUNT");
         pcount = this->value_of<int>("PCOUNT");
         extname = this->value_of<std::string>("EXTNAME");
     }
 
-    extension_hdu(std::fstream &file, hdu const& other) : hdu(other)
+    extension_hdu(std::istream &file, hdu const& other) : hdu(other)
     {
         gcount = this->value_of<int>("GCOUNT");
         pcount = this->value_of<int>("PCOUNT");
         extname = this->value_of<std::string>("EXTNAME");
     }
 
-    extension_hdu(std::fstream &file, std::streampos pos) : hdu(file, pos)
+    //!creates extension from an already read header, no data is read
+    extension_hdu(hdu const& other) : hdu(other)
+    {
+        gcount = this->value_of<int>("GCOUNT");
+        pcount = this->value_of<int>("PCOUNT");
+        extname = this->value_of<std::string>("EXTNAME");
+    }
+
+    extension_hdu(std::istream &file, std::streampos pos) : hdu(file, pos)
     {
         gcount = this->value_of<int>("GCOUNT");
         pcount = this->value_of<int>("PCOUNT");
@@ -0,0 +1,412 @@
+#ifndef BOOST_ASTRONOMY_IO_EXTERNAL_SORT_HPP
+#define BOOST_ASTRONOMY_IO_EXTERNAL_SORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <numeric>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <vector>
+#include <queue>
+
+#include <boost/filesystem.hpp>
+
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/column_view.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/detail/parallel_for.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//!tuning of external_sort
+struct external_sort_options
+{
+    std::size_t memory_budget = std::size_t(256) << 20; //! bytes used for rows held in memory
+    std::size_t threads = 0; //! runs sorted in parallel, 0 uses hardware concurrency
+    std::string temp_directory = "."; //! directory of the sorted runs spilled to disk
+    std::size_t merge_width = 64; //! runs merged at once, bounds the files open while merging
+};
+
+namespace detail {
+
+//!maps keys to unsigned integers with the same order, NaN after +infinity
+inline std::uint64_t radix_key(std::int64_t value)
+{
+    return static_cast<std::uint64_t>(value) ^ (std::uint64_t(1) << 63);
+}
+
+inline std::uint64_t radix_key(std::uint64_t value)
+{
+    return value;
+}
+
+inline std::uint64_t radix_key(double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (std::uint64_t(1) << 63);
+}
+
+//!ordering used for both run sorting and merging
+template <typename Key>
+bool key_less(Key const& lhs, Key const& rhs)
+{
+    return radix_key(lhs) < radix_key(rhs);
+}
+
+inline bool key_less(std::string const& lhs, std::string const& rhs)
+{
+    return lhs < rhs;
+}
+
+/*!
+stable LSD radix sort of positions by key, 8 bits per pass. passes in which every key has the
+same digit (e.g. high bytes of small ids) are skipped
+*/
+template <typename Key>
+std::vector<std::size_t> sorted_order(std::vector<Key> const& keys)
+{
+    std::size_t const count = keys.size();
+    std::vector<std::uint64_t> digits(count), digits_next(count);
+    std::vector<std::size_t> order(count), order_next(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        digits[i] = radix_key(keys[i]);
+    }
+    std::iota(order.begin(), order.end(), 0);
+
+    for (unsigned shift = 0; shift < 64; shift += 8)
+    {
+        std::size_t histogram[256] = {};
+        for (std::size_t i = 0; i < count; i++)
+        {
+            histogram[(digits[i] >> shift) & 0xFF]++;
+        }
+        if (count == 0 || histogram[(digits[0] >> shift) & 0xFF] == count)
+        {
+            continue;
+        }
+
+        std::size_t offset = 0;
+        for (auto& bucket : histogram)
+        {
+            std::size_t const size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (std::size_t i = 0; i < count; i++)
+        {
+            std::size_t const target = histogram[(digits[i] >> shift) & 0xFF]++;
+            digits_next[target] = digits[i];
+            order_next[target] = order[i];
+        }
+        digits.swap(digits_next);
+        order.swap(order_next);
+    }
+    return order;
+}
+
+inline std::vector<std::size_t> sorted_order(std::vector<std::string> const& keys)
+{
+    std::vector<std::size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&keys](std::size_t lhs, std::size_t rhs) {
+        return keys[lhs] < keys[rhs];
+    });
+    return order;
+}
+
+//!removes the spilled runs when the sort finishes or fails
+struct run_files
+{
+    std::vector<std::string> paths;
+    std::vector<std::size_t> rows;
+
+    run_files() {}
+
+    run_files(run_files const&) = delete;
+    run_files& operator=(run_files const&) = delete;
+
+    ~run_files()
+    {
+        for (auto const& path : paths)
+        {
+            std::remove(path.c_str());
+        }
+    }
+
+    /*!
+    adds a run of count rows named after stem in directory, with a random part so sorts of the
+    same table running at the same time do not clash. returns its path
+    */
+    std::string const& add(std::string const& directory, std::string const& stem, std::size_t count)
+    {
+        paths.push_back(boost::filesystem::unique_path(
+            boost::filesystem::path(directory) / (stem + ".%%%%-%%%%-%%%%-%%%%.run")).string());
+        rows.push_back(count);
+        return paths.back();
+    }
+
+    void swap(run_files& other)
+    {
+        paths.swap(other.paths);
+        rows.swap(other.rows);
+    }
+};
+
+//!buffered reader of one sorted run during the merge
+template <typename Key>
+struct run_reader
+{
+    std::ifstream file;
+    std::size_t remaining = 0;
+    std::size_t block_rows = 0;
+    std::vector<char> rows;
+    column_view<Key> keys;
+    std::size_t position = 0;
+    Key key{};
+
+    //!reads the next block of rows, returns false when the run is exhausted
+    bool refill(binary_table_extension const& table, std::string const& key_column)
+    {
+        std::size_t const row_size = table.naxis(1);
+        std::size_t const count = std::min(remaining, block_rows);
+        if (count == 0)
+        {
+            return false;
+        }
+
+        rows.resize(count * row_size);
+        file.read(rows.data(), static_cast<std::streamsize>(rows.size()));
+        if (!file)
+        {
+            throw file_io_exception();
+        }
+        remaining -= count;
+        keys = column_view<Key>(table, key_column, rows.data(), count);
+        position = 0;
+        key = keys[0];
+        return true;
+    }
+
+    char const* row(std::size_t row_size) const
+    {
+        return rows.data() + position * row_size;
+    }
+
+    //!moves to the next row, returns false when the run is exhausted
+    bool next(binary_table_extension const& table, std::string const& key_column)
+    {
+        if (++position < keys.size())
+        {
+            key = keys[position];
+            return true;
+        }
+        return refill(table, key_column);
+    }
+};
+
+/*!
+k-way merge of the runs [first, last), passing every row to output in key order. ties are
+taken from the earlier run, so merging consecutive runs keeps the sort stable
+*/
+template <typename Key, typename Output>
+void merge_runs
+(
+    binary_table_extension const& table,
+    std::string const& key_column,
+    run_files const& runs,
+    std::size_t first,
+    std::size_t last,
+    std::size_t block_rows,
+    Output output
+)
+{
+    std::size_t const row_size = table.naxis(1);
+    std::vector<run_reader<Key>> readers(last - first);
+    auto greater = [&readers](std::size_t lhs, std::size_t rhs)
+    {
+        if (key_less(readers[rhs].key, readers[lhs].key))
+        {
+            return true;
+        }
+        return !key_less(readers[lhs].key, readers[rhs].key) && lhs > rhs;
+    };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(greater)> heap(greater);
+
+    for (std::size_t r = 0; r < readers.size(); r++)
+    {
+        readers[r].file.open(runs.paths[first + r], std::ios_base::in | std::ios_base::binary);
+        if (!readers[r].file.is_open())
+        {
+            throw file_io_exception();
+        }
+        readers[r].remaining = runs.rows[first + r];
+        readers[r].block_rows = block_rows;
+        if (readers[r].refill(table, key_column))
+        {
+            heap.push(r);
+        }
+    }
+
+    while (!heap.empty())
+    {
+        std::size_t const r = heap.top();
+        heap.pop();
+        output(readers[r].row(row_size));
+        if (readers[r].next(table, key_column))
+        {
+            heap.push(r);
+        }
+    }
+}
+
+} //namespace detail
+
+/*!
+sorts a binary table that need not fit in memory by the given key column and writes it as the
+only extension of a new FITS file (after an empty primary header) with the same header.
+the file must be positioned at the header of the table. runs of rows fitting the memory
+budget are read sequentially, sorted in parallel (radix sort on the decoded keys, string keys
+use a stable comparison sort) and spilled to temporary files, which are then k-way merged,
+at most merge_width at a time: more runs are first merged into longer runs in extra passes.
+the sort is stable. Key is std::int64_t, std::uint64_t, double or std::string, as for
+column_view.
+tables with a heap (PCOUNT != 0) are not supported
+*/
+template <typename Key>
+void external_sort
+(
+    std::istream& file,
+    std::string const& key_column,
+    std::string const& output_path,
+    external_sort_options const& options = external_sort_options()
+)
+{
+    hdu header(file);
+    binary_table_extension table(header);
+    if (table.value_of<std::size_t>("PCOUNT") != 0)
+    {
+        throw invalid_table_colum_format();
+    }
+    table.get_column_info(key_column);
+
+    std::size_t const row_size = table.naxis(1);
+    std::size_t const total_rows = table.naxis(2);
+    std::size_t const threads = boost::astronomy::detail::thread_count(options.threads);
+    //a row, its decoded key and the radix sort digits and positions (two buffers each)
+    std::size_t const row_cost = row_size + sizeof(Key) + 2 * sizeof(std::uint64_t) +
+        2 * sizeof(std::size_t);
+    std::size_t const run_rows = std::max<std::size_t>(1, options.memory_budget / threads / row_cost);
+
+    std::string const stem = boost::filesystem::path(output_path).filename().string();
+    detail::run_files runs;
+
+    std::vector<std::vector<char>> batch(threads);
+    std::size_t rows_read = 0;
+    while (rows_read < total_rows)
+    {
+        std::size_t batch_size = 0;
+        for (; batch_size < threads && rows_read < total_rows; batch_size++)
+        {
+            std::size_t const count = std::min(run_rows, total_rows - rows_read);
+            batch[batch_size].resize(count * row_size);
+            file.read(batch[batch_size].data(), static_cast<std::streamsize>(count * row_size));
+            if (!file)
+            {
+                throw file_io_exception();
+            }
+            runs.add(options.temp_directory, stem, count);
+            rows_read += count;
+        }
+
+        std::size_t const first_run = runs.paths.size() - batch_size;
+        boost::astronomy::detail::parallel_for(batch_size, batch_size,
+            [&](std::size_t begin, std::size_t end, std::size_t)
+            {
+                for (std::size_t b = begin; b < end; b++)
+                {
+                    std::vector<char> const& rows = batch[b];
+                    std::size_t const count = rows.size() / row_size;
+                    std::vector<std::size_t> order = detail::sorted_order(
+                        column_view<Key>(table, key_column, rows.data(), count).materialize());
+
+                    //rows are written in sorted order straight from the batch, without a copy
+                    std::ofstream run(runs.paths[first_run + b],
+                        std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+                    for (std::size_t i = 0; i < count && run; i++)
+                    {
+                        run.write(rows.data() + order[i] * row_size,
+                            static_cast<std::streamsize>(row_size));
+                    }
+                    if (!run)
+                    {
+                        throw file_io_exception();
+                    }
+                }
+            });
+    }
+    batch.clear();
+    batch.shrink_to_fit();
+
+    std::size_t const merge_width = std::max<std::size_t>(2, options.merge_width);
+    std::size_t const block_rows = std::max<std::size_t>(1,
+        options.memory_budget / (std::min(runs.paths.size(), merge_width) + 1) / row_cost);
+
+    while (runs.paths.size() > merge_width)
+    {
+        detail::run_files merged;
+        for (std::size_t first = 0; first < runs.paths.size(); first += merge_width)
+        {
+            std::size_t const last = std::min(first + merge_width, runs.paths.size());
+            std::size_t const count = std::accumulate(runs.rows.begin() + first,
+                runs.rows.begin() + last, std::size_t(0));
+            std::ofstream run(merged.add(options.temp_directory, stem, count),
+                std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+            detail::merge_runs<Key>(table, key_column, runs, first, last, block_rows,
+                [&run, row_size](char const* row) {
+                    run.write(row, static_cast<std::streamsize>(row_size));
+                });
+            if (!run)
+            {
+                throw file_io_exception();
+            }
+        }
+        //the runs of the previous pass are removed with merged
+        runs.swap(merged);
+    }
+
+    fits_writer writer(output_path);
+    writer.write_empty_primary();
+    writer.write_header(table.get_cards());
+    detail::merge_runs<Key>(table, key_column, runs, 0, runs.paths.size(), block_rows,
+        [&writer, row_size](char const* row) {
+            writer.write_data(row, row_size);
+        });
+    writer.close();
+}
+
+//!sorts the binary table whose header starts at pos, see external_sort above
+template <typename Key>
+void external_sort
+(
+    std::istream& file,
+    std::streampos pos,
+    std::string const& key_column,
+    std::string const& output_path,
+    external_sort_options const& options = external_sort_options()
+)
+{
+    file.seekg(pos);
+    external_sort<Key>(file, key_column, output_path, options);
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_EXTERNAL_SORT_HPP
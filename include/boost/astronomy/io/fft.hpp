@@ -0,0 +1,633 @@
+#ifndef BOOST_ASTRONOMY_IO_FFT_HPP
+#define BOOST_ASTRONOMY_IO_FFT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <boost/astronomy/detail/parallel_for.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+#include <boost/astronomy/io/image.hpp>
+
+/*!
+self contained mixed radix FFT. complex transforms of any length factor it into radices 4, 2,
+3 and larger primes (recursive decimation in time), real transforms of even length run as a
+complex transform of half the length. plans hold the factors and twiddles and are cached by
+length, so repeated transforms of one size share them across threads.
+
+neither direction is normalized: inverse(forward(x)) is n * x
+*/
+
+namespace boost { namespace astronomy { namespace io {
+
+namespace detail {
+
+//!a * b without the NaN recovery std::complex does, which keeps the butterflies inline
+inline std::complex<double> multiply(std::complex<double> a, std::complex<double> b)
+{
+    return std::complex<double>(a.real() * b.real() - a.imag() * b.imag(),
+        a.real() * b.imag() + a.imag() * b.real());
+}
+
+inline double pi()
+{
+    return 3.14159265358979323846;
+}
+
+//!plans created once per length and shared by all threads
+template <typename Plan>
+std::shared_ptr<Plan const> cached_plan(std::size_t n)
+{
+    static std::mutex mutex;
+    static std::map<std::size_t, std::shared_ptr<Plan const>> plans;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& plan = plans[n];
+    if (!plan)
+    {
+        plan = std::make_shared<Plan const>(n);
+    }
+    return plan;
+}
+
+} //namespace detail
+
+//!complex transform of a fixed length
+struct fft_plan
+{
+private:
+    struct stage
+    {
+        std::size_t radix;
+        std::size_t span; //! length of the sub transforms combined by this stage
+    };
+
+    std::size_t size_;
+    std::size_t largest_radix;
+    std::vector<stage> stages;
+    std::vector<std::complex<double>> twiddles[2]; //! exp(-+2 pi i k / n), forward and inverse
+
+    void factorize()
+    {
+        std::size_t remaining = size_;
+        std::size_t radix = 4;
+        while (remaining > 1)
+        {
+            while (remaining % radix != 0)
+            {
+                radix = radix == 4 ? 2 : (radix == 2 ? 3 : radix + 2);
+                if (radix * radix > remaining)
+                {
+                    radix = remaining;
+                }
+            }
+            remaining /= radix;
+            stages.push_back(stage{radix, remaining});
+            largest_radix = std::max(largest_radix, radix);
+        }
+    }
+
+    void butterfly_2(std::complex<double>* out, std::size_t stride, std::size_t span,
+        std::complex<double> const* twiddle) const
+    {
+        for (std::size_t k = 0; k < span; k++)
+        {
+            std::complex<double> const t = detail::multiply(out[k + span], twiddle[k * stride]);
+            out[k + span] = out[k] - t;
+            out[k] += t;
+        }
+    }
+
+    void butterfly_4(std::complex<double>* out, std::size_t stride, std::size_t span,
+        std::complex<double> const* twiddle, bool inverse) const
+    {
+        for (std::size_t k = 0; k < span; k++)
+        {
+            std::complex<double> const s0 = detail::multiply(out[k + span], twiddle[k * stride]);
+            std::complex<double> const s1 =
+                detail::multiply(out[k + 2 * span], twiddle[2 * k * stride]);
+            std::complex<double> const s2 =
+                detail::multiply(out[k + 3 * span], twiddle[3 * k * stride]);
+            std::complex<double> const s3 = s0 + s2;
+            std::complex<double> const s4 = s0 - s2;
+            std::complex<double> const s5 = out[k] - s1;
+            std::complex<double> const s6 = out[k] + s1;
+
+            //s4 turned by -i forward, +i inverse
+            std::complex<double> const turned = inverse
+                ? std::complex<double>(-s4.imag(), s4.real())
+                : std::complex<double>(s4.imag(), -s4.real());
+            out[k] = s6 + s3;
+            out[k + 2 * span] = s6 - s3;
+            out[k + span] = s5 + turned;
+            out[k + 3 * span] = s5 - turned;
+        }
+    }
+
+    void butterfly_3(std::complex<double>* out, std::size_t stride, std::size_t span,
+        std::complex<double> const* twiddle, bool inverse) const
+    {
+        //imaginary part of exp(-+2 pi i / 3)
+        double const sine = inverse ? 0.86602540378443864676 : -0.86602540378443864676;
+        for (std::size_t k = 0; k < span; k++)
+        {
+            std::complex<double> const s1 = detail::multiply(out[k + span], twiddle[k * stride]);
+            std::complex<double> const s2 =
+                detail::multiply(out[k + 2 * span], twiddle[2 * k * stride]);
+            std::complex<double> const sum = s1 + s2;
+            std::complex<double> const difference = s1 - s2;
+            std::complex<double> const middle = out[k] - 0.5 * sum;
+            std::complex<double> const turned(-sine * difference.imag(), sine * difference.real());
+
+            out[k] += sum;
+            out[k + span] = middle + turned;
+            out[k + 2 * span] = middle - turned;
+        }
+    }
+
+    void butterfly_generic(std::complex<double>* out, std::size_t stride, std::size_t span,
+        std::size_t radix, std::complex<double> const* twiddle,
+        std::complex<double>* scratch) const
+    {
+        for (std::size_t u = 0; u < span; u++)
+        {
+            for (std::size_t q = 0; q < radix; q++)
+            {
+                scratch[q] = out[u + q * span];
+            }
+            for (std::size_t q = 0; q < radix; q++)
+            {
+                std::size_t const k = u + q * span;
+                std::complex<double> sum = scratch[0];
+                std::size_t index = 0;
+                for (std::size_t r = 1; r < radix; r++)
+                {
+                    index += stride * k;
+                    index %= size_;
+                    sum += detail::multiply(scratch[r], twiddle[index]);
+                }
+                out[k] = sum;
+            }
+        }
+    }
+
+    //!transform of in[0], in[stride], ... into out, stages from the given one on
+    void work(std::complex<double>* out, std::complex<double> const* in, std::size_t stride,
+        std::size_t index, bool inverse, std::complex<double>* scratch) const
+    {
+        std::size_t const radix = stages[index].radix;
+        std::size_t const span = stages[index].span;
+        if (span == 1)
+        {
+            for (std::size_t q = 0; q < radix; q++)
+            {
+                out[q] = in[q * stride];
+            }
+        }
+        else
+        {
+            for (std::size_t q = 0; q < radix; q++)
+            {
+                work(out + q * span, in + q * stride, stride * radix, index + 1, inverse, scratch);
+            }
+        }
+
+        std::complex<double> const* twiddle = twiddles[inverse ? 1 : 0].data();
+        switch (radix)
+        {
+        case 2:
+            butterfly_2(out, stride, span, twiddle);
+            break;
+        case 3:
+            butterfly_3(out, stride, span, twiddle, inverse);
+            break;
+        case 4:
+            butterfly_4(out, stride, span, twiddle, inverse);
+            break;
+        default:
+            butterfly_generic(out, stride, span, radix, twiddle, scratch);
+        }
+    }
+
+public:
+    explicit fft_plan(std::size_t n) : size_(n), largest_radix(1)
+    {
+        if (n == 0)
+        {
+            throw invalid_fft_size_exception();
+        }
+        factorize();
+        twiddles[0].resize(n);
+        twiddles[1].resize(n);
+        for (std::size_t k = 0; k < n; k++)
+        {
+            double const angle = -2 * detail::pi() * static_cast<double>(k) / static_cast<double>(n);
+            twiddles[0][k] = std::polar(1.0, angle);
+            twiddles[1][k] = std::conj(twiddles[0][k]);
+        }
+    }
+
+    //!the cached plan for length n
+    static std::shared_ptr<fft_plan const> get(std::size_t n)
+    {
+        return detail::cached_plan<fft_plan>(n);
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    //!out[k] = sum in[j] exp(-+2 pi i j k / n), in and out must not overlap
+    void transform(std::complex<double> const* in, std::complex<double>* out, bool inverse) const
+    {
+        if (size_ == 1)
+        {
+            out[0] = in[0];
+            return;
+        }
+        std::vector<std::complex<double>> scratch(largest_radix);
+        work(out, in, 1, 0, inverse, scratch.data());
+    }
+
+    void forward(std::complex<double> const* in, std::complex<double>* out) const
+    {
+        transform(in, out, false);
+    }
+
+    void inverse(std::complex<double> const* in, std::complex<double>* out) const
+    {
+        transform(in, out, true);
+    }
+};
+
+/*!
+transform of n real values to the n / 2 + 1 non negative frequencies, the others being their
+complex conjugates. even lengths pack pairs of values into a complex transform of n / 2
+*/
+struct real_fft_plan
+{
+private:
+    std::size_t size_;
+    std::shared_ptr<fft_plan const> complex_plan;
+    std::vector<std::complex<double>> twiddles; //! exp(-2 pi i k / n) for the even split
+
+public:
+    explicit real_fft_plan(std::size_t n) : size_(n)
+    {
+        if (n == 0)
+        {
+            throw invalid_fft_size_exception();
+        }
+        complex_plan = fft_plan::get(n % 2 == 0 ? n / 2 : n);
+        if (n % 2 == 0)
+        {
+            twiddles.resize(n / 2 + 1);
+            for (std::size_t k = 0; k < twiddles.size(); k++)
+            {
+                twiddles[k] = std::polar(1.0,
+                    -2 * detail::pi() * static_cast<double>(k) / static_cast<double>(n));
+            }
+        }
+    }
+
+    static std::shared_ptr<real_fft_plan const> get(std::size_t n)
+    {
+        return detail::cached_plan<real_fft_plan>(n);
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    //!number of complex values of a spectrum
+    std::size_t spectrum_size() const
+    {
+        return size_ / 2 + 1;
+    }
+
+    //!in holds size() values, out spectrum_size()
+    void forward(double const* in, std::complex<double>* out) const
+    {
+        if (size_ % 2 != 0)
+        {
+            std::vector<std::complex<double>> values(in, in + size_);
+            std::vector<std::complex<double>> spectrum(size_);
+            complex_plan->forward(values.data(), spectrum.data());
+            std::copy(spectrum.begin(), spectrum.begin() + spectrum_size(), out);
+            return;
+        }
+
+        std::size_t const half = size_ / 2;
+        std::vector<std::complex<double>> packed(half);
+        std::vector<std::complex<double>> spectrum(half);
+        for (std::size_t k = 0; k < half; k++)
+        {
+            packed[k] = std::complex<double>(in[2 * k], in[2 * k + 1]);
+        }
+        complex_plan->forward(packed.data(), spectrum.data());
+
+        for (std::size_t k = 0; k <= half; k++)
+        {
+            std::complex<double> const z = spectrum[k % half];
+            std::complex<double> const mirror = std::conj(spectrum[(half - k) % half]);
+            std::complex<double> const even = 0.5 * (z + mirror);
+            std::complex<double> const odd = 0.5 * (z - mirror);
+            //odd / i
+            out[k] = even + detail::multiply(twiddles[k],
+                std::complex<double>(odd.imag(), -odd.real()));
+        }
+    }
+
+    //!in holds spectrum_size() values, out size(); the imaginary parts of the ends are ignored
+    void inverse(std::complex<double> const* in, double* out) const
+    {
+        if (size_ % 2 != 0)
+        {
+            std::vector<std::complex<double>> spectrum(size_);
+            std::vector<std::complex<double>> values(size_);
+            for (std::size_t k = 0; k < size_; k++)
+            {
+                spectrum[k] = k < spectrum_size() ? in[k] : std::conj(in[size_ - k]);
+            }
+            complex_plan->inverse(spectrum.data(), values.data());
+            for (std::size_t k = 0; k < size_; k++)
+            {
+                out[k] = values[k].real();
+            }
+            return;
+        }
+
+        std::size_t const half = size_ / 2;
+        std::vector<std::complex<double>> packed(half);
+        std::vector<std::complex<double>> values(half);
+        for (std::size_t k = 0; k < half; k++)
+        {
+            std::complex<double> const x = in[k];
+            std::complex<double> const mirror = std::conj(in[half - k]);
+            std::complex<double> const even = x + mirror;
+            std::complex<double> const odd = detail::multiply(x - mirror, std::conj(twiddles[k]));
+            //even + i odd
+            packed[k] = even + std::complex<double>(-odd.imag(), odd.real());
+        }
+        complex_plan->inverse(packed.data(), values.data());
+        for (std::size_t k = 0; k < half; k++)
+        {
+            out[2 * k] = values[k].real();
+            out[2 * k + 1] = values[k].imag();
+        }
+    }
+};
+
+//!smallest length of at least n made of the factors 2, 3 and 5, which transform fastest
+inline std::size_t fft_size(std::size_t n)
+{
+    for (std::size_t size = n > 1 ? n : 1;; size++)
+    {
+        std::size_t remaining = size;
+        for (std::size_t factor : {2u, 3u, 5u})
+        {
+            while (remaining % factor == 0)
+            {
+                remaining /= factor;
+            }
+        }
+        if (remaining == 1)
+        {
+            return size;
+        }
+    }
+}
+
+//!transform of count complex values
+inline std::vector<std::complex<double>> fft(std::complex<double> const* values,
+    std::size_t count, bool inverse = false)
+{
+    std::vector<std::complex<double>> result(count);
+    fft_plan::get(count)->transform(values, result.data(), inverse);
+    return result;
+}
+
+//!non negative frequencies of count real values, such as a table column
+template <typename Type>
+std::vector<std::complex<double>> real_fft(Type const* values, std::size_t count)
+{
+    auto const plan = real_fft_plan::get(count);
+    std::vector<double> in(values, values + count);
+    std::vector<std::complex<double>> result(plan->spectrum_size());
+    plan->forward(in.data(), result.data());
+    return result;
+}
+
+template <typename Container>
+std::vector<std::complex<double>> real_fft(Container const& values)
+{
+    return real_fft(values.data(), values.size());
+}
+
+//!count real values from the non negative frequencies of their transform
+inline std::vector<double> inverse_real_fft(std::vector<std::complex<double>> const& spectrum,
+    std::size_t count)
+{
+    auto const plan = real_fft_plan::get(count);
+    if (spectrum.size() != plan->spectrum_size())
+    {
+        throw invalid_fft_size_exception();
+    }
+    std::vector<double> result(count);
+    plan->inverse(spectrum.data(), result.data());
+    return result;
+}
+
+namespace detail {
+
+//!columns gathered and transformed together, so the strided reads fill whole cache lines
+inline std::size_t fft_column_block()
+{
+    return 8;
+}
+
+//!transforms the columns of rows x columns values, row stride apart, in place
+inline void fft_columns(std::complex<double>* data, std::size_t columns, std::size_t rows,
+    std::size_t row_stride, bool inverse, std::size_t threads)
+{
+    auto const plan = fft_plan::get(rows);
+    std::size_t const block = fft_column_block();
+    std::size_t const blocks = (columns + block - 1) / block;
+
+    astronomy::detail::parallel_for(blocks, threads,
+        [&](std::size_t begin, std::size_t end, std::size_t)
+        {
+            std::vector<std::complex<double>> gathered(block * rows);
+            std::vector<std::complex<double>> transformed(rows);
+            for (std::size_t b = begin; b < end; b++)
+            {
+                std::size_t const first = b * block;
+                std::size_t const count = std::min(block, columns - first);
+                for (std::size_t y = 0; y < rows; y++)
+                {
+                    std::complex<double> const* row = data + y * row_stride + first;
+                    for (std::size_t c = 0; c < count; c++)
+                    {
+                        gathered[c * rows + y] = row[c];
+                    }
+                }
+                for (std::size_t c = 0; c < count; c++)
+                {
+                    plan->transform(gathered.data() + c * rows, transformed.data(), inverse);
+                    std::copy(transformed.begin(), transformed.end(),
+                        gathered.begin() + static_cast<std::ptrdiff_t>(c * rows));
+                }
+                for (std::size_t y = 0; y < rows; y++)
+                {
+                    std::complex<double>* row = data + y * row_stride + first;
+                    for (std::size_t c = 0; c < count; c++)
+                    {
+                        row[c] = gathered[c * rows + y];
+                    }
+                }
+            }
+        });
+}
+
+} //namespace detail
+
+//!in place transform of height rows of width complex values, rows and columns over threads
+inline void fft_2d(std::complex<double>* data, std::size_t width, std::size_t height,
+    bool inverse = false, std::size_t threads = 1)
+{
+    auto const plan = fft_plan::get(width);
+    astronomy::detail::parallel_for(height, threads,
+        [&](std::size_t begin, std::size_t end, std::size_t)
+        {
+            std::vector<std::complex<double>> transformed(width);
+            for (std::size_t y = begin; y < end; y++)
+            {
+                plan->transform(data + y * width, transformed.data(), inverse);
+                std::copy(transformed.begin(), transformed.end(), data + y * width);
+            }
+        });
+    detail::fft_columns(data, width, height, width, inverse, threads);
+}
+
+//!non negative horizontal frequencies of an image, columns() = width / 2 + 1 per row
+struct image_spectrum
+{
+private:
+    std::size_t width_;
+    std::size_t height_;
+    std::vector<std::complex<double>> values_;
+
+public:
+    image_spectrum() : width_(0), height_(0) {}
+
+    image_spectrum(std::size_t width, std::size_t height)
+        : width_(width), height_(height), values_((width / 2 + 1) * height)
+    {}
+
+    //!width of the transformed image
+    std::size_t get_width() const
+    {
+        return width_;
+    }
+
+    std::size_t get_height() const
+    {
+        return height_;
+    }
+
+    std::size_t columns() const
+    {
+        return width_ / 2 + 1;
+    }
+
+    std::complex<double>& operator()(std::size_t v, std::size_t u)
+    {
+        return values_[v * columns() + u];
+    }
+
+    std::complex<double> const& operator()(std::size_t v, std::size_t u) const
+    {
+        return values_[v * columns() + u];
+    }
+
+    std::complex<double>* data()
+    {
+        return values_.data();
+    }
+
+    std::complex<double> const* data() const
+    {
+        return values_.data();
+    }
+};
+
+//!real to complex transform of an image, rows then columns over threads (0: one per core)
+template <typename PixelType>
+image_spectrum fft_2d(image_buffer<PixelType> const& image, std::size_t threads = 1)
+{
+    std::size_t const width = image.get_width();
+    std::size_t const height = image.get_height();
+    image_spectrum spectrum(width, height);
+    if (width == 0 || height == 0)
+    {
+        return spectrum;
+    }
+
+    auto const plan = real_fft_plan::get(width);
+    astronomy::detail::parallel_for(height, threads,
+        [&](std::size_t begin, std::size_t end, std::size_t)
+        {
+            std::vector<double> row(width);
+            for (std::size_t y = begin; y < end; y++)
+            {
+                PixelType const* pixels = image.row(y);
+                for (std::size_t x = 0; x < width; x++)
+                {
+                    row[x] = static_cast<double>(pixels[x]);
+                }
+                plan->forward(row.data(), spectrum.data() + y * spectrum.columns());
+            }
+        });
+    detail::fft_columns(spectrum.data(), spectrum.columns(), height, spectrum.columns(), false,
+        threads);
+    return spectrum;
+}
+
+/*!
+image from its spectrum into out, scaled by width * height like every inverse here. the
+spectrum is taken by value as the column pass works in place, move it in when done with it
+*/
+inline void inverse_fft_2d(image_spectrum spectrum, image_buffer<double>& out,
+    std::size_t threads = 1)
+{
+    std::size_t const width = spectrum.get_width();
+    std::size_t const height = spectrum.get_height();
+    out.resize(width, height);
+    if (width == 0 || height == 0)
+    {
+        return;
+    }
+
+    detail::fft_columns(spectrum.data(), spectrum.columns(), height, spectrum.columns(), true,
+        threads);
+    auto const plan = real_fft_plan::get(width);
+    astronomy::detail::parallel_for(height, threads,
+        [&](std::size_t begin, std::size_t end, std::size_t)
+        {
+            for (std::size_t y = begin; y < end; y++)
+            {
+                plan->inverse(spectrum.data() + y * spectrum.columns(), out.row(y));
+            }
+        });
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_FFT_HPP
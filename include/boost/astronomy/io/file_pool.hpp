@@ -0,0 +1,230 @@
+#ifndef BOOST_ASTRONOMY_IO_FILE_POOL_HPP
+#define BOOST_ASTRONOMY_IO_FILE_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/config.hpp>
+
+//!the pool keeps positional_file handles, so it is only available on POSIX platforms
+#ifdef BOOST_HAS_UNISTD_H
+
+#include <sys/stat.h>
+
+#include <boost/astronomy/io/positional_file.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//!counters of a file_pool since it was created
+struct file_pool_statistics
+{
+    std::size_t opens = 0;      //! files opened, reopens after eviction included
+    std::size_t hits = 0;       //! reads served by an already open file
+    std::size_t evictions = 0;  //! files closed to stay within the capacity
+    std::size_t open_files = 0; //! files currently open in the pool
+};
+
+struct pooled_file;
+
+/*!
+least recently used set of open read only files with a cap on their number, for workloads
+touching more files than descriptors can be kept open. files are handed out as pooled_file
+handles that hold no descriptor: every read borrows the open file from the pool, reopening it
+when it was evicted meanwhile.
+
+copies of a pool refer to the same pool, which is safe to use from many threads. a read in
+progress keeps its descriptor open even if the file is evicted meanwhile, so the cap may be
+exceeded by the number of reads in flight
+*/
+struct file_pool
+{
+private:
+    typedef std::list<std::pair<std::string, positional_file>> lru_list;
+
+    struct state
+    {
+        std::mutex mutex;
+        std::size_t capacity;
+        lru_list files; //! most recently used first
+        std::unordered_map<std::string, lru_list::iterator> index;
+        file_pool_statistics statistics;
+
+        explicit state(std::size_t cap) : capacity(cap != 0 ? cap : 1) {}
+
+        void evict_to(std::size_t count)
+        {
+            while (files.size() > count)
+            {
+                index.erase(files.back().first);
+                files.pop_back();
+                statistics.evictions++;
+            }
+        }
+    };
+
+    std::shared_ptr<state> pool;
+
+    //!pool without state, held by default constructed pooled_file handles
+    struct empty_tag {};
+    explicit file_pool(empty_tag) {}
+    friend struct pooled_file;
+
+public:
+    //!pool keeping at most capacity files open
+    explicit file_pool(std::size_t capacity = 256) : pool(std::make_shared<state>(capacity)) {}
+
+    //!handle of the file with given name, the file is opened right away to report errors early
+    pooled_file open(std::string const& file_name) const;
+
+    /*!
+    open file with given name, opened (and the least recently used file closed) if necessary.
+    device and inode, when not zero, must match the file or file_io_exception is thrown, so a
+    reopen never silently switches to a replaced file
+    */
+    positional_file acquire
+    (
+        std::string const& file_name,
+        std::uint64_t device = 0,
+        std::uint64_t inode = 0
+    ) const
+    {
+        {
+            std::lock_guard<std::mutex> lock(pool->mutex);
+            auto found = pool->index.find(file_name);
+            if (found != pool->index.end())
+            {
+                pool->files.splice(pool->files.begin(), pool->files, found->second);
+                pool->statistics.hits++;
+                return found->second->second;
+            }
+        }
+
+        //opened without the lock held, another thread may open the same file meanwhile
+        positional_file file(file_name);
+        if (inode != 0)
+        {
+            struct stat info;
+            if (::fstat(file.native_handle(), &info) != 0 ||
+                static_cast<std::uint64_t>(info.st_dev) != device ||
+                static_cast<std::uint64_t>(info.st_ino) != inode)
+            {
+                throw file_io_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->statistics.opens++;
+        auto found = pool->index.find(file_name);
+        if (found != pool->index.end())
+        {
+            pool->files.splice(pool->files.begin(), pool->files, found->second);
+            return found->second->second;
+        }
+        pool->evict_to(pool->capacity - 1);
+        pool->files.emplace_front(file_name, file);
+        pool->index.emplace(file_name, pool->files.begin());
+        return file;
+    }
+
+    std::size_t capacity() const
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        return pool->capacity;
+    }
+
+    //!changes the cap, closing least recently used files above it
+    void set_capacity(std::size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->capacity = capacity != 0 ? capacity : 1;
+        pool->evict_to(pool->capacity);
+    }
+
+    //!closes all files of the pool, handles reopen them when read
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->files.clear();
+        pool->index.clear();
+    }
+
+    file_pool_statistics statistics() const
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        file_pool_statistics result = pool->statistics;
+        result.open_files = pool->files.size();
+        return result;
+    }
+};
+
+/*!
+handle of a file in a file_pool, holding its name and identity but no descriptor, so
+thousands of them are cheap to keep. reads have the interface of positional_file, use
+pooled_stream to read through a std::istream
+*/
+struct pooled_file
+{
+private:
+    file_pool pool;
+    std::string name;
+    std::uint64_t device = 0;
+    std::uint64_t inode = 0;
+
+public:
+    //!handle of no file, allocates no pool
+    pooled_file() : pool(file_pool::empty_tag()) {}
+
+    pooled_file(file_pool const& owner, std::string const& file_name)
+        : pool(owner), name(file_name)
+    {
+        struct stat info;
+        if (::fstat(pool.acquire(name).native_handle(), &info) != 0)
+        {
+            throw file_io_exception();
+        }
+        device = static_cast<std::uint64_t>(info.st_dev);
+        inode = static_cast<std::uint64_t>(info.st_ino);
+    }
+
+    bool is_open() const
+    {
+        return !name.empty();
+    }
+
+    std::string const& file_name() const
+    {
+        return name;
+    }
+
+    std::uint64_t size() const
+    {
+        return pool.acquire(name, device, inode).size();
+    }
+
+    //!reads up to size bytes at offset, see positional_file::read_at
+    std::size_t read_at(char* buffer, std::size_t size, std::uint64_t offset) const
+    {
+        return pool.acquire(name, device, inode).read_at(buffer, size, offset);
+    }
+};
+
+inline pooled_file file_pool::open(std::string const& file_name) const
+{
+    return pooled_file(*this, file_name);
+}
+
+//!input stream reading a pooled_file through a position and buffer of its own
+typedef basic_positional_stream<pooled_file> pooled_stream;
+
+}}} //namespace boost::astronomy::io
+
+#endif // BOOST_HAS_UNISTD_H
+
+#endif // !BOOST_ASTRONOMY_IO_FILE_POOL_HPP
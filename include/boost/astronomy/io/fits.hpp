@@ -2,14 +2,23 @@
 #define BOOST_ASTRONOMY_IO_FITS_HPP
 
 #include <fstream>
+#include <istream>
 #include <string>
 #include <vector>
 #include <memory>
 
+#include <boost/config.hpp>
 #include <boost/astronomy/io/primary_hdu.hpp>
 #include <boost/astronomy/io/extension_hdu.hpp>
 #include <boost/astronomy/io/image_extension.hpp>
 #include <boost/astronomy/io/ascii_table.hpp>
+#ifdef BOOST_HAS_UNISTD_H
+#include <boost/astronomy/io/positional_file.hpp>
+#include <boost/astronomy/io/file_pool.hpp>
+#endif
+#include <boost/astronomy/io/byte_source.hpp>
+#include <boost/astronomy/io/compressed_stream.hpp>
+#include <boost/astronomy/io/metrics.hpp>
 #include <boost/astronomy/exception/fits_exception.hpp>
 
 namespace boost { namespace astronomy { namespace io {
@@ -18,6 +27,13 @@ struct fits
 {
 protected:
     std::fstream fits_file; //!FITS to be processed
+    std::unique_ptr<std::istream> shared_file; //!used instead of fits_file when set
+#ifdef BOOST_HAS_UNISTD_H
+    pooled_file pooled; //!source of shared_file, which is only kept while reading
+    std::uint64_t pooled_position = 0; //!where reading continues in pooled
+#endif
+    std::istream* external = nullptr; //!stream of the caller, used instead of fits_file when set
+    std::unique_ptr<detail::metered_stream> metered; //!counts reads of the source (metrics.hpp)
     std::vector<std::shared_ptr<hdu>> hdu_; //!Stores all th HDU in file
 
 public:
@@ -30,49 +46,151 @@ public:
     )
     {
         fits_file.open(file_path, std::ios_base::in | std::ios_base::binary | mode);
+
+        //gzip and bzip2 compressed files are decoded on the fly
+        if (fits_file && detect_compression(fits_file) != compression::none)
+        {
+            fits_file.close();
+#ifndef BOOST_ASTRONOMY_NO_COMPRESSION
+            shared_file.reset(new compressed_stream(file_path));
+#else
+            throw compression_not_supported_exception();
+#endif
+        }
         read_primary_hdu();
         //read_extensions();
     }
 
+#ifdef BOOST_HAS_UNISTD_H
+    //!reads through a cursor of its own, other threads may read the same file meanwhile
+    explicit fits(positional_file const& file) : shared_file(new positional_stream(file))
+    {
+        read_primary_hdu();
+    }
+
+    /*!
+    reads through a file_pool, the object holds neither a descriptor nor a read buffer
+    between reads so thousands of them can be kept
+    */
+    explicit fits(pooled_file const& file) : pooled(file)
+    {
+        read_primary_hdu();
+    }
+#endif
+
+    /*!
+    reads from a stream of the caller, which must outlive the object: a memory_stream,
+    mapped_stream or forward_stream (byte_source.hpp) or any other std::istream
+    */
+    explicit fits(std::istream& stream) : external(&stream)
+    {
+        read_primary_hdu();
+    }
+
+    //!stream the HDUs are read from, its reads are counted unless metrics are disabled
+    std::istream& input()
+    {
+#ifndef BOOST_ASTRONOMY_IO_DISABLE_METRICS
+        if (!metered)
+        {
+            metered.reset(new detail::metered_stream());
+        }
+        metered->attach(source());
+        return *metered;
+#else
+        return source();
+#endif
+    }
+
+    //!io counters of this handle: reads of its source and the counters of all its HDUs
+    io_counters metrics() const
+    {
+        io_counters result;
+        if (metered)
+        {
+            result = metered->counters();
+        }
+        for (auto const& unit : hdu_)
+        {
+            result += unit->metrics();
+        }
+        return result;
+    }
+
+    //!io counters of every HDU read so far, in file order
+    std::vector<io_counters> hdu_metrics() const
+    {
+        std::vector<io_counters> result;
+        for (auto const& unit : hdu_)
+        {
+            result.push_back(unit->metrics());
+        }
+        return result;
+    }
+
+private:
+    std::istream& source()
+    {
+        if (external)
+        {
+            return *external;
+        }
+#ifdef BOOST_HAS_UNISTD_H
+        if (!shared_file && pooled.is_open())
+        {
+            shared_file.reset(new pooled_stream(pooled, pooled_position, 2880));
+        }
+#endif
+        if (shared_file)
+        {
+            return *shared_file;
+        }
+        return fits_file;
+    }
+
+public:
     void read_primary_hdu()
     {
-        hdu_.emplace_back(std::make_shared<hdu>(fits_file));
+        BOOST_ASTRONOMY_IO_TRACE("fits::read_primary_hdu");
+        hdu_.emplace_back(std::make_shared<hdu>(input()));
                     
         switch (hdu_[0]->value_of<int>(std::string("BITPIX")))
         {
         case 8:
-            hdu_[0] = std::make_shared<primary_hdu<bitpix::B8>>(fits_file, *hdu_[0]);
+            hdu_[0] = std::make_shared<primary_hdu<bitpix::B8>>(input(), *hdu_[0]);
             break;
         case 16:
-            hdu_[0] = std::make_shared<primary_hdu<bitpix::B16>>(fits_file, *hdu_[0]);
+            hdu_[0] = std::make_shared<primary_hdu<bitpix::B16>>(input(), *hdu_[0]);
             break;
         case 32:
-            hdu_[0] = std::make_shared<primary_hdu<bitpix::B32>>(fits_file, *hdu_[0]);
+            hdu_[0] = std::make_shared<primary_hdu<bitpix::B32>>(input(), *hdu_[0]);
             break;
         case -32:
-            hdu_[0] = std::make_shared<primary_hdu<bitpix::_B32>>(fits_file, *hdu_[0]);
+            hdu_[0] = std::make_shared<primary_hdu<bitpix::_B32>>(input(), *hdu_[0]);
             break;
         case -64:
-            hdu_[0] = std::make_shared<primary_hdu<bitpix::_B64>>(fits_file, *hdu_[0]);
+            hdu_[0] = std::make_shared<primary_hdu<bitpix::_B64>>(input(), *hdu_[0]);
             break;
         default:
             throw fits_exception();
         }
+        park();
     }
 
     void read_extensions()
     {
+        BOOST_ASTRONOMY_IO_TRACE("fits::read_extensions");
         //if no extension then return
         if (!hdu_[0]->value_of<bool>("EXTEND"))
         {
             return;
         }
 
-        while (!fits_file.eof())
+        while (input().peek() != std::istream::traits_type::eof())
         {
             //this statement allows up to read all the cards stored
             //It gives us the benefit of knowing which kind of data we need to store
-            hdu_.emplace_back(std::make_shared<hdu>(fits_file));
+            hdu_.emplace_back(std::make_shared<hdu>(input()));
 
             if (hdu_.back()->value_of<std::string>("XTENSION") == "'IMAGE   '")
             {
@@ -80,23 +198,23 @@ public:
                 {
                 case 8:
                     hdu_.back() =
-                        std::make_shared<image_extension<bitpix::B8>>(fits_file, *hdu_.back());
+                        std::make_shared<image_extension<bitpix::B8>>(input(), *hdu_.back());
                     break;
                 case 16:
                     hdu_.back() =
-                        std::make_shared<image_extension<bitpix::B16>>(fits_file, *hdu_.back());
+                        std::make_shared<image_extension<bitpix::B16>>(input(), *hdu_.back());
                     break;
                 case 32:
                     hdu_.back() =
-                        std::make_shared<image_extension<bitpix::B32>>(fits_file, *hdu_.back());
+                        std::make_shared<image_extension<bitpix::B32>>(input(), *hdu_.back());
                     break;
                 case -32:
                     hdu_.back() =
-                        std::make_shared<image_extension<bitpix::_B32>>(fits_file, *hdu_.back());
+                        std::make_shared<image_extension<bitpix::_B32>>(input(), *hdu_.back());
                     break;
                 case -64:
                     hdu_.back() =
-                        std::make_shared<image_extension<bitpix::_B64>>(fits_file, *hdu_.back());
+                        std::make_shared<image_extension<bitpix::_B64>>(input(), *hdu_.back());
                     break;
                 default:
                     throw fits_exception();
@@ -105,10 +223,40 @@ public:
             }
             else if (hdu_.back()->value_of<std::string>("XTENSION") == "'TABLE   '")
             {
-                hdu_.back() = std::make_shared<ascii_table>(fits_file, *hdu_.back());
+                hdu_.back() = std::make_shared<ascii_table>(input(), *hdu_.back());
             }
                         
         }
+        park();
+    }
+
+private:
+    /*!
+    ends a read: publishes the counted reads to the process wide metrics and drops the stream
+    of a pooled file, remembering where reading continues
+    */
+    void park()
+    {
+        if (metered)
+        {
+            metered->publish();
+        }
+#ifdef BOOST_HAS_UNISTD_H
+        if (pooled.is_open() && shared_file)
+        {
+            shared_file->clear();
+            std::streamoff const position = shared_file->tellg();
+            if (position >= 0)
+            {
+                pooled_position = static_cast<std::uint64_t>(position);
+            }
+            shared_file.reset();
+            if (metered)
+            {
+                metered->detach();
+            }
+        }
+#endif
     }
 };
 
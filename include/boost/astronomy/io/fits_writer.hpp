@@ -0,0 +1,263 @@
+#ifndef BOOST_ASTRONOMY_IO_FITS_WRITER_HPP
+#define BOOST_ASTRONOMY_IO_FITS_WRITER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/checksum.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+/*!
+sequential writer of FITS files. headers and data are appended HDU by HDU, every unit is padded
+to a multiple of 2880 bytes (headers with blanks, data with zeros) and the output is collected in
+a buffer of whole blocks so the file is written in large sequential chunks.
+CHECKSUM and DATASUM can be generated on the fly, see write_checksums
+*/
+struct fits_writer
+{
+private:
+    std::fstream file;
+    std::vector<char> buffer;
+    std::size_t buffered = 0;
+    std::size_t written = 0;
+    std::size_t unit_bytes = 0; //! bytes of the current data unit written so far
+
+    bool checksums = false;
+    bool checksum_pending = false; //! checksum cards of the last header are not filled yet
+    std::size_t header_offset = 0;
+    std::vector<char> header_bytes;
+    std::size_t checksum_card = 0;
+    std::size_t datasum_card = 0;
+    checksum_accumulator data_sum;
+
+public:
+    //!opens (truncates) the file, buffer_blocks blocks of 2880 bytes are collected before writing
+    explicit fits_writer(std::string const& file_name, std::size_t buffer_blocks = 64)
+        : file(file_name, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary),
+          buffer(2880 * (buffer_blocks != 0 ? buffer_blocks : 1))
+    {
+        if (!file.is_open())
+        {
+            throw file_io_exception();
+        }
+    }
+
+    fits_writer(fits_writer const&) = delete;
+    fits_writer& operator=(fits_writer const&) = delete;
+
+    ~fits_writer()
+    {
+        try
+        {
+            close();
+        }
+        catch (...) {}
+    }
+
+    //!writes a primary header with no data, to be followed by extensions
+    void write_empty_primary()
+    {
+        std::vector<card> cards(4);
+        cards[0].create_card("SIMPLE", true);
+        cards[1].create_card("BITPIX", 8);
+        cards[2].create_card("NAXIS", 0);
+        cards[3].create_card("EXTEND", true);
+        write_header(cards);
+    }
+
+    /*!
+    when enabled, CHECKSUM and DATASUM cards are added to every header written afterwards
+    (replacing cards of the same name) and filled when its data unit ends. the sums are
+    accumulated while the data is written, the header is patched in place at the end
+    */
+    void write_checksums(bool enable)
+    {
+        checksums = enable;
+    }
+
+    /*!
+    writes the cards as a new header unit, the END card is appended (an END card in cards is
+    ignored) and padding of the previous data unit is written first. CHECKSUM and DATASUM cards
+    in cards are dropped, the data written after them need not be what they were computed over
+    */
+    void write_header(std::vector<card> const& cards)
+    {
+        end_data();
+
+        std::vector<char> header;
+        header.reserve(2880);
+        auto append = [&header](card const& c) {
+            header.insert(header.end(), c.raw().begin(), c.raw().end());
+        };
+
+        for (auto const& c : cards)
+        {
+            std::string const key = c.key();
+            if (key == "END" || key == "CHECKSUM" || key == "DATASUM")
+            {
+                continue;
+            }
+            append(c);
+        }
+
+        if (checksums)
+        {
+            card placeholder;
+            checksum_card = header.size();
+            placeholder.create_card("CHECKSUM", "'" + std::string(16, '0') + "'");
+            append(placeholder);
+            datasum_card = header.size();
+            placeholder.create_card("DATASUM", "'0'");
+            append(placeholder);
+        }
+
+        card end;
+        end.create_commentary_card("END", "");
+        append(end);
+        header.resize(header.size() + (2880 - header.size() % 2880) % 2880, ' ');
+
+        header_offset = written;
+        put(header.data(), header.size());
+        if (checksums)
+        {
+            header_bytes.swap(header);
+            data_sum = checksum_accumulator();
+            checksum_pending = true;
+        }
+    }
+
+    //!appends bytes to the data unit of the last written header
+    void write_data(char const* data, std::size_t size)
+    {
+        put(data, size);
+        unit_bytes += size;
+        if (checksum_pending)
+        {
+            data_sum.update(data, size);
+        }
+    }
+
+    //!pads the current data unit with zeros up to the block boundary
+    void end_data()
+    {
+        fill('\0', (2880 - unit_bytes % 2880) % 2880);
+        unit_bytes = 0;
+
+        if (checksum_pending)
+        {
+            checksum_pending = false;
+            fill_checksums();
+        }
+    }
+
+    //!writes buffered blocks to the file
+    void flush()
+    {
+        if (buffered != 0)
+        {
+            file.write(buffer.data(), static_cast<std::streamsize>(buffered));
+            buffered = 0;
+        }
+        file.flush();
+        if (!file)
+        {
+            throw file_io_exception();
+        }
+    }
+
+    //!pads the last data unit, flushes and closes the file
+    void close()
+    {
+        if (file.is_open())
+        {
+            end_data();
+            flush();
+            file.close();
+        }
+    }
+
+    //!returns number of bytes written so far, buffered bytes included
+    std::size_t bytes_written() const
+    {
+        return written;
+    }
+
+private:
+    //!fills DATASUM and CHECKSUM of the last header and rewrites it
+    void fill_checksums()
+    {
+        card value;
+        value.create_card("DATASUM", "'" + std::to_string(data_sum.value()) + "'");
+        std::copy(value.raw().begin(), value.raw().end(), header_bytes.begin() +
+            static_cast<std::ptrdiff_t>(datasum_card));
+
+        //CHECKSUM is '0000000000000000' while the sum is computed
+        std::uint32_t const total = checksum_add(
+            checksum(header_bytes.data(), header_bytes.size()), data_sum.value());
+        value.create_card("CHECKSUM", "'" + encode_checksum(~total) + "'");
+        std::copy(value.raw().begin(), value.raw().end(), header_bytes.begin() +
+            static_cast<std::ptrdiff_t>(checksum_card));
+
+        std::size_t const buffer_start = written - buffered;
+        if (header_offset >= buffer_start)
+        {
+            std::memcpy(buffer.data() + (header_offset - buffer_start),
+                header_bytes.data(), header_bytes.size());
+            return;
+        }
+
+        flush();
+        file.seekp(static_cast<std::streamoff>(header_offset));
+        file.write(header_bytes.data(), static_cast<std::streamsize>(header_bytes.size()));
+        file.seekp(0, std::ios_base::end);
+        if (!file)
+        {
+            throw file_io_exception();
+        }
+    }
+
+    void put(char const* data, std::size_t size)
+    {
+        written += size;
+        while (size != 0)
+        {
+            if (buffered == buffer.size())
+            {
+                flush();
+            }
+            std::size_t const chunk = std::min(size, buffer.size() - buffered);
+            std::memcpy(buffer.data() + buffered, data, chunk);
+            buffered += chunk;
+            data += chunk;
+            size -= chunk;
+        }
+    }
+
+    void fill(char value, std::size_t size)
+    {
+        written += size;
+        while (size != 0)
+        {
+            if (buffered == buffer.size())
+            {
+                flush();
+            }
+            std::size_t const chunk = std::min(size, buffer.size() - buffered);
+            std::memset(buffer.data() + buffered, value, chunk);
+            buffered += chunk;
+            size -= chunk;
+        }
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_FITS_WRITER_HPP
@@ -3,10 +3,13 @@
 
 #include <string>
 #include <fstream>
+#include <istream>
+#include <cstdint>
 #include <vector>
 #include <cstddef>
 #include <unordered_map>
 #include <memory>
+#include <cstdlib>
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/lexical_cast.hpp>
@@ -16,6 +19,9 @@
 #include <boost/astronomy/exception/fits_exception.hpp>
 #include <boost/astronomy/io/card.hpp>
 #include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/io/checksum.hpp>
+#include <boost/astronomy/io/metrics.hpp>
+#include <boost/astronomy/io/trace.hpp>
 
 namespace boost { namespace astronomy { namespace io {
 
@@ -33,9 +39,16 @@ protected:
     //! stores the card-key index (used for faster searching)
     std::unordered_map<std::string, std::size_t> key_index; 
 
+    std::uint32_t header_sum = 0; //! checksum of the header unit, computed while reading it
+
+    //! cards parsed and time spent in header parse, pixel and column decode (see metrics.hpp)
+    mutable detail::atomic_counters metrics_;
+
 public:
     hdu() {}
 
+    virtual ~hdu() {}
+
     hdu(std::string const& file_name)
     {
         std::fstream file(file_name, std::ios_base::in | std::ios_base::binary);
@@ -50,27 +63,36 @@ public:
         file.close();
     }
 
-    hdu(std::fstream &file)
+    hdu(std::istream &file)
     {
         read_header(file);
     }
 
-    hdu(std::fstream &file, std::streampos pos)
+    hdu(std::istream &file, std::streampos pos)
     {
         read_header(file, pos);
     }
 
     //!Starts reading the header from current streampos of file
-    void read_header(std::fstream &file)
+    void read_header(std::istream &file)
     {
+        BOOST_ASTRONOMY_IO_TRACE("hdu::read_header");
+        detail::scoped_timer timer(metrics_, detail::io_metric::header_parse_ns);
         cards.reserve(36); //reserves the space of atleast 1 HDU unit 
         char _80_char_from_file[80]; //used as buffer to read a card consisting of 80 char
 
+        checksum_accumulator sum;
+
         //reading file card by card until END card is found
         while (true)
         {
             //read from file and create push card into the vector
             file.read(_80_char_from_file, 80);
+            if (file.gcount() != 80)
+            {
+                throw file_io_exception(); //the header ends before its END card
+            }
+            sum.update(_80_char_from_file, 80);
             cards.emplace_back(_80_char_from_file);
 
             //store the index of the card in map
@@ -82,7 +104,14 @@ public:
                 break;
             }
         }
-        set_unit_end(file);    //set cursor to the end of the HDU unit
+        //the rest of the block is read instead of skipped so it is part of the checksum
+        for (std::size_t i = cards.size() % 36; i != 0 && i < 36; i++)
+        {
+            file.read(_80_char_from_file, 80);
+            sum.update(_80_char_from_file, 80);
+        }
+        header_sum = sum.value();
+        detail::record(metrics_, detail::io_metric::cards_parsed, cards.size());
 
         //finding and storing bitpix value
                     
@@ -120,7 +149,7 @@ public:
     }
 
     //!starts reading file from the position specified
-    void read_header(std::fstream &file, std::streampos pos)
+    void read_header(std::istream &file, std::streampos pos)
     {
         file.seekg(pos);
         read_header(file);
@@ -144,17 +173,99 @@ public:
         return this->naxis_[n];
     }
 
+    //!io counters of this HDU: cards parsed and time spent parsing and decoding
+    io_counters metrics() const
+    {
+        return this->metrics_.snapshot();
+    }
+
+    //!returns the checksum of the header unit (cards and padding) as read from the file
+    std::uint32_t header_checksum() const
+    {
+        return this->header_sum;
+    }
+
+    /*!
+    returns size of the data unit in bytes without padding,
+    |BITPIX| / 8 * GCOUNT * (PCOUNT + NAXIS1 * NAXIS2 * ... * NAXISn)
+    */
+    std::size_t data_size() const
+    {
+        if (naxis_.empty() || naxis_[0] == 0)
+        {
+            return 0;
+        }
+
+        //random groups have NAXIS1 = 0, which is not part of the product
+        std::size_t elements = 1;
+        for (std::size_t i = 1; i < naxis_.size(); i++)
+        {
+            if (i != 1 || naxis_[i] != 0 || key_index.count("GROUPS") == 0)
+            {
+                elements *= naxis_[i];
+            }
+        }
+
+        std::size_t const pcount = key_index.count("PCOUNT") ? value_of<std::size_t>("PCOUNT") : 0;
+        std::size_t const gcount = key_index.count("GCOUNT") ? value_of<std::size_t>("GCOUNT") : 1;
+        std::size_t const element_size =
+            static_cast<std::size_t>(std::abs(value_of<int>("BITPIX"))) / 8;
+        return element_size * gcount * (pcount + elements);
+    }
+
+    /*!
+    verifies CHECKSUM and DATASUM keywords (if present) against the header checksum and
+    the given checksum of the data unit
+    */
+    checksum_status verify_checksums(std::uint32_t data_sum) const
+    {
+        checksum_status status;
+        status.header_sum = header_sum;
+        status.data_sum = data_sum;
+
+        status.has_checksum = key_index.count("CHECKSUM") != 0;
+        std::uint32_t const total = checksum_add(header_sum, data_sum);
+        status.checksum_valid = total == 0 || total == 0xFFFFFFFFu;
+
+        status.has_datasum = key_index.count("DATASUM") != 0;
+        if (status.has_datasum)
+        {
+            std::string const value = boost::algorithm::trim_copy_if(
+                value_of<std::string>("DATASUM"),
+                [](char c) -> bool { return c == '\'' || c == ' '; });
+            try
+            {
+                status.datasum_valid = boost::lexical_cast<std::uint32_t>(value) == data_sum;
+            }
+            catch (boost::bad_lexical_cast const&)
+            {
+                status.datasum_valid = false;
+            }
+        }
+        return status;
+    }
+
+    //!returns all the cards of the header in file order, END card included
+    std::vector<card> const& get_cards() const
+    {
+        return this->cards;
+    }
+
     //!returns the value of perticular key 
     template <typename ReturnType>
-    ReturnType value_of(std::string const& key)// const
+    ReturnType value_of(std::string const& key) const
     {
         return this->cards[key_index.at(key)].value<ReturnType>();
     }
 
-    void set_unit_end(std::fstream &file) const
+    void set_unit_end(std::istream &file) const
     {
         //set cursor to the end of the HDU unit
-        file.seekg((file.tellg() + (2880 - (file.tellg() % 2880))));    
+        std::streamoff position = file.tellg();
+        if (position % 2880 != 0)
+        {
+            file.seekg(position + (2880 - (position % 2880)));
+        }
     }
 
     virtual std::unique_ptr<column> get_column(std::string name) const
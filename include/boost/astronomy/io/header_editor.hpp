@@ -0,0 +1,308 @@
+#ifndef BOOST_ASTRONOMY_IO_HEADER_EDITOR_HPP
+#define BOOST_ASTRONOMY_IO_HEADER_EDITOR_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+
+//!headers are edited through pwrite and mmap, so the editor is only available on POSIX platforms
+#ifdef BOOST_HAS_UNISTD_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/checksum.hpp>
+#include <boost/astronomy/io/positional_file.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+namespace detail {
+
+//!writes all size bytes at offset of a descriptor
+inline void write_at(int fd, char const* data, std::size_t size, std::uint64_t offset)
+{
+    std::size_t done = 0;
+    while (done < size)
+    {
+        ssize_t const count = ::pwrite(fd, data + done, size - done,
+            static_cast<off_t>(offset + done));
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw file_io_exception();
+        }
+        done += static_cast<std::size_t>(count);
+    }
+}
+
+} //namespace detail
+
+/*!
+edits the header of one HDU of a FITS file in place. cards are modified, inserted or removed
+in memory and written by commit: when they still fit the header blocks of the file (the
+blank cards after END of the last block are spare room) the blocks are rewritten through a
+mapping and nothing else in the file is touched. only when the header needs more blocks the
+rest of the file is shifted towards its end to make room, which is not atomic.
+
+CHECKSUM is recomputed from DATASUM when the header has both, no data is read. a CHECKSUM
+without a readable DATASUM can not be recomputed and is removed
+*/
+struct header_editor
+{
+private:
+    positional_file file;
+    std::uint64_t header_offset = 0; //! file offset of the header
+    std::size_t header_size = 0;     //! bytes of the header blocks in the file
+    std::vector<card> cards;         //! cards of the header, END card last
+
+    static bool is_commentary(std::string const& key)
+    {
+        return key.empty() || key == "COMMENT" || key == "HISTORY";
+    }
+
+    std::vector<card>::iterator find(std::string const& key)
+    {
+        return std::find_if(cards.begin(), cards.end() - 1,
+            [&key](card const& c) { return c.key() == key; });
+    }
+
+    std::vector<card>::const_iterator find(std::string const& key) const
+    {
+        return std::find_if(cards.begin(), cards.end() - 1,
+            [&key](card const& c) { return c.key() == key; });
+    }
+
+    //!the cards padded with blanks to size bytes
+    std::string header_bytes(std::size_t size) const
+    {
+        std::string bytes;
+        bytes.reserve(size);
+        for (auto const& c : cards)
+        {
+            bytes += c.raw();
+        }
+        bytes.resize(size, ' ');
+        return bytes;
+    }
+
+    /*!
+    sets CHECKSUM for the new header of size bytes from the data sum recorded in DATASUM, or
+    removes it when there is no DATASUM to compute it from
+    */
+    void refresh_checksum(std::size_t size)
+    {
+        auto checksum_card = find("CHECKSUM");
+        if (checksum_card == cards.end() - 1)
+        {
+            return;
+        }
+
+        auto datasum_card = find("DATASUM");
+        std::uint32_t data_sum = 0;
+        try
+        {
+            if (datasum_card == cards.end() - 1)
+            {
+                throw boost::bad_lexical_cast();
+            }
+            data_sum = boost::lexical_cast<std::uint32_t>(boost::algorithm::trim_copy_if(
+                datasum_card->value<std::string>(),
+                [](char c) -> bool { return c == '\'' || c == ' '; }));
+        }
+        catch (boost::bad_lexical_cast const&)
+        {
+            //the edit invalidated CHECKSUM and the data would have to be read to fix it
+            cards.erase(checksum_card);
+            return;
+        }
+
+        //CHECKSUM is '0000000000000000' while the sum is computed
+        checksum_card->create_card("CHECKSUM", "'" + std::string(16, '0') + "'");
+        std::string const bytes = header_bytes(size);
+        std::uint32_t const total = checksum_add(checksum(bytes.data(), bytes.size()), data_sum);
+        checksum_card->create_card("CHECKSUM", "'" + encode_checksum(~total) + "'");
+    }
+
+    void write_in_place(std::string const& bytes)
+    {
+        std::uint64_t const page = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+        std::uint64_t const start = header_offset / page * page;
+        std::size_t const length = static_cast<std::size_t>(header_offset - start) + bytes.size();
+
+        void* address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED,
+            file.native_handle(), static_cast<off_t>(start));
+        if (address == MAP_FAILED)
+        {
+            throw file_io_exception();
+        }
+        std::memcpy(static_cast<char*>(address) + (header_offset - start), bytes.data(),
+            bytes.size());
+        ::munmap(address, length);
+    }
+
+    //!moves everything after the header grow bytes towards the end, last chunk first
+    void shift_tail(std::size_t grow)
+    {
+        std::uint64_t const size = file.size();
+        if (::ftruncate(file.native_handle(), static_cast<off_t>(size + grow)) != 0)
+        {
+            throw file_io_exception();
+        }
+
+        std::uint64_t const tail = header_offset + header_size;
+        std::uint64_t remaining = size - tail;
+        std::vector<char> chunk(static_cast<std::size_t>(
+            std::min<std::uint64_t>(remaining, std::uint64_t(8) << 20)));
+        while (remaining != 0)
+        {
+            std::size_t const count = static_cast<std::size_t>(
+                std::min<std::uint64_t>(remaining, chunk.size()));
+            std::uint64_t const source = tail + remaining - count;
+            if (file.read_at(chunk.data(), count, source) != count)
+            {
+                throw file_io_exception();
+            }
+            detail::write_at(file.native_handle(), chunk.data(), count, source + grow);
+            remaining -= count;
+        }
+    }
+
+public:
+    //!opens the file for writing and reads the header of the HDU at index (0 is primary)
+    explicit header_editor(std::string const& file_name, std::size_t index = 0)
+    {
+        int const fd = ::open(file_name.c_str(), O_RDWR);
+        if (fd < 0)
+        {
+            throw file_io_exception();
+        }
+        file = positional_file(fd, true);
+
+        //headers are read block by block, data units are skipped
+        positional_stream stream(file, 0, 2880);
+        for (std::size_t current = 0; ; current++)
+        {
+            if (stream.peek() == std::istream::traits_type::eof())
+            {
+                throw hdu_not_found_exception();
+            }
+
+            std::streamoff const start = stream.tellg();
+            hdu header(stream);
+            if (current == index)
+            {
+                header_offset = static_cast<std::uint64_t>(start);
+                header_size = static_cast<std::size_t>(stream.tellg() - start);
+                cards = header.get_cards();
+                break;
+            }
+            std::size_t const padded = (header.data_size() + 2879) / 2880 * 2880;
+            stream.seekg(static_cast<std::streamoff>(padded), std::ios_base::cur);
+        }
+    }
+
+    //!cards of the header with pending edits, END card last
+    std::vector<card> const& get_cards() const
+    {
+        return cards;
+    }
+
+    bool contains(std::string const& key) const
+    {
+        return find(key) != cards.end() - 1;
+    }
+
+    //!blank cards left in the header blocks of the file after the pending edits
+    std::size_t spare_cards() const
+    {
+        return cards.size() < header_size / 80 ? header_size / 80 - cards.size() : 0;
+    }
+
+    /*!
+    replaces the first card with the key of c, or inserts c before END when there is none.
+    commentary cards (COMMENT, HISTORY, blank) are always inserted
+    */
+    void set(card const& c)
+    {
+        std::string const key = c.key();
+        if (!is_commentary(key))
+        {
+            auto found = find(key);
+            if (found != cards.end() - 1)
+            {
+                *found = c;
+                return;
+            }
+        }
+        cards.insert(cards.end() - 1, c);
+    }
+
+    //!sets a keyword to value, see set(card const&)
+    template <typename Value>
+    void set(std::string const& key, Value const& value, std::string const& comment = "")
+    {
+        card c;
+        c.create_card(key, value, comment);
+        set(c);
+    }
+
+    //!removes the first card with given key, returns false if there is none
+    bool remove(std::string const& key)
+    {
+        auto found = find(key);
+        if (found == cards.end() - 1)
+        {
+            return false;
+        }
+        cards.erase(found);
+        return true;
+    }
+
+    /*!
+    writes the edited header to the file, returns true if it was updated in place and false
+    if the rest of the file had to be shifted for additional header blocks
+    */
+    bool commit()
+    {
+        //a header that shrinks keeps its blocks, filled with blank cards
+        std::size_t const size = std::max((cards.size() + 35) / 36 * 2880, header_size);
+        refresh_checksum(size);
+        std::string const bytes = header_bytes(size);
+
+        bool const in_place = size == header_size;
+        if (in_place)
+        {
+            write_in_place(bytes);
+        }
+        else
+        {
+            shift_tail(size - header_size);
+            detail::write_at(file.native_handle(), bytes.data(), size, header_offset);
+            header_size = size;
+        }
+        return in_place;
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // BOOST_HAS_UNISTD_H
+
+#endif // !BOOST_ASTRONOMY_IO_HEADER_EDITOR_HPP
@@ -0,0 +1,561 @@
+#ifndef BOOST_ASTRONOMY_IO_HEADER_HARVEST_HPP
+#define BOOST_ASTRONOMY_IO_HEADER_HARVEST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/card_value.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/detail/parallel_for.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//!tuning of header harvesting
+struct harvest_options
+{
+    std::size_t threads = 0; //! workers reading files, 0 uses hardware concurrency
+    bool recursive = true;   //! descend into subdirectories
+    //! file name extensions (compared case insensitively) of harvested files, empty for all files
+    std::vector<std::string> extensions = {".fits", ".fit", ".fts"};
+};
+
+//!throughput counters of one harvest
+struct harvest_statistics
+{
+    std::size_t files = 0;        //! files read successfully
+    std::size_t failed_files = 0; //! files that are not readable FITS files
+    std::size_t hdus = 0;
+    std::size_t header_bytes = 0; //! bytes read, only header blocks are read
+    double seconds = 0;
+
+    double files_per_second() const
+    {
+        return seconds > 0 ? static_cast<double>(files + failed_files) / seconds : 0.0;
+    }
+
+    double bytes_per_second() const
+    {
+        return seconds > 0 ? static_cast<double>(header_bytes) / seconds : 0.0;
+    }
+};
+
+/*!
+column of strings stored back to back in one buffer, values of missing keywords are empty and
+not present
+*/
+struct string_column
+{
+private:
+    std::vector<char> chars;
+    std::vector<std::size_t> ends;
+    std::vector<bool> present_;
+
+public:
+    std::size_t size() const
+    {
+        return ends.size();
+    }
+
+    std::string operator[](std::size_t i) const
+    {
+        std::size_t const begin = i == 0 ? 0 : ends[i - 1];
+        return std::string(chars.data() + begin, ends[i] - begin);
+    }
+
+    //!true if the keyword was found in the header of i-th row
+    bool present(std::size_t i) const
+    {
+        return present_[i];
+    }
+
+    //!length of the longest value
+    std::size_t max_length() const
+    {
+        std::size_t length = 0;
+        for (std::size_t i = 0; i < ends.size(); i++)
+        {
+            length = std::max(length, ends[i] - (i == 0 ? 0 : ends[i - 1]));
+        }
+        return length;
+    }
+
+    void push_back(char const* first, char const* last)
+    {
+        chars.insert(chars.end(), first, last);
+        ends.push_back(chars.size());
+        present_.push_back(true);
+    }
+
+    void push_missing()
+    {
+        ends.push_back(chars.size());
+        present_.push_back(false);
+    }
+
+    //!appends all values of other
+    void append(string_column const& other)
+    {
+        std::size_t const offset = chars.size();
+        chars.insert(chars.end(), other.chars.begin(), other.chars.end());
+        for (auto end : other.ends)
+        {
+            ends.push_back(end + offset);
+        }
+        present_.insert(present_.end(), other.present_.begin(), other.present_.end());
+    }
+};
+
+/*!
+columnar index of harvested headers, one row per HDU. values are kept as the text of the card
+value (string values without quotes), numbers() converts a column to numbers
+*/
+struct header_index
+{
+    std::vector<std::string> keywords;
+    string_column files;                 //! file of each row
+    std::vector<std::size_t> hdu_numbers; //! position of the HDU in its file, 0 is primary
+    std::vector<std::size_t> offsets;    //! byte offset of the HDU header in its file
+    std::vector<string_column> values;   //! values[k] is the column of keywords[k]
+    std::vector<std::string> failed;     //! files that could not be read
+    harvest_statistics statistics;
+
+    std::size_t size() const
+    {
+        return hdu_numbers.size();
+    }
+
+    //!returns column of values of the keyword
+    string_column const& column(std::string const& keyword) const
+    {
+        auto found = std::find(keywords.begin(), keywords.end(), keyword);
+        if (found == keywords.end())
+        {
+            throw column_not_found_exception();
+        }
+        return values[static_cast<std::size_t>(found - keywords.begin())];
+    }
+
+    //!returns numeric values of the keyword, NaN where it is missing or not a number
+    std::vector<double> numbers(std::string const& keyword) const
+    {
+        string_column const& col = column(keyword);
+        std::vector<double> result(col.size(), std::numeric_limits<double>::quiet_NaN());
+        for (std::size_t i = 0; i < col.size(); i++)
+        {
+            std::string const value = col[i];
+            char* end = nullptr;
+            double const number = std::strtod(value.c_str(), &end);
+            if (col.present(i) && !value.empty() && end == value.c_str() + value.size())
+            {
+                result[i] = number;
+            }
+        }
+        return result;
+    }
+
+    //!returns rows where the keyword is present and its value satisfies predicate
+    std::vector<std::size_t> rows_where
+    (
+        std::string const& keyword,
+        std::function<bool(std::string const&)> const& predicate
+    ) const
+    {
+        string_column const& col = column(keyword);
+        std::vector<std::size_t> rows;
+        for (std::size_t i = 0; i < col.size(); i++)
+        {
+            if (col.present(i) && predicate(col[i]))
+            {
+                rows.push_back(i);
+            }
+        }
+        return rows;
+    }
+
+    //!appends rows of other, which must have the same keywords
+    void append(header_index const& other)
+    {
+        files.append(other.files);
+        hdu_numbers.insert(hdu_numbers.end(), other.hdu_numbers.begin(), other.hdu_numbers.end());
+        offsets.insert(offsets.end(), other.offsets.begin(), other.offsets.end());
+        for (std::size_t k = 0; k < values.size(); k++)
+        {
+            values[k].append(other.values[k]);
+        }
+        failed.insert(failed.end(), other.failed.begin(), other.failed.end());
+        statistics.files += other.statistics.files;
+        statistics.failed_files += other.statistics.failed_files;
+        statistics.hdus += other.statistics.hdus;
+        statistics.header_bytes += other.statistics.header_bytes;
+    }
+};
+
+namespace detail {
+
+//!state of one worker, reused for all of its files
+struct harvester
+{
+    std::vector<std::string> keys; //! requested keywords padded to 8 chars
+    std::vector<char> block;
+    std::vector<long long> naxis;
+    std::vector<char> unescaped;
+    std::vector<bool> seen;
+
+    explicit harvester(std::vector<std::string> const& keywords) : block(2880)
+    {
+        for (auto const& keyword : keywords)
+        {
+            keys.push_back(keyword.substr(0, 8) + std::string(8 - std::min<std::size_t>(8, keyword.size()), ' '));
+        }
+    }
+
+    void store(string_column& column, char const* first, char const* last)
+    {
+        if (std::find(first, last, '\'') == last)
+        {
+            column.push_back(first, last);
+            return;
+        }
+
+        unescaped.clear();
+        for (; first != last; ++first)
+        {
+            unescaped.push_back(*first);
+            if (*first == '\'' && first + 1 != last && first[1] == '\'')
+            {
+                ++first;
+            }
+        }
+        column.push_back(unescaped.data(), unescaped.data() + unescaped.size());
+    }
+
+    /*!
+    reads all headers of one file into partial, data units are skipped.
+    returns false (leaving partial unchanged) if the file is not a readable FITS file
+    */
+    bool harvest(std::string const& file_name, header_index& partial)
+    {
+        std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        header_index found;
+        found.values.resize(keys.size());
+        std::size_t offset = 0;
+        std::size_t bytes = 0;
+
+        for (std::size_t hdu = 0; file.read(block.data(), 2880); hdu++)
+        {
+            if (hdu == 0 && std::memcmp(block.data(), "SIMPLE  ", 8) != 0)
+            {
+                return false;
+            }
+            if (hdu != 0 && std::memcmp(block.data(), "XTENSION", 8) != 0)
+            {
+                break; //trailing blocks that are not an extension are ignored
+            }
+
+            seen.assign(keys.size(), false);
+            std::size_t const header_offset = offset;
+            long long bitpix = 0, pcount = 0, gcount = 1;
+            naxis.clear();
+            bool end = false;
+            while (!end)
+            {
+                offset += 2880;
+                bytes += 2880;
+                for (std::size_t c = 0; c < 36 && !end; c++)
+                {
+                    char const* record = block.data() + 80 * c;
+                    if (std::memcmp(record, "END     ", 8) == 0)
+                    {
+                        end = true;
+                        break;
+                    }
+
+                    char const* first;
+                    char const* last;
+                    card_value(record, first, last);
+
+                    for (std::size_t k = 0; k < keys.size(); k++)
+                    {
+                        if (!seen[k] && std::memcmp(record, keys[k].data(), 8) == 0)
+                        {
+                            seen[k] = true;
+                            store(found.values[k], first, last);
+                        }
+                    }
+
+                    long long value = 0;
+                    if (std::memcmp(record, "BITPIX  ", 8) == 0)
+                    {
+                        parse_integer(first, last, bitpix);
+                    }
+                    else if (std::memcmp(record, "PCOUNT  ", 8) == 0)
+                    {
+                        parse_integer(first, last, pcount);
+                    }
+                    else if (std::memcmp(record, "GCOUNT  ", 8) == 0)
+                    {
+                        parse_integer(first, last, gcount);
+                    }
+                    else if (std::memcmp(record, "NAXIS", 5) == 0 &&
+                        parse_integer(first, last, value))
+                    {
+                        long long number = 0;
+                        char const* key_end = std::find(record + 5, record + 8, ' ');
+                        if (key_end == record + 5)
+                        {
+                            naxis.resize(static_cast<std::size_t>(std::max(0LL, value)), 0);
+                        }
+                        else if (parse_integer(record + 5, key_end, number) && number > 0 &&
+                            static_cast<std::size_t>(number) <= naxis.size())
+                        {
+                            naxis[static_cast<std::size_t>(number - 1)] = value;
+                        }
+                    }
+                }
+                if (!end && !file.read(block.data(), 2880))
+                {
+                    return false;
+                }
+            }
+
+            for (std::size_t k = 0; k < keys.size(); k++)
+            {
+                if (!seen[k])
+                {
+                    found.values[k].push_missing();
+                }
+            }
+            found.files.push_back(file_name.data(), file_name.data() + file_name.size());
+            found.hdu_numbers.push_back(hdu);
+            found.offsets.push_back(header_offset);
+
+            //skip the data unit (random groups have NAXIS1 = 0, excluded from the product)
+            long long elements = naxis.empty() ? 0 : 1;
+            for (std::size_t i = 0; i < naxis.size(); i++)
+            {
+                elements *= (i == 0 && naxis[i] == 0 && naxis.size() > 1) ? 1 : naxis[i];
+            }
+            long long const size = std::abs(bitpix) / 8 * gcount * (pcount + elements);
+            std::size_t const padded = (static_cast<std::size_t>(std::max(0LL, size)) + 2879) / 2880 * 2880;
+            offset += padded;
+            file.seekg(static_cast<std::streamoff>(offset));
+        }
+
+        if (found.size() == 0)
+        {
+            return false;
+        }
+        found.statistics.files = 1;
+        found.statistics.hdus = found.size();
+        found.statistics.header_bytes = bytes;
+        partial.append(found);
+        return true;
+    }
+};
+
+} //namespace detail
+
+/*!
+harvests the keywords from every HDU of the given files, reading only header blocks.
+files are handed to the workers in small batches as they become free; rows come out in
+the order of files, one per HDU
+*/
+inline header_index harvest_headers
+(
+    std::vector<std::string> const& files,
+    std::vector<std::string> const& keywords,
+    harvest_options const& options = harvest_options()
+)
+{
+    auto const start = std::chrono::steady_clock::now();
+
+    std::size_t const batch = 16;
+    std::size_t const batches = (files.size() + batch - 1) / batch;
+    std::vector<header_index> partial(batches);
+    for (auto& p : partial)
+    {
+        p.values.resize(keywords.size());
+    }
+
+    std::atomic<std::size_t> next(0);
+    std::size_t const threads = boost::astronomy::detail::thread_count(options.threads);
+    boost::astronomy::detail::parallel_for(threads, threads,
+        [&](std::size_t, std::size_t, std::size_t)
+        {
+            detail::harvester worker(keywords);
+            for (std::size_t b = next++; b < batches; b = next++)
+            {
+                for (std::size_t f = b * batch; f < std::min(files.size(), (b + 1) * batch); f++)
+                {
+                    if (!worker.harvest(files[f], partial[b]))
+                    {
+                        partial[b].failed.push_back(files[f]);
+                        partial[b].statistics.failed_files++;
+                    }
+                }
+            }
+        });
+
+    header_index index;
+    index.keywords = keywords;
+    index.values.resize(keywords.size());
+    for (auto const& p : partial)
+    {
+        index.append(p);
+    }
+    index.statistics.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    return index;
+}
+
+//!harvests all files below the directory whose extension is one of options.extensions
+inline header_index harvest_directory
+(
+    std::string const& directory,
+    std::vector<std::string> const& keywords,
+    harvest_options const& options = harvest_options()
+)
+{
+    namespace fs = boost::filesystem;
+
+    auto accepted = [&options](fs::path const& path) {
+        if (options.extensions.empty())
+        {
+            return true;
+        }
+        std::string const extension = boost::algorithm::to_lower_copy(path.extension().string());
+        return std::find(options.extensions.begin(), options.extensions.end(), extension) !=
+            options.extensions.end();
+    };
+
+    std::vector<std::string> files;
+    if (options.recursive)
+    {
+        for (fs::recursive_directory_iterator it(directory), end; it != end; ++it)
+        {
+            if (fs::is_regular_file(it->status()) && accepted(it->path()))
+            {
+                files.push_back(it->path().string());
+            }
+        }
+    }
+    else
+    {
+        for (fs::directory_iterator it(directory), end; it != end; ++it)
+        {
+            if (fs::is_regular_file(it->status()) && accepted(it->path()))
+            {
+                files.push_back(it->path().string());
+            }
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return harvest_headers(files, keywords, options);
+}
+
+/*!
+writes the index as a binary table (after an empty primary header): FILE, HDU, OFFSET and one
+text column per keyword named after it, all values as they appear in the headers
+*/
+inline void write_header_index(header_index const& index, std::string const& file_name)
+{
+    std::vector<string_column const*> text_columns{&index.files};
+    std::vector<std::string> names{"FILE"};
+    for (std::size_t k = 0; k < index.keywords.size(); k++)
+    {
+        text_columns.push_back(&index.values[k]);
+        names.push_back(index.keywords[k]);
+    }
+
+    std::vector<std::size_t> widths;
+    std::size_t row_size = 12; //HDU (J) and OFFSET (K)
+    for (auto const* col : text_columns)
+    {
+        widths.push_back(std::max<std::size_t>(1, col->max_length()));
+        row_size += widths.back();
+    }
+
+    std::vector<card> cards(8);
+    cards[0].create_card("XTENSION", std::string("'BINTABLE'"));
+    cards[1].create_card("BITPIX", 8);
+    cards[2].create_card("NAXIS", 2);
+    cards[3].create_card("NAXIS1", row_size);
+    cards[4].create_card("NAXIS2", index.size());
+    cards[5].create_card("PCOUNT", 0);
+    cards[6].create_card("GCOUNT", 1);
+    cards[7].create_card("TFIELDS", names.size() + 2);
+
+    auto add_column = [&cards](std::size_t number, std::string const& name, std::string const& form) {
+        cards.emplace_back();
+        cards.back().create_card("TTYPE" + std::to_string(number), "'" + name + "'");
+        cards.emplace_back();
+        cards.back().create_card("TFORM" + std::to_string(number), "'" + form + "'");
+    };
+    add_column(1, names[0], std::to_string(widths[0]) + "A");
+    add_column(2, "HDU", "J");
+    add_column(3, "OFFSET", "K");
+    for (std::size_t c = 1; c < names.size(); c++)
+    {
+        add_column(c + 3, names[c], std::to_string(widths[c]) + "A");
+    }
+    cards.emplace_back();
+    cards.back().create_card("EXTNAME", std::string("'HEADERS'"));
+
+    fits_writer writer(file_name);
+    writer.write_empty_primary();
+    writer.write_header(cards);
+
+    std::vector<char> row(row_size);
+    for (std::size_t i = 0; i < index.size(); i++)
+    {
+        std::fill(row.begin(), row.end(), ' ');
+        char* out = row.data();
+        for (std::size_t c = 0; c < text_columns.size(); c++)
+        {
+            std::string const value = (*text_columns[c])[i];
+            std::copy(value.begin(), value.end(), out);
+            out += widths[c];
+
+            if (c == 0)
+            {
+                auto const hdu = static_cast<std::uint32_t>(index.hdu_numbers[i]);
+                auto const offset = static_cast<std::uint64_t>(index.offsets[i]);
+                for (int b = 0; b < 4; b++)
+                {
+                    *out++ = static_cast<char>((hdu >> (8 * (3 - b))) & 0xFF);
+                }
+                for (int b = 0; b < 8; b++)
+                {
+                    *out++ = static_cast<char>((offset >> (8 * (7 - b))) & 0xFF);
+                }
+            }
+        }
+        writer.write_data(row.data(), row.size());
+    }
+    writer.close();
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_HEADER_HARVEST_HPP
@@ -0,0 +1,125 @@
+#ifndef BOOST_ASTRONOMY_IO_HUGE_PAGE_RESOURCE_HPP
+#define BOOST_ASTRONOMY_IO_HUGE_PAGE_RESOURCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <new>
+
+#include <boost/config.hpp>
+#include <boost/astronomy/io/memory_resource.hpp>
+
+//!huge_page_resource maps memory with mmap and is only available on POSIX platforms
+#ifdef BOOST_HAS_UNISTD_H
+
+#include <sys/mman.h>
+
+namespace boost { namespace astronomy { namespace io {
+
+/*!
+maps allocations of at least threshold bytes directly, aligned to 2 MiB and marked for
+transparent huge pages, so multi-GB pixel arrays need fewer TLB entries. explicit huge pages
+(MAP_HUGETLB) are tried first when requested. smaller allocations go to upstream
+*/
+struct huge_page_resource : public memory_resource
+{
+private:
+    memory_resource* upstream;
+    std::size_t threshold;
+    bool explicit_pages;
+    std::atomic<std::size_t> mapped;
+
+public:
+    static std::size_t page_size()
+    {
+        return std::size_t(2) * 1024 * 1024;
+    }
+
+    explicit huge_page_resource
+    (
+        std::size_t min_bytes = page_size(),
+        bool use_hugetlb = false,
+        memory_resource* upstream_resource = new_delete_resource()
+    )
+        : upstream(upstream_resource), threshold(min_bytes), explicit_pages(use_hugetlb),
+        mapped(0)
+    {}
+
+    huge_page_resource(huge_page_resource const&) = delete;
+    huge_page_resource& operator=(huge_page_resource const&) = delete;
+
+    //!bytes currently mapped for large allocations
+    std::size_t mapped_bytes() const
+    {
+        return mapped.load();
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if (bytes < threshold || alignment > page_size())
+        {
+            return upstream->allocate(bytes, alignment);
+        }
+
+        std::size_t const size = rounded(bytes);
+        void* result = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        if (explicit_pages)
+        {
+            result = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+#endif
+        if (result == MAP_FAILED)
+        {
+            //maps one page more and trims both ends to get a 2 MiB aligned range
+            void* const raw = mmap(nullptr, size + page_size(), PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED)
+            {
+                throw std::bad_alloc();
+            }
+            std::uintptr_t const begin = reinterpret_cast<std::uintptr_t>(raw);
+            std::uintptr_t const aligned = (begin + page_size() - 1) / page_size() * page_size();
+            if (aligned != begin)
+            {
+                munmap(raw, aligned - begin);
+            }
+            std::size_t const tail = page_size() - (aligned - begin);
+            if (tail != 0)
+            {
+                munmap(reinterpret_cast<void*>(aligned + size), tail);
+            }
+            result = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+            madvise(result, size, MADV_HUGEPAGE);
+#endif
+        }
+        mapped.fetch_add(size);
+        return result;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        if (bytes < threshold || alignment > page_size())
+        {
+            upstream->deallocate(p, bytes, alignment);
+            return;
+        }
+        munmap(p, rounded(bytes));
+        mapped.fetch_sub(rounded(bytes));
+    }
+
+private:
+    static std::size_t rounded(std::size_t bytes)
+    {
+        return (bytes + page_size() - 1) / page_size() * page_size();
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // BOOST_HAS_UNISTD_H
+
+#endif // !BOOST_ASTRONOMY_IO_HUGE_PAGE_RESOURCE_HPP
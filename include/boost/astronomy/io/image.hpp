@@ -2,13 +2,16 @@
 #define BOOST_ASTRONOMY_IO_IMAGE_HPP
 
 
-#include <valarray>
 #include <fstream>
+#include <istream>
 #include <cstddef>
 #include <algorithm>
 #include <iterator>
 #include <cstdint>
+#include <cstring>
 #include <string>
+#include <type_traits>
+#include <vector>
 #include <cmath>
 #include <numeric>
 
@@ -16,66 +19,225 @@
 #include <boost/cstdfloat.hpp>
 
 #include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/aligned_buffer.hpp>
+#include <boost/astronomy/io/checksum.hpp>
+#include <boost/astronomy/io/trace.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
 
 
 namespace boost { namespace astronomy { namespace io {
 
+/*!
+non owning view of pixels in rows that are stride elements apart, indexed like a two
+dimensional mdspan with extents (height, width) and a row stride
+*/
+template <typename PixelType>
+struct image_view
+{
+private:
+    PixelType* first = nullptr;
+    std::size_t columns = 0;
+    std::size_t lines = 0;
+    std::size_t pitch = 0;
+
+public:
+    image_view() {}
+
+    image_view(PixelType* data, std::size_t width, std::size_t height, std::size_t stride)
+        : first(data), columns(width), lines(height), pitch(stride) {}
+
+    //!extent(0) is the number of rows, extent(1) the number of pixels in a row
+    std::size_t extent(std::size_t dimension) const
+    {
+        return dimension == 0 ? this->lines : this->columns;
+    }
+
+    std::size_t width() const
+    {
+        return this->columns;
+    }
+
+    std::size_t height() const
+    {
+        return this->lines;
+    }
+
+    //!distance between the first pixels of two consecutive rows, in pixels
+    std::size_t stride() const
+    {
+        return this->pitch;
+    }
+
+    PixelType* data() const
+    {
+        return this->first;
+    }
+
+    PixelType* row(std::size_t y) const
+    {
+        return this->first + y * this->pitch;
+    }
+
+    PixelType& operator()(std::size_t y, std::size_t x) const
+    {
+        return this->first[y * this->pitch + x];
+    }
+};
+
+namespace detail {
+
+//!converts count big endian values in place to native order
+template <typename PixelType>
+void big_to_native_pixels(PixelType* values, std::size_t count)
+{
+    typedef typename std::conditional<sizeof(PixelType) == 8, std::uint64_t,
+        typename std::conditional<sizeof(PixelType) == 4, std::uint32_t,
+        typename std::conditional<sizeof(PixelType) == 2, std::uint16_t,
+        std::uint8_t>::type>::type>::type bits_type;
+
+    if (sizeof(PixelType) == 1)
+    {
+        return;
+    }
+    for (std::size_t i = 0; i < count; i++)
+    {
+        bits_type bits;
+        std::memcpy(&bits, values + i, sizeof(bits));
+        bits = boost::endian::big_to_native(bits);
+        std::memcpy(values + i, &bits, sizeof(bits));
+    }
+}
+
+} //namespace detail
+
+/*!
+pixels of an image in row major order. every row starts on a 64 byte boundary: rows are
+stride() pixels apart, the pixels past the width of a row are zero. the storage is not
+initialized before the pixels are read into it
+*/
 template <typename PixelType>
 struct image_buffer
 {
 protected:
-    std::valarray<PixelType> data; //! stores the image
+    aligned_buffer<PixelType> data; //! stores the image, allocated from the default resource
     std::size_t width; //! width of image 
     std::size_t height; //! height of image
-    //std::fstream image_file; //! image file
+    std::size_t stride_; //! pixels from the start of a row to the start of the next
+    checksum_accumulator unit_sum; //! checksum of the big endian pixels, summed by read_rows
 
-    //! Used purly for Type punning
-    union pixel_data
+    //!sizes the buffer for an image of the given size, the pixels are left uninitialized
+    void allocate(std::size_t columns, std::size_t rows)
     {
-        PixelType pixel;
-        std::uint8_t byte[sizeof(PixelType)];
-        //char byte[sizeof(PixelType)];
-    };
+        this->width = columns;
+        this->height = rows;
+        this->stride_ = padded_stride(columns);
+        this->data.reset(this->stride_ * rows);
+        if (this->stride_ != columns)
+        {
+            for (std::size_t y = 0; y < rows; y++)
+            {
+                std::fill(this->row(y) + columns, this->row(y) + this->stride_, PixelType());
+            }
+        }
+    }
+
+    //!reads the rows of big endian pixels that follow in image_file, a truncated data unit throws
+    void read_rows(std::istream &image_file)
+    {
+        std::streamsize const row_bytes = static_cast<std::streamsize>(this->width * sizeof(PixelType));
+        this->unit_sum = checksum_accumulator();
+        for (std::size_t y = 0; y < this->height; y++)
+        {
+            image_file.read(reinterpret_cast<char*>(this->row(y)), row_bytes);
+            if (image_file.gcount() != row_bytes)
+            {
+                throw file_io_exception();
+            }
+            this->unit_sum.update(reinterpret_cast<char const*>(this->row(y)),
+                static_cast<std::size_t>(row_bytes));
+            detail::big_to_native_pixels(this->row(y), this->width);
+        }
+    }
+
+    //!calls function with every pixel, padding excluded
+    template <typename Function>
+    void for_each_pixel(Function function) const
+    {
+        for (std::size_t y = 0; y < this->height; y++)
+        {
+            std::for_each(this->row(y), this->row(y) + this->width, function);
+        }
+    }
 
 public:
-    image_buffer() {}
+    typedef PixelType pixel_type;
 
-    image_buffer(std::size_t width, std::size_t height) : width(width), height(height)
+    //!row stride for rows of width pixels, a multiple of 64 bytes
+    static std::size_t padded_stride(std::size_t width)
     {
-        this->data.resize(width*height);
+        std::size_t const step = aligned_buffer<PixelType>::alignment() / sizeof(PixelType);
+        return (width + step - 1) / step * step;
+    }
+
+    image_buffer() : width(0), height(0), stride_(0) {}
+
+    image_buffer(std::size_t width, std::size_t height) : width(0), height(0), stride_(0)
+    {
+        this->allocate(width, height);
     }
 
     virtual ~image_buffer() {}
 
+    //! sizes the image to width x height pixels, the pixels are left uninitialized
+    void resize(std::size_t columns, std::size_t rows)
+    {
+        this->allocate(columns, rows);
+    }
+
     //! returns the maximum value of all the pixels in the image
     PixelType max() const
     {
-        return this->data.max();
+        if (this->width * this->height == 0)
+        {
+            return PixelType();
+        }
+        PixelType result = this->data[0];
+        this->for_each_pixel([&](PixelType p) { result = p > result ? p : result; });
+        return result;
     }
 
     //! returns the manimum value of all the pixels in the image
     PixelType min() const
     {
-        return this->data.min();
+        if (this->width * this->height == 0)
+        {
+            return PixelType();
+        }
+        PixelType result = this->data[0];
+        this->for_each_pixel([&](PixelType p) { result = p < result ? p : result; });
+        return result;
     }
 
     //! returns the mean value of all the pixels in image
     double mean() const
     {
-        if (this->data.size() == 0)
+        if (this->width * this->height == 0)
         {
             return 0;
         }
 
-        return (std::accumulate(std::begin(this->data),
-            std::end(this->data), 0.0) / this->data.size());
+        double sum = 0;
+        this->for_each_pixel([&](PixelType p) { sum += p; });
+        return sum / (this->width * this->height);
     }
 
     //! returns the median of all the pixel values in the image 
     //! Note: uses additional space of order O(n) where n is the number of total pixels
     PixelType median() const
     {
-        std::valarray<PixelType> soreted_array = this->data;
+        std::vector<PixelType> soreted_array;
+        soreted_array.reserve(this->width * this->height);
+        this->for_each_pixel([&](PixelType p) { soreted_array.push_back(p); });
         std::nth_element(std::begin(soreted_array),
             std::begin(soreted_array) + soreted_array.size() / 2, std::end(soreted_array));
 
@@ -83,29 +245,78 @@ public:
     }
 
     //! returns the standard deviation of all the pixel values in the image 
-    //! Note: uses additional space of order O(n) where n is the number of total pixels
     double std_dev() const
     {
-        if (this->data.size() == 0)
+        if (this->width * this->height == 0)
         {
             return 0;
         }
 
         double avg = this->mean();
 
-        std::valarray<double> diff(this->data.size());
-        for (size_t i = 0; i < diff.size(); i++)
-        {
-            diff[i] = this->data[i] - avg;
-        }
-                    
-        diff *= diff;
-        return std::sqrt(diff.sum() / (diff.size() - 1));
+        double sum = 0;
+        this->for_each_pixel([&](PixelType p) {
+            double const diff = p - avg;
+            sum += diff * diff;
+        });
+        return std::sqrt(sum / (this->width * this->height - 1));
+    }
+
+    //! returns the pixel in row x and column y
+    PixelType operator() (std::size_t x, std::size_t y) const
+    {
+        return this->data[(x*this->stride_) + y];
+    }
+
+    //! returns pointer to the first pixel, rows are stride() pixels apart
+    PixelType const* pixels() const
+    {
+        return this->data.data();
+    }
+
+    PixelType* row(std::size_t y)
+    {
+        return this->data.data() + y * this->stride_;
+    }
+
+    PixelType const* row(std::size_t y) const
+    {
+        return this->data.data() + y * this->stride_;
     }
 
-    PixelType operator() (std::size_t x, std::size_t y)
+    std::size_t stride() const
     {
-        return this->data[(x*this->width) + y];
+        return this->stride_;
+    }
+
+    image_view<PixelType> view()
+    {
+        return image_view<PixelType>(this->data.data(), this->width, this->height, this->stride_);
+    }
+
+    image_view<PixelType const> view() const
+    {
+        return image_view<PixelType const>(this->data.data(), this->width, this->height,
+            this->stride_);
+    }
+
+    std::size_t get_width() const
+    {
+        return this->width;
+    }
+
+    std::size_t get_height() const
+    {
+        return this->height;
+    }
+
+    /*!
+    checksum of the data unit the pixels were last read from, summed over the big endian bytes
+    while reading. the zero padding of the unit does not change it
+    */
+    std::uint32_t read_checksum() const
+    {
+        return this->unit_sum.value();
     }
 };
 
@@ -137,20 +348,20 @@ public:
         image_file.close();
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    image(std::istream &file, std::size_t width, std::size_t height, std::streamoff start)
     {
         read_image(file, width, height, start);
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height)
+    image(std::istream &file, std::size_t width, std::size_t height)
     {
         read_image(file, width, height);
     }
 
-    void read_image_logic(std::fstream &image_file)
+    void read_image_logic(std::istream &image_file)
     {
-        image_file.read((char*)std::begin(data), width*height);
-        //std::copy_n(std::istreambuf_iterator<char>(file.rdbuf()), width*height, std::begin(data));
+        BOOST_ASTRONOMY_IO_TRACE("image::read_image");
+        this->read_rows(image_file);
     }
 
     void read_image
@@ -162,7 +373,7 @@ public:
     )
     {
         std::fstream image_file(file);
-        data.resize(width*height);
+        this->allocate(width, height);
         image_file.seekg(start);
 
         read_image_logic(image_file);
@@ -175,15 +386,15 @@ public:
         read_image(file, width, height, 0);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    void read_image(std::istream &file, std::size_t width, std::size_t height, std::streamoff start)
     {
-        data.resize(width*height);
+        this->allocate(width, height);
         file.seekg(start);
 
         read_image_logic(file);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height)
+    void read_image(std::istream &file, std::size_t width, std::size_t height)
     {
         read_image(file, width, height, file.tellg());
     }
@@ -213,23 +424,20 @@ public:
         image_file.close();
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    image(std::istream &file, std::size_t width, std::size_t height, std::streamoff start)
     {
         read_image(file, width, height, start);
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height)
+    image(std::istream &file, std::size_t width, std::size_t height)
     {
         read_image(file, width, height);
     }
 
-    void read_image_logic(std::fstream &image_file)
+    void read_image_logic(std::istream &image_file)
     {
-        for (std::size_t i = 0; i < height*width; i++)
-        {
-            image_file.read((char*)&data[i], 2);
-            data[i] = boost::endian::big_to_native(data[i]);
-        }
+        BOOST_ASTRONOMY_IO_TRACE("image::read_image");
+        this->read_rows(image_file);
     }
 
     void read_image
@@ -242,7 +450,7 @@ public:
     {
         std::fstream image_file(file);
         image_file.open(file);
-        data.resize(width*height);
+        this->allocate(width, height);
         image_file.seekg(start);
 
         read_image_logic(image_file);
@@ -255,15 +463,15 @@ public:
         read_image(file, width, height, 0);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    void read_image(std::istream &file, std::size_t width, std::size_t height, std::streamoff start)
     {
-        data.resize(width*height);
+        this->allocate(width, height);
         file.seekg(start);
 
         read_image_logic(file);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height)
+    void read_image(std::istream &file, std::size_t width, std::size_t height)
     {
         read_image(file, width, height, file.tellg());
     }
@@ -293,23 +501,20 @@ public:
         image_file.close();
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    image(std::istream &file, std::size_t width, std::size_t height, std::streamoff start)
     {
         read_image(file, width, height, start);
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height)
+    image(std::istream &file, std::size_t width, std::size_t height)
     {
         read_image(file, width, height);
     }
 
-    void read_image_logic(std::fstream &image_file)
+    void read_image_logic(std::istream &image_file)
     {
-        for (std::size_t i = 0; i < height*width; i++)
-        {
-            image_file.read((char*)&data[i], 4);
-            data[i] = boost::endian::big_to_native(data[i]);
-        }
+        BOOST_ASTRONOMY_IO_TRACE("image::read_image");
+        this->read_rows(image_file);
     }
 
     //!reads image
@@ -322,7 +527,7 @@ public:
     )
     {
         std::fstream image_file(file);
-        data.resize(width*height);
+        this->allocate(width, height);
         image_file.seekg(start);
 
         read_image_logic(image_file);
@@ -335,15 +540,15 @@ public:
         read_image(file, width, height, 0);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    void read_image(std::istream &file, std::size_t width, std::size_t height, std::streamoff start)
     {
-        data.resize(width*height);
+        this->allocate(width, height);
         file.seekg(start);
 
         read_image_logic(file);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height)
+    void read_image(std::istream &file, std::size_t width, std::size_t height)
     {
         read_image(file, width, height, file.tellg());
     }
@@ -373,25 +578,20 @@ public:
         image_file.close();
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    image(std::istream &file, std::size_t width, std::size_t height, std::streamoff start)
     {
         read_image(file, width, height, start);
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height)
+    image(std::istream &file, std::size_t width, std::size_t height)
     {
         read_image(file, width, height);
     }
 
-    void read_image_logic(std::fstream &image_file)
+    void read_image_logic(std::istream &image_file)
     {
-        pixel_data single_pixel;
-        for (std::size_t i = 0; i < height*width; i++)
-        {
-            image_file.read((char*)single_pixel.byte, 4);
-            data[i] = (single_pixel.byte[3] << 0) | (single_pixel.byte[2] << 8) |
-                (single_pixel.byte[1] << 16) | (single_pixel.byte[0] << 24);
-        }
+        BOOST_ASTRONOMY_IO_TRACE("image::read_image");
+        this->read_rows(image_file);
     }
 
     void read_image
@@ -403,7 +603,7 @@ public:
     )
     {
         std::fstream image_file(file);
-        data.resize(width*height);
+        this->allocate(width, height);
         image_file.seekg(start);
 
         read_image_logic(image_file);
@@ -415,15 +615,15 @@ public:
         read_image(file, width, height, 0);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    void read_image(std::istream &file, std::size_t width, std::size_t height, std::streamoff start)
     {
-        data.resize(width*height);
+        this->allocate(width, height);
         file.seekg(start);
 
         read_image_logic(file);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height)
+    void read_image(std::istream &file, std::size_t width, std::size_t height)
     {
         read_image(file, width, height, file.tellg());
     }
@@ -453,27 +653,20 @@ public:
         image_file.close();
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    image(std::istream &file, std::size_t width, std::size_t height, std::streamoff start)
     {
         read_image(file, width, height, start);
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height)
+    image(std::istream &file, std::size_t width, std::size_t height)
     {
         read_image(file, width, height);
     }
 
-    void read_image_logic(std::fstream &image_file)
+    void read_image_logic(std::istream &image_file)
     {
-        pixel_data single_pixel;
-        for (std::size_t i = 0; i < height*width; i++)
-        {
-            image_file.read((char*)single_pixel.byte, 8);
-            data[i] = (single_pixel.byte[7] << 0) | (single_pixel.byte[6] << 8) |
-                (single_pixel.byte[5] << 16) | (single_pixel.byte[4] << 24) |
-                (single_pixel.byte[3] << 32) | (single_pixel.byte[2] << 40) |
-                (single_pixel.byte[1] << 48) | (single_pixel.byte[0] << 56);
-        }
+        BOOST_ASTRONOMY_IO_TRACE("image::read_image");
+        this->read_rows(image_file);
     }
 
     void read_image
@@ -485,7 +678,7 @@ public:
     )
     {
         std::fstream image_file(file);
-        data.resize(width*height);
+        this->allocate(width, height);
         image_file.seekg(start);
 
         read_image_logic(image_file);
@@ -498,15 +691,15 @@ public:
         read_image(file, width, height, 0);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    void read_image(std::istream &file, std::size_t width, std::size_t height, std::streamoff start)
     {
-        data.resize(width*height);
+        this->allocate(width, height);
         file.seekg(start);
 
         read_image_logic(file);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height)
+    void read_image(std::istream &file, std::size_t width, std::size_t height)
     {
         read_image(file, width, height, file.tellg());
     }
@@ -0,0 +1,541 @@
+#ifndef BOOST_ASTRONOMY_IO_IMAGE_EXPRESSION_HPP
+#define BOOST_ASTRONOMY_IO_IMAGE_EXPRESSION_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <boost/astronomy/detail/parallel_for.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+#include <boost/astronomy/io/image.hpp>
+
+/*!
+lazy pixel wise arithmetic on images. operators on images, scalars and expressions build an
+expression tree holding references to the images; assign (or evaluate) runs the whole tree in
+one loop over the rows of the result, so
+
+    assign(calibrated, (raw - bias - dark * exposure) / flat);
+
+reads every input pixel once and creates no temporary image. the expression must not outlive
+the images it refers to. a result may appear in its own expression, every pixel depends on
+the pixels at the same position only
+*/
+
+namespace boost { namespace astronomy { namespace io {
+
+//!base of all expression nodes, Derived provides value_type, cursor, check_shape and row
+template <typename Derived>
+struct image_expression
+{
+    Derived const& self() const
+    {
+        return static_cast<Derived const&>(*this);
+    }
+};
+
+namespace detail {
+
+//!width and height shared by the images of an expression, scalars leave it open
+struct expression_shape
+{
+    std::size_t width = 0;
+    std::size_t height = 0;
+    bool known = false;
+
+    void require(std::size_t w, std::size_t h)
+    {
+        if (known && (width != w || height != h))
+        {
+            throw image_size_mismatch_exception();
+        }
+        width = w;
+        height = h;
+        known = true;
+    }
+};
+
+//!leaf referring to the pixels of an image
+template <typename PixelType>
+struct image_operand : public image_expression<image_operand<PixelType>>
+{
+    typedef PixelType value_type;
+    typedef PixelType const* cursor;
+
+private:
+    image_view<PixelType const> pixels;
+
+public:
+    explicit image_operand(image_buffer<PixelType> const& image) : pixels(image.view()) {}
+
+    void check_shape(expression_shape& shape) const
+    {
+        shape.require(pixels.width(), pixels.height());
+    }
+
+    cursor row(std::size_t y) const
+    {
+        return pixels.row(y);
+    }
+};
+
+//!leaf with the same value at every pixel
+template <typename Type>
+struct scalar_operand : public image_expression<scalar_operand<Type>>
+{
+    typedef Type value_type;
+
+    struct cursor
+    {
+        Type value;
+
+        Type operator[](std::size_t) const
+        {
+            return value;
+        }
+    };
+
+private:
+    Type value;
+
+public:
+    explicit scalar_operand(Type v) : value(v) {}
+
+    void check_shape(expression_shape&) const {}
+
+    cursor row(std::size_t) const
+    {
+        return cursor{value};
+    }
+};
+
+//!node applying Operation to the pixels of two expressions
+template <typename Operation, typename Left, typename Right>
+struct binary_expression : public image_expression<binary_expression<Operation, Left, Right>>
+{
+    typedef decltype(Operation::apply(std::declval<typename Left::value_type>(),
+        std::declval<typename Right::value_type>())) value_type;
+
+    struct cursor
+    {
+        typename Left::cursor left;
+        typename Right::cursor right;
+
+        value_type operator[](std::size_t x) const
+        {
+            return Operation::apply(left[x], right[x]);
+        }
+    };
+
+private:
+    Left left;
+    Right right;
+
+public:
+    binary_expression(Left const& l, Right const& r) : left(l), right(r) {}
+
+    void check_shape(expression_shape& shape) const
+    {
+        left.check_shape(shape);
+        right.check_shape(shape);
+    }
+
+    cursor row(std::size_t y) const
+    {
+        return cursor{left.row(y), right.row(y)};
+    }
+};
+
+//!node choosing between two expressions by the pixels of a condition
+template <typename Condition, typename Then, typename Else>
+struct where_expression : public image_expression<where_expression<Condition, Then, Else>>
+{
+    typedef typename std::common_type<typename Then::value_type,
+        typename Else::value_type>::type value_type;
+
+    struct cursor
+    {
+        typename Condition::cursor condition;
+        typename Then::cursor then;
+        typename Else::cursor otherwise;
+
+        value_type operator[](std::size_t x) const
+        {
+            return condition[x] ? static_cast<value_type>(then[x]) :
+                static_cast<value_type>(otherwise[x]);
+        }
+    };
+
+private:
+    Condition condition;
+    Then then;
+    Else otherwise;
+
+public:
+    where_expression(Condition const& c, Then const& t, Else const& e)
+        : condition(c), then(t), otherwise(e) {}
+
+    void check_shape(expression_shape& shape) const
+    {
+        condition.check_shape(shape);
+        then.check_shape(shape);
+        otherwise.check_shape(shape);
+    }
+
+    cursor row(std::size_t y) const
+    {
+        return cursor{condition.row(y), then.row(y), otherwise.row(y)};
+    }
+};
+
+//!node negating the pixels of an expression
+template <typename Operand>
+struct negate_expression : public image_expression<negate_expression<Operand>>
+{
+    typedef decltype(-std::declval<typename Operand::value_type>()) value_type;
+
+    struct cursor
+    {
+        typename Operand::cursor operand;
+
+        value_type operator[](std::size_t x) const
+        {
+            return -operand[x];
+        }
+    };
+
+private:
+    Operand operand;
+
+public:
+    explicit negate_expression(Operand const& o) : operand(o) {}
+
+    void check_shape(expression_shape& shape) const
+    {
+        operand.check_shape(shape);
+    }
+
+    cursor row(std::size_t y) const
+    {
+        return cursor{operand.row(y)};
+    }
+};
+
+struct plus_operation
+{
+    template <typename A, typename B>
+    static auto apply(A a, B b) -> decltype(a + b)
+    {
+        typedef decltype(a + b) result;
+        return static_cast<result>(a) + static_cast<result>(b);
+    }
+};
+
+struct minus_operation
+{
+    template <typename A, typename B>
+    static auto apply(A a, B b) -> decltype(a - b)
+    {
+        typedef decltype(a - b) result;
+        return static_cast<result>(a) - static_cast<result>(b);
+    }
+};
+
+struct multiplies_operation
+{
+    template <typename A, typename B>
+    static auto apply(A a, B b) -> decltype(a * b)
+    {
+        typedef decltype(a * b) result;
+        return static_cast<result>(a) * static_cast<result>(b);
+    }
+};
+
+struct divides_operation
+{
+    template <typename A, typename B>
+    static auto apply(A a, B b) -> decltype(a / b)
+    {
+        typedef decltype(a / b) result;
+        return static_cast<result>(a) / static_cast<result>(b);
+    }
+};
+
+struct minimum_operation
+{
+    template <typename A, typename B>
+    static typename std::common_type<A, B>::type apply(A a, B b)
+    {
+        typedef typename std::common_type<A, B>::type result;
+        result const x = static_cast<result>(a);
+        result const y = static_cast<result>(b);
+        return y < x ? y : x;
+    }
+};
+
+struct maximum_operation
+{
+    template <typename A, typename B>
+    static typename std::common_type<A, B>::type apply(A a, B b)
+    {
+        typedef typename std::common_type<A, B>::type result;
+        result const x = static_cast<result>(a);
+        result const y = static_cast<result>(b);
+        return x < y ? y : x;
+    }
+};
+
+struct less_operation
+{
+    template <typename A, typename B>
+    static bool apply(A a, B b) { return a < b; }
+};
+
+struct greater_operation
+{
+    template <typename A, typename B>
+    static bool apply(A a, B b) { return a > b; }
+};
+
+struct less_equal_operation
+{
+    template <typename A, typename B>
+    static bool apply(A a, B b) { return a <= b; }
+};
+
+struct greater_equal_operation
+{
+    template <typename A, typename B>
+    static bool apply(A a, B b) { return a >= b; }
+};
+
+struct equal_operation
+{
+    template <typename A, typename B>
+    static bool apply(A a, B b) { return a == b; }
+};
+
+struct not_equal_operation
+{
+    template <typename A, typename B>
+    static bool apply(A a, B b) { return a != b; }
+};
+
+template <typename PixelType>
+std::true_type is_image_test(image_buffer<PixelType> const*);
+std::false_type is_image_test(...);
+
+template <typename Derived>
+std::true_type is_expression_test(image_expression<Derived> const*);
+std::false_type is_expression_test(...);
+
+template <typename Type>
+struct is_image : decltype(is_image_test(std::declval<Type const*>())) {};
+
+template <typename Type>
+struct is_expression : decltype(is_expression_test(std::declval<Type const*>())) {};
+
+/*!
+maps an argument of an operator to its expression node: images become image_operand,
+arithmetic values scalar_operand and expressions stay as they are
+*/
+template <typename Type, typename Enable = void>
+struct operand_of {};
+
+template <typename Type>
+struct operand_of<Type, typename std::enable_if<is_image<Type>::value>::type>
+{
+    typedef image_operand<typename Type::pixel_type> type;
+
+    static type make(Type const& image)
+    {
+        return type(image);
+    }
+};
+
+template <typename Type>
+struct operand_of<Type, typename std::enable_if<is_expression<Type>::value>::type>
+{
+    typedef Type type;
+
+    static type const& make(Type const& expression)
+    {
+        return expression;
+    }
+};
+
+template <typename Type>
+struct operand_of<Type, typename std::enable_if<std::is_arithmetic<Type>::value>::type>
+{
+    typedef scalar_operand<Type> type;
+
+    static type make(Type value)
+    {
+        return type(value);
+    }
+};
+
+//!true for an image or expression argument, the operators need at least one of them
+template <typename Type>
+struct is_pixel_source
+    : std::integral_constant<bool, is_image<Type>::value || is_expression<Type>::value> {};
+
+template <bool Enabled, typename A, typename B, typename Operation>
+struct binary_result {};
+
+template <typename A, typename B, typename Operation>
+struct binary_result<true, A, B, Operation>
+{
+    typedef binary_expression<Operation, typename operand_of<A>::type,
+        typename operand_of<B>::type> type;
+};
+
+//!type of A op B when one side is an image or expression and the other one too or a number
+template <typename A, typename B, typename Operation>
+struct enable_binary
+    : binary_result<(is_pixel_source<A>::value || is_pixel_source<B>::value) &&
+        (is_pixel_source<A>::value || std::is_arithmetic<A>::value) &&
+        (is_pixel_source<B>::value || std::is_arithmetic<B>::value), A, B, Operation> {};
+
+template <typename Operation, typename A, typename B>
+binary_expression<Operation, typename operand_of<A>::type, typename operand_of<B>::type>
+make_binary(A const& a, B const& b)
+{
+    return binary_expression<Operation, typename operand_of<A>::type,
+        typename operand_of<B>::type>(operand_of<A>::make(a), operand_of<B>::make(b));
+}
+
+//!evaluates rows [begin, end) of expression into image
+template <typename PixelType, typename Expression>
+void evaluate_rows(image_buffer<PixelType>& image, Expression const& expression,
+    std::size_t begin, std::size_t end)
+{
+    std::size_t const width = image.get_width();
+    for (std::size_t y = begin; y < end; y++)
+    {
+        PixelType* out = image.row(y);
+        typename Expression::cursor const in = expression.row(y);
+        for (std::size_t x = 0; x < width; x++)
+        {
+            out[x] = static_cast<PixelType>(in[x]);
+        }
+    }
+}
+
+} //namespace detail
+
+#define BOOST_ASTRONOMY_IO_IMAGE_OPERATOR(op, operation)                                    \
+    template <typename A, typename B>                                                       \
+    typename detail::enable_binary<A, B, detail::operation>::type                            \
+    operator op(A const& a, B const& b)                                                     \
+    {                                                                                       \
+        return detail::make_binary<detail::operation>(a, b);                                \
+    }
+
+BOOST_ASTRONOMY_IO_IMAGE_OPERATOR(+, plus_operation)
+BOOST_ASTRONOMY_IO_IMAGE_OPERATOR(-, minus_operation)
+BOOST_ASTRONOMY_IO_IMAGE_OPERATOR(*, multiplies_operation)
+BOOST_ASTRONOMY_IO_IMAGE_OPERATOR(/, divides_operation)
+BOOST_ASTRONOMY_IO_IMAGE_OPERATOR(<, less_operation)
+BOOST_ASTRONOMY_IO_IMAGE_OPERATOR(>, greater_operation)
+BOOST_ASTRONOMY_IO_IMAGE_OPERATOR(<=, less_equal_operation)
+BOOST_ASTRONOMY_IO_IMAGE_OPERATOR(>=, greater_equal_operation)
+BOOST_ASTRONOMY_IO_IMAGE_OPERATOR(==, equal_operation)
+BOOST_ASTRONOMY_IO_IMAGE_OPERATOR(!=, not_equal_operation)
+
+#undef BOOST_ASTRONOMY_IO_IMAGE_OPERATOR
+
+template <typename A>
+typename std::enable_if<detail::is_pixel_source<A>::value,
+    detail::negate_expression<typename detail::operand_of<A>::type>>::type
+operator-(A const& a)
+{
+    return detail::negate_expression<typename detail::operand_of<A>::type>(
+        detail::operand_of<A>::make(a));
+}
+
+//!pixel wise minimum, named after numpy.minimum to keep std::min usable
+template <typename A, typename B>
+typename detail::enable_binary<A, B, detail::minimum_operation>::type
+minimum(A const& a, B const& b)
+{
+    return detail::make_binary<detail::minimum_operation>(a, b);
+}
+
+//!pixel wise maximum, named after numpy.maximum to keep std::max usable
+template <typename A, typename B>
+typename detail::enable_binary<A, B, detail::maximum_operation>::type
+maximum(A const& a, B const& b)
+{
+    return detail::make_binary<detail::maximum_operation>(a, b);
+}
+
+//!pixels of then where condition holds, else the pixels of otherwise
+template <typename Condition, typename Then, typename Else>
+typename std::enable_if<detail::is_pixel_source<Condition>::value,
+    detail::where_expression<typename detail::operand_of<Condition>::type,
+        typename detail::operand_of<Then>::type, typename detail::operand_of<Else>::type>>::type
+where(Condition const& condition, Then const& then, Else const& otherwise)
+{
+    return detail::where_expression<typename detail::operand_of<Condition>::type,
+        typename detail::operand_of<Then>::type, typename detail::operand_of<Else>::type>(
+            detail::operand_of<Condition>::make(condition), detail::operand_of<Then>::make(then),
+            detail::operand_of<Else>::make(otherwise));
+}
+
+//!pixels limited to [low, high]
+template <typename A, typename Low, typename High>
+auto clip(A const& a, Low const& low, High const& high)
+    -> decltype(minimum(maximum(a, low), high))
+{
+    return minimum(maximum(a, low), high);
+}
+
+/*!
+evaluates expression into image in one pass, resizing the image to the size of the images in
+the expression when they differ. rows are split over threads (0: one per core). throws
+image_size_mismatch_exception if the images of the expression differ in size
+*/
+template <typename PixelType, typename Expression>
+void assign(image_buffer<PixelType>& image, image_expression<Expression> const& expression,
+    std::size_t threads = 1)
+{
+    Expression const& root = expression.self();
+    detail::expression_shape shape;
+    root.check_shape(shape);
+    if (!shape.known)
+    {
+        shape.width = image.get_width();
+        shape.height = image.get_height();
+    }
+    if (shape.width != image.get_width() || shape.height != image.get_height())
+    {
+        image.resize(shape.width, shape.height);
+    }
+
+    if (threads == 1 || shape.height < 2)
+    {
+        detail::evaluate_rows(image, root, 0, shape.height);
+        return;
+    }
+    astronomy::detail::parallel_for(shape.height, threads,
+        [&](std::size_t begin, std::size_t end, std::size_t)
+        {
+            detail::evaluate_rows(image, root, begin, end);
+        });
+}
+
+//!evaluates expression into a new image of its value type (or PixelType when given)
+template <typename PixelType = void, typename Expression>
+image_buffer<typename std::conditional<std::is_void<PixelType>::value,
+    typename Expression::value_type, PixelType>::type>
+evaluate(image_expression<Expression> const& expression, std::size_t threads = 1)
+{
+    image_buffer<typename std::conditional<std::is_void<PixelType>::value,
+        typename Expression::value_type, PixelType>::type> result;
+    assign(result, expression, threads);
+    return result;
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_IMAGE_EXPRESSION_HPP
@@ -1,9 +1,11 @@
 #ifndef BOOST_ASTRONOMY_IO_IMAGE_EXTENSION_HDU_HPP
 #define BOOST_ASTRONOMY_IO_IMAGE_EXTENSION_HDU_HPP
 
+#include <istream>
 #include <string>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 #include <valarray>
 
 #include <boost/astronomy/io/hdu.hpp>
@@ -19,9 +21,10 @@ protected:
     image<DataType> data;
 
 public:
-    image_extension(std::fstream &file) : extension_hdu(file)
+    image_extension(std::istream &file) : extension_hdu(file)
     {
         //read image according to dimension specified by naxis
+        detail::scoped_timer timer(this->metrics_, detail::io_metric::pixel_decode_ns);
         switch (this->naxis())
         {
         case 0:
@@ -40,9 +43,10 @@ public:
         set_unit_end(file);
     }
 
-    image_extension(std::fstream &file, hdu const& other) : extension_hdu(file, other)
+    image_extension(std::istream &file, hdu const& other) : extension_hdu(file, other)
     {
         //read image according to dimension specified by naxis
+        detail::scoped_timer timer(this->metrics_, detail::io_metric::pixel_decode_ns);
         switch (this->naxis())
         {
         case 0:
@@ -61,9 +65,10 @@ public:
         set_unit_end(file);
     }
 
-    image_extension(std::fstream &file, std::streampos pos) : extension_hdu(file, pos)
+    image_extension(std::istream &file, std::streampos pos) : extension_hdu(file, pos)
     {
         //read image according to dimension specified by naxis
+        detail::scoped_timer timer(this->metrics_, detail::io_metric::pixel_decode_ns);
         switch (this->naxis())
         {
         case 0:
@@ -81,6 +86,12 @@ public:
         }
         set_unit_end(file);
     }
+
+    //!checksum of the data unit computed while it was read, see hdu::verify_checksums
+    std::uint32_t data_checksum() const
+    {
+        return this->data.read_checksum();
+    }
 };
 
 }}} //namespace boost::astronomy::io
@@ -0,0 +1,339 @@
+#ifndef BOOST_ASTRONOMY_IO_MEMORY_RESOURCE_HPP
+#define BOOST_ASTRONOMY_IO_MEMORY_RESOURCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include <boost/config.hpp>
+
+#ifdef BOOST_HAS_UNISTD_H
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif // BOOST_HAS_UNISTD_H
+
+/*!
+memory resources for the buffers of the io layer: pixels of images, decoded columns and raw
+table data. containers take their resource from get_default_resource when they are created,
+so a scoped_resource around the reads of a file places all of its buffers in one arena that
+is freed at once. the interface follows std::pmr, which is not available in C++14
+*/
+
+namespace boost { namespace astronomy { namespace io {
+
+//!source of raw memory, see std::pmr::memory_resource
+struct memory_resource
+{
+    virtual ~memory_resource() {}
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+    {
+        return do_allocate(bytes, alignment);
+    }
+
+    void deallocate(void* p, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+    {
+        do_deallocate(p, bytes, alignment);
+    }
+
+    bool is_equal(memory_resource const& other) const noexcept
+    {
+        return do_is_equal(other);
+    }
+
+protected:
+    virtual void* do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+    virtual void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) = 0;
+
+    virtual bool do_is_equal(memory_resource const& other) const noexcept
+    {
+        return this == &other;
+    }
+};
+
+namespace detail {
+
+//!global heap with any power of two alignment
+struct heap_resource : public memory_resource
+{
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        std::size_t const size = bytes != 0 ? bytes : 1;
+#ifdef BOOST_HAS_UNISTD_H
+        void* p = nullptr;
+        if (posix_memalign(&p, alignment < sizeof(void*) ? sizeof(void*) : alignment, size) != 0)
+        {
+            throw std::bad_alloc();
+        }
+#else
+        void* const p = _aligned_malloc(size, alignment);
+        if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+#endif
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t, std::size_t) override
+    {
+#ifdef BOOST_HAS_UNISTD_H
+        std::free(p);
+#else
+        _aligned_free(p);
+#endif
+    }
+};
+
+} //namespace detail
+
+//!resource allocating from the global heap, the initial default resource
+inline memory_resource* new_delete_resource()
+{
+    static detail::heap_resource resource;
+    return &resource;
+}
+
+namespace detail {
+
+inline memory_resource*& thread_resource()
+{
+    thread_local memory_resource* resource = nullptr;
+    return resource;
+}
+
+inline std::atomic<memory_resource*>& process_resource()
+{
+    static std::atomic<memory_resource*> resource(new_delete_resource());
+    return resource;
+}
+
+} //namespace detail
+
+//!resource of the innermost scoped_resource of the calling thread, else the process default
+inline memory_resource* get_default_resource()
+{
+    memory_resource* const scoped = detail::thread_resource();
+    return scoped != nullptr ? scoped : detail::process_resource().load();
+}
+
+//!sets the process default resource, nullptr restores new_delete_resource. returns the previous
+inline memory_resource* set_default_resource(memory_resource* resource)
+{
+    return detail::process_resource().exchange(
+        resource != nullptr ? resource : new_delete_resource());
+}
+
+/*!
+makes resource the default resource of the calling thread until the end of the scope. buffers
+created meanwhile keep using it after the scope ends, so it must outlive them
+*/
+struct scoped_resource
+{
+private:
+    memory_resource* previous;
+
+public:
+    explicit scoped_resource(memory_resource& resource) : previous(detail::thread_resource())
+    {
+        detail::thread_resource() = &resource;
+    }
+
+    scoped_resource(scoped_resource const&) = delete;
+    scoped_resource& operator=(scoped_resource const&) = delete;
+
+    ~scoped_resource()
+    {
+        detail::thread_resource() = previous;
+    }
+};
+
+/*!
+bump allocator for buffers sharing a lifetime, e.g. all the HDUs of one file. deallocate does
+nothing, release frees everything at once. chunks grow geometrically, so their number stays
+logarithmic in the bytes allocated. a request larger than the next chunk gets a chunk of its
+own and leaves the growth alone. not thread safe, use one arena per thread
+*/
+struct arena_resource : public memory_resource
+{
+private:
+    struct chunk
+    {
+        chunk* next;
+        std::size_t size;
+        std::size_t alignment;
+    };
+
+    memory_resource* upstream;
+    std::size_t first_size;  //! size of the first chunk, again after release
+    std::size_t next_size;   //! size of the next chunk requested from upstream
+    chunk* chunks = nullptr; //! most recent first
+    char* current = nullptr;
+    std::size_t remaining = 0;
+    std::size_t allocated = 0;
+
+public:
+    explicit arena_resource
+    (
+        std::size_t initial_size = 64 * 1024,
+        memory_resource* upstream_resource = get_default_resource()
+    )
+        : upstream(upstream_resource),
+          first_size(initial_size < 256 ? 256 : initial_size),
+          next_size(first_size)
+    {}
+
+    arena_resource(arena_resource const&) = delete;
+    arena_resource& operator=(arena_resource const&) = delete;
+
+    ~arena_resource()
+    {
+        release();
+    }
+
+    //!frees all memory handed out, buffers still using it must not be touched anymore
+    void release()
+    {
+        while (chunks != nullptr)
+        {
+            chunk* const next = chunks->next;
+            upstream->deallocate(chunks, chunks->size, chunks->alignment);
+            chunks = next;
+        }
+        current = nullptr;
+        remaining = 0;
+        allocated = 0;
+        next_size = first_size;
+    }
+
+    //!bytes handed out since construction or the last release
+    std::size_t bytes_allocated() const
+    {
+        return allocated;
+    }
+
+    memory_resource* upstream_resource() const
+    {
+        return upstream;
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        std::size_t const padding =
+            (alignment - reinterpret_cast<std::uintptr_t>(current) % alignment) % alignment;
+        if (current != nullptr && padding + bytes <= remaining)
+        {
+            void* const result = current + padding;
+            current += padding + bytes;
+            remaining -= padding + bytes;
+            allocated += bytes;
+            return result;
+        }
+
+        std::size_t const header = (sizeof(chunk) + alignment - 1) / alignment * alignment;
+        if (header + bytes > next_size)
+        {
+            //oversized, the current chunk stays in use for the requests that follow
+            char* const dedicated = add_chunk(header + bytes, alignment);
+            allocated += bytes;
+            return dedicated + header;
+        }
+
+        char* const fresh = add_chunk(next_size, alignment);
+        current = fresh + header + bytes;
+        remaining = next_size - header - bytes;
+        next_size *= 2;
+        allocated += bytes;
+        return fresh + header;
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+private:
+    //!chunk of size bytes from upstream, linked for release
+    char* add_chunk(std::size_t size, std::size_t alignment)
+    {
+        std::size_t const chunk_alignment = alignment < alignof(std::max_align_t) ?
+            alignof(std::max_align_t) : alignment;
+        chunk* const fresh = static_cast<chunk*>(upstream->allocate(size, chunk_alignment));
+        fresh->next = chunks;
+        fresh->size = size;
+        fresh->alignment = chunk_alignment;
+        chunks = fresh;
+        return reinterpret_cast<char*>(fresh);
+    }
+};
+
+/*!
+allocator forwarding to a memory_resource, see std::pmr::polymorphic_allocator. copies of a
+container take the default resource of the copying thread, not the resource of the source
+*/
+template <typename T>
+struct polymorphic_allocator
+{
+private:
+    memory_resource* resource_;
+
+public:
+    typedef T value_type;
+
+    polymorphic_allocator() noexcept : resource_(get_default_resource()) {}
+
+    polymorphic_allocator(memory_resource* resource) noexcept : resource_(resource) {}
+
+    template <typename U>
+    polymorphic_allocator(polymorphic_allocator<U> const& other) noexcept
+        : resource_(other.resource())
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        resource_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    polymorphic_allocator select_on_container_copy_construction() const
+    {
+        return polymorphic_allocator();
+    }
+
+    memory_resource* resource() const
+    {
+        return resource_;
+    }
+};
+
+template <typename T, typename U>
+bool operator==(polymorphic_allocator<T> const& a, polymorphic_allocator<U> const& b)
+{
+    return a.resource() == b.resource() || a.resource()->is_equal(*b.resource());
+}
+
+template <typename T, typename U>
+bool operator!=(polymorphic_allocator<T> const& a, polymorphic_allocator<U> const& b)
+{
+    return !(a == b);
+}
+
+//!vector allocating from a memory_resource, the storage of pixels, columns and table data
+template <typename T>
+using resource_vector = std::vector<T, polymorphic_allocator<T>>;
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_MEMORY_RESOURCE_HPP
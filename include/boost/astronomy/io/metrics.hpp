@@ -0,0 +1,346 @@
+#ifndef BOOST_ASTRONOMY_IO_METRICS_HPP
+#define BOOST_ASTRONOMY_IO_METRICS_HPP
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <istream>
+#include <streambuf>
+
+/*!
+instrumentation of the io layer. fits handles count the bytes, reads and seeks of their
+source, every hdu counts the cards it parsed and the time spent parsing its header, decoding
+its pixels and decoding its columns, and all of it adds up in process wide aggregates
+(io_metrics). defining BOOST_ASTRONOMY_IO_DISABLE_METRICS removes the counting at compile
+time, the accessors then report zeros
+*/
+
+namespace boost { namespace astronomy { namespace io {
+
+//!values of the io counters at one point in time
+struct io_counters
+{
+    std::uint64_t bytes_read = 0;       //! bytes read from the source of a fits handle
+    std::uint64_t read_requests = 0;    //! reads the readers requested from that source (each
+                                        //! get or read counts, whether or not the buffer of
+                                        //! the source had to refill)
+    std::uint64_t seeks = 0;            //! seeks on that source, position queries excluded
+    std::uint64_t cards_parsed = 0;     //! header cards parsed
+    std::uint64_t header_parse_ns = 0;  //! time spent reading and parsing headers
+    std::uint64_t pixel_decode_ns = 0;  //! time spent reading and decoding image data units
+    std::uint64_t column_decode_ns = 0; //! time spent decoding table columns
+
+    io_counters& operator+=(io_counters const& other)
+    {
+        bytes_read += other.bytes_read;
+        read_requests += other.read_requests;
+        seeks += other.seeks;
+        cards_parsed += other.cards_parsed;
+        header_parse_ns += other.header_parse_ns;
+        pixel_decode_ns += other.pixel_decode_ns;
+        column_decode_ns += other.column_decode_ns;
+        return *this;
+    }
+};
+
+namespace detail {
+
+enum class io_metric
+{
+    bytes_read,
+    read_requests,
+    seeks,
+    cards_parsed,
+    header_parse_ns,
+    pixel_decode_ns,
+    column_decode_ns
+};
+
+#ifndef BOOST_ASTRONOMY_IO_DISABLE_METRICS
+
+//!relaxed atomic counter that can be copied, copies take the current value
+struct relaxed_counter
+{
+    std::atomic<std::uint64_t> value;
+
+    relaxed_counter() : value(0) {}
+
+    relaxed_counter(relaxed_counter const& other) : value(other.get()) {}
+
+    relaxed_counter& operator=(relaxed_counter const& other)
+    {
+        value.store(other.get(), std::memory_order_relaxed);
+        return *this;
+    }
+
+    void add(std::uint64_t amount)
+    {
+        value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    std::uint64_t get() const
+    {
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+//!io counters updated concurrently
+struct atomic_counters
+{
+    relaxed_counter counters[7];
+
+    void add(io_metric which, std::uint64_t amount)
+    {
+        counters[static_cast<int>(which)].add(amount);
+    }
+
+    void add(io_counters const& values)
+    {
+        add(io_metric::bytes_read, values.bytes_read);
+        add(io_metric::read_requests, values.read_requests);
+        add(io_metric::seeks, values.seeks);
+        add(io_metric::cards_parsed, values.cards_parsed);
+        add(io_metric::header_parse_ns, values.header_parse_ns);
+        add(io_metric::pixel_decode_ns, values.pixel_decode_ns);
+        add(io_metric::column_decode_ns, values.column_decode_ns);
+    }
+
+    io_counters snapshot() const
+    {
+        io_counters result;
+        result.bytes_read = counters[0].get();
+        result.read_requests = counters[1].get();
+        result.seeks = counters[2].get();
+        result.cards_parsed = counters[3].get();
+        result.header_parse_ns = counters[4].get();
+        result.pixel_decode_ns = counters[5].get();
+        result.column_decode_ns = counters[6].get();
+        return result;
+    }
+
+    void reset()
+    {
+        for (auto& c : counters)
+        {
+            c.value.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+inline atomic_counters& global_counters()
+{
+    static atomic_counters counters;
+    return counters;
+}
+
+//!adds amount to a counter of an object and to the process wide aggregate
+inline void record(atomic_counters& local, io_metric which, std::uint64_t amount)
+{
+    local.add(which, amount);
+    global_counters().add(which, amount);
+}
+
+//!records the time from its construction to its destruction
+struct scoped_timer
+{
+private:
+    atomic_counters& local;
+    io_metric which;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    scoped_timer(atomic_counters& counters, io_metric metric)
+        : local(counters), which(metric), start(std::chrono::steady_clock::now())
+    {}
+
+    scoped_timer(scoped_timer const&) = delete;
+    scoped_timer& operator=(scoped_timer const&) = delete;
+
+    ~scoped_timer()
+    {
+        record(local, which, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count()));
+    }
+};
+
+#else
+
+struct atomic_counters
+{
+    void add(io_metric, std::uint64_t) {}
+    void add(io_counters const&) {}
+    io_counters snapshot() const { return io_counters(); }
+    void reset() {}
+};
+
+inline atomic_counters& global_counters()
+{
+    static atomic_counters counters;
+    return counters;
+}
+
+inline void record(atomic_counters&, io_metric, std::uint64_t) {}
+
+struct scoped_timer
+{
+    scoped_timer(atomic_counters&, io_metric) {}
+};
+
+#endif // !BOOST_ASTRONOMY_IO_DISABLE_METRICS
+
+/*!
+stream buffer forwarding to the buffer of another stream and counting the bytes, reads and
+seeks requested from it. tellg (a seek by 0 from the current position) is not a seek. it has no buffer of its own, so the position of the source is
+always the position of the metered stream
+*/
+struct metered_streambuf : public std::streambuf
+{
+private:
+    std::streambuf* source = nullptr;
+    io_counters counts;
+
+public:
+    void attach(std::streambuf* buffer)
+    {
+        source = buffer;
+    }
+
+    std::streambuf* attached() const
+    {
+        return source;
+    }
+
+    //!bytes, reads and seeks counted so far
+    io_counters const& counters() const
+    {
+        return counts;
+    }
+
+protected:
+    int_type underflow() override
+    {
+        return source->sgetc();
+    }
+
+    int_type uflow() override
+    {
+        int_type const c = source->sbumpc();
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            counts.read_requests++;
+            counts.bytes_read++;
+        }
+        return c;
+    }
+
+    std::streamsize xsgetn(char* destination, std::streamsize count) override
+    {
+        std::streamsize const read = source->sgetn(destination, count);
+        counts.read_requests++;
+        counts.bytes_read += static_cast<std::uint64_t>(read);
+        return read;
+    }
+
+    std::streamsize showmanyc() override
+    {
+        return source->in_avail();
+    }
+
+    pos_type seekoff
+    (
+        off_type offset,
+        std::ios_base::seekdir direction,
+        std::ios_base::openmode which = std::ios_base::in
+    ) override
+    {
+        if (offset != 0 || direction != std::ios_base::cur)
+        {
+            counts.seeks++;
+        }
+        return source->pubseekoff(offset, direction, which);
+    }
+
+    pos_type seekpos(pos_type target, std::ios_base::openmode which = std::ios_base::in) override
+    {
+        counts.seeks++;
+        return source->pubseekpos(target, which);
+    }
+};
+
+//!input stream over a metered_streambuf, see fits::input
+struct metered_stream : public std::istream
+{
+private:
+    metered_streambuf buffer;
+    io_counters published; //! counts already added to the process wide aggregates
+
+public:
+    metered_stream() : std::istream(nullptr)
+    {
+        rdbuf(&buffer);
+    }
+
+    //!forwards to stream from now on, taking over its state when it is a different stream
+    void attach(std::istream& stream)
+    {
+        if (buffer.attached() != stream.rdbuf())
+        {
+            buffer.attach(stream.rdbuf());
+            clear(stream.rdstate());
+        }
+    }
+
+    //!forwards to no stream until the next attach
+    void detach()
+    {
+        buffer.attach(nullptr);
+    }
+
+    io_counters const& counters() const
+    {
+        return buffer.counters();
+    }
+
+    //!adds the counts since the last call to the process wide aggregates
+    void publish()
+    {
+        io_counters const& current = buffer.counters();
+        io_counters delta;
+        delta.bytes_read = current.bytes_read - published.bytes_read;
+        delta.read_requests = current.read_requests - published.read_requests;
+        delta.seeks = current.seeks - published.seeks;
+        global_counters().add(delta);
+        published = current;
+    }
+};
+
+} //namespace detail
+
+//!process wide aggregates of the io counters of all fits handles and hdus
+struct io_metrics
+{
+    //!false when the counting is compiled out
+    static bool enabled()
+    {
+#ifndef BOOST_ASTRONOMY_IO_DISABLE_METRICS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static io_counters snapshot()
+    {
+        return detail::global_counters().snapshot();
+    }
+
+    static void reset()
+    {
+        detail::global_counters().reset();
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_METRICS_HPP
@@ -0,0 +1,454 @@
+#ifndef BOOST_ASTRONOMY_IO_PIXEL_CONVERSION_HPP
+#define BOOST_ASTRONOMY_IO_PIXEL_CONVERSION_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <boost/config.hpp>
+#include <boost/endian/conversion.hpp>
+
+#include <boost/astronomy/detail/parallel_for.hpp>
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/image.hpp>
+
+/*!
+conversion of pixels between the BITPIX types (and IEEE half precision) with explicit
+rounding, saturation and BSCALE/BZERO re-quantization. the kernels are branch free loops over
+contiguous pixels that the compiler vectorizes; the rounding mode and saturation are template
+parameters chosen once per call, not per pixel
+*/
+
+namespace boost { namespace astronomy { namespace io {
+
+//!IEEE 754 half precision value, stored as its bits
+struct float16
+{
+    std::uint16_t bits;
+
+    float16() = default;
+
+    //!rounds to the nearest half precision value, ties to even
+    explicit float16(float value);
+
+    explicit operator float() const;
+
+    static float16 from_bits(std::uint16_t raw)
+    {
+        float16 result;
+        result.bits = raw;
+        return result;
+    }
+
+    //!largest finite value
+    static float highest()
+    {
+        return 65504.0f;
+    }
+};
+
+namespace detail {
+
+inline std::uint32_t float_bits(float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bits_float(std::uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+//!float to half, rounding to nearest even (after F. Giesen, float_to_half_fast3_rtne)
+inline std::uint16_t float_to_half(float value)
+{
+    std::uint32_t const infinity = 255u << 23;
+    std::uint32_t const half_max = (127u + 16u) << 23;
+    float const denormal_magic = bits_float(((127u - 15u) + (23u - 10u) + 1u) << 23);
+
+    std::uint32_t bits = float_bits(value);
+    std::uint32_t const sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    std::uint32_t result;
+    if (bits >= half_max)
+    {
+        result = bits > infinity ? 0x7E00u : 0x7C00u; //NaN stays NaN, overflow is infinite
+    }
+    else if (bits < (113u << 23))
+    {
+        //subnormal or zero, the addition rounds the mantissa into place
+        result = float_bits(bits_float(bits) + denormal_magic) - float_bits(denormal_magic);
+    }
+    else
+    {
+        std::uint32_t const odd = (bits >> 13) & 1u;
+        bits += (static_cast<std::uint32_t>(15 - 127) << 23) + 0xFFFu;
+        bits += odd;
+        result = bits >> 13;
+    }
+    return static_cast<std::uint16_t>(result | (sign >> 16));
+}
+
+inline float half_to_float(std::uint16_t half)
+{
+    std::uint32_t const sign = static_cast<std::uint32_t>(half & 0x8000u) << 16;
+    std::uint32_t const exponent = (half >> 10) & 0x1Fu;
+    std::uint32_t const mantissa = half & 0x3FFu;
+
+    if (exponent == 0x1F)
+    {
+        return bits_float(sign | 0x7F800000u | (mantissa << 13));
+    }
+    if (exponent != 0)
+    {
+        return bits_float(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+    }
+    //zero or subnormal, mantissa * 2^-24
+    return bits_float(sign | float_bits(static_cast<float>(mantissa) * 5.9604644775390625e-8f));
+}
+
+} //namespace detail
+
+inline float16::float16(float value) : bits(detail::float_to_half(value)) {}
+
+inline float16::operator float() const
+{
+    return detail::half_to_float(bits);
+}
+
+//!how values between two integers are rounded when the target is an integer type
+enum class rounding
+{
+    nearest,     //! to the nearest integer, ties to even
+    toward_zero, //! truncation, as a C++ cast
+    down,        //! toward negative infinity
+    up           //! toward positive infinity
+};
+
+/*!
+physical values are zero + scale * pixel on both sides (BSCALE and BZERO). a target pixel is
+(source_zero + source_scale * pixel - target_zero) / target_scale, rounded and, when
+saturate is set, clamped to the range of the target type (NaN becomes 0 for integers).
+without saturation out of range values wrap around like a cast through std::int64_t
+*/
+struct conversion_options
+{
+    rounding mode = rounding::nearest;
+    bool saturate = true;
+    double source_scale = 1.0;
+    double source_zero = 0.0;
+    double target_scale = 1.0;
+    double target_zero = 0.0;
+};
+
+namespace detail {
+
+template <typename Type>
+struct pixel_traits
+{
+    typedef Type value_type;
+
+    static double lowest()
+    {
+        return static_cast<double>(std::numeric_limits<Type>::lowest());
+    }
+
+    static double highest()
+    {
+        return static_cast<double>(std::numeric_limits<Type>::max());
+    }
+
+    static double load(Type value)
+    {
+        return static_cast<double>(value);
+    }
+};
+
+template <>
+struct pixel_traits<float16>
+{
+    static double lowest()
+    {
+        return -static_cast<double>(float16::highest());
+    }
+
+    static double highest()
+    {
+        return static_cast<double>(float16::highest());
+    }
+
+    static double load(float16 value)
+    {
+        return static_cast<double>(half_to_float(value.bits));
+    }
+};
+
+/*!
+x limited to [low, high], NaN passes through. the quiet comparisons do not raise floating point
+exceptions, which lets the compiler turn the selections into vector blends
+*/
+inline double clamp_pixel(double x, double low, double high)
+{
+    x = std::isless(x, low) ? low : x;
+    return std::isgreater(x, high) ? high : x;
+}
+
+/*!
+x rounded to Integer, which holds every clamped x. the corrections of truncation stay in the
+integer domain so the loops remain free of branches
+*/
+template <rounding Mode, typename Integer>
+inline Integer round_pixel(double x)
+{
+    double const magic = 6755399441055744.0; //1.5 * 2^52, the sum drops the fraction
+    Integer const truncated = static_cast<Integer>(x);
+    switch (Mode)
+    {
+    case rounding::nearest:
+        return static_cast<Integer>((x + magic) - magic);
+    case rounding::toward_zero:
+        return truncated;
+    case rounding::down:
+        return truncated - static_cast<Integer>(std::isgreater(static_cast<double>(truncated), x));
+    case rounding::up:
+        return truncated + static_cast<Integer>(std::isless(static_cast<double>(truncated), x));
+    }
+    return truncated;
+}
+
+template <typename Target, rounding Mode, bool Saturate, bool Integer>
+struct pixel_store
+{
+    //!integer targets, NaN becomes 0
+    static Target store(double x, double low, double high)
+    {
+        x = std::isnan(x) ? 0.0 : x;
+        x = clamp_pixel(x, low, high);
+        typedef typename std::conditional<Saturate, std::int32_t, std::int64_t>::type integer;
+        return static_cast<Target>(round_pixel<Mode, integer>(x));
+    }
+};
+
+template <typename Target, rounding Mode, bool Saturate>
+struct pixel_store<Target, Mode, Saturate, false>
+{
+    //!floating point targets
+    static Target store(double x, double low, double high)
+    {
+        return static_cast<Target>(Saturate ? clamp_pixel(x, low, high) : x);
+    }
+};
+
+template <rounding Mode, bool Saturate>
+struct pixel_store<float16, Mode, Saturate, false>
+{
+    static float16 store(double x, double low, double high)
+    {
+        return float16(static_cast<float>(Saturate ? clamp_pixel(x, low, high) : x));
+    }
+};
+
+/*!
+the range arrives as arguments of a function that is not inlined: with the bounds known at
+compile time GCC moves the conversions into the branches of the selections and stops
+vectorizing the loop
+*/
+template <typename Source, typename Target, rounding Mode, bool Saturate>
+BOOST_NOINLINE void convert_kernel(Source const* in, Target* out, std::size_t count,
+    double scale, double offset, double low, double high)
+{
+    typedef pixel_store<Target, Mode, Saturate, std::is_integral<Target>::value> store;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        out[i] = store::store(pixel_traits<Source>::load(in[i]) * scale + offset, low, high);
+    }
+}
+
+template <typename Source, typename Target, rounding Mode>
+void convert_with_mode(Source const* in, Target* out, std::size_t count, double scale,
+    double offset, bool saturate)
+{
+    if (saturate)
+    {
+        convert_kernel<Source, Target, Mode, true>(in, out, count, scale, offset,
+            pixel_traits<Target>::lowest(), pixel_traits<Target>::highest());
+    }
+    else
+    {
+        //beyond 2^51 doubles are integral anyway and the wrapped bits meaningless
+        convert_kernel<Source, Target, Mode, false>(in, out, count, scale, offset,
+            -2251799813685248.0, 2251799813685248.0);
+    }
+}
+
+//!writes count pixels as big endian bytes to out
+template <typename Type>
+void native_to_big_bytes(Type const* pixels, std::size_t count, char* out)
+{
+    typedef typename std::conditional<sizeof(Type) == 8, std::uint64_t,
+        typename std::conditional<sizeof(Type) == 4, std::uint32_t,
+        typename std::conditional<sizeof(Type) == 2, std::uint16_t,
+        std::uint8_t>::type>::type>::type bits_type;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        bits_type bits;
+        std::memcpy(&bits, pixels + i, sizeof(bits));
+        bits = boost::endian::native_to_big(bits);
+        std::memcpy(out + i * sizeof(bits), &bits, sizeof(bits));
+    }
+}
+
+} //namespace detail
+
+//!converts count pixels from in to out, see conversion_options
+template <typename Source, typename Target>
+void convert_pixels(Source const* in, Target* out, std::size_t count,
+    conversion_options const& options = conversion_options())
+{
+    double const scale = options.source_scale / options.target_scale;
+    double const offset = (options.source_zero - options.target_zero) / options.target_scale;
+    switch (options.mode)
+    {
+    case rounding::nearest:
+        detail::convert_with_mode<Source, Target, rounding::nearest>(
+            in, out, count, scale, offset, options.saturate);
+        break;
+    case rounding::toward_zero:
+        detail::convert_with_mode<Source, Target, rounding::toward_zero>(
+            in, out, count, scale, offset, options.saturate);
+        break;
+    case rounding::down:
+        detail::convert_with_mode<Source, Target, rounding::down>(
+            in, out, count, scale, offset, options.saturate);
+        break;
+    case rounding::up:
+        detail::convert_with_mode<Source, Target, rounding::up>(
+            in, out, count, scale, offset, options.saturate);
+        break;
+    }
+}
+
+/*!
+sets target_scale and target_zero so that physical values in [low, high] use the whole range
+of Target, the usual re-quantization of float data to 8, 16 or 32 bit integers
+*/
+template <typename Target>
+void scale_to_fit(double low, double high, conversion_options& options)
+{
+    double const lowest = detail::pixel_traits<Target>::lowest();
+    double const highest = detail::pixel_traits<Target>::highest();
+    options.target_scale = high > low ? (high - low) / (highest - lowest) : 1.0;
+    options.target_zero = low - lowest * options.target_scale;
+}
+
+//!converts the pixels of in into out, resizing out, rows are split over threads (0: one per core)
+template <typename Source, typename Target>
+void convert_image(image_buffer<Source> const& in, image_buffer<Target>& out,
+    conversion_options const& options = conversion_options(), std::size_t threads = 1)
+{
+    if (out.get_width() != in.get_width() || out.get_height() != in.get_height())
+    {
+        out.resize(in.get_width(), in.get_height());
+    }
+    astronomy::detail::parallel_for(in.get_height(), threads,
+        [&](std::size_t begin, std::size_t end, std::size_t)
+        {
+            for (std::size_t y = begin; y < end; y++)
+            {
+                convert_pixels(in.row(y), out.row(y), in.get_width(), options);
+            }
+        });
+}
+
+//!returns the pixels of in converted to the pixel type of BITPIX Target
+template <bitpix Target, typename Source>
+image<Target> convert_image(image_buffer<Source> const& in,
+    conversion_options const& options = conversion_options(), std::size_t threads = 1)
+{
+    image<Target> result;
+    convert_image(in, result, options, threads);
+    return result;
+}
+
+/*!
+streaming stage: converts pixels chunk by chunk into a buffer of chunk pixels and hands every
+chunk to a sink, so a conversion feeding a writer holds one chunk, not a second image
+*/
+template <typename Source, typename Target>
+struct conversion_stage
+{
+private:
+    conversion_options options;
+    std::vector<Target> chunk;
+
+public:
+    explicit conversion_stage
+    (
+        conversion_options const& conversion = conversion_options(),
+        std::size_t chunk_pixels = 16384
+    )
+        : options(conversion), chunk(chunk_pixels != 0 ? chunk_pixels : 1)
+    {}
+
+    //!calls sink(Target const* pixels, std::size_t count) for consecutive chunks of in
+    template <typename Sink>
+    void operator()(Source const* in, std::size_t count, Sink&& sink)
+    {
+        while (count != 0)
+        {
+            std::size_t const size = count < chunk.size() ? count : chunk.size();
+            convert_pixels(in, chunk.data(), size, options);
+            sink(static_cast<Target const*>(chunk.data()), size);
+            in += size;
+            count -= size;
+        }
+    }
+};
+
+//!appends count pixels converted to Target, big endian, to the data unit of writer
+template <typename Target, typename Source>
+void write_converted(fits_writer& writer, Source const* pixels, std::size_t count,
+    conversion_options const& options = conversion_options(), std::size_t chunk_pixels = 16384)
+{
+    std::vector<char> bytes;
+    conversion_stage<Source, Target> stage(options, chunk_pixels);
+    stage(pixels, count, [&](Target const* converted, std::size_t size)
+    {
+        bytes.resize(size * sizeof(Target));
+        detail::native_to_big_bytes(converted, size, bytes.data());
+        writer.write_data(bytes.data(), bytes.size());
+    });
+}
+
+//!appends the rows of image converted to Target, big endian, to the data unit of writer
+template <typename Target, typename Source>
+void write_converted(fits_writer& writer, image_buffer<Source> const& image,
+    conversion_options const& options = conversion_options(), std::size_t chunk_pixels = 16384)
+{
+    std::vector<char> bytes;
+    conversion_stage<Source, Target> stage(options, chunk_pixels);
+    for (std::size_t y = 0; y < image.get_height(); y++)
+    {
+        stage(image.row(y), image.get_width(), [&](Target const* converted, std::size_t size)
+        {
+            bytes.resize(size * sizeof(Target));
+            detail::native_to_big_bytes(converted, size, bytes.data());
+            writer.write_data(bytes.data(), bytes.size());
+        });
+    }
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_PIXEL_CONVERSION_HPP
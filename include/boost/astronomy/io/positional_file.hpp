@@ -0,0 +1,305 @@
+#ifndef BOOST_ASTRONOMY_IO_POSITIONAL_FILE_HPP
+#define BOOST_ASTRONOMY_IO_POSITIONAL_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+
+#ifdef BOOST_HAS_UNISTD_H
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+#ifdef BOOST_HAS_UNISTD_H
+
+/*!
+read only file handle without a file position, every read names its offset (pread) so any
+number of threads can read the same open file concurrently without locking.
+copies share the descriptor, which is closed with the last copy if the handle owns it.
+only available where <unistd.h> is (POSIX platforms)
+*/
+struct positional_file
+{
+private:
+    struct descriptor
+    {
+        int value;
+        bool owned;
+
+        descriptor(int fd, bool owner) : value(fd), owned(owner) {}
+
+        descriptor(descriptor const&) = delete;
+        descriptor& operator=(descriptor const&) = delete;
+
+        ~descriptor()
+        {
+            if (owned)
+            {
+                ::close(value);
+            }
+        }
+    };
+
+    std::shared_ptr<descriptor const> handle;
+
+public:
+    positional_file() {}
+
+    explicit positional_file(std::string const& file_name)
+    {
+        int const fd = ::open(file_name.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw file_io_exception();
+        }
+        handle = std::make_shared<descriptor const>(fd, true);
+    }
+
+    /*!
+    handle over an open seekable descriptor (a file, a memfd, ...), closed with the last copy
+    only if take_ownership is set. use forward_stream (byte_source.hpp) for pipes and sockets
+    */
+    explicit positional_file(int fd, bool take_ownership = false)
+    {
+        if (fd < 0)
+        {
+            throw file_io_exception();
+        }
+        handle = std::make_shared<descriptor const>(fd, take_ownership);
+    }
+
+    bool is_open() const
+    {
+        return handle != nullptr;
+    }
+
+    int native_handle() const
+    {
+        return handle ? handle->value : -1;
+    }
+
+    //!current size of the file in bytes
+    std::uint64_t size() const
+    {
+        struct stat info;
+        if (!handle || ::fstat(handle->value, &info) != 0)
+        {
+            throw file_io_exception();
+        }
+        return static_cast<std::uint64_t>(info.st_size);
+    }
+
+    /*!
+    reads up to size bytes starting at offset into buffer, returns the number of bytes read
+    which is less than size only at the end of the file
+    */
+    std::size_t read_at(char* buffer, std::size_t size, std::uint64_t offset) const
+    {
+        if (!handle)
+        {
+            throw file_io_exception();
+        }
+
+        std::size_t done = 0;
+        while (done < size)
+        {
+            ssize_t const count = ::pread(handle->value, buffer + done, size - done,
+                static_cast<off_t>(offset + done));
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw file_io_exception();
+            }
+            if (count == 0)
+            {
+                break;
+            }
+            done += static_cast<std::size_t>(count);
+        }
+        return done;
+    }
+};
+
+#endif // BOOST_HAS_UNISTD_H
+
+/*!
+stream buffer reading a positional_file (or any File with the same size and read_at members)
+through a position and buffer of its own, so every reader (thread) uses a separate buffer
+over the shared handle. reads larger than the buffer go straight into the destination
+*/
+template <typename File>
+struct basic_positional_streambuf : public std::streambuf
+{
+private:
+    File file;
+    std::vector<char> buffer;
+    std::uint64_t buffer_offset = 0; //! file offset of the first buffered byte
+
+public:
+    explicit basic_positional_streambuf
+    (
+        File const& source,
+        std::uint64_t offset = 0,
+        std::size_t buffer_size = std::size_t(64) << 10
+    ) : file(source), buffer(std::max<std::size_t>(buffer_size, 1)), buffer_offset(offset)
+    {
+        setg(buffer.data(), buffer.data(), buffer.data());
+    }
+
+    basic_positional_streambuf(basic_positional_streambuf const&) = delete;
+    basic_positional_streambuf& operator=(basic_positional_streambuf const&) = delete;
+
+    //!file offset of the next byte to be read
+    std::uint64_t position() const
+    {
+        return buffer_offset + static_cast<std::uint64_t>(gptr() - eback());
+    }
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() < egptr())
+        {
+            return traits_type::to_int_type(*gptr());
+        }
+
+        buffer_offset = position();
+        std::size_t const count = file.read_at(buffer.data(), buffer.size(), buffer_offset);
+        setg(buffer.data(), buffer.data(), buffer.data() + count);
+        return count == 0 ? traits_type::eof() : traits_type::to_int_type(*gptr());
+    }
+
+    std::streamsize xsgetn(char* destination, std::streamsize count) override
+    {
+        std::streamsize done = 0;
+        while (done < count)
+        {
+            std::streamsize const buffered = std::min<std::streamsize>(egptr() - gptr(),
+                count - done);
+            if (buffered > 0)
+            {
+                std::memcpy(destination + done, gptr(), static_cast<std::size_t>(buffered));
+                gbump(static_cast<int>(buffered));
+                done += buffered;
+                continue;
+            }
+
+            std::size_t const wanted = static_cast<std::size_t>(count - done);
+            if (wanted >= buffer.size())
+            {
+                std::uint64_t const offset = position();
+                std::size_t const read = file.read_at(destination + done, wanted, offset);
+                buffer_offset = offset + read;
+                setg(buffer.data(), buffer.data(), buffer.data());
+                return done + static_cast<std::streamsize>(read);
+            }
+            if (traits_type::eq_int_type(underflow(), traits_type::eof()))
+            {
+                break;
+            }
+        }
+        return done;
+    }
+
+    std::streamsize showmanyc() override
+    {
+        std::uint64_t const size = file.size();
+        std::uint64_t const current = position();
+        return current < size ? static_cast<std::streamsize>(size - current) : -1;
+    }
+
+    pos_type seekoff
+    (
+        off_type offset,
+        std::ios_base::seekdir direction,
+        std::ios_base::openmode which = std::ios_base::in
+    ) override
+    {
+        if (!(which & std::ios_base::in))
+        {
+            return pos_type(off_type(-1));
+        }
+
+        off_type base = 0;
+        if (direction == std::ios_base::cur)
+        {
+            base = static_cast<off_type>(position());
+        }
+        else if (direction == std::ios_base::end)
+        {
+            base = static_cast<off_type>(file.size());
+        }
+
+        off_type const target = base + offset;
+        if (target < 0)
+        {
+            return pos_type(off_type(-1));
+        }
+
+        std::uint64_t const next = static_cast<std::uint64_t>(target);
+        if (next >= buffer_offset &&
+            next <= buffer_offset + static_cast<std::uint64_t>(egptr() - eback()))
+        {
+            setg(eback(), eback() + (next - buffer_offset), egptr());
+        }
+        else
+        {
+            buffer_offset = next;
+            setg(buffer.data(), buffer.data(), buffer.data());
+        }
+        return pos_type(target);
+    }
+
+    pos_type seekpos(pos_type target, std::ios_base::openmode which = std::ios_base::in) override
+    {
+        return seekoff(off_type(target), std::ios_base::beg, which);
+    }
+};
+
+/*!
+input stream over a positional_file, accepted by every reader taking a std::istream (hdu,
+tables, images, fits, ...). create one per thread, all of them can share one positional_file
+*/
+template <typename File>
+struct basic_positional_stream : public std::istream
+{
+private:
+    basic_positional_streambuf<File> buffer;
+
+public:
+    explicit basic_positional_stream
+    (
+        File const& file,
+        std::uint64_t offset = 0,
+        std::size_t buffer_size = std::size_t(64) << 10
+    ) : std::istream(nullptr), buffer(file, offset, buffer_size)
+    {
+        rdbuf(&buffer);
+    }
+};
+
+#ifdef BOOST_HAS_UNISTD_H
+typedef basic_positional_streambuf<positional_file> positional_streambuf;
+typedef basic_positional_stream<positional_file> positional_stream;
+#endif
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_POSITIONAL_FILE_HPP
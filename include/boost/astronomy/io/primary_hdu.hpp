@@ -5,8 +5,10 @@
 #include <string>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 #include <valarray>
 #include <fstream>
+#include <istream>
 
 #include <boost/astronomy/io/hdu.hpp>
 #include <boost/astronomy/io/image.hpp>
@@ -25,12 +27,13 @@ public:
     primary_hdu() {}
 
     //!This constructore should be used when file is never read and boost::astronomy::io::hdu object is not created of the file
-    primary_hdu(std::fstream &file) : hdu(file)
+    primary_hdu(std::istream &file) : hdu(file)
     {
         simple = this->value_of<bool>("SIMPLE");
         extend = this->value_of<bool>("EXTEND");
 
         //read image according to dimension specified by naxis
+        detail::scoped_timer timer(this->metrics_, detail::io_metric::pixel_decode_ns);
         switch (this->naxis())
         {
         case 0:
@@ -51,12 +54,13 @@ public:
     }
 
     //!This constructore should be used when boost::astronomy::io::hdu object already exist for the file 
-    primary_hdu(std::fstream &file, hdu const& other) : hdu(other)
+    primary_hdu(std::istream &file, hdu const& other) : hdu(other)
     {
         simple = this->value_of<bool>("SIMPLE");
         extend = this->value_of<bool>("EXTEND");
 
         //read image according to dimension specified by naxis
+        detail::scoped_timer timer(this->metrics_, detail::io_metric::pixel_decode_ns);
         switch (this->naxis())
         {
         case 0:
@@ -82,6 +86,12 @@ public:
         return this->data;
     }
 
+    //!checksum of the data unit computed while it was read, see hdu::verify_checksums
+    std::uint32_t data_checksum() const
+    {
+        return this->data.read_checksum();
+    }
+
     //!value of SIMPLE 
     bool is_simple() const
     {
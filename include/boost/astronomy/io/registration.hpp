@@ -0,0 +1,450 @@
+#ifndef BOOST_ASTRONOMY_IO_REGISTRATION_HPP
+#define BOOST_ASTRONOMY_IO_REGISTRATION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <boost/astronomy/detail/parallel_for.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+#include <boost/astronomy/io/fft.hpp>
+#include <boost/astronomy/io/image.hpp>
+
+/*!
+translation between exposures by phase correlation. the normalized cross power spectrum of two
+hann windowed images transforms back to a peak at their shift, refined below a pixel on a
+finer grid around it.
+
+both images are reduced to a pyramid of 2 x 2 means. the coarsest level is correlated whole,
+which finds shifts up to half the image; every finer level doubles the estimate and corrects it
+from a window at the centre of the reference and the window at the estimated position in the
+other image, so the full resolution frame is never transformed whole. the reference keeps the
+spectra of its windows, registering many frames against it transforms only the frames
+*/
+
+namespace boost { namespace astronomy { namespace io {
+
+struct registration_options
+{
+    std::size_t levels = 0;   //! pyramid levels below full size, 0 halves while above 256 pixels
+    std::size_t window = 128; //! side of the windows refining the shift on finer levels
+    std::size_t threads = 1;  //! threads of a transform, or of the frames of a batch; 0: per core
+};
+
+//!image(y, x) matches reference(y - y_shift, x - x_shift), peak near 1 for a clean match
+struct image_shift
+{
+    double x = 0;
+    double y = 0;
+    double peak = 0;
+};
+
+namespace detail {
+
+template <typename PixelType>
+image_buffer<double> pixels_as_double(image_buffer<PixelType> const& image)
+{
+    image_buffer<double> result(image.get_width(), image.get_height());
+    for (std::size_t y = 0; y < image.get_height(); y++)
+    {
+        PixelType const* row = image.row(y);
+        double* target = result.row(y);
+        for (std::size_t x = 0; x < image.get_width(); x++)
+        {
+            target[x] = static_cast<double>(row[x]);
+        }
+    }
+    return result;
+}
+
+//!mean of every 2 x 2 block, an odd last row or column is dropped
+inline image_buffer<double> half_size(image_buffer<double> const& image)
+{
+    image_buffer<double> result(image.get_width() / 2, image.get_height() / 2);
+    for (std::size_t y = 0; y < result.get_height(); y++)
+    {
+        double const* upper = image.row(2 * y);
+        double const* lower = image.row(2 * y + 1);
+        double* target = result.row(y);
+        for (std::size_t x = 0; x < result.get_width(); x++)
+        {
+            target[x] = 0.25 * (upper[2 * x] + upper[2 * x + 1] + lower[2 * x] + lower[2 * x + 1]);
+        }
+    }
+    return result;
+}
+
+//!image and its levels, each half the size of the one before
+template <typename PixelType>
+std::vector<image_buffer<double>> image_pyramid(image_buffer<PixelType> const& image,
+    std::size_t levels)
+{
+    std::vector<image_buffer<double>> pyramid;
+    pyramid.push_back(pixels_as_double(image));
+    for (std::size_t level = 0; level < levels; level++)
+    {
+        pyramid.push_back(half_size(pyramid.back()));
+    }
+    return pyramid;
+}
+
+inline std::size_t pyramid_levels(std::size_t width, std::size_t height,
+    registration_options const& options)
+{
+    if (options.levels != 0)
+    {
+        std::size_t levels = 0;
+        while (levels < options.levels && width >= 16 && height >= 16)
+        {
+            width /= 2;
+            height /= 2;
+            levels++;
+        }
+        return levels;
+    }
+    std::size_t levels = 0;
+    while (std::max(width, height) > 256 && std::min(width, height) >= 64)
+    {
+        width /= 2;
+        height /= 2;
+        levels++;
+    }
+    return levels;
+}
+
+inline std::vector<double> hann_window(std::size_t size)
+{
+    double const pi = 3.14159265358979323846;
+    std::vector<double> window(size, 1.0);
+    for (std::size_t i = 0; size > 1 && i < size; i++)
+    {
+        window[i] = 0.5 - 0.5 * std::cos(2 * pi * static_cast<double>(i) /
+            static_cast<double>(size - 1));
+    }
+    return window;
+}
+
+//!rectangle of the windows correlated on one level
+struct registration_window
+{
+    std::size_t x;
+    std::size_t y;
+    std::size_t width;
+    std::size_t height;
+};
+
+//!spectrum of the window of image, less its mean and tapered by the hann window
+inline image_spectrum window_spectrum(image_buffer<double> const& image,
+    registration_window const& window, std::vector<double> const& taper_x,
+    std::vector<double> const& taper_y, std::size_t threads)
+{
+    double mean = 0;
+    for (std::size_t y = 0; y < window.height; y++)
+    {
+        double const* row = image.row(window.y + y) + window.x;
+        for (std::size_t x = 0; x < window.width; x++)
+        {
+            mean += row[x];
+        }
+    }
+    mean /= static_cast<double>(window.width * window.height);
+
+    image_buffer<double> tapered(window.width, window.height);
+    for (std::size_t y = 0; y < window.height; y++)
+    {
+        double const* row = image.row(window.y + y) + window.x;
+        double* target = tapered.row(y);
+        for (std::size_t x = 0; x < window.width; x++)
+        {
+            target[x] = (row[x] - mean) * taper_x[x] * taper_y[y];
+        }
+    }
+    return fft_2d(tapered, threads);
+}
+
+//!signed offset of index i of n, indices past the middle are negative
+inline double wrapped_offset(std::size_t i, std::size_t n)
+{
+    return i > n / 2 ? static_cast<double>(i) - static_cast<double>(n) : static_cast<double>(i);
+}
+
+//!steps per pixel of the grid the peak is refined on
+inline std::size_t peak_upsampling()
+{
+    return 16;
+}
+
+/*!
+the correlation surface near (x, y) sampled peak_upsampling() times finer than a pixel by a
+direct inverse DFT of the cross power spectrum, evaluated as two small matrix products
+(after Guizar-Sicairos et al.); returns the refined position of its maximum
+*/
+inline std::pair<double, double> refine_peak(image_spectrum const& cross, double x, double y)
+{
+    double const pi = 3.14159265358979323846;
+    std::size_t const width = cross.get_width();
+    std::size_t const height = cross.get_height();
+    std::size_t const steps = peak_upsampling();
+    std::size_t const samples = 2 * steps + 1;
+    auto const grid = [&](std::size_t i)
+    {
+        return (static_cast<double>(i) - static_cast<double>(steps)) / static_cast<double>(steps);
+    };
+
+    //partial sums over the horizontal frequencies, the missing half by conjugate symmetry
+    std::vector<std::complex<double>> partial(height * samples);
+    for (std::size_t j = 0; j < samples; j++)
+    {
+        double const position = x + grid(j);
+        for (std::size_t u = 0; u < cross.columns(); u++)
+        {
+            double const weight = u == 0 || 2 * u == width ? 1.0 : 2.0;
+            std::complex<double> const turn = weight * std::polar(1.0,
+                2 * pi * static_cast<double>(u) * position / static_cast<double>(width));
+            for (std::size_t v = 0; v < height; v++)
+            {
+                partial[v * samples + j] += multiply(cross(v, u), turn);
+            }
+        }
+    }
+
+    double best = -1e300;
+    std::size_t best_i = steps;
+    std::size_t best_j = steps;
+    std::vector<double> surface(samples * samples);
+    for (std::size_t i = 0; i < samples; i++)
+    {
+        double const position = y + grid(i);
+        std::vector<std::complex<double>> turns(height);
+        for (std::size_t v = 0; v < height; v++)
+        {
+            turns[v] = std::polar(1.0,
+                2 * pi * wrapped_offset(v, height) * position / static_cast<double>(height));
+        }
+        for (std::size_t j = 0; j < samples; j++)
+        {
+            double sum = 0;
+            for (std::size_t v = 0; v < height; v++)
+            {
+                sum += multiply(partial[v * samples + j], turns[v]).real();
+            }
+            surface[i * samples + j] = sum;
+            if (sum > best)
+            {
+                best = sum;
+                best_i = i;
+                best_j = j;
+            }
+        }
+    }
+
+    //a parabola through the finest samples for the last fraction of a step
+    auto const vertex = [](double before, double at, double after)
+    {
+        double const curvature = before - 2 * at + after;
+        return curvature < 0 ? std::max(-0.5, std::min(0.5, 0.5 * (before - after) / curvature))
+            : 0.0;
+    };
+    double refined_x = grid(best_j);
+    double refined_y = grid(best_i);
+    if (best_j > 0 && best_j + 1 < samples)
+    {
+        refined_x += vertex(surface[best_i * samples + best_j - 1], best,
+            surface[best_i * samples + best_j + 1]) / static_cast<double>(steps);
+    }
+    if (best_i > 0 && best_i + 1 < samples)
+    {
+        refined_y += vertex(surface[(best_i - 1) * samples + best_j], best,
+            surface[(best_i + 1) * samples + best_j]) / static_cast<double>(steps);
+    }
+    return std::make_pair(x + refined_x, y + refined_y);
+}
+
+//!shift of moving against reference from the peak of their normalized cross power spectrum
+inline image_shift correlation_peak(image_spectrum const& reference, image_spectrum moving,
+    std::size_t threads)
+{
+    std::size_t const width = moving.get_width();
+    std::size_t const height = moving.get_height();
+    for (std::size_t v = 0; v < height; v++)
+    {
+        for (std::size_t u = 0; u < moving.columns(); u++)
+        {
+            std::complex<double> const cross = multiply(moving(v, u), std::conj(reference(v, u)));
+            double const magnitude = std::abs(cross);
+            moving(v, u) = magnitude > 1e-300 ? cross / magnitude : std::complex<double>();
+        }
+    }
+    image_buffer<double> surface;
+    inverse_fft_2d(moving, surface, threads);
+
+    std::size_t peak_x = 0;
+    std::size_t peak_y = 0;
+    for (std::size_t y = 0; y < height; y++)
+    {
+        double const* row = surface.row(y);
+        for (std::size_t x = 0; x < width; x++)
+        {
+            if (row[x] > surface(peak_y, peak_x))
+            {
+                peak_x = x;
+                peak_y = y;
+            }
+        }
+    }
+
+    auto const refined = refine_peak(moving, wrapped_offset(peak_x, width),
+        wrapped_offset(peak_y, height));
+    image_shift shift;
+    shift.x = refined.first;
+    shift.y = refined.second;
+    shift.peak = surface(peak_y, peak_x) / static_cast<double>(width * height);
+    return shift;
+}
+
+} //namespace detail
+
+/*!
+a reference frame prepared for registration: its pyramid windows, their tapers and spectra.
+measuring is const and may run concurrently for different frames
+*/
+struct registration_reference
+{
+private:
+    struct level
+    {
+        detail::registration_window window;
+        std::vector<double> taper_x;
+        std::vector<double> taper_y;
+        image_spectrum spectrum;
+    };
+
+    registration_options options_;
+    std::size_t width_;
+    std::size_t height_;
+    std::vector<level> levels; //! full size first
+
+    template <typename PixelType>
+    image_shift measure(image_buffer<PixelType> const& image, std::size_t threads) const
+    {
+        if (image.get_width() != width_ || image.get_height() != height_)
+        {
+            throw image_size_mismatch_exception();
+        }
+        if (levels.empty())
+        {
+            return image_shift();
+        }
+
+        auto const pyramid = detail::image_pyramid(image, levels.size() - 1);
+        image_shift estimate;
+        for (std::size_t l = levels.size(); l-- > 0;)
+        {
+            level const& reference = levels[l];
+            image_buffer<double> const& moving = pyramid[l];
+
+            //the window of the moving image sits at the estimated shift, kept inside the image
+            detail::registration_window window = reference.window;
+            std::ptrdiff_t const dx = static_cast<std::ptrdiff_t>(std::floor(2 * estimate.x + 0.5));
+            std::ptrdiff_t const dy = static_cast<std::ptrdiff_t>(std::floor(2 * estimate.y + 0.5));
+            auto const place = [](std::size_t origin, std::ptrdiff_t offset, std::size_t free)
+            {
+                std::ptrdiff_t const position = static_cast<std::ptrdiff_t>(origin) + offset;
+                return static_cast<std::size_t>(std::max<std::ptrdiff_t>(0,
+                    std::min<std::ptrdiff_t>(position, static_cast<std::ptrdiff_t>(free))));
+            };
+            if (l + 1 < levels.size())
+            {
+                window.x = place(window.x, dx, moving.get_width() - window.width);
+                window.y = place(window.y, dy, moving.get_height() - window.height);
+            }
+
+            image_shift const residual = detail::correlation_peak(reference.spectrum,
+                detail::window_spectrum(moving, window, reference.taper_x, reference.taper_y,
+                    threads),
+                threads);
+            estimate.x = static_cast<double>(window.x) - static_cast<double>(reference.window.x) +
+                residual.x;
+            estimate.y = static_cast<double>(window.y) - static_cast<double>(reference.window.y) +
+                residual.y;
+            estimate.peak = residual.peak;
+        }
+        return estimate;
+    }
+
+public:
+    template <typename PixelType>
+    explicit registration_reference(image_buffer<PixelType> const& reference,
+        registration_options const& options = registration_options())
+        : options_(options), width_(reference.get_width()), height_(reference.get_height())
+    {
+        if (width_ == 0 || height_ == 0)
+        {
+            return;
+        }
+
+        std::size_t const count = detail::pyramid_levels(width_, height_, options);
+        auto const pyramid = detail::image_pyramid(reference, count);
+        levels.resize(count + 1);
+        for (std::size_t l = 0; l <= count; l++)
+        {
+            image_buffer<double> const& image = pyramid[l];
+            level& current = levels[l];
+            //the coarsest level is correlated whole, the others through a centred window
+            std::size_t const side = options.window != 0 ? options.window : 128;
+            current.window.width = l == count ? image.get_width() : std::min(side, image.get_width());
+            current.window.height = l == count ? image.get_height()
+                : std::min(side, image.get_height());
+            current.window.x = (image.get_width() - current.window.width) / 2;
+            current.window.y = (image.get_height() - current.window.height) / 2;
+            current.taper_x = detail::hann_window(current.window.width);
+            current.taper_y = detail::hann_window(current.window.height);
+            current.spectrum = detail::window_spectrum(image, current.window, current.taper_x,
+                current.taper_y, options.threads);
+        }
+    }
+
+    registration_options const& options() const
+    {
+        return options_;
+    }
+
+    //!shift of image against the reference, transforms use options().threads
+    template <typename PixelType>
+    image_shift measure(image_buffer<PixelType> const& image) const
+    {
+        return measure(image, options_.threads);
+    }
+
+    //!shifts of a container of images, the frames split over options().threads
+    template <typename Images>
+    std::vector<image_shift> measure_all(Images const& images) const
+    {
+        std::vector<image_shift> shifts(images.size());
+        astronomy::detail::parallel_for(images.size(), options_.threads,
+            [&](std::size_t begin, std::size_t end, std::size_t)
+            {
+                for (std::size_t i = begin; i < end; i++)
+                {
+                    shifts[i] = measure(images[i], 1);
+                }
+            });
+        return shifts;
+    }
+};
+
+//!shift of image against reference
+template <typename ReferenceType, typename PixelType>
+image_shift register_image(image_buffer<ReferenceType> const& reference,
+    image_buffer<PixelType> const& image,
+    registration_options const& options = registration_options())
+{
+    return registration_reference(reference, options).measure(image);
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_REGISTRATION_HPP
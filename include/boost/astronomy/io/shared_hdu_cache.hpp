@@ -0,0 +1,1139 @@
+#ifndef BOOST_ASTRONOMY_IO_SHARED_HDU_CACHE_HPP
+#define BOOST_ASTRONOMY_IO_SHARED_HDU_CACHE_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/config.hpp>
+
+//!the cache is built on POSIX shared memory (shm_open, mmap) and process shared mutexes
+#ifdef BOOST_HAS_UNISTD_H
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/io/column_decode.hpp>
+#include <boost/astronomy/io/column_view.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+/*!
+identity of a decoded HDU in the cache: the file (device, inode, size and modification time,
+so a rewritten file never matches entries of its old contents), the index of the HDU and a
+free form description of the decode options
+*/
+struct hdu_cache_key
+{
+private:
+    std::string text;
+
+public:
+    hdu_cache_key(std::string const& file, std::size_t hdu_index, std::string const& options = "")
+    {
+        struct stat info;
+        if (::stat(file.c_str(), &info) != 0)
+        {
+            throw file_io_exception();
+        }
+
+        //nanosecond modification times are st_mtimespec on macOS, only seconds are portable
+#if defined(__APPLE__)
+        std::string const modified = std::to_string(info.st_mtimespec.tv_sec) + "." +
+            std::to_string(info.st_mtimespec.tv_nsec);
+#elif defined(__linux__)
+        std::string const modified = std::to_string(info.st_mtim.tv_sec) + "." +
+            std::to_string(info.st_mtim.tv_nsec);
+#else
+        std::string const modified = std::to_string(info.st_mtime);
+#endif
+        text = std::to_string(info.st_dev) + ":" + std::to_string(info.st_ino) + ":" +
+            std::to_string(info.st_size) + ":" + modified + ":" + std::to_string(hdu_index) + ":" +
+            options;
+        if (text.size() >= 256)
+        {
+            throw invalid_cache_key_exception();
+        }
+    }
+
+    std::string const& str() const
+    {
+        return text;
+    }
+};
+
+/*!
+read only view of an array stored in the cache, rows of width elements are stored one after
+another. the view points into the shared mapping so the shared_hdu it came from must outlive it
+*/
+template <typename Type>
+struct shared_array
+{
+private:
+    Type const* values = nullptr;
+    std::size_t count = 0;
+    std::size_t columns = 0;
+    std::size_t lines = 0;
+
+public:
+    shared_array() {}
+
+    shared_array(Type const* first, std::size_t size, std::size_t width, std::size_t height)
+        : values(first), count(size), columns(width), lines(height) {}
+
+    std::size_t size() const
+    {
+        return this->count;
+    }
+
+    std::size_t width() const
+    {
+        return this->columns;
+    }
+
+    std::size_t height() const
+    {
+        return this->lines;
+    }
+
+    Type const* data() const
+    {
+        return this->values;
+    }
+
+    Type const* begin() const
+    {
+        return this->values;
+    }
+
+    Type const* end() const
+    {
+        return this->values + this->count;
+    }
+
+    Type const& operator[](std::size_t i) const
+    {
+        return this->values[i];
+    }
+
+    //!element in given row and column
+    Type const& at(std::size_t row, std::size_t column) const
+    {
+        return this->values[row * this->columns + column];
+    }
+};
+
+//!row of a character array (a cached 'A' column) with trailing blanks removed
+inline std::string string_at(shared_array<char> const& text, std::size_t row)
+{
+    char const* field = text.data() + row * text.width();
+    std::size_t size = text.width();
+    while (size > 0 && (field[size - 1] == ' ' || field[size - 1] == '\0'))
+    {
+        size--;
+    }
+    return std::string(field, size);
+}
+
+namespace detail {
+
+template <typename Type> struct shared_type_code;
+template <> struct shared_type_code<char> { enum { value = 1 }; };
+template <> struct shared_type_code<std::int8_t> { enum { value = 2 }; };
+template <> struct shared_type_code<std::uint8_t> { enum { value = 3 }; };
+template <> struct shared_type_code<std::int16_t> { enum { value = 4 }; };
+template <> struct shared_type_code<std::uint16_t> { enum { value = 5 }; };
+template <> struct shared_type_code<std::int32_t> { enum { value = 6 }; };
+template <> struct shared_type_code<std::uint32_t> { enum { value = 7 }; };
+template <> struct shared_type_code<std::int64_t> { enum { value = 8 }; };
+template <> struct shared_type_code<std::uint64_t> { enum { value = 9 }; };
+template <> struct shared_type_code<float> { enum { value = 10 }; };
+template <> struct shared_type_code<double> { enum { value = 11 }; };
+
+std::uint64_t const shared_segment_magic = 0x3147455355444824ULL;
+std::uint64_t const shared_directory_magic = 0x3152494455444824ULL;
+std::size_t const shared_alignment = 64;
+
+//!a segment starts with this header followed by one record per array and the array data
+struct shared_segment_header
+{
+    std::uint64_t magic;
+    std::uint64_t arrays;
+};
+
+struct shared_array_record
+{
+    char name[72];
+    std::uint32_t type;
+    std::uint32_t element_size;
+    std::uint64_t offset; //! from the start of the segment, multiple of shared_alignment
+    std::uint64_t count;
+    std::uint64_t width;
+    std::uint64_t height;
+};
+
+enum cache_slot_state : std::uint32_t
+{
+    slot_free = 0,
+    slot_building = 1,
+    slot_ready = 2
+};
+
+//!one cached HDU, all fields are guarded by the directory mutex
+struct cache_directory_entry
+{
+    std::uint32_t state;
+    std::uint32_t references;
+    std::int64_t builder;     //! process publishing the entry while building
+    std::uint64_t generation; //! makes segment names unique across reuse of the slot
+    std::uint64_t size;
+    std::uint64_t last_use;
+    char key[256];
+};
+
+struct cache_directory_header
+{
+    std::uint64_t magic;
+    std::atomic<std::uint32_t> ready; //! set once the creator has initialized the directory
+    pthread_mutex_t mutex;
+    std::uint64_t capacity;
+    std::uint64_t used;
+    std::uint64_t clock;
+    std::uint64_t generation;
+    std::uint64_t slots;
+};
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "directory needs address free atomics");
+
+//!memory mapping released on destruction
+struct memory_mapping
+{
+    void* address = MAP_FAILED;
+    std::size_t size = 0;
+
+    memory_mapping(void* start, std::size_t length) : address(start), size(length) {}
+
+    memory_mapping(memory_mapping const&) = delete;
+    memory_mapping& operator=(memory_mapping const&) = delete;
+
+    ~memory_mapping()
+    {
+        if (address != MAP_FAILED)
+        {
+            ::munmap(address, size);
+        }
+    }
+
+    char const* data() const
+    {
+        return static_cast<char const*>(address);
+    }
+};
+
+//!maps size bytes of the shared memory object opened as descriptor, which is closed
+inline std::unique_ptr<memory_mapping> map_shared(int descriptor, std::size_t size, bool writable)
+{
+    void* address = ::mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+        MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if (address == MAP_FAILED)
+    {
+        throw shared_memory_exception();
+    }
+    return std::unique_ptr<memory_mapping>(new memory_mapping(address, size));
+}
+
+/*!
+holds the directory mutex, recovering it when its previous owner died. macOS has no robust
+mutexes, there a process dying while it holds the lock blocks the cache until it is removed
+*/
+struct directory_lock
+{
+private:
+    pthread_mutex_t* mutex;
+
+public:
+    explicit directory_lock(pthread_mutex_t* locked) : mutex(locked)
+    {
+        int const status = ::pthread_mutex_lock(mutex);
+#ifndef __APPLE__
+        if (status == EOWNERDEAD)
+        {
+            ::pthread_mutex_consistent(mutex);
+        }
+        else
+#endif
+        if (status != 0)
+        {
+            throw shared_memory_exception();
+        }
+    }
+
+    directory_lock(directory_lock const&) = delete;
+    directory_lock& operator=(directory_lock const&) = delete;
+
+    ~directory_lock()
+    {
+        ::pthread_mutex_unlock(mutex);
+    }
+};
+
+/*!
+table of the cached HDUs shared by all processes using the same cache name, created by the
+first process and attached by later ones
+*/
+struct shared_directory
+{
+    std::string name;
+    std::unique_ptr<memory_mapping> mapping;
+    cache_directory_header* header = nullptr;
+    cache_directory_entry* entries = nullptr;
+
+    shared_directory(std::string const& cache_name, std::uint64_t capacity, std::size_t slots)
+        : name(cache_name)
+    {
+        std::string const object = "/" + name + ".dir";
+        std::size_t size = sizeof(cache_directory_header) + slots * sizeof(cache_directory_entry);
+
+        int descriptor = ::shm_open(object.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (descriptor >= 0)
+        {
+            if (::ftruncate(descriptor, static_cast<off_t>(size)) != 0)
+            {
+                ::close(descriptor);
+                ::shm_unlink(object.c_str());
+                throw shared_memory_exception();
+            }
+            mapping = map_shared(descriptor, size, true);
+            header = static_cast<cache_directory_header*>(mapping->address);
+
+            pthread_mutexattr_t attributes;
+            ::pthread_mutexattr_init(&attributes);
+            ::pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+#ifndef __APPLE__
+            ::pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+#endif
+            ::pthread_mutex_init(&header->mutex, &attributes);
+            ::pthread_mutexattr_destroy(&attributes);
+
+            header->magic = shared_directory_magic;
+            header->capacity = capacity;
+            header->slots = slots;
+            header->ready.store(1, std::memory_order_release);
+        }
+        else
+        {
+            descriptor = ::shm_open(object.c_str(), O_RDWR, 0600);
+            if (descriptor < 0)
+            {
+                throw shared_memory_exception();
+            }
+
+            //the creator sizes the object right after creating it
+            struct stat info;
+            for (int attempt = 0; ; attempt++)
+            {
+                if (::fstat(descriptor, &info) != 0 || attempt == 5000)
+                {
+                    ::close(descriptor);
+                    throw shared_memory_exception();
+                }
+                if (static_cast<std::size_t>(info.st_size) >= sizeof(cache_directory_header))
+                {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            size = static_cast<std::size_t>(info.st_size);
+            mapping = map_shared(descriptor, size, true);
+            header = static_cast<cache_directory_header*>(mapping->address);
+
+            for (int attempt = 0; header->ready.load(std::memory_order_acquire) == 0; attempt++)
+            {
+                if (attempt == 5000)
+                {
+                    throw shared_memory_exception();
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if (header->magic != shared_directory_magic || size <
+                sizeof(cache_directory_header) + header->slots * sizeof(cache_directory_entry))
+            {
+                throw shared_memory_exception();
+            }
+        }
+        entries = reinterpret_cast<cache_directory_entry*>(header + 1);
+    }
+
+    std::string segment_name(std::size_t slot) const
+    {
+        return "/" + name + "." + std::to_string(slot) + "." +
+            std::to_string(entries[slot].generation);
+    }
+
+    std::size_t slot_count() const
+    {
+        return static_cast<std::size_t>(header->slots);
+    }
+
+    //!slot holding key, slot_count() if there is none (directory must be locked)
+    std::size_t find(std::string const& key) const
+    {
+        for (std::size_t slot = 0; slot < slot_count(); slot++)
+        {
+            if (entries[slot].state != slot_free && key == entries[slot].key)
+            {
+                return slot;
+            }
+        }
+        return slot_count();
+    }
+
+    //!removes an entry, processes still mapping its segment keep their view
+    void evict(std::size_t slot)
+    {
+        cache_directory_entry& entry = entries[slot];
+        ::shm_unlink(segment_name(slot).c_str());
+        header->used -= entry.size;
+        entry.state = slot_free;
+        entry.references = 0;
+        entry.size = 0;
+        entry.key[0] = '\0';
+    }
+
+    //!least recently used entry nobody refers to, slot_count() if there is none
+    std::size_t eviction_candidate() const
+    {
+        std::size_t candidate = slot_count();
+        for (std::size_t slot = 0; slot < slot_count(); slot++)
+        {
+            cache_directory_entry const& entry = entries[slot];
+            if (entry.state == slot_ready && entry.references == 0 &&
+                (candidate == slot_count() || entry.last_use < entries[candidate].last_use))
+            {
+                candidate = slot;
+            }
+        }
+        return candidate;
+    }
+
+    /*!
+    evicts unused entries until size more bytes fit into the capacity, nothing is evicted when
+    they would not fit even without the unused entries
+    */
+    bool make_room(std::uint64_t size)
+    {
+        std::uint64_t unused = 0;
+        for (std::size_t slot = 0; slot < slot_count(); slot++)
+        {
+            if (entries[slot].state == slot_ready && entries[slot].references == 0)
+            {
+                unused += entries[slot].size;
+            }
+        }
+        if (header->used - unused + size > header->capacity)
+        {
+            return false;
+        }
+
+        while (header->used + size > header->capacity)
+        {
+            std::size_t const slot = eviction_candidate();
+            if (slot == slot_count())
+            {
+                return false;
+            }
+            evict(slot);
+        }
+        return true;
+    }
+
+    //!true if the process publishing the entry in slot has died
+    bool builder_died(std::size_t slot) const
+    {
+        return ::kill(static_cast<pid_t>(entries[slot].builder), 0) != 0 && errno == ESRCH;
+    }
+};
+
+} //namespace detail
+
+/*!
+handle of one decoded HDU in the cache. while it is alive the entry is referenced and can not
+be evicted, arrays are read only views into the mapped segment. handles of a sidecar_cache
+map a file instead and hold no reference
+*/
+struct shared_hdu
+{
+private:
+    std::shared_ptr<detail::shared_directory> directory;
+    std::size_t slot = 0;
+    std::unique_ptr<detail::memory_mapping> mapping;
+    bool shared = false;
+
+public:
+    shared_hdu() {}
+
+    shared_hdu
+    (
+        std::shared_ptr<detail::shared_directory> cache_directory,
+        std::size_t entry_slot,
+        std::unique_ptr<detail::memory_mapping> segment,
+        bool shared_memory = true
+    ) : directory(std::move(cache_directory)), slot(entry_slot), mapping(std::move(segment)),
+        shared(shared_memory) {}
+
+    shared_hdu(shared_hdu&& other) = default;
+
+    shared_hdu& operator=(shared_hdu&& other)
+    {
+        if (this != &other)
+        {
+            release();
+            directory = std::move(other.directory);
+            slot = other.slot;
+            mapping = std::move(other.mapping);
+            shared = other.shared;
+        }
+        return *this;
+    }
+
+    ~shared_hdu()
+    {
+        try
+        {
+            release();
+        }
+        catch (...) {}
+    }
+
+    bool empty() const
+    {
+        return !mapping;
+    }
+
+    /*!
+    false when the HDU could not be cached and was published into private memory of this
+    process only
+    */
+    bool is_shared() const
+    {
+        return mapping && shared;
+    }
+
+    //!size of the segment in bytes
+    std::size_t size_bytes() const
+    {
+        return mapping ? mapping->size : 0;
+    }
+
+    //!names of the cached arrays in the order they were added
+    std::vector<std::string> names() const
+    {
+        std::vector<std::string> result;
+        for (std::size_t i = 0; i < array_count(); i++)
+        {
+            result.emplace_back(records()[i].name);
+        }
+        return result;
+    }
+
+    //!view of the array with given name, Type must be its element type
+    template <typename Type>
+    shared_array<Type> array(std::string const& name) const
+    {
+        for (std::size_t i = 0; i < array_count(); i++)
+        {
+            detail::shared_array_record const& record = records()[i];
+            if (name == record.name)
+            {
+                if (record.type != detail::shared_type_code<Type>::value)
+                {
+                    throw cache_type_mismatch_exception();
+                }
+                return shared_array<Type>(
+                    reinterpret_cast<Type const*>(mapping->data() + record.offset),
+                    static_cast<std::size_t>(record.count), static_cast<std::size_t>(record.width),
+                    static_cast<std::size_t>(record.height));
+            }
+        }
+        throw column_not_found_exception();
+    }
+
+    //!drops the reference to the entry and unmaps it
+    void release()
+    {
+        mapping.reset();
+        if (directory)
+        {
+            detail::directory_lock lock(&directory->header->mutex);
+            detail::cache_directory_entry& entry = directory->entries[slot];
+            if (entry.references != 0)
+            {
+                entry.references--;
+            }
+            entry.last_use = ++directory->header->clock;
+        }
+        directory.reset();
+    }
+
+private:
+    std::size_t array_count() const
+    {
+        return mapping ? static_cast<std::size_t>(
+            reinterpret_cast<detail::shared_segment_header const*>(mapping->data())->arrays) : 0;
+    }
+
+    detail::shared_array_record const* records() const
+    {
+        return reinterpret_cast<detail::shared_array_record const*>(
+            mapping->data() + sizeof(detail::shared_segment_header));
+    }
+};
+
+/*!
+collects the decoded arrays of one HDU before they are published, each array is copied once
+into the shared segment
+*/
+struct hdu_cache_builder
+{
+private:
+    struct pending_array
+    {
+        std::string name;
+        std::uint32_t type;
+        std::uint32_t element_size;
+        std::vector<char> bytes;
+        std::size_t count;
+        std::size_t width;
+        std::size_t height;
+    };
+
+    std::vector<pending_array> arrays;
+
+public:
+    //!adds count elements arranged as height rows of width elements
+    template <typename Type>
+    void add
+    (
+        std::string const& name,
+        Type const* values,
+        std::size_t count,
+        std::size_t width,
+        std::size_t height
+    )
+    {
+        if (name.size() >= sizeof(detail::shared_array_record::name))
+        {
+            throw invalid_cache_key_exception();
+        }
+
+        char const* first = reinterpret_cast<char const*>(values);
+        arrays.push_back(pending_array{name, detail::shared_type_code<Type>::value,
+            static_cast<std::uint32_t>(sizeof(Type)),
+            std::vector<char>(first, first + count * sizeof(Type)), count, width, height});
+    }
+
+    template <typename Type>
+    void add(std::string const& name, Type const* values, std::size_t count)
+    {
+        add(name, values, count, count, 1);
+    }
+
+    //!adds the pixels of a decoded image
+    template <bitpix Bitpix>
+    void add_image(std::string const& name, image<Bitpix> const& pixels)
+    {
+        std::size_t const width = pixels.get_width();
+        std::vector<typename image<Bitpix>::pixel_type> values(width * pixels.get_height());
+        for (std::size_t y = 0; y < pixels.get_height(); y++)
+        {
+            std::copy(pixels.row(y), pixels.row(y) + width, values.begin() + y * width);
+        }
+        add(name, values.data(), values.size(), width, pixels.get_height());
+    }
+
+    //!adds the pixels of a decoded image as doubles, physical value = bzero + bscale * pixel
+    template <bitpix Bitpix>
+    void add_image(std::string const& name, image<Bitpix> const& pixels, double bscale, double bzero)
+    {
+        std::size_t const count = pixels.get_width() * pixels.get_height();
+        std::vector<double> values(count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            values[i] = bzero + bscale *
+                static_cast<double>(pixels(i / pixels.get_width(), i % pixels.get_width()));
+        }
+        add(name, values.data(), count, pixels.get_width(), pixels.get_height());
+    }
+
+    /*!
+    adds a scalar column of a binary table under its name: integer columns (unsigned
+    conventions included) as std::int64_t, unsigned 'K' columns as std::uint64_t, other
+    numeric columns as scaled doubles and 'A' columns as characters, one row of the column
+    width per table row (see string_at)
+    */
+    void add_column(binary_table_extension const& table, std::string const& name)
+    {
+        column const& info = table.get_column_info(name);
+        char const type = table.get_type(info.TFORM());
+        std::size_t const rows = table.naxis(2);
+
+        if (type == 'A')
+        {
+            std::size_t const width = table.column_size(info.TFORM());
+            std::vector<char> text(width * rows);
+            char const* field = table.get_data().data() + info.TBCOL();
+            for (std::size_t row = 0; row < rows; row++)
+            {
+                std::copy_n(field + row * table.naxis(1), width, text.data() + row * width);
+            }
+            add(name, text.data(), text.size(), width, rows);
+        }
+        else if (type == 'K' && column_scaling(info).is_sign_offset<std::int64_t>())
+        {
+            std::vector<std::uint64_t> values =
+                column_view<std::uint64_t>(table, name).materialize();
+            add(name, values.data(), values.size());
+        }
+        else if (is_integer_column(type, column_scaling(info)))
+        {
+            std::vector<std::int64_t> values = column_view<std::int64_t>(table, name).materialize();
+            add(name, values.data(), values.size());
+        }
+        else
+        {
+            std::vector<double> values = column_view<double>(table, name).materialize();
+            add(name, values.data(), values.size());
+        }
+    }
+
+    //!size of the segment holding all arrays added so far
+    std::size_t size() const
+    {
+        std::size_t offset = data_offset();
+        for (auto const& a : arrays)
+        {
+            offset = aligned(offset) + a.bytes.size();
+        }
+        return std::max(offset, std::size_t(1));
+    }
+
+    //!writes the segment into memory of size() bytes
+    void write(char* destination) const
+    {
+        detail::shared_segment_header header{detail::shared_segment_magic, arrays.size()};
+        std::memcpy(destination, &header, sizeof(header));
+
+        std::size_t offset = data_offset();
+        for (std::size_t i = 0; i < arrays.size(); i++)
+        {
+            pending_array const& a = arrays[i];
+            offset = aligned(offset);
+
+            detail::shared_array_record record;
+            std::memset(&record, 0, sizeof(record));
+            std::copy(a.name.begin(), a.name.end(), record.name);
+            record.type = a.type;
+            record.element_size = a.element_size;
+            record.offset = offset;
+            record.count = a.count;
+            record.width = a.width;
+            record.height = a.height;
+            std::memcpy(destination + sizeof(header) + i * sizeof(record), &record, sizeof(record));
+
+            std::copy(a.bytes.begin(), a.bytes.end(), destination + offset);
+            offset += a.bytes.size();
+        }
+    }
+
+private:
+    std::size_t data_offset() const
+    {
+        return sizeof(detail::shared_segment_header) +
+            arrays.size() * sizeof(detail::shared_array_record);
+    }
+
+    static std::size_t aligned(std::size_t offset)
+    {
+        return (offset + detail::shared_alignment - 1) / detail::shared_alignment *
+            detail::shared_alignment;
+    }
+
+    static bool is_integer_column(char type, column_scaling const& s)
+    {
+        switch (type)
+        {
+        case 'B':
+            return s.is_identity() || s.is_sign_offset<std::uint8_t>();
+        case 'I':
+            return s.is_identity() || s.is_sign_offset<std::int16_t>();
+        case 'J':
+            return s.is_identity() || s.is_sign_offset<std::int32_t>();
+        case 'K':
+            return s.is_identity() || s.is_sign_offset<std::int64_t>();
+        default:
+            return false;
+        }
+    }
+};
+
+//!handle of the arrays of builder written into memory private to this process
+inline shared_hdu publish_private(hdu_cache_builder const& builder)
+{
+    std::size_t const size = builder.size();
+    void* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+        -1, 0);
+    if (address == MAP_FAILED)
+    {
+        throw shared_memory_exception();
+    }
+    std::unique_ptr<detail::memory_mapping> mapping(new detail::memory_mapping(address, size));
+    builder.write(static_cast<char*>(address));
+    return shared_hdu(nullptr, 0, std::move(mapping), false);
+}
+
+//!state of the cache as seen by the directory
+struct cache_statistics
+{
+    std::size_t slots = 0;
+    std::size_t entries = 0;    //! published entries
+    std::size_t referenced = 0; //! published entries with live handles
+    std::size_t building = 0;   //! entries being published
+    std::uint64_t used_bytes = 0;
+    std::uint64_t capacity = 0;
+};
+
+/*!
+cache of decoded HDUs in POSIX shared memory, shared by all processes opening it with the same
+name. the first process to ask for a key decodes the HDU and publishes it into its own segment,
+processes asking for the key meanwhile wait for it and later ones map the segment read only,
+so every HDU is decoded once per node and stored once in memory.
+
+entries are reference counted by the handles of all processes. when a new entry does not fit
+into the capacity, unreferenced entries are evicted least recently used first; an entry that
+does not fit even then is published privately to the calling process. evicted segments are
+unlinked, processes still mapping them keep valid views.
+
+the directory of entries (capacity and slot count included) is created by the first process,
+later processes use the values it was created with. references of a process that dies while
+holding handles are not returned, remove() clears such a cache
+*/
+struct shared_hdu_cache
+{
+private:
+    std::shared_ptr<detail::shared_directory> directory;
+
+public:
+    explicit shared_hdu_cache
+    (
+        std::string const& name = "boost_astronomy_hdu_cache",
+        std::uint64_t capacity = std::uint64_t(1) << 30,
+        std::size_t slots = 256
+    ) : directory(std::make_shared<detail::shared_directory>(name, capacity, slots)) {}
+
+    //!handle of a published entry, an empty handle if the key is not (yet) published
+    shared_hdu find(hdu_cache_key const& key)
+    {
+        std::string name;
+        std::size_t slot = 0;
+        {
+            detail::directory_lock lock(&directory->header->mutex);
+            slot = directory->find(key.str());
+            if (slot == directory->slot_count() ||
+                directory->entries[slot].state != detail::slot_ready)
+            {
+                return shared_hdu();
+            }
+            acquire(slot);
+            name = directory->segment_name(slot);
+        }
+        return attach(slot, name);
+    }
+
+    /*!
+    handle of the entry for key, calling build(hdu_cache_builder&) to decode and publish it
+    when no process has done so. if another process is publishing the key this one waits for it
+    */
+    template <typename Build>
+    shared_hdu get_or_publish(hdu_cache_key const& key, Build build)
+    {
+        while (true)
+        {
+            std::string name;
+            std::size_t slot = 0;
+            bool publish = false;
+            {
+                detail::directory_lock lock(&directory->header->mutex);
+                slot = directory->find(key.str());
+                if (slot == directory->slot_count())
+                {
+                    slot = reserve(key.str());
+                    publish = true;
+                }
+                else if (directory->entries[slot].state == detail::slot_ready)
+                {
+                    acquire(slot);
+                    name = directory->segment_name(slot);
+                }
+                else if (directory->builder_died(slot))
+                {
+                    directory->evict(slot);
+                    continue;
+                }
+            }
+
+            if (publish)
+            {
+                return publish_entry(slot, build);
+            }
+            if (!name.empty())
+            {
+                return attach(slot, name);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    //!evicts every entry without references, returns the number of evicted entries
+    std::size_t evict_unused()
+    {
+        detail::directory_lock lock(&directory->header->mutex);
+        std::size_t evicted = 0;
+        for (std::size_t slot = 0; slot < directory->slot_count(); slot++)
+        {
+            if (directory->entries[slot].state == detail::slot_ready &&
+                directory->entries[slot].references == 0)
+            {
+                directory->evict(slot);
+                evicted++;
+            }
+        }
+        return evicted;
+    }
+
+    cache_statistics statistics() const
+    {
+        detail::directory_lock lock(&directory->header->mutex);
+        cache_statistics result;
+        result.slots = directory->slot_count();
+        result.used_bytes = directory->header->used;
+        result.capacity = directory->header->capacity;
+        for (std::size_t slot = 0; slot < directory->slot_count(); slot++)
+        {
+            detail::cache_directory_entry const& entry = directory->entries[slot];
+            if (entry.state == detail::slot_ready)
+            {
+                result.entries++;
+                result.referenced += entry.references != 0 ? 1 : 0;
+            }
+            else if (entry.state == detail::slot_building)
+            {
+                result.building++;
+            }
+        }
+        return result;
+    }
+
+    /*!
+    unlinks the directory and all segments of the named cache, processes still using it keep
+    their mappings but new processes start with an empty cache
+    */
+    static void remove(std::string const& name)
+    {
+        {
+            //creates an empty directory when there is none, which is unlinked right away
+            detail::shared_directory existing(name, 0, 0);
+            detail::directory_lock lock(&existing.header->mutex);
+            for (std::size_t slot = 0; slot < existing.slot_count(); slot++)
+            {
+                if (existing.entries[slot].state != detail::slot_free)
+                {
+                    existing.evict(slot);
+                }
+            }
+        }
+        ::shm_unlink(("/" + name + ".dir").c_str());
+    }
+
+private:
+    void acquire(std::size_t slot)
+    {
+        directory->entries[slot].references++;
+        directory->entries[slot].last_use = ++directory->header->clock;
+    }
+
+    //!marks a slot as being published by this process, slot_count() if none is available
+    std::size_t reserve(std::string const& key)
+    {
+        std::size_t slot = 0;
+        while (slot < directory->slot_count() &&
+            directory->entries[slot].state != detail::slot_free)
+        {
+            slot++;
+        }
+        if (slot == directory->slot_count())
+        {
+            slot = directory->eviction_candidate();
+            if (slot == directory->slot_count())
+            {
+                return slot;
+            }
+            directory->evict(slot);
+        }
+
+        detail::cache_directory_entry& entry = directory->entries[slot];
+        entry.state = detail::slot_building;
+        entry.references = 1;
+        entry.builder = static_cast<std::int64_t>(::getpid());
+        entry.generation = ++directory->header->generation;
+        entry.size = 0;
+        entry.last_use = ++directory->header->clock;
+        std::copy(key.begin(), key.end(), entry.key);
+        entry.key[key.size()] = '\0';
+        return slot;
+    }
+
+    template <typename Build>
+    shared_hdu publish_entry(std::size_t slot, Build& build)
+    {
+        hdu_cache_builder builder;
+        std::size_t size = 0;
+        bool cached = slot != directory->slot_count();
+        try
+        {
+            build(builder);
+            size = builder.size();
+            if (cached)
+            {
+                detail::directory_lock lock(&directory->header->mutex);
+                cached = directory->make_room(size);
+                if (cached)
+                {
+                    directory->header->used += size;
+                    directory->entries[slot].size = size;
+                }
+                else
+                {
+                    directory->evict(slot);
+                }
+            }
+        }
+        catch (...)
+        {
+            abandon(slot);
+            throw;
+        }
+
+        if (!cached)
+        {
+            return publish_private(builder);
+        }
+
+        std::unique_ptr<detail::memory_mapping> mapping;
+        try
+        {
+            std::string const name = segment_name(slot);
+            int descriptor = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+            if (descriptor < 0 && errno == EEXIST)
+            {
+                //left over by a cache that was removed while in use
+                ::shm_unlink(name.c_str());
+                descriptor = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+            }
+            if (descriptor < 0)
+            {
+                throw shared_memory_exception();
+            }
+            if (::ftruncate(descriptor, static_cast<off_t>(size)) != 0)
+            {
+                ::close(descriptor);
+                throw shared_memory_exception();
+            }
+            mapping = detail::map_shared(descriptor, size, true);
+            builder.write(static_cast<char*>(mapping->address));
+        }
+        catch (...)
+        {
+            abandon(slot);
+            throw;
+        }
+
+        detail::directory_lock lock(&directory->header->mutex);
+        directory->entries[slot].state = detail::slot_ready;
+        return shared_hdu(directory, slot, std::move(mapping));
+    }
+
+    std::string segment_name(std::size_t slot) const
+    {
+        detail::directory_lock lock(&directory->header->mutex);
+        return directory->segment_name(slot);
+    }
+
+    //!removes an entry whose publication failed
+    void abandon(std::size_t slot)
+    {
+        if (slot != directory->slot_count())
+        {
+            detail::directory_lock lock(&directory->header->mutex);
+            if (directory->entries[slot].state == detail::slot_building)
+            {
+                directory->evict(slot);
+            }
+        }
+    }
+
+    shared_hdu attach(std::size_t slot, std::string const& name)
+    {
+        std::unique_ptr<detail::memory_mapping> mapping;
+        try
+        {
+            int const descriptor = ::shm_open(name.c_str(), O_RDONLY, 0600);
+            struct stat info;
+            if (descriptor < 0 || ::fstat(descriptor, &info) != 0)
+            {
+                if (descriptor >= 0)
+                {
+                    ::close(descriptor);
+                }
+                throw shared_memory_exception();
+            }
+            mapping = detail::map_shared(descriptor, static_cast<std::size_t>(info.st_size), false);
+            if (mapping->size < sizeof(detail::shared_segment_header) ||
+                reinterpret_cast<detail::shared_segment_header const*>(mapping->data())->magic !=
+                    detail::shared_segment_magic)
+            {
+                throw shared_memory_exception();
+            }
+        }
+        catch (...)
+        {
+            shared_hdu(directory, slot, nullptr).release();
+            throw;
+        }
+        return shared_hdu(directory, slot, std::move(mapping));
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // BOOST_HAS_UNISTD_H
+
+#endif // !BOOST_ASTRONOMY_IO_SHARED_HDU_CACHE_HPP
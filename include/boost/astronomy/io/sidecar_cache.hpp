@@ -0,0 +1,295 @@
+#ifndef BOOST_ASTRONOMY_IO_SIDECAR_CACHE_HPP
+#define BOOST_ASTRONOMY_IO_SIDECAR_CACHE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/config.hpp>
+
+//!sidecars are mapped with mmap and keyed like the shared_hdu_cache, so POSIX platforms only
+#ifdef BOOST_HAS_UNISTD_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+
+#include <boost/astronomy/io/shared_hdu_cache.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+namespace detail {
+
+std::uint64_t const sidecar_magic = 0x3152414345444953ULL;
+std::uint32_t const sidecar_version = 1;
+std::uint32_t const sidecar_byte_order = 0x01020304;
+
+/*!
+first page of a sidecar file, the segment written by hdu_cache_builder follows at
+segment_offset (a multiple of the page size) so it is mapped as is
+*/
+struct sidecar_header
+{
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t byte_order;  //! sidecar_byte_order in the byte order of the writer
+    std::uint64_t segment_offset;
+    std::uint64_t segment_size;
+    char stamp[256];           //! hdu_cache_key of the source when the sidecar was written
+    char source[3072];         //! absolute path of the source file
+};
+
+inline std::size_t sidecar_segment_offset()
+{
+    long const page = ::sysconf(_SC_PAGESIZE);
+    std::size_t const size = page > 0 ? static_cast<std::size_t>(page) : 4096;
+    return (sizeof(sidecar_header) + size - 1) / size * size;
+}
+
+//!writes all size bytes at offset of a descriptor, false on failure
+inline bool write_all(int fd, char const* data, std::size_t size, std::size_t offset)
+{
+    std::size_t done = 0;
+    while (done < size)
+    {
+        ssize_t const count = ::pwrite(fd, data + done, size - done,
+            static_cast<off_t>(offset + done));
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            return false;
+        }
+        done += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+//!FNV-1a hash used to name sidecar files
+inline std::uint64_t sidecar_hash(std::string const& text)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (char c : text)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+} //namespace detail
+
+/*!
+persistent cache of decoded HDUs in a directory of sidecar files. the arrays published by a
+build function (see hdu_cache_builder) are stored native endian, already scaled if the build
+function scales them, and aligned so a later open maps the file and reads pixels right away
+instead of reading and byte swapping the FITS data again.
+
+every sidecar carries a validation stamp of the source file (device, inode, size and
+modification time) together with the HDU index and decode options, a sidecar whose stamp,
+byte order or format version does not match is rebuilt. files are replaced atomically, so
+concurrent processes never map a partly written sidecar
+*/
+struct sidecar_cache
+{
+private:
+    boost::filesystem::path root;
+
+public:
+    //!uses (and creates) the given directory for the sidecar files
+    explicit sidecar_cache(std::string const& directory) : root(directory)
+    {
+        boost::system::error_code error;
+        boost::filesystem::create_directories(root, error);
+        if (error)
+        {
+            throw file_io_exception();
+        }
+    }
+
+    //!path of the sidecar of an HDU of file decoded with given options
+    std::string sidecar_path
+    (
+        std::string const& file,
+        std::size_t hdu_index,
+        std::string const& options = ""
+    ) const
+    {
+        std::string const name = boost::filesystem::absolute(file).string() + ":" +
+            std::to_string(hdu_index) + ":" + options;
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx",
+            static_cast<unsigned long long>(detail::sidecar_hash(name)));
+        return (root / (std::string(hash) + ".fsc")).string();
+    }
+
+    //!maps the sidecar of an HDU, an empty handle if there is none or it is out of date
+    shared_hdu find
+    (
+        std::string const& file,
+        std::size_t hdu_index,
+        std::string const& options = ""
+    ) const
+    {
+        hdu_cache_key const key(file, hdu_index, options);
+        return map(sidecar_path(file, hdu_index, options), key.str(),
+            boost::filesystem::absolute(file).string());
+    }
+
+    /*!
+    maps the sidecar of an HDU, calling build(hdu_cache_builder&) to decode it and write the
+    sidecar when there is no valid one. if the sidecar can not be written the arrays are
+    returned in private memory
+    */
+    template <typename Build>
+    shared_hdu get_or_create
+    (
+        std::string const& file,
+        std::size_t hdu_index,
+        std::string const& options,
+        Build build
+    ) const
+    {
+        hdu_cache_key const key(file, hdu_index, options);
+        std::string const path = sidecar_path(file, hdu_index, options);
+        std::string const source = boost::filesystem::absolute(file).string();
+
+        shared_hdu cached = map(path, key.str(), source);
+        if (!cached.empty())
+        {
+            return cached;
+        }
+
+        hdu_cache_builder builder;
+        build(builder);
+        if (source.size() < sizeof(detail::sidecar_header::source) && write(path, key.str(),
+            source, builder))
+        {
+            cached = map(path, key.str(), source);
+            if (!cached.empty())
+            {
+                return cached;
+            }
+        }
+        return publish_private(builder);
+    }
+
+    //!removes the sidecar of an HDU, returns false if there was none
+    bool remove
+    (
+        std::string const& file,
+        std::size_t hdu_index,
+        std::string const& options = ""
+    ) const
+    {
+        return ::unlink(sidecar_path(file, hdu_index, options).c_str()) == 0;
+    }
+
+private:
+    static shared_hdu map(std::string const& path, std::string const& stamp,
+        std::string const& source)
+    {
+        int const descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+        {
+            return shared_hdu();
+        }
+
+        detail::sidecar_header header;
+        struct stat info;
+        bool const valid =
+            ::pread(descriptor, &header, sizeof(header), 0) ==
+                static_cast<ssize_t>(sizeof(header)) &&
+            ::fstat(descriptor, &info) == 0 &&
+            header.magic == detail::sidecar_magic &&
+            header.version == detail::sidecar_version &&
+            header.byte_order == detail::sidecar_byte_order &&
+            header.segment_offset == detail::sidecar_segment_offset() &&
+            header.segment_size >= sizeof(detail::shared_segment_header) &&
+            static_cast<std::uint64_t>(info.st_size) ==
+                header.segment_offset + header.segment_size &&
+            std::find(header.stamp, header.stamp + sizeof(header.stamp), '\0') !=
+                header.stamp + sizeof(header.stamp) && stamp == header.stamp &&
+            std::find(header.source, header.source + sizeof(header.source), '\0') !=
+                header.source + sizeof(header.source) && source == header.source;
+        if (!valid)
+        {
+            ::close(descriptor);
+            return shared_hdu();
+        }
+
+        std::size_t const size = static_cast<std::size_t>(header.segment_size);
+        void* address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor,
+            static_cast<off_t>(header.segment_offset));
+        ::close(descriptor);
+        if (address == MAP_FAILED)
+        {
+            return shared_hdu();
+        }
+        std::unique_ptr<detail::memory_mapping> mapping(new detail::memory_mapping(address, size));
+        if (reinterpret_cast<detail::shared_segment_header const*>(mapping->data())->magic !=
+            detail::shared_segment_magic)
+        {
+            return shared_hdu();
+        }
+        return shared_hdu(nullptr, 0, std::move(mapping));
+    }
+
+    //!writes the sidecar into a temporary file renamed to path once complete
+    static bool write(std::string const& path, std::string const& stamp,
+        std::string const& source, hdu_cache_builder const& builder)
+    {
+        std::string const temporary = boost::filesystem::unique_path(
+            path + ".%%%%-%%%%-%%%%.tmp").string();
+        int const descriptor = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (descriptor < 0)
+        {
+            return false;
+        }
+
+        std::size_t const offset = detail::sidecar_segment_offset();
+        detail::sidecar_header header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic = detail::sidecar_magic;
+        header.version = detail::sidecar_version;
+        header.byte_order = detail::sidecar_byte_order;
+        header.segment_offset = offset;
+        header.segment_size = builder.size();
+        std::copy(stamp.begin(), stamp.end(), header.stamp);
+        std::copy(source.begin(), source.end(), header.source);
+
+        //written, not filled through a mapping: a full disk fails the write instead of
+        //raising SIGBUS on the page fault
+        std::vector<char> page(offset, '\0');
+        std::memcpy(page.data(), &header, sizeof(header));
+        std::vector<char> segment(builder.size());
+        builder.write(segment.data());
+        bool const written = detail::write_all(descriptor, page.data(), page.size(), 0) &&
+            detail::write_all(descriptor, segment.data(), segment.size(), offset);
+        if (::close(descriptor) != 0 || !written ||
+            ::rename(temporary.c_str(), path.c_str()) != 0)
+        {
+            ::unlink(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // BOOST_HAS_UNISTD_H
+
+#endif // !BOOST_ASTRONOMY_IO_SIDECAR_CACHE_HPP
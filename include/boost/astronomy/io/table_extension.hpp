@@ -2,10 +2,18 @@
 #define BOOST_ASTRONOMY_IO_TABLE_EXTENSION_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <algorithm>
 #include <fstream>
+#include <istream>
 #include <string>
+#include <vector>
+#include <boost/algorithm/string/trim.hpp>
 #include <boost/astronomy/io/extension_hdu.hpp>
 #include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/io/checksum.hpp>
+#include <boost/astronomy/io/memory_resource.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
 
 namespace boost { namespace astronomy { namespace io {
 
@@ -15,27 +23,107 @@ struct table_extension : public extension_hdu
 protected:
     std::size_t tfields;
     std::vector<column> col_metadata;
-    std::vector<char> data;
+    resource_vector<char> data; //! allocated from the default resource
+    checksum_accumulator read_sum; //! checksum of data, summed by read_table_data
 
 public:
     table_extension() {}
 
-    table_extension(std::fstream &file) : extension_hdu(file)
+    table_extension(std::istream &file) : extension_hdu(file)
     {
         tfields = this->value_of<std::size_t>("TFIELDS");
-        col_metadata.reserve(tfields);
+        col_metadata.resize(tfields);
     }
 
-    table_extension(std::fstream &file, hdu const& other) : extension_hdu(file, other)
+    table_extension(std::istream &file, hdu const& other) : extension_hdu(file, other)
     {
         tfields = this->value_of<std::size_t>("TFIELDS");
-        col_metadata.reserve(tfields);
+        col_metadata.resize(tfields);
     }
 
-    table_extension(std::fstream &file, std::streampos pos) : extension_hdu(file, pos)
+    table_extension(hdu const& other) : extension_hdu(other)
     {
         tfields = this->value_of<std::size_t>("TFIELDS");
-        col_metadata.reserve(tfields);
+        col_metadata.resize(tfields);
+    }
+
+    table_extension(std::istream &file, std::streampos pos) : extension_hdu(file, pos)
+    {
+        tfields = this->value_of<std::size_t>("TFIELDS");
+        col_metadata.resize(tfields);
+    }
+
+    //!returns metadata (TFORM, TBCOL, TSCAL...) of the column with given TTYPE
+    column const& get_column_info(std::string const& name) const
+    {
+        for (auto const& col : col_metadata)
+        {
+            if (col.TTYPE() == name)
+            {
+                return col;
+            }
+        }
+        throw column_not_found_exception();
+    }
+
+    //!returns raw table data as stored in the file, naxis(1) bytes per row
+    resource_vector<char> const& get_data() const
+    {
+        return this->data;
+    }
+
+    /*!
+    checksum of the data unit, padding included (blanks for ascii tables, zeros otherwise).
+    the sum taken while the data was read is used when it covers all of it, otherwise the
+    data in memory is summed with the given number of threads. the heap of binary tables is not
+    kept in memory, so tables with PCOUNT != 0 must be verified with verify_checksums on the file
+    */
+    std::uint32_t data_checksum(std::size_t threads = 1) const
+    {
+        if (this->value_of<std::size_t>("PCOUNT") != 0)
+        {
+            throw invalid_table_colum_format();
+        }
+
+        std::string const type = boost::algorithm::trim_copy_if(
+            this->value_of<std::string>("XTENSION"),
+            [](char c) -> bool { return c == '\'' || c == ' '; });
+
+        checksum_accumulator sum = read_sum.size() == data.size() ? read_sum :
+            checksum_accumulator(checksum(data.data(), data.size(), threads), data.size());
+        sum.update_fill(type == "TABLE" ? ' ' : '\0', (2880 - data.size() % 2880) % 2880);
+        return sum.value();
+    }
+
+    //!returns metadata of all the columns in TFIELDS order
+    std::vector<column> const& get_columns() const
+    {
+        return this->col_metadata;
+    }
+
+protected:
+    /*!
+    reads the naxis(1) * naxis(2) bytes of table data that follow in file, in chunks summed
+    for data_checksum while they are still in cache
+    */
+    void read_table_data(std::istream &file)
+    {
+        std::size_t const size = naxis(1) * naxis(2);
+        std::size_t const chunk = std::size_t(1) << 20;
+        data.resize(size);
+        read_sum = checksum_accumulator();
+        for (std::size_t done = 0; done < size; )
+        {
+            std::size_t const count = std::min(chunk, size - done);
+            file.read(data.data() + done, static_cast<std::streamsize>(count));
+            std::size_t const read = static_cast<std::size_t>(file.gcount());
+            read_sum.update(data.data() + done, read);
+            done += read;
+            if (read != count)
+            {
+                break;
+            }
+        }
     }
 };
 
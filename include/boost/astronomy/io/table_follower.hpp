@@ -0,0 +1,217 @@
+#ifndef BOOST_ASTRONOMY_IO_TABLE_FOLLOWER_HPP
+#define BOOST_ASTRONOMY_IO_TABLE_FOLLOWER_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//!how table_follower finds out about appended rows
+enum class follow_mode
+{
+    header,   //! NAXIS2 card is re-read, the writer updates it after appending rows
+    file_size //! rows are counted from the file size, the writer appends unpadded rows
+              //! to the last HDU and updates NAXIS2 only when it is done, before it pads
+              //! the last block or appends another HDU
+};
+
+//!rows appended since the previous batch, raw in the layout of table_follower::table()
+struct table_batch
+{
+    std::size_t first_row = 0; //! table row of the first row in data
+    std::size_t rows = 0;
+    std::vector<char> data;
+};
+
+/*!
+incremental reader of a binary table that is still being appended to. only the rows appended
+after the last consumed row are read, and growth is detected by re-reading the NAXIS2 card
+(or the file size) instead of re-reading the header and data, so the cost of a poll does not
+depend on the size of the table. batches can be decoded with column_view over batch.data
+*/
+struct table_follower
+{
+private:
+    std::fstream file;
+    binary_table_extension layout;
+    follow_mode mode;
+    std::streamoff data_start = 0;
+    std::streamoff naxis2_card = 0; //! file offset of the NAXIS2 card
+    std::streamoff last_size = -1; //! file size at the last poll, file_size mode only
+    std::size_t header_rows = 0; //! NAXIS2 at construction, file_size mode stops once it changes
+    std::size_t known_rows = 0;
+    std::size_t next_row = 0;
+
+public:
+    /*!
+    follows the binary table whose header starts at pos, delivering rows from start_row on
+    (e.g. the consumed() value saved by a previous consumer)
+    */
+    table_follower
+    (
+        std::string const& file_name,
+        std::streampos pos,
+        follow_mode follow = follow_mode::header,
+        std::size_t start_row = 0
+    ) : file(file_name, std::ios_base::in | std::ios_base::binary), mode(follow), next_row(start_row)
+    {
+        if (!file.is_open())
+        {
+            throw file_io_exception();
+        }
+
+        hdu header(file, pos);
+        layout = binary_table_extension(header);
+        data_start = static_cast<std::streamoff>(file.tellg());
+
+        auto const& cards = layout.get_cards();
+        for (std::size_t i = 0; i < cards.size(); i++)
+        {
+            if (cards[i].key() == "NAXIS2")
+            {
+                naxis2_card = static_cast<std::streamoff>(pos) + static_cast<std::streamoff>(80 * i);
+            }
+        }
+        known_rows = layout.naxis(2);
+        header_rows = known_rows;
+    }
+
+    //!column layout of the table, its NAXIS2 is the value at construction
+    binary_table_extension const& table() const
+    {
+        return this->layout;
+    }
+
+    //!number of rows consumed so far, i.e. the table row the next batch starts at
+    std::size_t consumed() const
+    {
+        return this->next_row;
+    }
+
+    //!checks for appended rows, returns number of rows not consumed yet
+    std::size_t poll()
+    {
+        file.clear();
+        std::size_t rows = known_rows;
+        if (mode == follow_mode::header)
+        {
+            //rows may be appended inside the padding of the last block, so the card is
+            //read on every poll
+            rows = read_naxis2();
+        }
+        else
+        {
+            file.seekg(0, std::ios_base::end);
+            std::streamoff const size = static_cast<std::streamoff>(file.tellg());
+            if (size == last_size)
+            {
+                return available();
+            }
+            last_size = size;
+            if (layout.naxis(1) != 0 && size > data_start)
+            {
+                rows = static_cast<std::size_t>(size - data_start) / layout.naxis(1);
+            }
+
+            //once the writer has set NAXIS2 the bytes after the rows are padding or the
+            //next HDU, not rows
+            std::size_t const final_rows = read_naxis2();
+            if (final_rows != header_rows)
+            {
+                rows = std::min(rows, final_rows);
+            }
+        }
+
+        if (rows < next_row)
+        {
+            throw table_truncated_exception();
+        }
+        known_rows = rows;
+        return available();
+    }
+
+    //!rows known to exist but not consumed yet, as of the last poll
+    std::size_t available() const
+    {
+        return known_rows > next_row ? known_rows - next_row : 0;
+    }
+
+    /*!
+    polls and reads up to max_rows of the new rows into batch (its buffer is reused),
+    returns false if there are no new rows
+    */
+    bool read(table_batch& batch, std::size_t max_rows = std::numeric_limits<std::size_t>::max())
+    {
+        std::size_t const rows = std::min(poll(), max_rows);
+        batch.first_row = next_row;
+        batch.rows = rows;
+        batch.data.resize(rows * layout.naxis(1));
+        if (rows == 0)
+        {
+            return false;
+        }
+
+        file.clear();
+        file.seekg(data_start + static_cast<std::streamoff>(next_row * layout.naxis(1)));
+        file.read(batch.data.data(), static_cast<std::streamsize>(batch.data.size()));
+        if (!file)
+        {
+            throw file_io_exception();
+        }
+        next_row += rows;
+        return true;
+    }
+
+    /*!
+    polls every interval until new rows arrive or timeout expires, returns number of rows
+    available
+    */
+    std::size_t wait
+    (
+        std::chrono::milliseconds timeout,
+        std::chrono::milliseconds interval = std::chrono::milliseconds(10)
+    )
+    {
+        auto const deadline = std::chrono::steady_clock::now() + timeout;
+        std::size_t rows = poll();
+        while (rows == 0 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(interval);
+            rows = poll();
+        }
+        return rows;
+    }
+
+private:
+    std::size_t read_naxis2()
+    {
+        char buffer[80];
+        file.seekg(naxis2_card);
+        file.read(buffer, 80);
+        if (!file)
+        {
+            throw file_io_exception();
+        }
+        card naxis2(buffer);
+        if (naxis2.key() != "NAXIS2")
+        {
+            throw file_io_exception();
+        }
+        return naxis2.value<std::size_t>();
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_TABLE_FOLLOWER_HPP
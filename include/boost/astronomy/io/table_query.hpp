@@ -0,0 +1,334 @@
+#ifndef BOOST_ASTRONOMY_IO_TABLE_QUERY_HPP
+#define BOOST_ASTRONOMY_IO_TABLE_QUERY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include <boost/astronomy/io/column_view.hpp>
+#include <boost/astronomy/detail/parallel_for.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+namespace detail {
+
+//! spreads std::hash output (identity for integers in most implementations) over partitions
+inline std::size_t partition_of(std::size_t hash, std::size_t partitions)
+{
+    std::uint64_t mixed = static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::size_t>((mixed >> 32) % partitions);
+}
+
+/*!
+decodes all keys of the view and buckets the positions by hash partition,
+rows[worker][partition] keeps every worker's positions in increasing order
+*/
+template <typename Key>
+void partition_keys
+(
+    column_view<Key> const& view,
+    std::size_t threads,
+    std::size_t partitions,
+    std::vector<Key>& keys,
+    std::vector<std::vector<std::vector<std::size_t>>>& rows
+)
+{
+    keys.resize(view.size());
+    rows.assign(threads, std::vector<std::vector<std::size_t>>(partitions));
+    std::hash<Key> hasher;
+
+    boost::astronomy::detail::parallel_for(view.size(), threads,
+        [&](std::size_t begin, std::size_t end, std::size_t worker)
+        {
+            for (std::size_t i = begin; i < end; i++)
+            {
+                keys[i] = view[i];
+                rows[worker][partition_of(hasher(keys[i]), partitions)].push_back(i);
+            }
+        });
+}
+
+} //namespace detail
+
+//!matching row pairs of an inner join, left_rows[i] joins right_rows[i]
+struct join_result
+{
+    std::vector<std::size_t> left_rows;
+    std::vector<std::size_t> right_rows;
+
+    std::size_t size() const
+    {
+        return left_rows.size();
+    }
+};
+
+/*!
+inner equi-join of two key columns (positions are positions in the views).
+both sides are split into hash partitions in parallel, then each partition builds a hash table
+on its right side rows and probes it with its left side rows, so partitions are joined
+independently without locking. pairs come out grouped by partition; within a partition they
+are ordered by left position. the right side should be the smaller one (e.g. the object table)
+*/
+template <typename Key>
+join_result hash_join
+(
+    column_view<Key> const& left,
+    column_view<Key> const& right,
+    std::size_t threads = 0
+)
+{
+    threads = boost::astronomy::detail::thread_count(threads);
+    std::size_t const partitions = threads * 4;
+
+    std::vector<Key> left_keys, right_keys;
+    std::vector<std::vector<std::vector<std::size_t>>> left_rows, right_rows;
+    detail::partition_keys(left, threads, partitions, left_keys, left_rows);
+    detail::partition_keys(right, threads, partitions, right_keys, right_rows);
+
+    std::vector<join_result> partial(partitions);
+    boost::astronomy::detail::parallel_for(partitions, threads,
+        [&](std::size_t begin, std::size_t end, std::size_t)
+        {
+            for (std::size_t p = begin; p < end; p++)
+            {
+                std::unordered_multimap<Key, std::size_t> table;
+                for (auto const& worker_rows : right_rows)
+                {
+                    for (auto row : worker_rows[p])
+                    {
+                        table.emplace(right_keys[row], row);
+                    }
+                }
+
+                if (table.empty())
+                {
+                    continue;
+                }
+
+                for (auto const& worker_rows : left_rows)
+                {
+                    for (auto row : worker_rows[p])
+                    {
+                        auto range = table.equal_range(left_keys[row]);
+                        for (auto match = range.first; match != range.second; ++match)
+                        {
+                            partial[p].left_rows.push_back(row);
+                            partial[p].right_rows.push_back(match->second);
+                        }
+                    }
+                }
+            }
+        });
+
+    join_result result;
+    std::size_t total = 0;
+    for (auto const& part : partial)
+    {
+        total += part.size();
+    }
+    result.left_rows.reserve(total);
+    result.right_rows.reserve(total);
+    for (auto const& part : partial)
+    {
+        result.left_rows.insert(result.left_rows.end(),
+            part.left_rows.begin(), part.left_rows.end());
+        result.right_rows.insert(result.right_rows.end(),
+            part.right_rows.begin(), part.right_rows.end());
+    }
+    return result;
+}
+
+
+//!aggregate functions supported by group_by, NaN (TNULL) values are ignored by all of them
+enum class aggregate
+{
+    count, //! number of non null values
+    sum,
+    mean,
+    min,
+    max
+};
+
+//!one aggregate column of group_by, values must have as many rows as the key view
+struct aggregation
+{
+    aggregate function;
+    column_view<double> values;
+
+    aggregation(aggregate f, column_view<double> const& v) : function(f), values(v) {}
+};
+
+//!groups sorted by key, values[a][g] is the result of a-th aggregation for g-th group
+template <typename Key>
+struct group_by_result
+{
+    std::vector<Key> keys;
+    std::vector<std::size_t> counts; //! number of rows in each group
+    std::vector<std::vector<double>> values;
+};
+
+namespace detail {
+
+struct aggregate_state
+{
+    std::size_t count = 0;
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double value)
+    {
+        if (std::isnan(value))
+        {
+            return;
+        }
+        count++;
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void merge(aggregate_state const& other)
+    {
+        count += other.count;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    double result(aggregate function) const
+    {
+        switch (function)
+        {
+        case aggregate::count:
+            return static_cast<double>(count);
+        case aggregate::sum:
+            return sum;
+        case aggregate::mean:
+            return count ? sum / static_cast<double>(count) :
+                std::numeric_limits<double>::quiet_NaN();
+        case aggregate::min:
+            return count ? min : std::numeric_limits<double>::quiet_NaN();
+        case aggregate::max:
+            return count ? max : std::numeric_limits<double>::quiet_NaN();
+        }
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+};
+
+//!groups of one worker, states[g * aggregations + a]
+template <typename Key>
+struct partial_groups
+{
+    std::unordered_map<Key, std::size_t> index;
+    std::vector<Key> keys;
+    std::vector<std::size_t> counts;
+    std::vector<aggregate_state> states;
+};
+
+} //namespace detail
+
+/*!
+groups rows by key and evaluates the aggregations per group. every worker aggregates its own
+range of rows into a private hash table, the partial tables are merged afterwards so only
+the key column and the aggregated columns are ever decoded
+*/
+template <typename Key>
+group_by_result<Key> group_by
+(
+    column_view<Key> const& keys,
+    std::vector<aggregation> const& aggregations,
+    std::size_t threads = 0
+)
+{
+    for (auto const& a : aggregations)
+    {
+        if (a.values.size() != keys.size())
+        {
+            throw column_length_mismatch_exception();
+        }
+    }
+
+    threads = boost::astronomy::detail::thread_count(threads);
+    std::size_t const width = aggregations.size();
+    std::vector<detail::partial_groups<Key>> partial(threads);
+
+    boost::astronomy::detail::parallel_for(keys.size(), threads,
+        [&](std::size_t begin, std::size_t end, std::size_t worker)
+        {
+            detail::partial_groups<Key>& groups = partial[worker];
+            for (std::size_t i = begin; i < end; i++)
+            {
+                auto inserted = groups.index.emplace(keys[i], groups.keys.size());
+                if (inserted.second)
+                {
+                    groups.keys.push_back(inserted.first->first);
+                    groups.counts.push_back(0);
+                    groups.states.resize(groups.states.size() + width);
+                }
+
+                std::size_t const g = inserted.first->second;
+                groups.counts[g]++;
+                for (std::size_t a = 0; a < width; a++)
+                {
+                    groups.states[g * width + a].add(aggregations[a].values[i]);
+                }
+            }
+        });
+
+    detail::partial_groups<Key>& merged = partial[0];
+    for (std::size_t worker = 1; worker < partial.size(); worker++)
+    {
+        detail::partial_groups<Key> const& groups = partial[worker];
+        for (std::size_t g = 0; g < groups.keys.size(); g++)
+        {
+            auto inserted = merged.index.emplace(groups.keys[g], merged.keys.size());
+            if (inserted.second)
+            {
+                merged.keys.push_back(groups.keys[g]);
+                merged.counts.push_back(0);
+                merged.states.resize(merged.states.size() + width);
+            }
+
+            std::size_t const target = inserted.first->second;
+            merged.counts[target] += groups.counts[g];
+            for (std::size_t a = 0; a < width; a++)
+            {
+                merged.states[target * width + a].merge(groups.states[g * width + a]);
+            }
+        }
+    }
+
+    std::vector<std::size_t> order(merged.keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&merged](std::size_t lhs, std::size_t rhs) {
+        return merged.keys[lhs] < merged.keys[rhs];
+    });
+
+    group_by_result<Key> result;
+    result.keys.reserve(order.size());
+    result.counts.reserve(order.size());
+    result.values.assign(width, std::vector<double>());
+    for (auto g : order)
+    {
+        result.keys.push_back(merged.keys[g]);
+        result.counts.push_back(merged.counts[g]);
+        for (std::size_t a = 0; a < width; a++)
+        {
+            result.values[a].push_back(merged.states[g * width + a].result(aggregations[a].function));
+        }
+    }
+    return result;
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_TABLE_QUERY_HPP
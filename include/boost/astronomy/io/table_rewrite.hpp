@@ -0,0 +1,344 @@
+#ifndef BOOST_ASTRONOMY_IO_TABLE_REWRITE_HPP
+#define BOOST_ASTRONOMY_IO_TABLE_REWRITE_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/table_extension.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/ascii_table.hpp>
+#include <boost/astronomy/io/bit_column.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//!tuning of rewrite_table
+struct rewrite_options
+{
+    std::size_t buffer_size = std::size_t(8) << 20; //! bytes of source rows read at once
+};
+
+namespace detail {
+
+//!bytes of one field moved from the source row to the target row
+struct field_copy
+{
+    std::size_t source;
+    std::size_t target;
+    std::size_t size;
+};
+
+//!column keywords carrying the column number, renumbered or dropped by the rewrite
+inline bool is_column_keyword(std::string const& prefix)
+{
+    static char const* const keywords[] = {
+        "TTYPE", "TFORM", "TUNIT", "TSCAL", "TZERO", "TNULL", "TDISP", "TDIM", "TBCOL",
+        "TLMIN", "TLMAX", "TDMIN", "TDMAX", "TCTYP", "TCUNI", "TCRPX", "TCRVL", "TCDLT", "TCROT"
+    };
+    return std::find(std::begin(keywords), std::end(keywords), prefix) != std::end(keywords);
+}
+
+//!source layout of a table: offset in the row and width of every field, in TFIELDS order
+struct table_layout
+{
+    std::unique_ptr<table_extension> table;
+    std::vector<std::size_t> offsets;
+    std::vector<std::size_t> widths;
+};
+
+inline table_layout read_layout(hdu const& header)
+{
+    std::string const kind = boost::trim_copy_if(
+        header.value_of<std::string>("XTENSION"),
+        [](char c) -> bool { return c == '\'' || c == ' '; });
+
+    table_layout layout;
+    if (kind == "BINTABLE")
+    {
+        auto table = std::make_unique<binary_table_extension>(header);
+        for (auto const& col : table->get_columns())
+        {
+            char const type = table->get_type(col.TFORM());
+            if (type == 'P' || type == 'Q')
+            {
+                //descriptors point into the heap which is not copied
+                throw invalid_table_colum_format();
+            }
+            layout.offsets.push_back(col.TBCOL());
+            layout.widths.push_back(table->column_size(col.TFORM()));
+        }
+        layout.table = std::move(table);
+    }
+    else if (kind == "TABLE")
+    {
+        auto table = std::make_unique<ascii_table>(header);
+        for (auto const& col : table->get_columns())
+        {
+            layout.offsets.push_back(col.TBCOL() - 1);
+            layout.widths.push_back(table->column_size(col.TFORM()));
+        }
+        layout.table = std::move(table);
+    }
+    else
+    {
+        throw wrong_extension_type();
+    }
+    return layout;
+}
+
+/*!
+header of the rewritten table: the source cards in their original order with the row geometry
+updated, column keywords of dropped columns removed and the others renumbered.
+numbers[i] is the new (1 based) number of i-th source column or 0 if it is dropped
+*/
+inline std::vector<card> rewrite_header
+(
+    table_layout const& layout,
+    std::vector<std::size_t> const& numbers,
+    std::vector<std::size_t> const& target_offsets,
+    std::size_t fields,
+    std::size_t row_size,
+    std::size_t rows
+)
+{
+    std::vector<card> cards;
+    for (auto const& c : layout.table->get_cards())
+    {
+        std::string const key = c.key();
+        card updated;
+        if (key == "END" || key == "THEAP")
+        {
+            continue;
+        }
+        else if (key == "NAXIS1")
+        {
+            updated.create_card(key, row_size);
+        }
+        else if (key == "NAXIS2")
+        {
+            updated.create_card(key, rows);
+        }
+        else if (key == "TFIELDS")
+        {
+            updated.create_card(key, fields);
+        }
+        else if (key == "PCOUNT")
+        {
+            updated.create_card(key, 0);
+        }
+        else
+        {
+            std::size_t const digits = key.find_last_not_of("0123456789") + 1;
+            if (digits == 0 || digits == key.length() || !is_column_keyword(key.substr(0, digits)))
+            {
+                cards.push_back(c);
+                continue;
+            }
+
+            std::size_t const number = boost::lexical_cast<std::size_t>(key.substr(digits));
+            if (number == 0 || number > numbers.size() || numbers[number - 1] == 0)
+            {
+                continue;
+            }
+
+            std::string const renamed = key.substr(0, digits) +
+                boost::lexical_cast<std::string>(numbers[number - 1]);
+            if (key.substr(0, digits) == "TBCOL")
+            {
+                updated.create_card(renamed, target_offsets[number - 1] + 1);
+            }
+            else
+            {
+                updated = card(renamed + std::string(8 - renamed.length(), ' ') + c.raw().substr(8));
+            }
+        }
+        cards.push_back(updated);
+    }
+    return cards;
+}
+
+inline std::size_t rewrite_table
+(
+    std::istream& file,
+    fits_writer& writer,
+    std::vector<std::string> const& columns,
+    bit_mask const* selection,
+    rewrite_options const& options
+)
+{
+    hdu header(file);
+    std::streampos const data_start = file.tellg();
+    table_layout layout = read_layout(header);
+    table_extension& table = *layout.table;
+
+    std::size_t const source_row_size = table.naxis(1);
+    std::size_t const total_rows = table.naxis(2);
+    if (selection && selection->size() != total_rows)
+    {
+        throw invalid_selection_mask_size();
+    }
+
+    //columns in the requested order, all of them if none are named
+    std::vector<std::size_t> kept;
+    if (columns.empty())
+    {
+        for (std::size_t i = 0; i < table.get_columns().size(); i++)
+        {
+            kept.push_back(i);
+        }
+    }
+    for (auto const& name : columns)
+    {
+        kept.push_back(table.get_column_info(name).index() - 1);
+    }
+
+    std::vector<std::size_t> numbers(table.get_columns().size(), 0);
+    std::vector<std::size_t> target_offsets(table.get_columns().size(), 0);
+    std::vector<field_copy> copies;
+    std::size_t row_size = 0;
+    for (std::size_t k = 0; k < kept.size(); k++)
+    {
+        std::size_t const i = kept[k];
+        if (numbers[i] != 0)
+        {
+            throw invalid_table_colum_format();
+        }
+        numbers[i] = k + 1;
+        target_offsets[i] = row_size;
+
+        //fields adjacent in both layouts are moved by one copy
+        if (!copies.empty() && copies.back().source + copies.back().size == layout.offsets[i] &&
+            copies.back().target + copies.back().size == row_size)
+        {
+            copies.back().size += layout.widths[i];
+        }
+        else
+        {
+            copies.push_back(field_copy{layout.offsets[i], row_size, layout.widths[i]});
+        }
+        row_size += layout.widths[i];
+    }
+
+    std::size_t const rows = selection ? selection->count() : total_rows;
+    writer.write_header(rewrite_header(layout, numbers, target_offsets, kept.size(), row_size, rows));
+
+    std::size_t const block_rows = std::max<std::size_t>(1,
+        options.buffer_size / std::max<std::size_t>(1, source_row_size));
+    std::vector<char> source(block_rows * source_row_size);
+    std::vector<char> target(block_rows * row_size);
+    for (std::size_t first = 0; first < total_rows; first += block_rows)
+    {
+        std::size_t const count = std::min(block_rows, total_rows - first);
+        file.read(source.data(), static_cast<std::streamsize>(count * source_row_size));
+        if (!file)
+        {
+            throw file_io_exception();
+        }
+
+        char* out = target.data();
+        for (std::size_t r = 0; r < count; r++)
+        {
+            if (selection && !selection->test(first + r))
+            {
+                continue;
+            }
+            char const* in = source.data() + r * source_row_size;
+            for (auto const& copy : copies)
+            {
+                std::memcpy(out + copy.target, in + copy.source, copy.size);
+            }
+            out += row_size;
+        }
+        writer.write_data(target.data(), static_cast<std::size_t>(out - target.data()));
+    }
+    writer.end_data();
+
+    //skip the heap so the file is left at the next HDU
+    file.seekg(data_start + static_cast<std::streamoff>(
+        source_row_size * total_rows + table.value_of<std::size_t>("PCOUNT")));
+    table.set_unit_end(file);
+    return rows;
+}
+
+} //namespace detail
+
+/*!
+writes a copy of the table whose header starts at the current position of file, keeping only
+the given columns (in the given order, all columns if none are given). field bytes are moved
+from the source rows to the new row layout without being decoded; NAXIS1, NAXIS2, TFIELDS,
+TBCOLn (ascii tables) and all column keywords are regenerated. binary tables with variable
+length arrays are not supported. the file is left at the next HDU, returns rows written
+*/
+inline std::size_t rewrite_table
+(
+    std::istream& file,
+    fits_writer& writer,
+    std::vector<std::string> const& columns,
+    rewrite_options const& options = rewrite_options()
+)
+{
+    return detail::rewrite_table(file, writer, columns, nullptr, options);
+}
+
+//!same as above, only rows set in selection are written
+inline std::size_t rewrite_table
+(
+    std::istream& file,
+    fits_writer& writer,
+    std::vector<std::string> const& columns,
+    bit_mask const& selection,
+    rewrite_options const& options = rewrite_options()
+)
+{
+    return detail::rewrite_table(file, writer, columns, &selection, options);
+}
+
+//!writes the rewritten table as the only extension of a new file
+inline std::size_t rewrite_table
+(
+    std::istream& file,
+    std::string const& output_path,
+    std::vector<std::string> const& columns,
+    rewrite_options const& options = rewrite_options()
+)
+{
+    fits_writer writer(output_path);
+    writer.write_empty_primary();
+    std::size_t const rows = detail::rewrite_table(file, writer, columns, nullptr, options);
+    writer.close();
+    return rows;
+}
+
+//!writes the selected rows of the rewritten table as the only extension of a new file
+inline std::size_t rewrite_table
+(
+    std::istream& file,
+    std::string const& output_path,
+    std::vector<std::string> const& columns,
+    bit_mask const& selection,
+    rewrite_options const& options = rewrite_options()
+)
+{
+    fits_writer writer(output_path);
+    writer.write_empty_primary();
+    std::size_t const rows = detail::rewrite_table(file, writer, columns, &selection, options);
+    writer.close();
+    return rows;
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_TABLE_REWRITE_HPP
@@ -0,0 +1,318 @@
+#ifndef BOOST_ASTRONOMY_IO_TRACE_HPP
+#define BOOST_ASTRONOMY_IO_TRACE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*!
+timelines of the io layer. compiled with BOOST_ASTRONOMY_IO_ENABLE_TRACE, the spans placed
+with BOOST_ASTRONOMY_IO_TRACE record their begin and end on the thread they ran on. every
+thread writes to a ring buffer of its own without locking, tracing::write_chrome_json merges
+the buffers into a Chrome trace (chrome://tracing, ui.perfetto.dev), also while the traced
+threads keep running. without the macro the spans compile to nothing and the export writes
+an empty trace
+*/
+
+//!number of spans a thread keeps, older spans are overwritten
+#ifndef BOOST_ASTRONOMY_IO_TRACE_CAPACITY
+#define BOOST_ASTRONOMY_IO_TRACE_CAPACITY 65536
+#endif
+
+#define BOOST_ASTRONOMY_IO_TRACE_JOIN_IMPL(a, b) a##b
+#define BOOST_ASTRONOMY_IO_TRACE_JOIN(a, b) BOOST_ASTRONOMY_IO_TRACE_JOIN_IMPL(a, b)
+
+#ifdef BOOST_ASTRONOMY_IO_ENABLE_TRACE
+//!records a span named name (a string literal) from here to the end of the scope
+#define BOOST_ASTRONOMY_IO_TRACE(name) \
+    ::boost::astronomy::io::detail::trace_span \
+        BOOST_ASTRONOMY_IO_TRACE_JOIN(boost_astronomy_trace_span_, __LINE__)(name)
+#else
+#define BOOST_ASTRONOMY_IO_TRACE(name)
+#endif
+
+namespace boost { namespace astronomy { namespace io {
+
+//!one finished span
+struct trace_event
+{
+    char const* name = nullptr;
+    std::uint32_t thread = 0;   //! sequential id of the thread, in order of its first span
+    std::uint64_t begin_ns = 0; //! since the first span of the process
+    std::uint64_t end_ns = 0;
+};
+
+namespace detail {
+
+#ifdef BOOST_ASTRONOMY_IO_ENABLE_TRACE
+
+//!one slot of a ring, atomic so that readers may copy it while the owner overwrites it
+struct trace_slot
+{
+    std::atomic<char const*> name;
+    std::atomic<std::uint64_t> begin_ns;
+    std::atomic<std::uint64_t> end_ns;
+};
+
+/*!
+spans of one thread, a seqlock over the whole ring. only the owning thread writes: it bumps
+claimed before overwriting a slot and publishes head with release once done, so a reader
+that copied slots between loading head and claimed knows which of them may be torn. buffers
+outlive their threads, the spans of joined workers stay exportable
+*/
+struct trace_ring
+{
+    std::size_t capacity;
+    std::unique_ptr<trace_slot[]> slots;
+    std::atomic<std::uint64_t> head;    //! spans completely written
+    std::atomic<std::uint64_t> claimed; //! spans whose writing has started
+    std::atomic<std::uint64_t> base;    //! first span not dropped by tracing::clear
+    std::uint32_t thread;
+    trace_ring* next = nullptr;
+
+    explicit trace_ring(std::uint32_t id)
+        : capacity(BOOST_ASTRONOMY_IO_TRACE_CAPACITY),
+        slots(new trace_slot[BOOST_ASTRONOMY_IO_TRACE_CAPACITY]),
+        head(0), claimed(0), base(0), thread(id)
+    {}
+
+    void push(char const* name, std::uint64_t begin, std::uint64_t end)
+    {
+        std::uint64_t const span = head.load(std::memory_order_relaxed);
+        claimed.store(span + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        trace_slot& slot = slots[static_cast<std::size_t>(span % capacity)];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.begin_ns.store(begin, std::memory_order_relaxed);
+        slot.end_ns.store(end, std::memory_order_relaxed);
+        head.store(span + 1, std::memory_order_release);
+    }
+
+    //!appends the spans from base on that were not overwritten while they were copied
+    void collect(std::vector<trace_event>& result) const
+    {
+        std::uint64_t const end = head.load(std::memory_order_acquire);
+        std::uint64_t const first = std::max(base.load(std::memory_order_relaxed),
+            end > capacity ? end - capacity : 0);
+        std::size_t const start = result.size();
+        for (std::uint64_t span = first; span < end; span++)
+        {
+            trace_slot const& slot = slots[static_cast<std::size_t>(span % capacity)];
+            trace_event event;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.thread = thread;
+            event.begin_ns = slot.begin_ns.load(std::memory_order_relaxed);
+            event.end_ns = slot.end_ns.load(std::memory_order_relaxed);
+            result.push_back(event);
+        }
+
+        //spans below written - capacity were overwritten meanwhile, possibly halfway
+        std::atomic_thread_fence(std::memory_order_acquire);
+        std::uint64_t const written = claimed.load(std::memory_order_relaxed);
+        if (written > capacity && written - capacity > first)
+        {
+            std::uint64_t const torn = std::min(written - capacity, end) - first;
+            result.erase(result.begin() + static_cast<std::ptrdiff_t>(start),
+                result.begin() + static_cast<std::ptrdiff_t>(start + torn));
+        }
+    }
+};
+
+//!lock free list of the ring buffers of all threads that recorded a span
+struct trace_registry
+{
+    std::atomic<trace_ring*> first;
+    std::atomic<std::uint32_t> threads;
+    std::chrono::steady_clock::time_point epoch;
+
+    trace_registry() : first(nullptr), threads(0), epoch(std::chrono::steady_clock::now()) {}
+
+    trace_registry(trace_registry const&) = delete;
+    trace_registry& operator=(trace_registry const&) = delete;
+
+    ~trace_registry()
+    {
+        trace_ring* ring = first.load();
+        while (ring != nullptr)
+        {
+            trace_ring* const next = ring->next;
+            delete ring;
+            ring = next;
+        }
+    }
+
+    trace_ring* add()
+    {
+        trace_ring* const ring = new trace_ring(threads.fetch_add(1));
+        ring->next = first.load(std::memory_order_relaxed);
+        while (!first.compare_exchange_weak(ring->next, ring,
+            std::memory_order_release, std::memory_order_relaxed))
+        {}
+        return ring;
+    }
+
+    std::uint64_t now() const
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count());
+    }
+};
+
+inline trace_registry& registry()
+{
+    static trace_registry instance;
+    return instance;
+}
+
+inline trace_ring& thread_ring()
+{
+    thread_local trace_ring* ring = registry().add();
+    return *ring;
+}
+
+//!records the time from its construction to its destruction on the calling thread
+struct trace_span
+{
+private:
+    char const* name;
+    std::uint64_t begin;
+
+public:
+    explicit trace_span(char const* span_name) : name(span_name), begin(registry().now()) {}
+
+    trace_span(trace_span const&) = delete;
+    trace_span& operator=(trace_span const&) = delete;
+
+    ~trace_span()
+    {
+        thread_ring().push(name, begin, registry().now());
+    }
+};
+
+#endif // BOOST_ASTRONOMY_IO_ENABLE_TRACE
+
+//!writes nanoseconds as microseconds with three decimals, the unit of Chrome traces
+inline void write_microseconds(std::ostream& out, std::uint64_t ns)
+{
+    std::string fraction = std::to_string(ns % 1000);
+    out << ns / 1000 << '.' << std::string(3 - fraction.size(), '0') << fraction;
+}
+
+inline void write_json_string(std::ostream& out, char const* text)
+{
+    out << '"';
+    for (; *text != '\0'; text++)
+    {
+        if (*text == '"' || *text == '\\')
+        {
+            out << '\\';
+        }
+        out << *text;
+    }
+    out << '"';
+}
+
+} //namespace detail
+
+//!access to the recorded spans of all threads
+struct tracing
+{
+    //!false when tracing is not compiled in
+    static bool enabled()
+    {
+#ifdef BOOST_ASTRONOMY_IO_ENABLE_TRACE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /*!
+    spans still held by the ring buffers, ordered by thread and begin. traced threads may keep
+    running: spans finishing meanwhile may or may not be included, and spans overwritten
+    while they were copied are left out
+    */
+    static std::vector<trace_event> collect()
+    {
+        std::vector<trace_event> result;
+#ifdef BOOST_ASTRONOMY_IO_ENABLE_TRACE
+        for (detail::trace_ring* ring = detail::registry().first.load(std::memory_order_acquire);
+            ring != nullptr; ring = ring->next)
+        {
+            ring->collect(result);
+        }
+        std::sort(result.begin(), result.end(), [](trace_event const& a, trace_event const& b) {
+            return a.thread != b.thread ? a.thread < b.thread : a.begin_ns < b.begin_ns;
+        });
+#endif
+        return result;
+    }
+
+    //!drops the spans recorded so far, spans finishing meanwhile may or may not be dropped
+    static void clear()
+    {
+#ifdef BOOST_ASTRONOMY_IO_ENABLE_TRACE
+        for (detail::trace_ring* ring = detail::registry().first.load(std::memory_order_acquire);
+            ring != nullptr; ring = ring->next)
+        {
+            ring->base.store(ring->head.load(std::memory_order_acquire),
+                std::memory_order_relaxed);
+        }
+#endif
+    }
+
+    //!writes the recorded spans as complete ("X") events of a Chrome trace
+    static void write_chrome_json(std::ostream& out)
+    {
+        std::vector<trace_event> const events = collect();
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        std::uint32_t named = 0;
+        for (auto const& event : events)
+        {
+            if (!first)
+            {
+                out << ',';
+            }
+            first = false;
+
+            //names the thread before its first span
+            if (event.thread >= named)
+            {
+                out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << event.thread
+                    << ",\"args\":{\"name\":\"thread " << event.thread << "\"}},";
+                named = event.thread + 1;
+            }
+
+            out << "{\"name\":";
+            detail::write_json_string(out, event.name);
+            out << ",\"cat\":\"io\",\"ph\":\"X\",\"ts\":";
+            detail::write_microseconds(out, event.begin_ns);
+            out << ",\"dur\":";
+            detail::write_microseconds(out, event.end_ns - event.begin_ns);
+            out << ",\"pid\":1,\"tid\":" << event.thread << '}';
+        }
+        out << "]}\n";
+    }
+
+    //!writes the trace to a file, returns false if it could not be written
+    static bool write_chrome_json(std::string const& file_name)
+    {
+        std::ofstream out(file_name, std::ios_base::out | std::ios_base::trunc);
+        write_chrome_json(out);
+        out.close();
+        return !out.fail();
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_TRACE_HPP
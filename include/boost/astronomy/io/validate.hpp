@@ -0,0 +1,759 @@
+#ifndef BOOST_ASTRONOMY_IO_VALIDATE_HPP
+#define BOOST_ASTRONOMY_IO_VALIDATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <boost/config.hpp>
+
+//!files are read with positional_file, so the validator is only available on POSIX platforms
+#ifdef BOOST_HAS_UNISTD_H
+
+#include <boost/astronomy/io/card_value.hpp>
+#include <boost/astronomy/io/positional_file.hpp>
+#include <boost/astronomy/detail/parallel_for.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//!severity of a validation diagnostic
+enum class severity
+{
+    warning, //! not conforming, but the structure of the file can still be read
+    error    //! the file is not a valid FITS file, readers may fail or read garbage
+};
+
+//!one problem found by the validator
+struct diagnostic
+{
+    io::severity level;
+    std::uint64_t offset; //! file offset of the card, block or byte concerned
+    std::size_t hdu;      //! index of the HDU, 0 is the primary HDU
+    std::string keyword;  //! keyword concerned, empty if none
+    std::string message;
+};
+
+//!result of validating one file
+struct validation_report
+{
+    std::string file;
+    std::uint64_t file_size = 0;
+    std::size_t hdus = 0;      //! HDUs whose header could be located
+    std::uint64_t bytes_read = 0; //! bytes read from the file, data units are not read
+    std::vector<diagnostic> diagnostics;
+
+    //!true if there is no diagnostic of severity error
+    bool valid() const
+    {
+        return std::none_of(diagnostics.begin(), diagnostics.end(),
+            [](diagnostic const& d) { return d.level == severity::error; });
+    }
+};
+
+//!tuning of validation
+struct validation_options
+{
+    std::size_t threads = 0; //! workers validating files, 0 uses hardware concurrency
+    std::size_t read_size = std::size_t(1) << 20; //! bytes read at once, whole blocks
+    bool check_padding = true; //! check the fill bytes of the last block of every data unit
+};
+
+namespace detail {
+
+//!a card of a header with its value (string values without quotes and trailing blanks)
+struct parsed_card
+{
+    std::string key;
+    std::string value;
+    bool quoted;
+    std::uint64_t offset;
+};
+
+/*!
+validates one file at a time, reusing its read window. headers are read in reads of
+read_size bytes starting at the header, data units are skipped except for their last block
+when padding is checked
+*/
+struct validator
+{
+    validation_options options;
+    std::vector<char> window;
+    std::uint64_t window_offset = 0;
+    std::size_t window_size = 0;
+    positional_file file;
+    validation_report* report = nullptr;
+    std::size_t current_hdu = 0;
+
+    explicit validator(validation_options const& settings)
+        : options(settings),
+          window(std::max<std::size_t>(1, settings.read_size / 2880) * 2880)
+    {}
+
+    void add(io::severity level, std::uint64_t offset, std::string const& keyword,
+        std::string const& message)
+    {
+        report->diagnostics.push_back(diagnostic{level, offset, current_hdu, keyword, message});
+    }
+
+    //!the block at offset, nullptr if the file ends before the block does
+    char const* block(std::uint64_t offset)
+    {
+        if (offset >= window_offset && offset + 2880 <= window_offset + window_size)
+        {
+            return window.data() + (offset - window_offset);
+        }
+        window_offset = offset;
+        window_size = file.read_at(window.data(), window.size(), offset);
+        report->bytes_read += window_size;
+        return window_size >= 2880 ? window.data() : nullptr;
+    }
+
+    static bool blank(char const* first, char const* last)
+    {
+        return std::all_of(first, last, [](char c) { return c == ' '; });
+    }
+
+    static bool is_commentary(std::string const& key)
+    {
+        return key.empty() || key == "COMMENT" || key == "HISTORY";
+    }
+
+    //!checks the value of a value card, string values were checked by card_value
+    static bool valid_value(std::string const& value, bool quoted)
+    {
+        if (quoted || value.empty() || value == "T" || value == "F")
+        {
+            return true;
+        }
+        if (value.front() == '(')
+        {
+            return value.back() == ')';
+        }
+        return detail::is_number(value.data(), value.data() + value.size());
+    }
+
+    static bool parse_integer(std::string const& text, long long& value)
+    {
+        return detail::parse_integer(text.data(), text.data() + text.size(), value);
+    }
+
+    //!integer value of a card, strings holding digits are not integers
+    static bool parse_integer(parsed_card const& c, long long& value)
+    {
+        return !c.quoted && parse_integer(c.value, value);
+    }
+
+    /*!
+    reads and checks the cards of the header at offset up to END. returns false if the header
+    is truncated, end is set to the offset after its last block
+    */
+    bool read_header(std::uint64_t offset, std::vector<parsed_card>& cards, std::uint64_t& end)
+    {
+        cards.clear();
+        bool found_end = false;
+        bool reported_after_end = false;
+        for (std::uint64_t position = offset; !found_end; position += 2880)
+        {
+            char const* data = block(position);
+            if (data == nullptr)
+            {
+                add(severity::error, position, "", "header is truncated before its END card");
+                return false;
+            }
+
+            for (std::size_t c = 0; c < 36; c++)
+            {
+                char const* record = data + 80 * c;
+                std::uint64_t const card_offset = position + 80 * c;
+                if (found_end)
+                {
+                    if (!reported_after_end && !blank(record, record + 80))
+                    {
+                        add(severity::error, card_offset, "",
+                            "header padding after the END card is not blank");
+                        reported_after_end = true;
+                    }
+                    continue;
+                }
+
+                if (std::any_of(record, record + 80,
+                    [](char ch) { return ch < 0x20 || ch > 0x7E; }))
+                {
+                    add(severity::error, card_offset, "",
+                        "card contains characters that are not printable ASCII");
+                    continue;
+                }
+
+                std::size_t length = 0;
+                while (length < 8 && record[length] != ' ')
+                {
+                    length++;
+                }
+                std::string const key(record, length);
+                bool const valid_key = blank(record + length, record + 8) &&
+                    std::all_of(key.begin(), key.end(), [](char ch) {
+                        return (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') ||
+                            ch == '-' || ch == '_';
+                    });
+                if (!valid_key)
+                {
+                    add(severity::error, card_offset, std::string(record, 8),
+                        "keyword is not left justified upper case letters, digits, - or _");
+                    continue;
+                }
+
+                if (key == "END")
+                {
+                    if (!blank(record + 8, record + 80))
+                    {
+                        add(severity::error, card_offset, key,
+                            "END card has characters after the keyword");
+                    }
+                    found_end = true;
+                    continue;
+                }
+
+                parsed_card parsed{key, std::string(), false, card_offset};
+                if (!is_commentary(key) && record[8] == '=' && record[9] == ' ')
+                {
+                    char const* first;
+                    char const* last;
+                    bool const valid = detail::card_value(record, first, last, parsed.quoted);
+                    parsed.value.assign(first, last);
+                    if (!valid || !valid_value(parsed.value, parsed.quoted))
+                    {
+                        add(severity::error, card_offset, key, "value cannot be parsed");
+                    }
+                }
+                cards.push_back(parsed);
+            }
+            end = position + 2880;
+        }
+        return true;
+    }
+
+    static parsed_card const* find(std::vector<parsed_card> const& cards, std::string const& key)
+    {
+        auto found = std::find_if(cards.begin(), cards.end(),
+            [&key](parsed_card const& c) { return c.key == key; });
+        return found != cards.end() ? &*found : nullptr;
+    }
+
+    /*!
+    the mandatory keyword expected as card at position, reported if it is elsewhere or missing.
+    returns the card wherever it is, nullptr if missing
+    */
+    parsed_card const* expect
+    (
+        std::vector<parsed_card> const& cards,
+        std::size_t position,
+        std::string const& key,
+        std::uint64_t header_offset
+    )
+    {
+        if (position < cards.size() && cards[position].key == key)
+        {
+            return &cards[position];
+        }
+
+        parsed_card const* found = find(cards, key);
+        if (found != nullptr)
+        {
+            add(severity::error, found->offset, key, "mandatory keyword is out of order, "
+                "expected as card " + std::to_string(position + 1));
+        }
+        else
+        {
+            add(severity::error, position < cards.size() ? cards[position].offset : header_offset,
+                key, "mandatory keyword is missing");
+        }
+        return found;
+    }
+
+    bool expect_integer
+    (
+        std::vector<parsed_card> const& cards,
+        std::size_t position,
+        std::string const& key,
+        std::uint64_t header_offset,
+        long long& value
+    )
+    {
+        parsed_card const* found = expect(cards, position, key, header_offset);
+        if (found == nullptr)
+        {
+            return false;
+        }
+        if (!parse_integer(*found, value))
+        {
+            add(severity::error, found->offset, key, "value is not an integer");
+            return false;
+        }
+        return true;
+    }
+
+    //!product = a * b, false if it does not fit 64 bits
+    static bool checked_multiply(std::uint64_t a, std::uint64_t b, std::uint64_t& product)
+    {
+        if (a != 0 && b > std::numeric_limits<std::uint64_t>::max() / a)
+        {
+            return false;
+        }
+        product = a * b;
+        return true;
+    }
+
+    //!bytes of a binary table field of format form (rTa), false if the format is invalid
+    static bool binary_width(std::string const& form, long long& width)
+    {
+        std::size_t digits = 0;
+        while (digits < form.size() && form[digits] >= '0' && form[digits] <= '9')
+        {
+            digits++;
+        }
+        if (digits == form.size())
+        {
+            return false;
+        }
+        long long repeat = 1;
+        if (digits != 0 && (!parse_integer(form.substr(0, digits), repeat) ||
+            repeat > std::numeric_limits<long long>::max() / 16))
+        {
+            return false;
+        }
+
+        char const type = form[digits];
+        bool const descriptor = type == 'P' || type == 'Q';
+        if (!descriptor && digits + 1 != form.size() && type != 'A')
+        {
+            return false;
+        }
+
+        switch (type)
+        {
+        case 'L': case 'B': case 'A':
+            width = repeat;
+            return true;
+        case 'X':
+            width = (repeat + 7) / 8;
+            return true;
+        case 'I':
+            width = 2 * repeat;
+            return true;
+        case 'J': case 'E':
+            width = 4 * repeat;
+            return true;
+        case 'K': case 'D': case 'C': case 'P':
+            width = 8 * repeat;
+            return true;
+        case 'M': case 'Q':
+            width = 16 * repeat;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    //!characters of an ASCII table field of format form (Aw, Iw, Fw.d, Ew.d, Dw.d)
+    static bool ascii_width(std::string const& form, long long& width)
+    {
+        if (form.size() < 2 || std::string("AIFED").find(form[0]) == std::string::npos)
+        {
+            return false;
+        }
+        std::size_t const dot = form.find('.');
+        long long decimals = 0;
+        if (dot != std::string::npos &&
+            (form[0] == 'A' || form[0] == 'I' || !parse_integer(form.substr(dot + 1), decimals)))
+        {
+            return false;
+        }
+        return parse_integer(form.substr(1, dot == std::string::npos ? dot : dot - 1), width) &&
+            width > 0;
+    }
+
+    //!TFIELDS, TFORMn, TBCOLn and row width of a binary or ASCII table
+    void check_table
+    (
+        std::vector<parsed_card> const& cards,
+        std::string const& type,
+        long long bitpix,
+        std::vector<long long> const& axes,
+        std::size_t tfields_position,
+        long long pcount,
+        long long gcount,
+        std::uint64_t header_offset
+    )
+    {
+        bool const ascii = type == "TABLE";
+        if (bitpix != 8)
+        {
+            add(severity::error, header_offset, "BITPIX", "tables must have BITPIX = 8");
+        }
+        if (axes.size() != 2)
+        {
+            add(severity::error, header_offset, "NAXIS", "tables must have NAXIS = 2");
+        }
+        if (gcount != 1)
+        {
+            add(severity::error, header_offset, "GCOUNT", "tables must have GCOUNT = 1");
+        }
+        if (ascii && pcount != 0)
+        {
+            add(severity::error, header_offset, "PCOUNT", "ASCII tables must have PCOUNT = 0");
+        }
+
+        long long fields = 0;
+        if (!expect_integer(cards, tfields_position, "TFIELDS", header_offset, fields))
+        {
+            return;
+        }
+        if (fields < 0 || fields > 999)
+        {
+            add(severity::error, find(cards, "TFIELDS")->offset, "TFIELDS",
+                "TFIELDS must be between 0 and 999");
+            return;
+        }
+
+        long long const row = axes.size() == 2 ? axes[0] : -1;
+        long long total = 0;
+        bool complete = true;
+        for (long long n = 1; n <= fields; n++)
+        {
+            std::string const tform_key = "TFORM" + std::to_string(n);
+            parsed_card const* tform = find(cards, tform_key);
+            if (tform == nullptr)
+            {
+                add(severity::error, header_offset, tform_key, "field format is missing");
+                complete = false;
+                continue;
+            }
+
+            std::string const form = tform->value;
+            long long width = 0;
+            if (!(ascii ? ascii_width(form, width) : binary_width(form, width)))
+            {
+                add(severity::error, tform->offset, tform_key,
+                    "'" + form + "' is not a valid " + (ascii ? "ASCII" : "binary") +
+                    " table format");
+                complete = false;
+                continue;
+            }
+            if (width > std::numeric_limits<long long>::max() - total)
+            {
+                add(severity::error, tform->offset, tform_key, "row width overflows");
+                complete = false;
+                continue;
+            }
+            total += width;
+
+            if (ascii)
+            {
+                std::string const tbcol_key = "TBCOL" + std::to_string(n);
+                parsed_card const* tbcol = find(cards, tbcol_key);
+                long long column = 0;
+                if (tbcol == nullptr || !parse_integer(*tbcol, column))
+                {
+                    add(severity::error, tbcol ? tbcol->offset : header_offset, tbcol_key,
+                        "field position is missing or not an integer");
+                }
+                else if (column < 1 || (row >= 0 && width - 1 > row - column))
+                {
+                    add(severity::error, tbcol->offset, tbcol_key,
+                        "field " + std::to_string(n) + " does not fit in the row of NAXIS1 = " +
+                        std::to_string(row) + " characters");
+                }
+            }
+        }
+
+        if (!ascii && complete && row >= 0 && total != row)
+        {
+            parsed_card const* naxis1 = find(cards, "NAXIS1");
+            add(severity::error, naxis1 ? naxis1->offset : header_offset, "NAXIS1",
+                "NAXIS1 = " + std::to_string(row) + " differs from the " +
+                std::to_string(total) + " bytes of the fields");
+        }
+    }
+
+    /*!
+    checks the HDU whose header starts at offset, next is set to the offset after its data
+    unit. returns false when the rest of the file cannot be located
+    */
+    bool check_hdu(std::uint64_t offset, std::uint64_t& next)
+    {
+        std::vector<parsed_card> cards;
+        std::uint64_t data_offset = 0;
+        if (!read_header(offset, cards, data_offset))
+        {
+            return false;
+        }
+        report->hdus++;
+
+        bool const primary = current_hdu == 0;
+        std::string type;
+        if (primary)
+        {
+            parsed_card const* simple = expect(cards, 0, "SIMPLE", offset);
+            if (simple != nullptr && !simple->quoted && simple->value == "F")
+            {
+                add(severity::warning, simple->offset, "SIMPLE",
+                    "SIMPLE = F, the file does not conform to the standard");
+            }
+            else if (simple != nullptr && (simple->quoted || simple->value != "T"))
+            {
+                add(severity::error, simple->offset, "SIMPLE", "SIMPLE must be T");
+            }
+        }
+        else
+        {
+            parsed_card const* xtension = expect(cards, 0, "XTENSION", offset);
+            if (xtension != nullptr)
+            {
+                type = xtension->value;
+            }
+        }
+
+        long long bitpix = 0;
+        long long naxis = 0;
+        bool sized = expect_integer(cards, 1, "BITPIX", offset, bitpix);
+        sized = expect_integer(cards, 2, "NAXIS", offset, naxis) && sized;
+        if (sized && bitpix != 8 && bitpix != 16 && bitpix != 32 && bitpix != 64 &&
+            bitpix != -32 && bitpix != -64)
+        {
+            add(severity::error, find(cards, "BITPIX")->offset, "BITPIX",
+                "BITPIX must be 8, 16, 32, 64, -32 or -64");
+            sized = false;
+        }
+        if (sized && (naxis < 0 || naxis > 999))
+        {
+            add(severity::error, find(cards, "NAXIS")->offset, "NAXIS", "NAXIS must be between 0 and 999");
+            sized = false;
+        }
+
+        std::vector<long long> axes;
+        for (long long i = 1; sized && i <= naxis; i++)
+        {
+            std::string const key = "NAXIS" + std::to_string(i);
+            long long length = 0;
+            if (!expect_integer(cards, static_cast<std::size_t>(2 + i), key, offset, length))
+            {
+                sized = false;
+            }
+            else if (length < 0)
+            {
+                add(severity::error, find(cards, key)->offset, key, "axis length is negative");
+                sized = false;
+            }
+            axes.push_back(length);
+        }
+
+        long long pcount = 0;
+        long long gcount = 1;
+        if (sized && !primary)
+        {
+            std::size_t const position = static_cast<std::size_t>(3 + naxis);
+            sized = expect_integer(cards, position, "PCOUNT", offset, pcount) && sized;
+            sized = expect_integer(cards, position + 1, "GCOUNT", offset, gcount) && sized;
+            if (type == "IMAGE" && (pcount != 0 || gcount != 1))
+            {
+                add(severity::error, offset, "PCOUNT", "image extensions must have PCOUNT = 0 "
+                    "and GCOUNT = 1");
+            }
+            else if (type == "BINTABLE" || type == "TABLE")
+            {
+                check_table(cards, type, bitpix, axes, position + 2, pcount, gcount, offset);
+            }
+        }
+        else if (sized && find(cards, "GROUPS") != nullptr)
+        {
+            //random groups keep PCOUNT and GCOUNT in the primary header
+            parsed_card const* p = find(cards, "PCOUNT");
+            parsed_card const* g = find(cards, "GCOUNT");
+            sized = (p == nullptr || parse_integer(*p, pcount)) &&
+                (g == nullptr || parse_integer(*g, gcount));
+        }
+
+        if (!sized || pcount < 0 || gcount < 0)
+        {
+            add(severity::error, offset, "",
+                "size of the data unit cannot be determined, the rest of the file is not checked");
+            return false;
+        }
+
+        //random groups have NAXIS1 = 0, which is not part of the product. the values come from
+        //the file, so every step is checked for overflow
+        std::uint64_t elements = axes.empty() ? 0 : 1;
+        bool fits = true;
+        for (std::size_t i = 0; fits && i < axes.size(); i++)
+        {
+            std::uint64_t const axis = (i == 0 && axes[i] == 0 && axes.size() > 1) ?
+                1 : static_cast<std::uint64_t>(axes[i]);
+            fits = checked_multiply(elements, axis, elements);
+        }
+        std::uint64_t size = 0;
+        fits = fits && elements <= std::numeric_limits<std::uint64_t>::max() -
+            static_cast<std::uint64_t>(pcount) &&
+            checked_multiply(static_cast<std::uint64_t>(std::abs(bitpix) / 8),
+                static_cast<std::uint64_t>(gcount), size) &&
+            checked_multiply(size, static_cast<std::uint64_t>(pcount) + elements, size) &&
+            size <= std::numeric_limits<std::uint64_t>::max() - 2879;
+        if (!fits)
+        {
+            add(severity::error, offset, "", "data unit size overflows, the rest of the file is "
+                "not checked");
+            return false;
+        }
+        std::uint64_t const padded = (size + 2879) / 2880 * 2880;
+
+        std::uint64_t const available = report->file_size - data_offset;
+        if (size > available)
+        {
+            add(severity::error, data_offset, "", "data unit of " + std::to_string(size) +
+                " bytes is truncated, the file has " + std::to_string(available) +
+                " bytes after the header");
+            return false;
+        }
+        if (padded > available)
+        {
+            add(severity::error, data_offset + size, "",
+                "last block of the data unit is incomplete");
+            return false;
+        }
+
+        if (options.check_padding && size % 2880 != 0)
+        {
+            //ASCII tables are padded with blanks, everything else with zeros
+            char const fill = type == "TABLE" ? ' ' : '\0';
+            std::uint64_t const last = data_offset + padded - 2880;
+            char const* data = block(last);
+            std::size_t const used = static_cast<std::size_t>(size % 2880);
+            char const* bad = std::find_if(data + used, data + 2880,
+                [fill](char c) { return c != fill; });
+            if (bad != data + 2880)
+            {
+                add(severity::warning, last + static_cast<std::uint64_t>(bad - data), "",
+                    type == "TABLE" ? "data padding is not blank" : "data padding is not zero");
+            }
+        }
+
+        next = data_offset + padded;
+        return true;
+    }
+
+    //!validates the file with given name
+    validation_report validate(std::string const& file_name)
+    {
+        validation_report result;
+        result.file = file_name;
+        report = &result;
+        current_hdu = 0;
+        window_offset = 0;
+        window_size = 0;
+
+        bool opened = false;
+        try
+        {
+            file = positional_file(file_name);
+            opened = true;
+            result.file_size = file.size();
+            if (result.file_size == 0)
+            {
+                add(severity::error, 0, "", "file is empty");
+            }
+
+            std::uint64_t offset = 0;
+            while (offset < result.file_size)
+            {
+                std::uint64_t const remaining = result.file_size - offset;
+                if (remaining < 2880)
+                {
+                    add(severity::error, offset, "", "file ends with a partial block of " +
+                        std::to_string(remaining) + " bytes");
+                    break;
+                }
+                char const* data = block(offset);
+                if (data == nullptr)
+                {
+                    throw file_io_exception();
+                }
+                if (current_hdu != 0 && std::memcmp(data, "XTENSION", 8) != 0)
+                {
+                    add(severity::warning, offset, "", std::to_string(remaining) +
+                        " bytes after the last HDU are not an extension");
+                    break;
+                }
+
+                std::uint64_t next = 0;
+                if (!check_hdu(offset, next))
+                {
+                    break;
+                }
+                offset = next;
+                current_hdu++;
+            }
+        }
+        catch (file_io_exception const&)
+        {
+            add(severity::error, 0, "",
+                opened ? "error while reading the file" : "file cannot be opened");
+        }
+
+        file = positional_file();
+        report = nullptr;
+        return result;
+    }
+};
+
+} //namespace detail
+
+/*!
+checks the block structure of a FITS file without decoding its data: card syntax, position of
+END and blank header padding, order of mandatory keywords, TFORM and TBCOL of tables against
+the row width, data unit sizes against the file length and (optionally) the fill bytes of
+data units. problems are reported with their file offset, checking stops at the first HDU
+whose successor cannot be located
+*/
+inline validation_report validate_file
+(
+    std::string const& file_name,
+    validation_options const& options = validation_options()
+)
+{
+    return detail::validator(options).validate(file_name);
+}
+
+//!validates files in parallel, reports come out in the order of files
+inline std::vector<validation_report> validate_files
+(
+    std::vector<std::string> const& files,
+    validation_options const& options = validation_options()
+)
+{
+    std::vector<validation_report> reports(files.size());
+    std::atomic<std::size_t> next(0);
+    std::size_t const threads = std::min(
+        boost::astronomy::detail::thread_count(options.threads), std::max<std::size_t>(1, files.size()));
+    boost::astronomy::detail::parallel_for(threads, threads,
+        [&](std::size_t, std::size_t, std::size_t)
+        {
+            detail::validator worker(options);
+            for (std::size_t f = next++; f < files.size(); f = next++)
+            {
+                reports[f] = worker.validate(files[f]);
+            }
+        });
+    return reports;
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // BOOST_HAS_UNISTD_H
+
+#endif // !BOOST_ASTRONOMY_IO_VALIDATE_HPP
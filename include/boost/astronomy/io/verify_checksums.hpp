@@ -0,0 +1,74 @@
+#ifndef BOOST_ASTRONOMY_IO_VERIFY_CHECKSUMS_HPP
+#define BOOST_ASTRONOMY_IO_VERIFY_CHECKSUMS_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/checksum.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+/*!
+verifies CHECKSUM and DATASUM of every HDU from the current position of file to its end in a
+single pass. data units are read in chunks of about buffer_size bytes (whole blocks), each
+chunk is summed by threads workers
+*/
+inline std::vector<checksum_status> verify_checksums
+(
+    std::istream& file,
+    std::size_t threads = 1,
+    std::size_t buffer_size = std::size_t(8) << 20
+)
+{
+    std::vector<checksum_status> result;
+    std::vector<char> buffer(std::max<std::size_t>(1, buffer_size / 2880) * 2880);
+
+    while (file.peek() != std::char_traits<char>::eof())
+    {
+        hdu header(file);
+        std::size_t remaining = (header.data_size() + 2879) / 2880 * 2880;
+
+        checksum_accumulator sum;
+        while (remaining != 0)
+        {
+            std::size_t const chunk = std::min(remaining, buffer.size());
+            file.read(buffer.data(), static_cast<std::streamsize>(chunk));
+            if (!file)
+            {
+                throw file_io_exception();
+            }
+            sum = checksum_accumulator(
+                checksum_add(sum.value(), checksum(buffer.data(), chunk, threads)),
+                sum.size() + chunk);
+            remaining -= chunk;
+        }
+        result.push_back(header.verify_checksums(sum.value()));
+    }
+    return result;
+}
+
+//!verifies all HDUs of the file with given name
+inline std::vector<checksum_status> verify_checksums
+(
+    std::string const& file_name,
+    std::size_t threads = 1,
+    std::size_t buffer_size = std::size_t(8) << 20
+)
+{
+    std::fstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    if (!file.is_open())
+    {
+        throw file_io_exception();
+    }
+    return verify_checksums(file, threads, buffer_size);
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_VERIFY_CHECKSUMS_HPP
@@ -0,0 +1,236 @@
+#define BOOST_TEST_MODULE io_bit_column_test
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/bit_column.hpp>
+#include <boost/astronomy/io/column_data.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+std::size_t const rows = 200;
+std::size_t const flag_bits = 70;
+std::size_t const flag_bytes = 9;
+char const* const file_name = "io_bit_column_test.fits";
+
+bool flag(std::size_t row, std::size_t bit)
+{
+    return (row + bit) % 7 == 0;
+}
+
+void write_test_file()
+{
+    std::ofstream file(file_name, std::ios_base::out | std::ios_base::binary);
+    write_header(file, {
+        "SIMPLE  =                    T",
+        "BITPIX  =                    8",
+        "NAXIS   =                    0",
+        "EXTEND  =                    T"
+    });
+    write_header(file, {
+        "XTENSION= 'BINTABLE'",
+        "BITPIX  =                    8",
+        "NAXIS   =                    2",
+        "NAXIS1  =                   14",
+        "NAXIS2  =                  200",
+        "PCOUNT  =                    0",
+        "GCOUNT  =                    1",
+        "TFIELDS =                    3",
+        "TTYPE1  = 'FLAGS   '",
+        "TFORM1  = '70X     '",
+        "TTYPE2  = 'VALID   '",
+        "TFORM2  = 'L       '",
+        "TTYPE3  = 'ID      '",
+        "TFORM3  = 'J       '",
+        "EXTNAME = 'EVENTS  '"
+    });
+
+    std::string data;
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        char bytes[flag_bytes] = {};
+        for (std::size_t bit = 0; bit < flag_bits; bit++)
+        {
+            if (flag(row, bit))
+            {
+                bytes[bit / 8] = static_cast<char>(bytes[bit / 8] | (0x80 >> (bit % 8)));
+            }
+        }
+        data.append(bytes, flag_bytes);
+        data += (row % 3 == 0) ? 'T' : 'F';
+        data += '\0';
+        data += '\0';
+        data += static_cast<char>(row >> 8);
+        data += static_cast<char>(row & 0xFF);
+    }
+    write_block(file, data, '\0');
+}
+
+binary_table_extension read_test_table()
+{
+    write_test_file();
+    std::fstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+    return binary_table_extension(file);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(bit_column_test)
+
+BOOST_AUTO_TEST_CASE(bit_mask_operations)
+{
+    bit_mask a(130, {0, 64, 129});
+    bit_mask b(130, {64, 100});
+
+    BOOST_TEST(a.count() == 3u);
+    BOOST_TEST((a & b).count() == 1u);
+    BOOST_TEST((a | b).count() == 4u);
+    BOOST_TEST((a ^ b).count() == 3u);
+    BOOST_TEST((~a).count() == 127u);
+    BOOST_TEST(bit_mask(130, true).all());
+    BOOST_TEST(bit_mask(130).none());
+
+    std::vector<std::size_t> indices;
+    a.for_each_set([&indices](std::size_t i) { indices.push_back(i); });
+    BOOST_TEST((indices == std::vector<std::size_t>{0, 64, 129}));
+
+    BOOST_CHECK_THROW(a &= bit_mask(10), boost::astronomy::invalid_selection_mask_size);
+}
+
+BOOST_AUTO_TEST_CASE(packed_bit_column)
+{
+    binary_table_extension table = read_test_table();
+    auto flags = table.get_bit_column("FLAGS");
+
+    BOOST_REQUIRE(flags);
+    BOOST_TEST(flags->rows() == rows);
+    BOOST_TEST(flags->bits_per_row() == flag_bits);
+    BOOST_TEST(flags->words_per_row() == 2u);
+
+    std::size_t total = 0;
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        for (std::size_t bit = 0; bit < flag_bits; bit++)
+        {
+            BOOST_TEST(flags->test(row, bit) == flag(row, bit));
+            total += flag(row, bit);
+        }
+    }
+    BOOST_TEST(flags->count() == total);
+
+    std::size_t rows_with_bit_3 = 0;
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        rows_with_bit_3 += flag(row, 3);
+    }
+    BOOST_TEST(flags->count(3) == rows_with_bit_3);
+
+    bit_mask pattern(flag_bits, {1, 66});
+    bit_mask any = flags->any_of(pattern);
+    bit_mask all = flags->all_of(pattern);
+    bit_mask none = flags->none_of(pattern);
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        BOOST_TEST(any.test(row) == (flag(row, 1) || flag(row, 66)));
+        BOOST_TEST(all.test(row) == (flag(row, 1) && flag(row, 66)));
+        BOOST_TEST(none.test(row) == !(flag(row, 1) || flag(row, 66)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(packed_short_rows)
+{
+    //10 bit rows straddle word boundaries
+    std::size_t const short_rows = 100;
+    bit_column column(short_rows, 10);
+    BOOST_TEST(column.packed());
+    for (std::size_t row = 0; row < short_rows; row++)
+    {
+        column.set_row_value(row, row * 7);
+    }
+    column.set(13, 9);
+    column.set(13, 9, false);
+
+    std::size_t rows_with_bit_2 = 0;
+    for (std::size_t row = 0; row < short_rows; row++)
+    {
+        BOOST_TEST(column.row_value(row) == (row * 7) % 1024);
+        BOOST_TEST(column.test(row, 2) == (((row * 7) >> 2) & 1));
+        rows_with_bit_2 += ((row * 7) >> 2) & 1;
+    }
+    BOOST_TEST(column.count(2) == rows_with_bit_2);
+
+    bit_mask pattern(10, {0, 2});
+    bit_mask all = column.all_of(pattern);
+    for (std::size_t row = 0; row < short_rows; row++)
+    {
+        BOOST_TEST(all.test(row) == (((row * 7) & 5) == 5));
+    }
+
+    binary_table_extension table = read_test_table();
+    auto valid = table.get_bit_column("VALID");
+    BOOST_REQUIRE(valid);
+    BOOST_TEST(valid->packed());
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        BOOST_TEST(valid->test(row) == (row % 3 == 0));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(packed_bytes_column_read)
+{
+    binary_table_extension table = read_test_table();
+    auto flags = table.get_column("FLAGS");
+
+    BOOST_REQUIRE(flags);
+    auto& values = static_cast<column_data<std::vector<char>>&>(*flags).get_data();
+
+    BOOST_REQUIRE(values.size() == rows);
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        BOOST_REQUIRE(values[row].size() == flag_bytes);
+        for (std::size_t bit = 0; bit < flag_bits; bit++)
+        {
+            bool const set = (static_cast<unsigned char>(values[row][bit / 8]) & (0x80 >> (bit % 8))) != 0;
+            BOOST_TEST(set == flag(row, bit));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(selection_feeds_column_read)
+{
+    binary_table_extension table = read_test_table();
+    auto valid = table.get_bit_column("VALID");
+
+    BOOST_REQUIRE(valid);
+    bit_mask selection = valid->select() & table.get_bit_column("FLAGS")->select(0);
+
+    auto ids = table.get_column("ID", selection);
+    auto& values = static_cast<column_data<std::int32_t>&>(*ids).get_data();
+
+    std::vector<std::int32_t> expected;
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        if (row % 3 == 0 && flag(row, 0))
+        {
+            expected.push_back(static_cast<std::int32_t>(row));
+        }
+    }
+    BOOST_TEST(values == expected, boost::test_tools::per_element());
+
+    BOOST_CHECK_THROW(table.get_bit_column("ID"), boost::astronomy::invalid_table_colum_format);
+    BOOST_CHECK_THROW(table.get_column("ID", bit_mask(3)),
+        boost::astronomy::invalid_selection_mask_size);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,220 @@
+#define BOOST_TEST_MODULE io_byte_source_test
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/config.hpp>
+
+#ifdef BOOST_HAS_UNISTD_H
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/column_view.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/positional_file.hpp>
+#include <boost/astronomy/io/byte_source.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+char const* const file_name = "io_byte_source_test.fits";
+std::size_t const tables = 2;
+
+std::size_t table_rows(std::size_t table)
+{
+    return 1000 * (table + 1) + 3;
+}
+
+//one 'J' column holding 1000 * table + row
+void write_test_file()
+{
+    fits_writer writer(file_name, 1);
+    writer.write_empty_primary();
+
+    for (std::size_t table = 0; table < tables; table++)
+    {
+        write_int_table
+        (
+            writer, table_rows(table), "T" + std::to_string(table),
+            [table](std::size_t row) { return 1000 * table + row; }
+        );
+    }
+}
+
+std::string file_contents()
+{
+    std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+//reads every unit of the test file sequentially, true if all values match
+bool read_all(std::istream& stream)
+{
+    hdu primary(stream);
+    for (std::size_t table = 0; table < tables; table++)
+    {
+        binary_table_extension extension(stream);
+        column_view<std::int64_t> values(extension, "VALUE");
+        if (values.size() != table_rows(table))
+        {
+            return false;
+        }
+        for (std::size_t row = 0; row < values.size(); row++)
+        {
+            if (values[row] != static_cast<std::int64_t>(1000 * table + row))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//stream buffer handing out a string a few bytes at a time and refusing to seek
+struct trickle_streambuf : public std::streambuf
+{
+    std::string const& bytes;
+    std::size_t next = 0;
+    char chunk[7];
+
+    explicit trickle_streambuf(std::string const& source) : bytes(source) {}
+
+    int_type underflow() override
+    {
+        std::size_t const count = bytes.copy(chunk, sizeof(chunk), next);
+        next += count;
+        setg(chunk, chunk, chunk + count);
+        return count == 0 ? traits_type::eof() : traits_type::to_int_type(chunk[0]);
+    }
+};
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(byte_source_test)
+
+BOOST_AUTO_TEST_CASE(memory)
+{
+    write_test_file();
+    std::string const contents = file_contents();
+
+    memory_stream stream(contents);
+    BOOST_TEST(read_all(stream));
+
+    stream.clear();
+    stream.seekg(2880);
+    BOOST_TEST(stream.tellg() == 2880);
+    std::string part(8, '\0');
+    stream.read(&part[0], 8);
+    BOOST_TEST(part == "XTENSION");
+    stream.seekg(-4, std::ios_base::end);
+    BOOST_TEST(stream.tellg() == static_cast<std::streamoff>(contents.size() - 4));
+    stream.seekg(10, std::ios_base::end);
+    BOOST_TEST(stream.fail());
+
+    memory_stream primary(contents);
+    BOOST_CHECK_NO_THROW(fits{primary});
+}
+
+#ifdef BOOST_HAS_UNISTD_H
+BOOST_AUTO_TEST_CASE(mapping)
+{
+    write_test_file();
+    std::string const contents = file_contents();
+
+    mapped_file const mapped(file_name);
+    BOOST_REQUIRE(mapped.size() == contents.size());
+    BOOST_TEST(std::string(mapped.data(), mapped.size()) == contents);
+    mapped_stream stream(mapped);
+    BOOST_TEST(read_all(stream));
+
+    BOOST_CHECK_THROW(mapped_file("io_byte_source_test.missing"),
+        boost::astronomy::file_io_exception);
+}
+
+BOOST_AUTO_TEST_CASE(descriptors)
+{
+    write_test_file();
+    std::string const contents = file_contents();
+
+    //a seekable descriptor of the caller, left open
+    int const fd = ::open(file_name, O_RDONLY);
+    BOOST_REQUIRE(fd >= 0);
+    {
+        positional_stream stream{positional_file(fd)};
+        BOOST_TEST(read_all(stream));
+    }
+    BOOST_TEST(::fcntl(fd, F_GETFD) != -1);
+    ::close(fd);
+
+    //a pipe, read sequentially with a buffer smaller than a card
+    int ends[2];
+    BOOST_REQUIRE(::pipe(ends) == 0);
+    std::thread writer([&]() {
+        std::size_t done = 0;
+        while (done < contents.size())
+        {
+            ssize_t const count = ::write(ends[1], contents.data() + done,
+                std::min<std::size_t>(contents.size() - done, 1000));
+            if (count <= 0)
+            {
+                break;
+            }
+            done += static_cast<std::size_t>(count);
+        }
+        ::close(ends[1]);
+    });
+    forward_stream<descriptor_source> piped{descriptor_source(ends[0]), 50};
+    BOOST_TEST(read_all(piped));
+    writer.join();
+    ::close(ends[0]);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(sequential_streams)
+{
+    write_test_file();
+    std::string const contents = file_contents();
+
+    trickle_streambuf trickle(contents);
+    std::istream raw(&trickle);
+    forward_stream<istream_source> stream(istream_source(raw), 100);
+    BOOST_TEST(read_all(stream));
+
+    //forward seeks skip, backward seeks stay within the buffer
+    trickle_streambuf again(contents);
+    std::istream second_raw(&again);
+    forward_stream<istream_source> second(istream_source(second_raw), 100);
+    second.seekg(2880);
+    BOOST_TEST(second.tellg() == 2880);
+    std::string part(8, '\0');
+    second.read(&part[0], 8);
+    BOOST_TEST(part == "XTENSION");
+    second.seekg(2880);
+    BOOST_TEST(second.get() == 'X');
+    second.seekg(5760 + 80);
+    BOOST_TEST(second.tellg() == 5760 + 80);
+    BOOST_TEST(second.get() == static_cast<unsigned char>(contents[5760 + 80]));
+    second.seekg(0);
+    BOOST_TEST(second.fail());
+
+    trickle_streambuf third(contents);
+    std::istream third_raw(&third);
+    forward_stream<istream_source> fits_stream{istream_source(third_raw)};
+    BOOST_CHECK_NO_THROW(fits{fits_stream});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
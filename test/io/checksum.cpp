@@ -0,0 +1,187 @@
+#define BOOST_TEST_MODULE io_checksum_test
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/checksum.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/primary_hdu.hpp>
+#include <boost/astronomy/io/image_extension.hpp>
+#include <boost/astronomy/io/verify_checksums.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+char const* const file_name = "io_checksum_test.fits";
+std::size_t const rows = 5000;
+
+std::vector<card> table_header(std::size_t row_count)
+{
+    std::vector<card> cards = table_cards(3, row_count, {"3A"});
+    cards.emplace_back(std::string("EXTNAME = 'DATA'"));
+    return cards;
+}
+
+std::string table_data(std::size_t row_count)
+{
+    std::string data;
+    for (std::size_t row = 0; row < row_count; row++)
+    {
+        data += static_cast<char>(row % 251);
+        data += static_cast<char>(row % 13);
+        data += static_cast<char>(255 - row % 7);
+    }
+    return data;
+}
+
+//two tables, the first one larger than the writer buffer
+void write_test_file()
+{
+    fits_writer writer(file_name, 2);
+    writer.write_checksums(true);
+    writer.write_empty_primary();
+
+    std::string data = table_data(rows);
+    writer.write_header(table_header(rows));
+    writer.write_data(data.data(), 7);
+    writer.write_data(data.data() + 7, data.size() - 7);
+
+    data = table_data(10);
+    writer.write_header(table_header(10));
+    writer.write_data(data.data(), data.size());
+}
+
+void corrupt(std::size_t offset)
+{
+    std::fstream file(file_name, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    file.seekg(static_cast<std::streamoff>(offset));
+    char byte = static_cast<char>(file.get());
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.put(static_cast<char>(byte ^ 0x10));
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(checksum_test)
+
+BOOST_AUTO_TEST_CASE(sums_and_encoding)
+{
+    std::string data = table_data(1001);
+
+    checksum_accumulator whole;
+    whole.update(data.data(), data.size());
+
+    checksum_accumulator pieces;
+    for (std::size_t first = 0; first < data.size(); first += 7)
+    {
+        pieces.update(data.data() + first, std::min<std::size_t>(7, data.size() - first));
+    }
+    BOOST_TEST(pieces.value() == whole.value());
+    BOOST_TEST(checksum(data.data(), data.size(), 3) == whole.value());
+
+    std::string padded = data + std::string(5, ' ');
+    checksum_accumulator filled = whole;
+    filled.update_fill(' ', 5);
+    BOOST_TEST(filled.value() == checksum(padded.data(), padded.size()));
+
+    //values from the reference implementation of the checksum convention
+    BOOST_TEST(encode_checksum(0) == "0000000000000000");
+    BOOST_TEST(encode_checksum(0x12345678u) == "N6AGN49EN4AEN49E");
+    BOOST_TEST(encode_checksum(0xFFFFFFFFu) == "orrrrooooooooooo");
+}
+
+BOOST_AUTO_TEST_CASE(write_and_verify)
+{
+    write_test_file();
+
+    auto status = verify_checksums(std::string(file_name), 2, 2880);
+    BOOST_REQUIRE(status.size() == 3u);
+    for (auto const& s : status)
+    {
+        BOOST_TEST(s.has_checksum);
+        BOOST_TEST(s.has_datasum);
+        BOOST_TEST(s.valid());
+    }
+
+    std::fstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+    binary_table_extension table(file);
+    BOOST_TEST(table.verify_checksums(table.data_checksum(2)).valid());
+    BOOST_TEST(table.value_of<std::string>("DATASUM") ==
+        "'" + std::to_string(table.data_checksum()) + "'");
+}
+
+BOOST_AUTO_TEST_CASE(sums_taken_while_reading)
+{
+    {
+        fits_writer writer(file_name);
+        writer.write_checksums(true);
+        std::vector<card> cards(6);
+        cards[0].create_card("SIMPLE", true);
+        cards[1].create_card("BITPIX", 16);
+        cards[2].create_card("NAXIS", 2);
+        cards[3].create_card("NAXIS1", 33);
+        cards[4].create_card("NAXIS2", 7);
+        cards[5].create_card("EXTEND", true);
+        writer.write_header(cards);
+        std::string const pixels = table_data(154);
+        writer.write_data(pixels.data(), pixels.size());
+
+        cards[0].create_card("XTENSION", std::string("'IMAGE'"));
+        cards[1].create_card("BITPIX", -32);
+        cards[5].create_card("PCOUNT", 0);
+        cards.emplace_back();
+        cards.back().create_card("GCOUNT", 1);
+        cards.emplace_back(std::string("EXTNAME = 'PIXELS'"));
+        writer.write_header(cards);
+        std::string const values = table_data(308);
+        writer.write_data(values.data(), values.size());
+
+        std::string const data = table_data(rows);
+        writer.write_header(table_header(rows));
+        writer.write_data(data.data(), data.size());
+    }
+
+    std::fstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    primary_hdu<bitpix::B16> primary(file);
+    BOOST_TEST(primary.verify_checksums(primary.data_checksum()).valid());
+
+    image_extension<bitpix::_B32> extension(file);
+    BOOST_TEST(extension.verify_checksums(extension.data_checksum()).valid());
+
+    //the sum taken while reading matches a new sum of the table in memory
+    binary_table_extension table(file);
+    BOOST_TEST(table.verify_checksums(table.data_checksum()).valid());
+    BOOST_TEST(table.data_checksum() == checksum_accumulator(checksum(table.get_data().data(),
+        table.get_data().size()), table.get_data().size()).value());
+}
+
+BOOST_AUTO_TEST_CASE(detect_corruption)
+{
+    write_test_file();
+    corrupt(2 * 2880 + 100);
+    auto status = verify_checksums(std::string(file_name));
+    BOOST_TEST(status[0].valid());
+    BOOST_TEST(!status[1].datasum_valid);
+    BOOST_TEST(!status[1].checksum_valid);
+
+    //a changed header only breaks CHECKSUM
+    write_test_file();
+    corrupt(2880 + 30);
+    status = verify_checksums(std::string(file_name));
+    BOOST_TEST(status[1].datasum_valid);
+    BOOST_TEST(!status[1].checksum_valid);
+    BOOST_TEST(status[2].valid());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
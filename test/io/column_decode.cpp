@@ -0,0 +1,169 @@
+#define BOOST_TEST_MODULE io_column_decode_test
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/column_decode.hpp>
+#include <boost/astronomy/io/column_data.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+std::size_t const rows = 100;
+char const* const file_name = "io_column_decode_test.fits";
+
+binary_table_extension read_test_table()
+{
+    {
+        std::ofstream file(file_name, std::ios_base::out | std::ios_base::binary);
+        write_header(file, {
+            "SIMPLE  =                    T",
+            "BITPIX  =                    8",
+            "NAXIS   =                    0",
+            "EXTEND  =                    T"
+        });
+        write_header(file, {
+            "XTENSION= 'BINTABLE'",
+            "BITPIX  =                    8",
+            "NAXIS   =                    2",
+            "NAXIS1  =                   30",
+            "NAXIS2  =                  100",
+            "PCOUNT  =                    0",
+            "GCOUNT  =                    1",
+            "TFIELDS =                    6",
+            "TTYPE1  = 'COUNTS  '",
+            "TFORM1  = 'I       '",
+            "TZERO1  =                32768",
+            "TTYPE2  = 'FLUX    '",
+            "TFORM2  = 'J       '",
+            "TSCAL2  =                  0.5",
+            "TZERO2  =                 10.0",
+            "TNULL2  =                   -1",
+            "TTYPE3  = 'MAG     '",
+            "TFORM3  = 'E       '",
+            "TTYPE4  = 'MJD     '",
+            "TFORM4  = 'D       '",
+            "TTYPE5  = 'ID      '",
+            "TFORM5  = '1K      '",
+            "TTYPE6  = 'PAIR    '",
+            "TFORM6  = '2I      '",
+            "EXTNAME = 'EVENTS  '"
+        });
+
+        std::string data;
+        for (std::size_t row = 0; row < rows; row++)
+        {
+            append_big_endian(data, static_cast<std::int16_t>(row * 600 - 32768));
+            append_big_endian(data, row % 10 == 0 ? std::int32_t(-1) : static_cast<std::int32_t>(row));
+            append_big_endian(data, static_cast<float>(row) * 0.25f);
+            append_big_endian(data, 50000.0 + static_cast<double>(row));
+            append_big_endian(data, static_cast<std::int64_t>(row) << 40);
+            append_big_endian(data, static_cast<std::int16_t>(row));
+            append_big_endian(data, static_cast<std::int16_t>(-static_cast<int>(row)));
+        }
+        write_block(file, data, '\0');
+    }
+
+    std::fstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+    return binary_table_extension(file);
+}
+
+template <typename T>
+std::vector<T> values_of(std::unique_ptr<column> const& col)
+{
+    auto typed = dynamic_cast<column_data<T>*>(col.get());
+    BOOST_REQUIRE(typed != nullptr);
+    return std::vector<T>(typed->get_data().begin(), typed->get_data().end());
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(column_decode_test)
+
+BOOST_AUTO_TEST_CASE(kernels)
+{
+    std::string buffer;
+    append_big_endian(buffer, std::int16_t(-32768));
+    append_big_endian(buffer, std::int16_t(32767));
+    append_big_endian(buffer, std::int16_t(7));
+
+    std::uint16_t unsigned_values[3];
+    decode_strided(buffer.data(), 2, 3, sign_offset_decoder<std::int16_t>(), unsigned_values);
+    BOOST_TEST(unsigned_values[0] == 0u);
+    BOOST_TEST(unsigned_values[1] == 65535u);
+    BOOST_TEST(unsigned_values[2] == 32775u);
+
+    column_scaling scaling;
+    scaling.scale = 2.0;
+    scaling.zero = 1.0;
+    scaling.has_null = true;
+    scaling.null_value = 7;
+    double scaled[3];
+    decode_strided(buffer.data(), 2, 3, scaled_decoder<std::int16_t>(scaling), scaled);
+    BOOST_TEST(scaled[0] == -65535.0);
+    BOOST_TEST(scaled[1] == 65535.0);
+    BOOST_TEST(std::isnan(scaled[2]));
+
+    std::string bytes;
+    append_big_endian(bytes, std::uint8_t(0));
+    append_big_endian(bytes, std::uint8_t(255));
+    std::int8_t signed_bytes[2];
+    decode_strided(bytes.data(), 1, 2, sign_offset_decoder<std::uint8_t>(), signed_bytes);
+    BOOST_TEST(signed_bytes[0] == -128);
+    BOOST_TEST(signed_bytes[1] == 127);
+
+    column_scaling unsigned_convention;
+    unsigned_convention.zero = 2147483648.0;
+    BOOST_TEST(unsigned_convention.is_sign_offset<std::int32_t>());
+    BOOST_TEST(!unsigned_convention.is_sign_offset<std::int16_t>());
+}
+
+BOOST_AUTO_TEST_CASE(table_columns)
+{
+    binary_table_extension table = read_test_table();
+
+    auto counts = values_of<std::uint16_t>(table.get_column("COUNTS"));
+    auto flux = values_of<double>(table.get_column("FLUX"));
+    auto mag = values_of<float>(table.get_column("MAG"));
+    auto mjd = values_of<double>(table.get_column("MJD"));
+    auto id = values_of<std::int64_t>(table.get_column("ID"));
+    auto pair = values_of<std::vector<std::int16_t>>(table.get_column("PAIR"));
+
+    BOOST_REQUIRE(counts.size() == rows);
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        BOOST_TEST(counts[row] == row * 600);
+        if (row % 10 == 0)
+        {
+            BOOST_TEST(std::isnan(flux[row]));
+        }
+        else
+        {
+            BOOST_TEST(flux[row] == 10.0 + 0.5 * static_cast<double>(row));
+        }
+        BOOST_TEST(mag[row] == static_cast<float>(row) * 0.25f);
+        BOOST_TEST(mjd[row] == 50000.0 + static_cast<double>(row));
+        BOOST_TEST(id[row] == static_cast<std::int64_t>(row) << 40);
+        BOOST_TEST(pair[row][0] == static_cast<std::int16_t>(row));
+        BOOST_TEST(pair[row][1] == static_cast<std::int16_t>(-static_cast<int>(row)));
+    }
+
+    bit_mask selection(rows);
+    selection.set(3);
+    selection.set(97);
+    auto selected = values_of<std::uint16_t>(table.get_column("COUNTS", selection));
+    BOOST_TEST((selected == std::vector<std::uint16_t>{1800, 58200}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
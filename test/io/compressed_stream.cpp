@@ -0,0 +1,151 @@
+#define BOOST_TEST_MODULE io_compressed_stream_test
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/column_view.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/compressed_stream.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+namespace bio = boost::iostreams;
+
+namespace {
+
+char const* const file_name = "io_compressed_stream_test.fits";
+std::string const gzip_name = std::string(file_name) + ".gz";
+std::string const bzip2_name = std::string(file_name) + ".bz2";
+std::size_t const tables = 3;
+
+std::size_t table_rows(std::size_t table)
+{
+    return 20000 * (table + 1) + 11;
+}
+
+//one 'J' column holding 100000 * table + row
+void write_test_file()
+{
+    fits_writer writer(file_name, 1);
+    writer.write_empty_primary();
+
+    for (std::size_t table = 0; table < tables; table++)
+    {
+        write_int_table
+        (
+            writer, table_rows(table), "T" + std::to_string(table),
+            [table](std::size_t row) { return 100000 * table + row; }
+        );
+    }
+}
+
+template <typename Compressor>
+void compress(std::string const& target, Compressor compressor)
+{
+    std::ifstream source(file_name, std::ios_base::in | std::ios_base::binary);
+    std::ofstream file(target, std::ios_base::out | std::ios_base::binary);
+    bio::filtering_ostream output;
+    output.push(compressor);
+    output.push(file);
+    output << source.rdbuf();
+}
+
+void write_test_files()
+{
+    write_test_file();
+    compress(gzip_name, bio::gzip_compressor());
+    compress(bzip2_name, bio::bzip2_compressor());
+}
+
+//reads every unit of the test file sequentially, true if all values match
+bool read_all(std::istream& stream)
+{
+    hdu primary(stream);
+    for (std::size_t table = 0; table < tables; table++)
+    {
+        binary_table_extension extension(stream);
+        column_view<std::int64_t> values(extension, "VALUE");
+        if (values.size() != table_rows(table))
+        {
+            return false;
+        }
+        for (std::size_t row = 0; row < values.size(); row++)
+        {
+            if (values[row] != static_cast<std::int64_t>(100000 * table + row))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(compressed_stream_test)
+
+BOOST_AUTO_TEST_CASE(detection_and_sequential_reads)
+{
+    write_test_files();
+    BOOST_TEST((detect_compression(std::string(file_name)) == compression::none));
+    BOOST_TEST((detect_compression(gzip_name) == compression::gzip));
+    BOOST_TEST((detect_compression(bzip2_name) == compression::bzip2));
+
+    std::ifstream plain_file(file_name, std::ios_base::in | std::ios_base::binary);
+    std::size_t const plain_size = static_cast<std::size_t>(
+        std::distance(std::istreambuf_iterator<char>(plain_file),
+            std::istreambuf_iterator<char>()));
+
+    for (std::string const& name : {std::string(file_name), gzip_name, bzip2_name})
+    {
+        //window smaller than a table so it slides
+        compressed_stream stream(name, 4096);
+        BOOST_TEST(read_all(stream));
+        BOOST_TEST(stream.tellg() == static_cast<std::streamoff>(plain_size));
+    }
+
+    compressed_stream stream(gzip_name);
+    BOOST_TEST((stream.kind() == compression::gzip));
+    BOOST_CHECK_NO_THROW(fits{gzip_name});
+    BOOST_CHECK_NO_THROW(fits{bzip2_name});
+
+    BOOST_CHECK_THROW(compressed_stream("io_compressed_stream_test.missing"),
+        boost::astronomy::file_io_exception);
+}
+
+BOOST_AUTO_TEST_CASE(header_fast_path)
+{
+    write_test_files();
+    for (std::string const& name : {std::string(file_name), gzip_name, bzip2_name})
+    {
+        BOOST_TEST(read_hdu_header(name, 0).value_of<bool>("EXTEND"));
+        for (std::size_t table = 0; table < tables; table++)
+        {
+            hdu const header = read_hdu_header(name, table + 1);
+            BOOST_TEST(header.value_of<std::string>("EXTNAME") ==
+                "'T" + std::to_string(table) + "'");
+            BOOST_TEST(header.naxis(2) == table_rows(table));
+        }
+        BOOST_CHECK_THROW(read_hdu_header(name, tables + 1),
+            boost::astronomy::hdu_not_found_exception);
+    }
+
+    //the stream stops right after the wanted header
+    compressed_stream stream(gzip_name, 4096);
+    read_hdu_header(stream, 1);
+    BOOST_TEST(stream.tellg() == 2 * 2880);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
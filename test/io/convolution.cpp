@@ -0,0 +1,229 @@
+#define BOOST_TEST_MODULE io_convolution_test
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/convolution.hpp>
+#include <boost/astronomy/io/image.hpp>
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+std::size_t const width = 53;
+std::size_t const height = 31;
+
+template <typename PixelType>
+image_buffer<PixelType> make_image(std::size_t w = width, std::size_t h = height)
+{
+    image_buffer<PixelType> result(w, h);
+    for (std::size_t y = 0; y < h; y++)
+    {
+        for (std::size_t x = 0; x < w; x++)
+        {
+            result.view()(y, x) = static_cast<PixelType>((y * 7 + x * 13) % 23 + (x == y ? 50 : 0));
+        }
+    }
+    return result;
+}
+
+//pixel i of a line of n, written out case by case
+long reference_index(long i, long n, border mode)
+{
+    if (mode == border::replicate)
+    {
+        return i < 0 ? 0 : (i >= n ? n - 1 : i);
+    }
+    if (mode == border::wrap)
+    {
+        while (i < 0)
+        {
+            i += n;
+        }
+        return i % n;
+    }
+    if (mode == border::reflect)
+    {
+        while (i < 0 || i >= n)
+        {
+            i = i < 0 ? -i : 2 * (n - 1) - i;
+        }
+        return i;
+    }
+    return i >= 0 && i < n ? i : -1;
+}
+
+template <typename PixelType>
+std::vector<double> reference(image_buffer<PixelType> const& image,
+    convolution_kernel const& kernel, convolution_options const& options)
+{
+    long const w = static_cast<long>(image.get_width());
+    long const h = static_cast<long>(image.get_height());
+    long const aw = static_cast<long>(kernel.width() / 2);
+    long const ah = static_cast<long>(kernel.height() / 2);
+    std::vector<double> result;
+    for (long y = 0; y < h; y++)
+    {
+        for (long x = 0; x < w; x++)
+        {
+            double sum = 0;
+            for (long j = 0; j < static_cast<long>(kernel.height()); j++)
+            {
+                for (long i = 0; i < static_cast<long>(kernel.width()); i++)
+                {
+                    long const sy = reference_index(y - j + ah, h, options.mode);
+                    long const sx = reference_index(x - i + aw, w, options.mode);
+                    double const pixel = sy < 0 || sx < 0 ? options.border_value
+                        : static_cast<double>(image(static_cast<std::size_t>(sy),
+                            static_cast<std::size_t>(sx)));
+                    sum += kernel(static_cast<std::size_t>(j), static_cast<std::size_t>(i)) * pixel;
+                }
+            }
+            result.push_back(sum);
+        }
+    }
+    return result;
+}
+
+template <typename Result>
+void check(image_buffer<Result> const& result, std::vector<double> const& expected,
+    double tolerance)
+{
+    BOOST_REQUIRE(result.get_width() * result.get_height() == expected.size());
+    for (std::size_t y = 0; y < result.get_height(); y++)
+    {
+        for (std::size_t x = 0; x < result.get_width(); x++)
+        {
+            BOOST_TEST(std::abs(result(y, x) - expected[y * result.get_width() + x]) <= tolerance);
+        }
+    }
+}
+
+//asymmetric, so a missing flip shows
+convolution_kernel asymmetric_kernel(std::size_t w, std::size_t h)
+{
+    std::vector<double> values;
+    for (std::size_t i = 0; i < w * h; i++)
+    {
+        values.push_back(static_cast<double>(i % 5) - 1.5 + 0.1 * static_cast<double>(i));
+    }
+    return convolution_kernel(w, h, values);
+}
+
+std::vector<border> const modes{border::constant, border::replicate, border::reflect,
+    border::wrap};
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(convolution_test)
+
+BOOST_AUTO_TEST_CASE(separable_kernels)
+{
+    auto const image = make_image<std::uint16_t>();
+    separable_kernel const gaussian = gaussian_kernel(1.5);
+    BOOST_TEST(gaussian.horizontal.size() == 13u);
+
+    for (border mode : modes)
+    {
+        for (std::size_t threads : {1u, 3u})
+        {
+            convolution_options options;
+            options.mode = mode;
+            options.border_value = 4.0;
+            options.threads = threads;
+            options.method = convolution_method::direct;
+            auto const expected = reference(image, convolution_kernel(gaussian), options);
+            check(convolve(image, gaussian, options), expected, 1e-3);
+
+            separable_kernel const uneven({0.5, -1.0, 2.0, 0.25}, {1.0, 3.0});
+            check(convolve<double>(image, uneven, options),
+                reference(image, convolution_kernel(uneven), options), 1e-9);
+        }
+    }
+
+    //a mean filter keeps a flat image flat
+    image_buffer<float> flat(20, 10);
+    for (std::size_t y = 0; y < 10; y++)
+    {
+        for (std::size_t x = 0; x < 20; x++)
+        {
+            flat.view()(y, x) = 3.0f;
+        }
+    }
+    auto const smoothed = convolve(flat, box_kernel(5));
+    BOOST_TEST(std::abs(smoothed(0, 0) - 3.0f) < 1e-5f);
+    BOOST_TEST(std::abs(smoothed(9, 19) - 3.0f) < 1e-5f);
+}
+
+BOOST_AUTO_TEST_CASE(general_kernels)
+{
+    auto const image = make_image<float>();
+    for (border mode : modes)
+    {
+        for (auto const& kernel : {asymmetric_kernel(3, 5), asymmetric_kernel(4, 2),
+            asymmetric_kernel(1, 1)})
+        {
+            convolution_options options;
+            options.mode = mode;
+            options.border_value = -2.0;
+            options.threads = 4;
+            options.method = convolution_method::direct;
+            auto const expected = reference(image, kernel, options);
+            check(convolve<double>(image, kernel, options), expected, 1e-9);
+
+            options.method = convolution_method::fft;
+            check(convolve<double>(image, kernel, options), expected, 1e-8);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(large_kernels)
+{
+    //kernels wider than the image reach around it more than once
+    auto const image = make_image<std::int32_t>(9, 6);
+    convolution_kernel const kernel = asymmetric_kernel(21, 15);
+    for (border mode : modes)
+    {
+        convolution_options options;
+        options.mode = mode;
+        auto const expected = reference(image, kernel, options);
+        check(convolve<double>(image, kernel, options), expected, 1e-8);
+        options.method = convolution_method::direct;
+        check(convolve<double>(image, kernel, options), expected, 1e-8);
+    }
+
+    //the automatic choice gives the same answer for a wide gaussian
+    auto const big = make_image<float>(64, 48);
+    convolution_options options;
+    options.threads = 2;
+    auto const automatic = convolve(big, gaussian_kernel(6.0), options);
+    options.method = convolution_method::direct;
+    auto const direct = convolve(big, gaussian_kernel(6.0), options);
+    for (std::size_t y = 0; y < 48; y++)
+    {
+        for (std::size_t x = 0; x < 64; x++)
+        {
+            BOOST_TEST(std::abs(automatic(y, x) - direct(y, x)) < 1e-3f);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(in_place_and_errors)
+{
+    auto image = make_image<double>();
+    auto const expected = convolve<double>(image, gaussian_kernel(1.0));
+    convolve(image, gaussian_kernel(1.0), image);
+    BOOST_TEST(image(5, 7) == expected(5, 7));
+
+    BOOST_CHECK_THROW(gaussian_kernel(0.0), boost::astronomy::invalid_kernel_exception);
+    BOOST_CHECK_THROW(box_kernel(0), boost::astronomy::invalid_kernel_exception);
+    BOOST_CHECK_THROW(convolution_kernel(2, 2, std::vector<double>(3)),
+        boost::astronomy::invalid_kernel_exception);
+    BOOST_CHECK_THROW(convolve(image, separable_kernel()),
+        boost::astronomy::invalid_kernel_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,199 @@
+#define BOOST_TEST_MODULE io_external_sort_test
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/column_view.hpp>
+#include <boost/astronomy/io/external_sort.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+std::size_t const rows = 5000;
+char const* const input_name = "io_external_sort_test.fits";
+char const* const output_name = "io_external_sort_test_sorted.fits";
+
+std::int32_t row_id(std::size_t row)
+{
+    return static_cast<std::int32_t>((row * 7919) % 1000) - 500;
+}
+
+double row_ra(std::size_t row)
+{
+    return static_cast<double>((row * 104729) % 3600) / 10.0 - 180.0;
+}
+
+std::string row_name(std::size_t row)
+{
+    return "s" + std::to_string((row * 31) % 97);
+}
+
+void write_test_file()
+{
+    std::ofstream file(input_name, std::ios_base::out | std::ios_base::binary);
+    write_header(file, {
+        "SIMPLE  =                    T",
+        "BITPIX  =                    8",
+        "NAXIS   =                    0",
+        "EXTEND  =                    T"
+    });
+
+    write_header(file, {
+        "XTENSION= 'BINTABLE'",
+        "BITPIX  =                    8",
+        "NAXIS   =                    2",
+        "NAXIS1  =                   20",
+        "NAXIS2  =                 5000",
+        "PCOUNT  =                    0",
+        "GCOUNT  =                    1",
+        "TFIELDS =                    4",
+        "TTYPE1  = 'ID      '",
+        "TFORM1  = 'J       '",
+        "TTYPE2  = 'RA      '",
+        "TFORM2  = 'D       '",
+        "TTYPE3  = 'ROW     '",
+        "TFORM3  = 'J       '",
+        "TTYPE4  = 'NAME    '",
+        "TFORM4  = '4A      '",
+        "EXTNAME = 'CATALOG '"
+    });
+    std::string data;
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        append_big_endian(data, row_id(row));
+        append_big_endian(data, row_ra(row));
+        append_big_endian(data, static_cast<std::int32_t>(row));
+        std::string name = row_name(row);
+        data += name + std::string(4 - name.length(), ' ');
+    }
+    write_block(file, data, '\0');
+}
+
+template <typename Key>
+binary_table_extension sort_test_file
+(
+    std::string const& key_column,
+    std::size_t threads,
+    std::size_t merge_width = external_sort_options().merge_width
+)
+{
+    write_test_file();
+    {
+        std::fstream file(input_name, std::ios_base::in | std::ios_base::binary);
+        hdu primary(file);
+
+        external_sort_options options;
+        options.memory_budget = 16 * 1024; //forces a few dozen runs
+        options.threads = threads;
+        options.merge_width = merge_width;
+        external_sort<Key>(file, key_column, output_name, options);
+    }
+
+    std::fstream file(output_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+    return binary_table_extension(file);
+}
+
+//expected order of source rows, ties kept in the input order
+template <typename Key, typename Function>
+std::vector<std::int64_t> expected_rows(Function key_of)
+{
+    std::vector<std::pair<Key, std::int64_t>> keyed;
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        keyed.emplace_back(key_of(row), static_cast<std::int64_t>(row));
+    }
+    std::stable_sort(keyed.begin(), keyed.end(),
+        [](std::pair<Key, std::int64_t> const& lhs, std::pair<Key, std::int64_t> const& rhs) {
+            return lhs.first < rhs.first;
+        });
+
+    std::vector<std::int64_t> order;
+    for (auto const& k : keyed)
+    {
+        order.push_back(k.second);
+    }
+    return order;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(external_sort_test)
+
+BOOST_AUTO_TEST_CASE(sort_by_integer_key)
+{
+    for (std::size_t threads : {1u, 3u})
+    {
+        binary_table_extension sorted = sort_test_file<std::int64_t>("ID", threads);
+        BOOST_REQUIRE(sorted.naxis(2) == rows);
+
+        auto source_rows = column_view<std::int64_t>(sorted, "ROW").materialize();
+        BOOST_TEST((source_rows == expected_rows<std::int32_t>(row_id)));
+
+        column_view<std::string> names(sorted, "NAME");
+        for (std::size_t i = 0; i < rows; i++)
+        {
+            BOOST_TEST(names[i] == row_name(static_cast<std::size_t>(source_rows[i])));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sort_by_real_and_string_keys)
+{
+    binary_table_extension by_ra = sort_test_file<double>("RA", 2);
+    BOOST_TEST((column_view<std::int64_t>(by_ra, "ROW").materialize() ==
+        expected_rows<double>(row_ra)));
+
+    binary_table_extension by_name = sort_test_file<std::string>("NAME", 2);
+    BOOST_TEST((column_view<std::int64_t>(by_name, "ROW").materialize() ==
+        expected_rows<std::string>(row_name)));
+}
+
+BOOST_AUTO_TEST_CASE(multi_pass_merge)
+{
+    //a few dozen runs merged three at a time take several passes
+    binary_table_extension sorted = sort_test_file<std::int64_t>("ID", 2, 3);
+    BOOST_REQUIRE(sorted.naxis(2) == rows);
+    BOOST_TEST((column_view<std::int64_t>(sorted, "ROW").materialize() ==
+        expected_rows<std::int32_t>(row_id)));
+
+    //no run is left behind
+    for (auto const& entry : boost::filesystem::directory_iterator("."))
+    {
+        BOOST_TEST(entry.path().extension().string() != ".run");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(missing_temp_directory)
+{
+    write_test_file();
+    std::fstream file(input_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+
+    external_sort_options options;
+    options.temp_directory = "io_external_sort_test.missing";
+    BOOST_CHECK_THROW(external_sort<std::int64_t>(file, "ID", output_name, options),
+        boost::astronomy::file_io_exception);
+}
+
+BOOST_AUTO_TEST_CASE(missing_key_column)
+{
+    write_test_file();
+    std::fstream file(input_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+    BOOST_CHECK_THROW(external_sort<std::int64_t>(file, "MISSING", output_name),
+        boost::astronomy::column_not_found_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,209 @@
+#define BOOST_TEST_MODULE io_fft_test
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/fft.hpp>
+#include <boost/astronomy/io/image.hpp>
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+std::vector<std::complex<double>> naive_dft(std::vector<std::complex<double>> const& in,
+    bool inverse)
+{
+    double const pi = 3.14159265358979323846;
+    std::size_t const n = in.size();
+    std::vector<std::complex<double>> out(n);
+    for (std::size_t k = 0; k < n; k++)
+    {
+        for (std::size_t j = 0; j < n; j++)
+        {
+            double const angle = (inverse ? 2 : -2) * pi * static_cast<double>((j * k) % n) /
+                static_cast<double>(n);
+            out[k] += in[j] * std::polar(1.0, angle);
+        }
+    }
+    return out;
+}
+
+std::vector<std::complex<double>> signal(std::size_t n)
+{
+    std::vector<std::complex<double>> values;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double const t = static_cast<double>(i);
+        values.emplace_back(std::sin(0.7 * t) + 0.01 * t, std::cos(1.3 * t * t));
+    }
+    return values;
+}
+
+double largest_difference(std::vector<std::complex<double>> const& a,
+    std::vector<std::complex<double>> const& b)
+{
+    double largest = 0;
+    for (std::size_t i = 0; i < a.size(); i++)
+    {
+        largest = std::max(largest, std::abs(a[i] - b[i]));
+    }
+    return largest;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(fft_test)
+
+BOOST_AUTO_TEST_CASE(complex_against_naive_dft)
+{
+    for (std::size_t n : {1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 12u, 30u, 49u, 60u, 97u, 128u, 210u,
+        243u, 1000u})
+    {
+        auto const in = signal(n);
+        double const tolerance = 1e-9 * static_cast<double>(n);
+        BOOST_TEST_CONTEXT("length " << n)
+        {
+            BOOST_TEST(largest_difference(fft(in.data(), n), naive_dft(in, false)) < tolerance);
+            BOOST_TEST(largest_difference(fft(in.data(), n, true), naive_dft(in, true)) < tolerance);
+
+            auto const back = fft(fft(in.data(), n).data(), n, true);
+            for (std::size_t i = 0; i < n; i++)
+            {
+                BOOST_TEST(std::abs(back[i] / static_cast<double>(n) - in[i]) < tolerance);
+            }
+        }
+    }
+
+    BOOST_TEST(fft_plan::get(60).get() == fft_plan::get(60).get());
+    BOOST_CHECK_THROW(fft_plan(0), boost::astronomy::invalid_fft_size_exception);
+}
+
+BOOST_AUTO_TEST_CASE(real_transforms)
+{
+    for (std::size_t n : {1u, 2u, 5u, 10u, 15u, 64u, 90u, 101u})
+    {
+        std::vector<float> column;
+        std::vector<std::complex<double>> complex_column;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            column.push_back(static_cast<float>(std::sin(0.3 * static_cast<double>(i * i)) + 1));
+            complex_column.emplace_back(column.back(), 0.0);
+        }
+
+        BOOST_TEST_CONTEXT("length " << n)
+        {
+            auto const spectrum = real_fft(column);
+            auto const expected = naive_dft(complex_column, false);
+            BOOST_REQUIRE(spectrum.size() == n / 2 + 1);
+            for (std::size_t k = 0; k < spectrum.size(); k++)
+            {
+                BOOST_TEST(std::abs(spectrum[k] - expected[k]) < 1e-9);
+            }
+
+            auto const back = inverse_real_fft(spectrum, n);
+            for (std::size_t i = 0; i < n; i++)
+            {
+                BOOST_TEST(std::abs(back[i] / static_cast<double>(n) - column[i]) < 1e-9);
+            }
+        }
+    }
+    BOOST_CHECK_THROW(inverse_real_fft(std::vector<std::complex<double>>(3), 10),
+        boost::astronomy::invalid_fft_size_exception);
+}
+
+BOOST_AUTO_TEST_CASE(images)
+{
+    std::size_t const width = 45;
+    std::size_t const height = 36;
+    image_buffer<std::int16_t> image(width, height);
+    std::vector<std::complex<double>> values;
+    for (std::size_t y = 0; y < height; y++)
+    {
+        for (std::size_t x = 0; x < width; x++)
+        {
+            image.view()(y, x) = static_cast<std::int16_t>((x * 31 + y * 17) % 41 - 20);
+            values.emplace_back(image(y, x), 0.0);
+        }
+    }
+
+    //complex 2D transform against rows then columns of the naive DFT
+    std::vector<std::complex<double>> expected(values.size());
+    for (std::size_t y = 0; y < height; y++)
+    {
+        std::vector<std::complex<double>> row(values.begin() + y * width,
+            values.begin() + (y + 1) * width);
+        auto const transformed = naive_dft(row, false);
+        std::copy(transformed.begin(), transformed.end(), expected.begin() + y * width);
+    }
+    for (std::size_t x = 0; x < width; x++)
+    {
+        std::vector<std::complex<double>> column;
+        for (std::size_t y = 0; y < height; y++)
+        {
+            column.push_back(expected[y * width + x]);
+        }
+        auto const transformed = naive_dft(column, false);
+        for (std::size_t y = 0; y < height; y++)
+        {
+            expected[y * width + x] = transformed[y];
+        }
+    }
+
+    std::vector<std::complex<double>> complex_image = values;
+    fft_2d(complex_image.data(), width, height, false, 3);
+    BOOST_TEST(largest_difference(complex_image, expected) < 1e-8);
+
+    //the real transform holds the first width / 2 + 1 columns of it
+    image_spectrum const spectrum = fft_2d(image, 4);
+    BOOST_REQUIRE(spectrum.columns() == width / 2 + 1);
+    for (std::size_t v = 0; v < height; v++)
+    {
+        for (std::size_t u = 0; u < spectrum.columns(); u++)
+        {
+            BOOST_TEST(std::abs(spectrum(v, u) - expected[v * width + u]) < 1e-8);
+        }
+    }
+
+    image_buffer<double> back;
+    inverse_fft_2d(spectrum, back, 2);
+    for (std::size_t y = 0; y < height; y++)
+    {
+        for (std::size_t x = 0; x < width; x++)
+        {
+            double const restored = back(y, x) / static_cast<double>(width * height);
+            BOOST_TEST(std::abs(restored - image(y, x)) < 1e-9);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(throughput)
+{
+    std::size_t const n = 2048;
+    auto const in = signal(n);
+    auto const plan = fft_plan::get(n);
+    std::vector<std::complex<double>> out(n);
+
+    auto const start = std::chrono::steady_clock::now();
+    std::size_t const repeats = 200;
+    for (std::size_t i = 0; i < repeats; i++)
+    {
+        plan->forward(in.data(), out.data());
+    }
+    auto const middle = std::chrono::steady_clock::now();
+    auto const naive = naive_dft(in, false);
+    auto const end = std::chrono::steady_clock::now();
+
+    double const fft_seconds =
+        std::chrono::duration<double>(middle - start).count() / static_cast<double>(repeats);
+    double const naive_seconds = std::chrono::duration<double>(end - middle).count();
+    BOOST_TEST_MESSAGE("length " << n << ": fft " << fft_seconds * 1e6 << " us, naive dft "
+        << naive_seconds * 1e6 << " us, " << naive_seconds / fft_seconds << " times faster");
+    BOOST_TEST(largest_difference(out, naive) < 1e-7);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
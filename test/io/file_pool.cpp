@@ -0,0 +1,151 @@
+#define BOOST_TEST_MODULE io_file_pool_test
+
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/file_pool.hpp>
+
+using namespace boost::astronomy::io;
+namespace fs = boost::filesystem;
+
+namespace {
+
+std::string const root = "io_file_pool_test";
+std::size_t const files = 12;
+
+std::string file_name(std::size_t i)
+{
+    return root + "/" + std::to_string(i) + ".fits";
+}
+
+//empty primary header followed by a data unit holding the file number as text
+void write_file(std::string const& name, std::size_t number)
+{
+    fits_writer writer(name);
+    writer.write_empty_primary();
+    std::string const text = "file " + std::to_string(number);
+    writer.write_data(text.data(), text.size());
+}
+
+//descriptors open in this process
+std::size_t open_descriptors()
+{
+    return static_cast<std::size_t>(std::distance(fs::directory_iterator("/proc/self/fd"),
+        fs::directory_iterator()));
+}
+
+std::string read_text(pooled_file const& file)
+{
+    char text[17] = {};
+    file.read_at(text, 16, 2880);
+    return std::string(text);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(file_pool_test)
+
+BOOST_AUTO_TEST_CASE(lru_cap_and_reopen)
+{
+    fs::remove_all(root);
+    fs::create_directories(root);
+    for (std::size_t i = 0; i < files; i++)
+    {
+        write_file(file_name(i), i % 10);
+    }
+
+    std::size_t const baseline = open_descriptors();
+    file_pool pool(3);
+    std::vector<pooled_file> handles;
+    for (std::size_t i = 0; i < files; i++)
+    {
+        handles.push_back(pool.open(file_name(i)));
+    }
+    BOOST_TEST(open_descriptors() <= baseline + 3);
+
+    file_pool_statistics statistics = pool.statistics();
+    BOOST_TEST(statistics.opens == files);
+    BOOST_TEST(statistics.evictions == files - 3);
+    BOOST_TEST(statistics.open_files == 3u);
+
+    //the three most recent files are still open
+    BOOST_TEST(read_text(handles[11]) == "file 1");
+    BOOST_TEST(read_text(handles[10]) == "file 0");
+    BOOST_TEST(pool.statistics().hits == 2u);
+    BOOST_TEST(pool.statistics().opens == files);
+
+    //evicted files are reopened transparently, a scan through more files than the cap
+    //reopens every one of them
+    for (std::size_t i = 0; i < files; i++)
+    {
+        BOOST_TEST(read_text(handles[i]) == "file " + std::to_string(i % 10));
+    }
+    statistics = pool.statistics();
+    BOOST_TEST(statistics.opens == 2 * files);
+    BOOST_TEST(open_descriptors() <= baseline + 3);
+
+    pool.set_capacity(1);
+    BOOST_TEST(pool.statistics().open_files == 1u);
+    pool.clear();
+    BOOST_TEST(pool.statistics().open_files == 0u);
+    BOOST_TEST(open_descriptors() == baseline);
+
+    //a file replaced while its handle was evicted is not read silently
+    write_file(root + "/replacement.fits", 9);
+    fs::rename(root + "/replacement.fits", file_name(0));
+    BOOST_CHECK_THROW(read_text(handles[0]), boost::astronomy::file_io_exception);
+    BOOST_CHECK_THROW(pool.open(root + "/missing.fits"), boost::astronomy::file_io_exception);
+}
+
+BOOST_AUTO_TEST_CASE(streams_and_fits)
+{
+    fs::remove_all(root);
+    fs::create_directories(root);
+    for (std::size_t i = 0; i < files; i++)
+    {
+        write_file(file_name(i), i);
+    }
+
+    std::size_t const baseline = open_descriptors();
+    file_pool pool(2);
+    std::vector<fits> opened;
+    opened.reserve(files);
+    for (std::size_t i = 0; i < files; i++)
+    {
+        opened.emplace_back(pool.open(file_name(i)));
+    }
+    BOOST_TEST(open_descriptors() <= baseline + 2);
+
+    //threads sharing the pool, each with its own stream
+    std::vector<std::thread> readers;
+    std::vector<std::string> texts(files);
+    for (std::size_t t = 0; t < 4; t++)
+    {
+        readers.emplace_back([&, t]() {
+            for (std::size_t i = t; i < files; i += 4)
+            {
+                pooled_stream stream(pool.open(file_name(i)), 2880);
+                std::getline(stream, texts[i], '\0');
+            }
+        });
+    }
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+    for (std::size_t i = 0; i < files; i++)
+    {
+        BOOST_TEST(texts[i] == "file " + std::to_string(i));
+    }
+    BOOST_TEST(pool.statistics().open_files <= 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
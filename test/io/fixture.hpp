@@ -0,0 +1,101 @@
+#ifndef BOOST_ASTRONOMY_TEST_IO_FIXTURE_HPP
+#define BOOST_ASTRONOMY_TEST_IO_FIXTURE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+
+//!helpers the io tests use to write FITS files byte by byte
+
+//!appends value in big endian byte order
+template <typename T>
+void append_big_endian(std::string& buffer, T value)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    std::reverse(bytes, bytes + sizeof(T));
+    buffer.append(bytes, sizeof(T));
+}
+
+//!writes block padded with fill to a multiple of 2880 bytes
+inline void write_block(std::ofstream& file, std::string block, char fill)
+{
+    block.append((2880 - block.length() % 2880) % 2880, fill);
+    file.write(block.data(), static_cast<std::streamsize>(block.length()));
+}
+
+//!writes the cards, each padded to 80 characters, followed by END
+inline void write_header(std::ofstream& file, std::vector<std::string> const& cards)
+{
+    std::string block;
+    for (auto const& c : cards)
+    {
+        block += c + std::string(80 - c.length(), ' ');
+    }
+    write_block(file, block + "END" + std::string(77, ' '), ' ');
+}
+
+//!mandatory cards of a binary table with rows of row_width bytes and the given column formats
+inline std::vector<boost::astronomy::io::card> table_cards
+(
+    std::size_t row_width,
+    std::size_t rows,
+    std::vector<std::string> const& forms
+)
+{
+    std::vector<boost::astronomy::io::card> cards(8);
+    cards[0].create_card("XTENSION", std::string("'BINTABLE'"));
+    cards[1].create_card("BITPIX", 8);
+    cards[2].create_card("NAXIS", 2);
+    cards[3].create_card("NAXIS1", row_width);
+    cards[4].create_card("NAXIS2", rows);
+    cards[5].create_card("PCOUNT", 0);
+    cards[6].create_card("GCOUNT", 1);
+    cards[7].create_card("TFIELDS", forms.size());
+    for (std::size_t i = 0; i < forms.size(); i++)
+    {
+        cards.emplace_back();
+        cards.back().create_card("TFORM" + std::to_string(i + 1), "'" + forms[i] + "'");
+    }
+    return cards;
+}
+
+/*!
+writes a binary table named extname with a single 'J' column VALUE holding value(row),
+extra_cards are appended to the header as they are
+*/
+template <typename Value>
+void write_int_table
+(
+    boost::astronomy::io::fits_writer& writer,
+    std::size_t rows,
+    std::string const& extname,
+    Value value,
+    std::vector<std::string> const& extra_cards = {}
+)
+{
+    std::vector<boost::astronomy::io::card> cards = table_cards(4, rows, {"J"});
+    cards.emplace_back(std::string("TTYPE1  = 'VALUE'"));
+    cards.emplace_back(std::string("EXTNAME = '" + extname + "'"));
+    for (auto const& c : extra_cards)
+    {
+        cards.emplace_back(c);
+    }
+    writer.write_header(cards);
+
+    std::string data;
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        append_big_endian(data, static_cast<std::int32_t>(value(row)));
+    }
+    writer.write_data(data.data(), data.size());
+}
+
+#endif // !BOOST_ASTRONOMY_TEST_IO_FIXTURE_HPP
@@ -0,0 +1,154 @@
+#define BOOST_TEST_MODULE io_header_editor_test
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/column_view.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/compressed_stream.hpp>
+#include <boost/astronomy/io/verify_checksums.hpp>
+#include <boost/astronomy/io/header_editor.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+namespace fs = boost::filesystem;
+
+namespace {
+
+char const* const file_name = "io_header_editor_test.fits";
+std::size_t const tables = 2;
+std::size_t const rows = 3000;
+
+//one 'J' column holding 10000 * table + row, with checksums
+void write_test_file()
+{
+    fits_writer writer(file_name, 1);
+    writer.write_checksums(true);
+    writer.write_empty_primary();
+
+    for (std::size_t table = 0; table < tables; table++)
+    {
+        write_int_table
+        (
+            writer, rows, "T" + std::to_string(table),
+            [table](std::size_t row) { return 10000 * table + row; },
+            {"OBSERVER= 'NOBODY'"}
+        );
+    }
+}
+
+//true if every table still holds its values and every checksum is valid
+bool file_intact()
+{
+    std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+    for (std::size_t table = 0; table < tables; table++)
+    {
+        binary_table_extension extension(file);
+        column_view<std::int64_t> values(extension, "VALUE");
+        for (std::size_t row = 0; row < rows; row++)
+        {
+            if (values[row] != static_cast<std::int64_t>(10000 * table + row))
+            {
+                return false;
+            }
+        }
+    }
+
+    for (auto const& status : verify_checksums(std::string(file_name)))
+    {
+        if (!status.checksum_valid || !status.datasum_valid)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(header_editor_test)
+
+BOOST_AUTO_TEST_CASE(in_place_edits)
+{
+    write_test_file();
+    std::uintmax_t const size = fs::file_size(file_name);
+
+    header_editor editor(file_name, 1);
+    std::size_t const spare = editor.spare_cards();
+    BOOST_TEST(editor.contains("OBSERVER"));
+    editor.set("CRVAL1", 123.5);
+    editor.set("PROCESS", true);
+    editor.set("OBSERVER", std::string("'SOMEBODY'"));
+    BOOST_TEST(editor.remove("OBSERVER") == true);
+    BOOST_TEST(editor.remove("OBSERVER") == false);
+    editor.set("OBSERVER", std::string("'SOMEBODY'"));
+    BOOST_TEST(editor.spare_cards() == spare - 2);
+    BOOST_TEST(editor.commit());
+
+    BOOST_TEST(fs::file_size(file_name) == size);
+    hdu const header = read_hdu_header(file_name, 1);
+    BOOST_TEST(header.value_of<double>("CRVAL1") == 123.5);
+    BOOST_TEST(header.value_of<bool>("PROCESS"));
+    BOOST_TEST(header.value_of<std::string>("OBSERVER") == "'SOMEBODY'");
+    BOOST_TEST(read_hdu_header(file_name, 2).value_of<std::string>("OBSERVER") == "'NOBODY'");
+    BOOST_TEST(file_intact());
+
+    BOOST_CHECK_THROW(header_editor(file_name, tables + 1),
+        boost::astronomy::hdu_not_found_exception);
+    BOOST_CHECK_THROW(header_editor("io_header_editor_test.missing"),
+        boost::astronomy::file_io_exception);
+}
+
+BOOST_AUTO_TEST_CASE(checksum_without_datasum)
+{
+    write_test_file();
+
+    header_editor editor(file_name, 1);
+    BOOST_TEST(editor.remove("DATASUM"));
+    editor.set("CRVAL1", 1.0);
+    BOOST_TEST(editor.commit());
+
+    //CHECKSUM can not be recomputed without DATASUM, it is removed instead of left wrong
+    BOOST_TEST(!editor.contains("CHECKSUM"));
+    hdu const header = read_hdu_header(file_name, 1);
+    BOOST_CHECK_THROW(header.value_of<std::string>("CHECKSUM"), std::out_of_range);
+    BOOST_TEST(verify_checksums(std::string(file_name))[2].valid());
+}
+
+BOOST_AUTO_TEST_CASE(growing_header_shifts_the_rest)
+{
+    write_test_file();
+    std::uintmax_t const size = fs::file_size(file_name);
+
+    header_editor editor(file_name, 1);
+    std::size_t const history = editor.spare_cards() + 10;
+    for (std::size_t i = 0; i < history; i++)
+    {
+        card c;
+        c.create_commentary_card("HISTORY", "step " + std::to_string(i));
+        editor.set(c);
+    }
+    BOOST_TEST(!editor.commit());
+    BOOST_TEST(fs::file_size(file_name) == size + 2880);
+    BOOST_TEST(file_intact());
+
+    //after the shift, the removed cards leave blanks and the header keeps its blocks
+    header_editor again(file_name, 1);
+    again.remove("OBSERVER");
+    BOOST_TEST(again.commit());
+    BOOST_TEST(fs::file_size(file_name) == size + 2880);
+    BOOST_TEST(!read_hdu_header(file_name, 1).get_cards().empty());
+    BOOST_TEST(file_intact());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
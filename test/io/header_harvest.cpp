@@ -0,0 +1,114 @@
+#define BOOST_TEST_MODULE io_header_harvest_test
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/column_view.hpp>
+#include <boost/astronomy/io/header_harvest.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+namespace fs = boost::filesystem;
+
+namespace {
+
+std::string const root = "io_header_harvest_test";
+
+//primary image of 100 x 40 16 bit pixels followed by an empty table
+void write_exposure(std::string const& name, std::string const& filter, int exposure)
+{
+    std::ofstream file(root + "/" + name, std::ios_base::out | std::ios_base::binary);
+    write_header(file, {
+        "SIMPLE  =                    T",
+        "BITPIX  =                   16",
+        "NAXIS   =                    2",
+        "NAXIS1  =                  100",
+        "NAXIS2  =                   40",
+        "DATE-OBS= '2021-03-04T05:06:07.5' / start of exposure",
+        "FILTER  = 'R''s band'",
+        "EXPTIME =                 " + std::to_string(exposure) + " / seconds"
+    });
+    std::string data(8000, '\x01');
+    data.append(2880 - data.size() % 2880, '\0');
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+    write_header(file, {
+        "XTENSION= 'BINTABLE'",
+        "BITPIX  =                    8",
+        "NAXIS   =                    2",
+        "NAXIS1  =                    0",
+        "NAXIS2  =                    0",
+        "PCOUNT  =                    0",
+        "GCOUNT  =                    1",
+        "TFIELDS =                    0",
+        "FILTER  = '" + filter + "'"
+    });
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(header_harvest_test)
+
+BOOST_AUTO_TEST_CASE(harvest_tree)
+{
+    fs::remove_all(root);
+    fs::create_directories(root + "/night2");
+    write_exposure("a.fits", "g", 30);
+    write_exposure("night2/b.FIT", "r", 60);
+    std::ofstream(root + "/broken.fits") << "not a FITS file";
+    std::ofstream(root + "/notes.txt") << "ignored";
+
+    harvest_options options;
+    options.threads = 2;
+    header_index index = harvest_directory(root, {"DATE-OBS", "FILTER", "EXPTIME", "NAXIS1"},
+        options);
+
+    BOOST_REQUIRE(index.size() == 4u);
+    BOOST_TEST(index.statistics.files == 2u);
+    BOOST_TEST(index.statistics.failed_files == 1u);
+    BOOST_TEST(index.statistics.hdus == 4u);
+    BOOST_TEST(index.statistics.header_bytes == 4u * 2880);
+    BOOST_REQUIRE(index.failed.size() == 1u);
+    BOOST_TEST(fs::path(index.failed[0]).filename().string() == "broken.fits");
+
+    BOOST_TEST(fs::path(index.files[2]).filename().string() == "b.FIT");
+    BOOST_TEST(index.hdu_numbers[3] == 1u);
+    BOOST_TEST(index.offsets[1] == 4u * 2880);
+
+    string_column const& date = index.column("DATE-OBS");
+    BOOST_TEST(date[0] == "2021-03-04T05:06:07.5");
+    BOOST_TEST(!date.present(1));
+
+    string_column const& filter = index.column("FILTER");
+    BOOST_TEST(filter[0] == "R's band");
+    BOOST_TEST(filter[3] == "r");
+
+    auto exposure = index.numbers("EXPTIME");
+    BOOST_TEST(exposure[2] == 60.0);
+    BOOST_TEST(std::isnan(exposure[3]));
+    BOOST_TEST(index.rows_where("FILTER", [](std::string const& v) { return v == "g"; }) ==
+        std::vector<std::size_t>{1});
+    BOOST_CHECK_THROW(index.column("OBJECT"), boost::astronomy::column_not_found_exception);
+
+    std::string const table_name = root + "/index.fits";
+    write_header_index(index, table_name);
+    std::fstream file(table_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+    binary_table_extension table(file);
+    BOOST_REQUIRE(table.naxis(2) == 4u);
+    BOOST_TEST(column_view<std::string>(table, "FILTER")[0] == "R's band");
+    BOOST_TEST(column_view<std::string>(table, "EXPTIME")[2] == "60");
+    BOOST_TEST(column_view<std::int64_t>(table, "OFFSET")[3] == 4 * 2880);
+    BOOST_TEST(column_view<std::int64_t>(table, "HDU")[3] == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,162 @@
+#define BOOST_TEST_MODULE io_image_buffer_test
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/primary_hdu.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+char const* const file_name = "io_image_buffer_test.fits";
+std::size_t const width = 37;
+std::size_t const height = 5;
+
+//value of the pixel in row y and column x
+double value(std::size_t y, std::size_t x)
+{
+    return static_cast<double>(y * 100 + x) - 250.5;
+}
+
+//primary image of the given BITPIX holding value(y, x) converted to Type
+template <typename Type>
+void write_image(int bitpix)
+{
+    fits_writer writer(file_name, 1);
+    std::vector<card> cards(6);
+    cards[0].create_card("SIMPLE", true);
+    cards[1].create_card("BITPIX", bitpix);
+    cards[2].create_card("NAXIS", 2);
+    cards[3].create_card("NAXIS1", width);
+    cards[4].create_card("NAXIS2", height);
+    cards[5].create_card("EXTEND", false);
+    writer.write_header(cards);
+
+    std::string bytes;
+    for (std::size_t y = 0; y < height; y++)
+    {
+        for (std::size_t x = 0; x < width; x++)
+        {
+            append_big_endian(bytes, static_cast<Type>(value(y, x)));
+        }
+    }
+    writer.write_data(bytes.data(), bytes.size());
+}
+
+template <bitpix Bitpix, typename Type>
+void check_round_trip(int code)
+{
+    write_image<Type>(code);
+    std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    primary_hdu<Bitpix> primary(file);
+    image<Bitpix> const pixels = primary.get_data();
+
+    BOOST_TEST(pixels.get_width() == width);
+    BOOST_TEST(pixels.get_height() == height);
+    BOOST_TEST(pixels.stride() * sizeof(Type) % 64 == 0u);
+    BOOST_TEST(pixels.stride() >= width);
+    for (std::size_t y = 0; y < height; y++)
+    {
+        BOOST_TEST(reinterpret_cast<std::uintptr_t>(pixels.row(y)) % 64 == 0u);
+        for (std::size_t x = 0; x < width; x++)
+        {
+            BOOST_TEST(pixels(y, x) == static_cast<Type>(value(y, x)));
+        }
+        //padding is zero
+        for (std::size_t x = width; x < pixels.stride(); x++)
+        {
+            BOOST_TEST(pixels.row(y)[x] == Type());
+        }
+    }
+
+    auto const view = pixels.view();
+    BOOST_TEST(view.extent(0) == height);
+    BOOST_TEST(view.extent(1) == width);
+    BOOST_TEST(view(3, 7) == static_cast<Type>(value(3, 7)));
+    BOOST_TEST(view.row(2) == pixels.row(2));
+
+    //statistics skip the padding
+    BOOST_TEST(pixels.min() == static_cast<Type>(value(0, 0)));
+    BOOST_TEST(pixels.max() == static_cast<Type>(value(height - 1, width - 1)));
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(image_buffer_test)
+
+BOOST_AUTO_TEST_CASE(every_bitpix)
+{
+    check_round_trip<bitpix::B16, std::int16_t>(16);
+    check_round_trip<bitpix::B32, std::int32_t>(32);
+    check_round_trip<bitpix::_B32, float>(-32);
+    check_round_trip<bitpix::_B64, double>(-64);
+}
+
+BOOST_AUTO_TEST_CASE(statistics)
+{
+    write_image<double>(-64);
+    std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    image<bitpix::_B64> pixels(file, width, height, 2880);
+
+    double sum = 0;
+    for (std::size_t y = 0; y < height; y++)
+    {
+        for (std::size_t x = 0; x < width; x++)
+        {
+            sum += value(y, x);
+        }
+    }
+    BOOST_TEST(pixels.mean() == sum / (width * height), boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(pixels.median() == value(2, 18));
+    BOOST_TEST(pixels.std_dev() > 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(truncated_data_unit)
+{
+    std::string bytes;
+    for (std::size_t i = 0; i < width * height - 3; i++)
+    {
+        append_big_endian(bytes, value(i / width, i % width));
+    }
+    std::istringstream file(bytes);
+
+    BOOST_CHECK_THROW((image<bitpix::_B64>(file, width, height)),
+        boost::astronomy::file_io_exception);
+}
+
+BOOST_AUTO_TEST_CASE(views_and_copies)
+{
+    image<bitpix::B8> pixels;
+    BOOST_TEST(pixels.get_width() == 0u);
+    BOOST_TEST(pixels.max() == 0u);
+    BOOST_TEST(pixels.mean() == 0.0);
+
+    write_image<std::uint8_t>(8);
+    std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    pixels.read_image(file, width, height, 2880);
+    BOOST_TEST(pixels.stride() == 64u);
+
+    image_view<std::uint8_t> view = pixels.view();
+    view(1, 2) = 200;
+    BOOST_TEST(pixels(1, 2) == 200u);
+
+    image<bitpix::B8> copy = pixels;
+    BOOST_TEST(copy.pixels() != pixels.pixels());
+    BOOST_TEST(copy(1, 2) == 200u);
+    BOOST_TEST(copy(4, 36) == pixels(4, 36));
+    BOOST_TEST(image<bitpix::B8>::padded_stride(65) == 128u);
+    BOOST_TEST(image<bitpix::_B64>::padded_stride(9) == 16u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
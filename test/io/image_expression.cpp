@@ -0,0 +1,164 @@
+#define BOOST_TEST_MODULE io_image_expression_test
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/image_expression.hpp>
+#include <boost/astronomy/io/memory_resource.hpp>
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+std::size_t const width = 70;
+std::size_t const height = 9;
+
+template <typename PixelType, typename Function>
+image_buffer<PixelType> make_image(Function function, std::size_t w = width, std::size_t h = height)
+{
+    image_buffer<PixelType> result(w, h);
+    for (std::size_t y = 0; y < h; y++)
+    {
+        for (std::size_t x = 0; x < w; x++)
+        {
+            result.view()(y, x) = static_cast<PixelType>(function(y, x));
+        }
+    }
+    return result;
+}
+
+//resource counting its allocations
+struct counting_resource : public memory_resource
+{
+    std::size_t calls = 0;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        calls++;
+        return new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+};
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(image_expression_test)
+
+BOOST_AUTO_TEST_CASE(calibration)
+{
+    auto const raw = make_image<std::uint16_t>([](std::size_t y, std::size_t x) {
+        return 1000 + 10 * y + x; });
+    auto const bias = make_image<std::uint16_t>([](std::size_t, std::size_t x) {
+        return 100 + x % 3; });
+    auto const dark = make_image<float>([](std::size_t y, std::size_t) {
+        return 0.5f * static_cast<float>(y); });
+    auto const flat = make_image<float>([](std::size_t y, std::size_t x) {
+        return 0.9f + 0.001f * static_cast<float>(y + x); });
+    double const exposure = 30.0;
+
+    image_buffer<float> calibrated;
+    assign(calibrated, (raw - bias - dark * exposure) / flat);
+    BOOST_REQUIRE(calibrated.get_width() == width);
+    BOOST_REQUIRE(calibrated.get_height() == height);
+    for (std::size_t y = 0; y < height; y++)
+    {
+        for (std::size_t x = 0; x < width; x++)
+        {
+            double const expected = (raw(y, x) - bias(y, x) - dark(y, x) * exposure) / flat(y, x);
+            BOOST_TEST(calibrated(y, x) == static_cast<float>(expected));
+        }
+    }
+
+    //the same in parallel, into the existing image without allocating
+    counting_resource counter;
+    image_buffer<float> parallel(width, height);
+    {
+        scoped_resource use(counter);
+        assign(parallel, (raw - bias - dark * exposure) / flat, 4);
+    }
+    BOOST_TEST(counter.calls == 0u);
+    for (std::size_t y = 0; y < height; y++)
+    {
+        for (std::size_t x = 0; x < width; x++)
+        {
+            BOOST_TEST(parallel(y, x) == calibrated(y, x));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(value_types)
+{
+    auto const a = make_image<std::int16_t>([](std::size_t y, std::size_t x) {
+        return static_cast<int>(x) - static_cast<int>(y) * 5; });
+    auto const b = make_image<std::int16_t>([](std::size_t, std::size_t) { return 30000; });
+
+    //int16 arithmetic promotes like C++ does, so the sum does not overflow
+    auto const sum = evaluate(a + b);
+    BOOST_TEST((std::is_same<decltype(sum), image_buffer<int> const>::value));
+    BOOST_TEST(sum(0, 69) == 30069);
+
+    auto const scaled = evaluate(a * 0.5);
+    BOOST_TEST((std::is_same<decltype(scaled), image_buffer<double> const>::value));
+    BOOST_TEST(scaled(1, 3) == -1.0);
+
+    auto const narrow = evaluate<std::int16_t>(-a);
+    BOOST_TEST(narrow(2, 1) == 9);
+
+    auto const mask = evaluate(a > 0);
+    BOOST_TEST((std::is_same<decltype(mask), image_buffer<bool> const>::value));
+    BOOST_TEST(mask(0, 1));
+    BOOST_TEST(!mask(0, 0));
+}
+
+BOOST_AUTO_TEST_CASE(selection_and_clipping)
+{
+    auto const a = make_image<float>([](std::size_t y, std::size_t x) {
+        return static_cast<float>(x) - 10.0f * static_cast<float>(y); });
+    auto const b = make_image<float>([](std::size_t, std::size_t x) {
+        return 20.0f - static_cast<float>(x); });
+
+    auto const low = evaluate(minimum(a, b));
+    auto const high = evaluate(maximum(a, 5));
+    auto const clipped = evaluate(clip(a, -5, 15));
+    auto const chosen = evaluate(where(a >= b, a, b * 2));
+    for (std::size_t y = 0; y < height; y++)
+    {
+        for (std::size_t x = 0; x < width; x++)
+        {
+            float const va = a(y, x);
+            float const vb = b(y, x);
+            BOOST_TEST(low(y, x) == (va < vb ? va : vb));
+            BOOST_TEST(high(y, x) == (va > 5 ? va : 5));
+            BOOST_TEST(clipped(y, x) == (va < -5 ? -5 : va > 15 ? 15 : va));
+            BOOST_TEST(chosen(y, x) == (va >= vb ? va : 2 * vb));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(aliasing_and_sizes)
+{
+    auto a = make_image<double>([](std::size_t y, std::size_t x) { return y + x; });
+    assign(a, a * 2 + 1);
+    BOOST_TEST(a(3, 4) == 15.0);
+
+    auto const small = make_image<double>([](std::size_t, std::size_t) { return 1; }, 5, 5);
+    image_buffer<double> out;
+    BOOST_CHECK_THROW(assign(out, a + small), boost::astronomy::image_size_mismatch_exception);
+
+    //the result takes the size of the images in the expression
+    image_buffer<double> filled(4, 3);
+    assign(filled, where(small > 0, 7.0, 8.0));
+    BOOST_TEST(filled.get_width() == 5u);
+    BOOST_TEST(filled.get_height() == 5u);
+    BOOST_TEST(filled(4, 4) == 7.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
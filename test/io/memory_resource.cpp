@@ -0,0 +1,222 @@
+#define BOOST_TEST_MODULE io_memory_resource_test
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/column_data.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/primary_hdu.hpp>
+#include <boost/astronomy/io/memory_resource.hpp>
+#include <boost/astronomy/io/huge_page_resource.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+char const* const image_name = "io_memory_resource_test_image.fits";
+char const* const table_name = "io_memory_resource_test_table.fits";
+
+//resource counting the bytes that are currently allocated from it
+struct counting_resource : public memory_resource
+{
+    std::size_t live = 0;
+    std::size_t calls = 0;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        live += bytes;
+        calls++;
+        return new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        live -= bytes;
+        new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+};
+
+bool aligned(void const* p, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+//16 bit primary image of 100 x 50 pixels
+void write_image_file()
+{
+    fits_writer writer(image_name, 1);
+    std::vector<card> cards(6);
+    cards[0].create_card("SIMPLE", true);
+    cards[1].create_card("BITPIX", 16);
+    cards[2].create_card("NAXIS", 2);
+    cards[3].create_card("NAXIS1", 100);
+    cards[4].create_card("NAXIS2", 50);
+    cards[5].create_card("EXTEND", false);
+    writer.write_header(cards);
+    std::string pixels;
+    for (std::size_t i = 0; i < 5000; i++)
+    {
+        pixels += static_cast<char>((i >> 8) & 0xFF);
+        pixels += static_cast<char>(i & 0xFF);
+    }
+    writer.write_data(pixels.data(), pixels.size());
+}
+
+void write_table_file()
+{
+    fits_writer writer(table_name, 1);
+    writer.write_empty_primary();
+    write_int_table(writer, 500, "T", [](std::size_t row) { return row; });
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(memory_resource_test)
+
+BOOST_AUTO_TEST_CASE(arena)
+{
+    counting_resource upstream;
+    {
+        arena_resource resource(1024, &upstream);
+        char* a = static_cast<char*>(resource.allocate(3, 1));
+        void* b = resource.allocate(8, 8);
+        void* c = resource.allocate(100, 64);
+        BOOST_TEST(aligned(b, 8));
+        BOOST_TEST(aligned(c, 64));
+        BOOST_TEST(b != static_cast<void*>(a));
+        BOOST_TEST(upstream.calls == 1u);
+        resource.deallocate(c, 100, 64);
+
+        //larger than a chunk, a chunk of its own that leaves the growth alone
+        std::size_t const first_chunk = upstream.live;
+        void* big = resource.allocate(10000, 16);
+        BOOST_TEST(aligned(big, 16));
+        BOOST_TEST(upstream.calls == 2u);
+        BOOST_TEST(upstream.live - first_chunk < 10000u + 64u);
+        BOOST_TEST(resource.bytes_allocated() == 3u + 8u + 100u + 10000u);
+
+        //the next regular chunk is twice the first one
+        std::size_t const before = upstream.live;
+        resource.allocate(first_chunk, 8);
+        BOOST_TEST(upstream.live - before == 2 * first_chunk);
+
+        //geometric growth keeps the number of chunks small
+        for (int i = 0; i < 1000; i++)
+        {
+            resource.allocate(1000, 8);
+        }
+        BOOST_TEST(upstream.calls < 12u);
+
+        resource.release();
+        BOOST_TEST(upstream.live == 0u);
+        BOOST_TEST(resource.bytes_allocated() == 0u);
+        resource.allocate(10, 8);
+        BOOST_TEST(upstream.live == first_chunk);
+    }
+    BOOST_TEST(upstream.live == 0u);
+}
+
+#ifdef BOOST_HAS_UNISTD_H
+BOOST_AUTO_TEST_CASE(huge_pages)
+{
+    counting_resource upstream;
+    huge_page_resource resource(huge_page_resource::page_size(), false, &upstream);
+
+    void* small = resource.allocate(1000, 16);
+    BOOST_TEST(upstream.live == 1000u);
+    BOOST_TEST(resource.mapped_bytes() == 0u);
+
+    std::size_t const bytes = 3 * huge_page_resource::page_size() + 5;
+    char* large = static_cast<char*>(resource.allocate(bytes, 64));
+    BOOST_TEST(aligned(large, huge_page_resource::page_size()));
+    BOOST_TEST(resource.mapped_bytes() == 4 * huge_page_resource::page_size());
+    large[0] = 1;
+    large[bytes - 1] = 2;
+    BOOST_TEST(large[0] + large[bytes - 1] == 3);
+
+    resource.deallocate(large, bytes, 64);
+    resource.deallocate(small, 1000, 16);
+    BOOST_TEST(resource.mapped_bytes() == 0u);
+    BOOST_TEST(upstream.live == 0u);
+
+    resource_vector<double> pixels{polymorphic_allocator<double>(&resource)};
+    pixels.resize(1 << 20, 1.5);
+    BOOST_TEST(resource.mapped_bytes() >= (1u << 20) * sizeof(double));
+    BOOST_TEST(aligned(pixels.data(), huge_page_resource::page_size()));
+}
+
+#endif
+
+BOOST_AUTO_TEST_CASE(default_resource)
+{
+    BOOST_TEST(get_default_resource() == new_delete_resource());
+    counting_resource outer;
+    counting_resource inner;
+
+    memory_resource* const previous = set_default_resource(&outer);
+    BOOST_TEST(previous == new_delete_resource());
+    {
+        resource_vector<int> a(10);
+        BOOST_TEST(a.get_allocator().resource() == &outer);
+        {
+            scoped_resource use(inner);
+            resource_vector<int> b(20);
+            BOOST_TEST(b.get_allocator().resource() == &inner);
+
+            //copies take the default resource of the copying thread
+            resource_vector<int> c(a);
+            BOOST_TEST(c.get_allocator().resource() == &inner);
+            BOOST_TEST(inner.live == 30 * sizeof(int));
+        }
+        BOOST_TEST(get_default_resource() == &outer);
+        BOOST_TEST(inner.live == 0u);
+    }
+    BOOST_TEST(outer.live == 0u);
+    BOOST_TEST(set_default_resource(nullptr) == &outer);
+    BOOST_TEST(get_default_resource() == new_delete_resource());
+}
+
+BOOST_AUTO_TEST_CASE(hdus_in_an_arena)
+{
+    write_image_file();
+    write_table_file();
+
+    counting_resource upstream;
+    arena_resource file_arena(4096, &upstream);
+    {
+        scoped_resource use(file_arena);
+        std::ifstream image_stream(image_name, std::ios_base::in | std::ios_base::binary);
+        primary_hdu<bitpix::B16> primary(image_stream);
+        image<bitpix::B16> const pixels = primary.get_data();
+        BOOST_TEST(pixels.get_width() == 100u);
+        BOOST_TEST(pixels(49, 99) == 4999);
+        BOOST_TEST(file_arena.bytes_allocated() >= 2 * 5000 * sizeof(std::int16_t));
+
+        std::ifstream stream(table_name, std::ios_base::in | std::ios_base::binary);
+        hdu header(stream);
+        binary_table_extension table(stream);
+        BOOST_TEST(table.get_data().get_allocator().resource() == &file_arena);
+        std::unique_ptr<column> values = table.get_column("VALUE");
+        auto const& typed = static_cast<column_data<std::int32_t> const&>(*values);
+        BOOST_TEST(typed.get_data()[499] == 499);
+        BOOST_TEST(file_arena.bytes_allocated() >= 2 * 5000 * sizeof(std::int16_t) + 2000 + 2000);
+    }
+
+    //the whole file goes at once
+    BOOST_TEST(upstream.live > 0u);
+    file_arena.release();
+    BOOST_TEST(upstream.live == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,146 @@
+#define BOOST_TEST_MODULE io_metrics_test
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/metrics.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+namespace fs = boost::filesystem;
+
+namespace {
+
+char const* const image_name = "io_metrics_test_image.fits";
+char const* const table_name = "io_metrics_test_table.fits";
+
+//16 bit primary image of 20 x 10 pixels followed by an image extension of 8 x 8 bytes
+void write_image_file()
+{
+    fits_writer writer(image_name, 1);
+    std::vector<card> cards(6);
+    cards[0].create_card("SIMPLE", true);
+    cards[1].create_card("BITPIX", 16);
+    cards[2].create_card("NAXIS", 2);
+    cards[3].create_card("NAXIS1", 20);
+    cards[4].create_card("NAXIS2", 10);
+    cards[5].create_card("EXTEND", true);
+    writer.write_header(cards);
+    std::string const pixels(400, '\x01');
+    writer.write_data(pixels.data(), pixels.size());
+
+    cards.resize(8);
+    cards[0] = card(std::string("XTENSION= 'IMAGE   '"));
+    cards[1].create_card("BITPIX", 8);
+    cards[3].create_card("NAXIS1", 8);
+    cards[4].create_card("NAXIS2", 8);
+    cards[5].create_card("PCOUNT", 0);
+    cards[6].create_card("GCOUNT", 1);
+    cards[7] = card(std::string("EXTNAME = 'SMALL'"));
+    writer.write_header(cards);
+    std::string const bytes(64, '\x02');
+    writer.write_data(bytes.data(), bytes.size());
+}
+
+void write_table_file()
+{
+    fits_writer writer(table_name, 1);
+    writer.write_empty_primary();
+    write_int_table(writer, 1000, "T", [](std::size_t) { return 0x03030303; });
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(metrics_test)
+
+BOOST_AUTO_TEST_CASE(fits_handle_counters)
+{
+    BOOST_REQUIRE(io_metrics::enabled());
+    write_image_file();
+
+    io_metrics::reset();
+    fits file(image_name);
+    file.read_extensions();
+
+    io_counters const counters = file.metrics();
+    std::vector<io_counters> const units = file.hdu_metrics();
+    BOOST_REQUIRE(units.size() == 2u);
+    BOOST_TEST(units[0].cards_parsed == 7u);
+    BOOST_TEST(units[1].cards_parsed == 9u);
+    BOOST_TEST(counters.cards_parsed == 16u);
+    BOOST_TEST(units[0].header_parse_ns > 0u);
+    BOOST_TEST(units[0].pixel_decode_ns > 0u);
+    BOOST_TEST(units[1].pixel_decode_ns > 0u);
+    BOOST_TEST(counters.column_decode_ns == 0u);
+
+    //both headers (36 cards each) and both data units were read
+    BOOST_TEST(counters.bytes_read >= 2 * 2880 + 400 + 64);
+    BOOST_TEST(counters.bytes_read <= fs::file_size(image_name));
+    BOOST_TEST(counters.read_requests >= 72u);
+    BOOST_TEST(counters.seeks > 0u);
+
+    //the process wide aggregates saw the same reads
+    io_counters const global = io_metrics::snapshot();
+    BOOST_TEST(global.bytes_read == counters.bytes_read);
+    BOOST_TEST(global.read_requests == counters.read_requests);
+    BOOST_TEST(global.cards_parsed >= counters.cards_parsed);
+    BOOST_TEST(global.pixel_decode_ns >= counters.pixel_decode_ns);
+
+    io_metrics::reset();
+    BOOST_TEST(io_metrics::snapshot().bytes_read == 0u);
+    BOOST_TEST(io_metrics::snapshot().cards_parsed == 0u);
+    BOOST_TEST(file.metrics().cards_parsed == 16u);
+}
+
+BOOST_AUTO_TEST_CASE(column_decode)
+{
+    write_table_file();
+    io_metrics::reset();
+
+    std::ifstream stream(table_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(stream);
+    binary_table_extension table(stream);
+    BOOST_TEST(table.metrics().cards_parsed == 12u);
+    BOOST_TEST(table.metrics().column_decode_ns == 0u);
+
+    auto column = table.get_column("VALUE");
+    BOOST_REQUIRE(column != nullptr);
+    BOOST_TEST(table.metrics().column_decode_ns > 0u);
+    BOOST_TEST(io_metrics::snapshot().column_decode_ns == table.metrics().column_decode_ns);
+    BOOST_TEST(io_metrics::snapshot().cards_parsed == 5u + 12u);
+}
+
+BOOST_AUTO_TEST_CASE(metered_stream_counts)
+{
+    std::istringstream source(std::string(100, 'x'));
+    detail::metered_stream stream;
+    stream.attach(source);
+
+    char buffer[10];
+    stream.read(buffer, sizeof(buffer));
+    stream.get();
+    BOOST_TEST(stream.tellg() == 11);
+    BOOST_TEST(stream.tellg() == 11);
+    BOOST_TEST(stream.counters().seeks == 0u);
+    BOOST_TEST(stream.counters().read_requests == 2u);
+    BOOST_TEST(stream.counters().bytes_read == 11u);
+
+    stream.seekg(50);
+    stream.seekg(-10, std::ios_base::cur);
+    BOOST_TEST(stream.tellg() == 40);
+    BOOST_TEST(stream.counters().seeks == 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
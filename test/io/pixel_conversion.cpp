@@ -0,0 +1,223 @@
+#define BOOST_TEST_MODULE io_pixel_conversion_test
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/pixel_conversion.hpp>
+#include <boost/astronomy/io/primary_hdu.hpp>
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+char const* const file_name = "io_pixel_conversion_test.fits";
+std::size_t const width = 45;
+std::size_t const height = 7;
+
+template <typename Target, typename Source>
+std::vector<Target> convert(std::vector<Source> const& in, conversion_options const& options)
+{
+    std::vector<Target> out(in.size());
+    convert_pixels(in.data(), out.data(), in.size(), options);
+    return out;
+}
+
+conversion_options with_mode(rounding mode, bool saturate = true)
+{
+    conversion_options options;
+    options.mode = mode;
+    options.saturate = saturate;
+    return options;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(pixel_conversion_test)
+
+BOOST_AUTO_TEST_CASE(half_precision)
+{
+    BOOST_TEST(float16(1.0f).bits == 0x3C00u);
+    BOOST_TEST(float16(-2.0f).bits == 0xC000u);
+    BOOST_TEST(float16(65504.0f).bits == 0x7BFFu);
+    BOOST_TEST(float16(1e6f).bits == 0x7C00u);
+    BOOST_TEST(float16(5.9604644775390625e-8f).bits == 0x0001u);
+    BOOST_TEST(std::isnan(static_cast<float>(float16(std::numeric_limits<float>::quiet_NaN()))));
+    //1 + 2^-11 lies halfway between two halves and rounds to the even one
+    BOOST_TEST(float16(1.00048828125f).bits == 0x3C00u);
+    BOOST_TEST(float16(1.00146484375f).bits == 0x3C02u);
+
+    //every finite half survives a round trip through float
+    for (std::uint32_t bits = 0; bits < 0x10000u; bits++)
+    {
+        float16 const half = float16::from_bits(static_cast<std::uint16_t>(bits));
+        if ((bits & 0x7C00u) != 0x7C00u)
+        {
+            BOOST_TEST(float16(static_cast<float>(half)).bits == half.bits);
+        }
+    }
+
+    std::vector<float> const in{-70000.0f, 0.1f, 3.5f, 70000.0f};
+    auto const halves = convert<float16>(in, conversion_options());
+    BOOST_TEST(static_cast<float>(halves[0]) == -65504.0f);
+    BOOST_TEST(static_cast<float>(halves[2]) == 3.5f);
+    BOOST_TEST(static_cast<float>(halves[3]) == 65504.0f);
+    auto const infinite = convert<float16>(in, with_mode(rounding::nearest, false));
+    BOOST_TEST(std::isinf(static_cast<float>(infinite[3])));
+
+    auto const back = convert<std::int16_t>(halves, conversion_options());
+    BOOST_TEST(back[0] == -32768);
+    BOOST_TEST(back[1] == 0);
+    BOOST_TEST(back[2] == 4);
+}
+
+BOOST_AUTO_TEST_CASE(rounding_modes)
+{
+    std::vector<double> const in{-2.5, -1.5, -0.7, 0.5, 1.5, 2.4, 2.6, 7.0};
+
+    auto const nearest = convert<std::int32_t>(in, with_mode(rounding::nearest));
+    BOOST_TEST(nearest == (std::vector<std::int32_t>{-2, -2, -1, 0, 2, 2, 3, 7}),
+        boost::test_tools::per_element());
+    auto const truncated = convert<std::int32_t>(in, with_mode(rounding::toward_zero));
+    BOOST_TEST(truncated == (std::vector<std::int32_t>{-2, -1, 0, 0, 1, 2, 2, 7}),
+        boost::test_tools::per_element());
+    auto const down = convert<std::int32_t>(in, with_mode(rounding::down));
+    BOOST_TEST(down == (std::vector<std::int32_t>{-3, -2, -1, 0, 1, 2, 2, 7}),
+        boost::test_tools::per_element());
+    auto const up = convert<std::int32_t>(in, with_mode(rounding::up));
+    BOOST_TEST(up == (std::vector<std::int32_t>{-2, -1, 0, 1, 2, 3, 3, 7}),
+        boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(saturation)
+{
+    std::vector<float> const in{-1e10f, -129.0f, 255.4f, 300.0f, 1e10f,
+        std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity()};
+
+    auto const bytes = convert<std::uint8_t>(in, conversion_options());
+    BOOST_TEST(bytes == (std::vector<std::uint8_t>{0, 0, 255, 255, 255, 0, 255}),
+        boost::test_tools::per_element());
+    auto const shorts = convert<std::int16_t>(in, conversion_options());
+    BOOST_TEST(shorts == (std::vector<std::int16_t>{-32768, -129, 255, 300, 32767, 0, 32767}),
+        boost::test_tools::per_element());
+
+    //without saturation values wrap around
+    auto const wrapped = convert<std::uint8_t>(std::vector<std::int32_t>{-1, 256, 300},
+        with_mode(rounding::nearest, false));
+    BOOST_TEST(wrapped == (std::vector<std::uint8_t>{255, 0, 44}),
+        boost::test_tools::per_element());
+
+    auto const floats = convert<float>(std::vector<double>{1e300, -1e300}, conversion_options());
+    BOOST_TEST(floats[0] == std::numeric_limits<float>::max());
+    BOOST_TEST(floats[1] == std::numeric_limits<float>::lowest());
+}
+
+BOOST_AUTO_TEST_CASE(requantization)
+{
+    //unsigned 16 bit data is stored as int16 with BZERO = 32768
+    conversion_options to_unsigned;
+    to_unsigned.target_zero = 32768;
+    auto const stored = convert<std::int16_t>(std::vector<std::int32_t>{0, 32768, 65535},
+        to_unsigned);
+    BOOST_TEST(stored == (std::vector<std::int16_t>{-32768, 0, 32767}),
+        boost::test_tools::per_element());
+
+    conversion_options from_unsigned;
+    from_unsigned.source_zero = 32768;
+    auto const physical = convert<std::int32_t>(stored, from_unsigned);
+    BOOST_TEST(physical == (std::vector<std::int32_t>{0, 32768, 65535}),
+        boost::test_tools::per_element());
+
+    //float data quantized to 8 bit over its range and restored to within one step
+    std::vector<double> in;
+    for (int i = 0; i <= 100; i++)
+    {
+        in.push_back(-3.0 + 0.07 * i);
+    }
+    conversion_options quantize;
+    scale_to_fit<std::uint8_t>(-3.0, 4.0, quantize);
+    auto const quantized = convert<std::uint8_t>(in, quantize);
+    BOOST_TEST(quantized.front() == 0u);
+    BOOST_TEST(quantized.back() == 255u);
+
+    conversion_options restore;
+    restore.source_scale = quantize.target_scale;
+    restore.source_zero = quantize.target_zero;
+    auto const restored = convert<double>(quantized, restore);
+    for (std::size_t i = 0; i < in.size(); i++)
+    {
+        BOOST_TEST(std::abs(restored[i] - in[i]) <= quantize.target_scale / 2 + 1e-12);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(images_and_streaming)
+{
+    image<bitpix::_B64> source;
+    source.resize(width, height);
+    for (std::size_t y = 0; y < height; y++)
+    {
+        for (std::size_t x = 0; x < width; x++)
+        {
+            source.view()(y, x) = 100.25 * static_cast<double>(y) - 3.5 * static_cast<double>(x);
+        }
+    }
+
+    conversion_options options;
+    options.target_scale = 0.5;
+    image<bitpix::B16> const converted = convert_image<bitpix::B16>(source, options, 3);
+    BOOST_REQUIRE(converted.get_width() == width);
+    BOOST_REQUIRE(converted.get_height() == height);
+    for (std::size_t y = 0; y < height; y++)
+    {
+        for (std::size_t x = 0; x < width; x++)
+        {
+            BOOST_TEST(converted(y, x) == static_cast<std::int16_t>(
+                std::nearbyint(source(y, x) / 0.5)));
+        }
+    }
+
+    //convert and write in chunks smaller than a row, then read the file back
+    {
+        fits_writer writer(file_name, 1);
+        std::vector<card> cards(7);
+        cards[0].create_card("SIMPLE", true);
+        cards[1].create_card("BITPIX", 16);
+        cards[2].create_card("NAXIS", 2);
+        cards[3].create_card("NAXIS1", width);
+        cards[4].create_card("NAXIS2", height);
+        cards[5].create_card("BSCALE", 0.5);
+        cards[6].create_card("EXTEND", false);
+        writer.write_header(cards);
+        write_converted<std::int16_t>(writer, source, options, 16);
+    }
+    std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    primary_hdu<bitpix::B16> primary(file);
+    image<bitpix::B16> const written = primary.get_data();
+    for (std::size_t y = 0; y < height; y++)
+    {
+        for (std::size_t x = 0; x < width; x++)
+        {
+            BOOST_TEST(written(y, x) == converted(y, x));
+        }
+    }
+
+    //the stage hands out whole chunks and the remainder
+    std::vector<std::int32_t> const pixels(10, 7);
+    std::vector<std::size_t> sizes;
+    conversion_stage<std::int32_t, float> stage(conversion_options(), 4);
+    stage(pixels.data(), pixels.size(), [&](float const* out, std::size_t count)
+    {
+        BOOST_TEST(out[count - 1] == 7.0f);
+        sizes.push_back(count);
+    });
+    BOOST_TEST(sizes == (std::vector<std::size_t>{4, 4, 2}), boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
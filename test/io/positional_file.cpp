@@ -0,0 +1,144 @@
+#define BOOST_TEST_MODULE io_positional_file_test
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/column_view.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/positional_file.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+char const* const file_name = "io_positional_file_test.fits";
+std::size_t const tables = 3;
+
+std::size_t table_rows(std::size_t table)
+{
+    return 1000 * (table + 1) + 7;
+}
+
+//one 'J' column holding 1000 * table + row
+void write_test_file()
+{
+    fits_writer writer(file_name, 1);
+    writer.write_empty_primary();
+
+    for (std::size_t table = 0; table < tables; table++)
+    {
+        write_int_table
+        (
+            writer, table_rows(table), "T" + std::to_string(table),
+            [table](std::size_t row) { return 1000 * table + row; }
+        );
+    }
+}
+
+std::string file_contents()
+{
+    std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(positional_file_test)
+
+BOOST_AUTO_TEST_CASE(stream_reads_and_seeks)
+{
+    write_test_file();
+    std::string const contents = file_contents();
+    positional_file file(file_name);
+    BOOST_REQUIRE(file.size() == contents.size());
+
+    char block[100];
+    BOOST_TEST(file.read_at(block, sizeof(block), 2880) == sizeof(block));
+    BOOST_TEST(std::string(block, 8) == "XTENSION");
+    BOOST_TEST(file.read_at(block, sizeof(block), contents.size() - 10) == 10u);
+    BOOST_TEST(file.read_at(block, sizeof(block), contents.size() + 10) == 0u);
+
+    //small buffer so reads cross buffer boundaries
+    positional_stream stream(file, 0, 16);
+    std::string part(50, '\0');
+    stream.seekg(2870);
+    stream.read(&part[0], 50);
+    BOOST_TEST(part == contents.substr(2870, 50));
+    BOOST_TEST(stream.tellg() == 2920);
+
+    stream.seekg(-40, std::ios_base::cur);
+    BOOST_TEST(stream.get() == static_cast<unsigned char>(contents[2880]));
+
+    //larger than the buffer, read directly
+    std::string large(5000, '\0');
+    stream.read(&large[0], 5000);
+    BOOST_TEST(large == contents.substr(2881, 5000));
+
+    stream.seekg(-3, std::ios_base::end);
+    stream.read(&part[0], 50);
+    BOOST_TEST(stream.gcount() == 3);
+    BOOST_TEST(stream.eof());
+
+    BOOST_CHECK_THROW(positional_file("io_positional_file_test.missing"),
+        boost::astronomy::file_io_exception);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_readers)
+{
+    write_test_file();
+    positional_file file(file_name);
+
+    //offsets of the tables from a sequential pass
+    std::vector<std::streamoff> offsets;
+    {
+        positional_stream stream(file);
+        hdu primary(stream);
+        for (std::size_t table = 0; table < tables; table++)
+        {
+            offsets.push_back(stream.tellg());
+            binary_table_extension skipped(stream);
+        }
+    }
+
+    std::atomic<std::size_t> failures(0);
+    std::vector<std::thread> readers;
+    for (std::size_t thread = 0; thread < 8; thread++)
+    {
+        readers.emplace_back([&, thread]() {
+            for (std::size_t pass = 0; pass < 20; pass++)
+            {
+                std::size_t const table = (thread + pass) % tables;
+                positional_stream stream(file, static_cast<std::uint64_t>(offsets[table]));
+                binary_table_extension extension(stream);
+                column_view<std::int64_t> values(extension, "VALUE");
+                std::size_t const row = (pass * 97) % table_rows(table);
+                if (values.size() != table_rows(table) ||
+                    values[row] != static_cast<std::int64_t>(1000 * table + row))
+                {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+    BOOST_TEST(failures.load() == 0u);
+
+    BOOST_CHECK_NO_THROW(fits{file});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+#define BOOST_TEST_MODULE io_registration_test
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/registration.hpp>
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+struct star
+{
+    double x;
+    double y;
+    double flux;
+    double sigma;
+};
+
+std::vector<star> star_field(std::size_t count, double width, double height)
+{
+    std::vector<star> stars;
+    std::uint32_t state = 12345;
+    auto const next = [&]()
+    {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<double>(state >> 8) / 16777216.0;
+    };
+    for (std::size_t i = 0; i < count; i++)
+    {
+        double const x = next() * width;
+        double const y = next() * height;
+        double const flux = 200 + 3000 * next() * next();
+        stars.push_back(star{x, y, flux, 1.2 + next()});
+    }
+    return stars;
+}
+
+//the field seen with its stars moved by (dx, dy), on a sloping sky
+template <bitpix Bitpix>
+image<Bitpix> exposure(std::vector<star> const& stars, std::size_t width, std::size_t height,
+    double dx, double dy)
+{
+    image<Bitpix> result;
+    result.resize(width, height);
+    for (std::size_t y = 0; y < height; y++)
+    {
+        for (std::size_t x = 0; x < width; x++)
+        {
+            double value = 100 + 0.05 * static_cast<double>(x);
+            for (star const& s : stars)
+            {
+                double const ex = static_cast<double>(x) - s.x - dx;
+                double const ey = static_cast<double>(y) - s.y - dy;
+                double const r2 = ex * ex + ey * ey;
+                if (r2 < 100)
+                {
+                    value += s.flux * std::exp(-r2 / (2 * s.sigma * s.sigma));
+                }
+            }
+            result.view()(y, x) = static_cast<typename image<Bitpix>::pixel_type>(value);
+        }
+    }
+    return result;
+}
+
+std::size_t const width = 300;
+std::size_t const height = 260;
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(registration_test)
+
+BOOST_AUTO_TEST_CASE(single_pairs)
+{
+    auto const stars = star_field(250, width, height);
+    auto const reference = exposure<bitpix::_B32>(stars, width, height, 0, 0);
+
+    for (auto const& shift : std::vector<std::vector<double>>{{12.3, -7.6}, {0.4, 0.25},
+        {-40.5, 23.75}, {0, 0}})
+    {
+        auto const frame = exposure<bitpix::_B32>(stars, width, height, shift[0], shift[1]);
+        image_shift const measured = register_image(reference, frame);
+        BOOST_TEST_CONTEXT("shift " << shift[0] << ", " << shift[1])
+        {
+            BOOST_TEST(std::abs(measured.x - shift[0]) < 0.1);
+            BOOST_TEST(std::abs(measured.y - shift[1]) < 0.1);
+            BOOST_TEST(measured.peak > 0.2);
+        }
+    }
+
+    //without a pyramid, on integer pixels
+    registration_options options;
+    options.threads = 2;
+    auto const small = exposure<bitpix::B16>(stars, 96, 80, 0, 0);
+    auto const moved = exposure<bitpix::B16>(stars, 96, 80, -3.5, 5.2);
+    image_shift const measured = register_image(small, moved, options);
+    BOOST_TEST(std::abs(measured.x + 3.5) < 0.15);
+    BOOST_TEST(std::abs(measured.y - 5.2) < 0.15);
+
+    BOOST_CHECK_THROW(register_image(reference, small), boost::astronomy::image_size_mismatch_exception);
+}
+
+BOOST_AUTO_TEST_CASE(batches)
+{
+    auto const stars = star_field(250, width, height);
+    auto const frame = exposure<bitpix::_B64>(stars, width, height, 0, 0);
+
+    registration_options options;
+    options.threads = 3;
+    options.levels = 2;
+    options.window = 64;
+    registration_reference const reference(frame, options);
+
+    std::vector<std::vector<double>> const shifts{{1.5, 2.25}, {-8.2, 0.7}, {20.6, -15.1},
+        {-0.3, -0.6}, {5, 5}};
+    std::vector<image<bitpix::_B64>> frames;
+    for (auto const& shift : shifts)
+    {
+        frames.push_back(exposure<bitpix::_B64>(stars, width, height, shift[0], shift[1]));
+    }
+
+    std::vector<image_shift> const measured = reference.measure_all(frames);
+    BOOST_REQUIRE(measured.size() == shifts.size());
+    for (std::size_t i = 0; i < shifts.size(); i++)
+    {
+        BOOST_TEST(std::abs(measured[i].x - shifts[i][0]) < 0.1);
+        BOOST_TEST(std::abs(measured[i].y - shifts[i][1]) < 0.1);
+
+        //the same as one at a time
+        image_shift const single = reference.measure(frames[i]);
+        BOOST_TEST(single.x == measured[i].x);
+        BOOST_TEST(single.y == measured[i].y);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,224 @@
+#define BOOST_TEST_MODULE io_shared_hdu_cache_test
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/shared_hdu_cache.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+char const* const file_name = "io_shared_hdu_cache_test.fits";
+std::size_t const width = 6;
+std::size_t const height = 4;
+std::size_t const rows = 5;
+
+//16 bit image of width x height pixels followed by a table of J, 4A and E columns
+void write_test_file()
+{
+    fits_writer writer(file_name);
+
+    std::vector<card> cards(6);
+    cards[0].create_card("SIMPLE", true);
+    cards[1].create_card("BITPIX", 16);
+    cards[2].create_card("NAXIS", 2);
+    cards[3].create_card("NAXIS1", width);
+    cards[4].create_card("NAXIS2", height);
+    cards[5].create_card("EXTEND", true);
+    writer.write_header(cards);
+
+    std::string data;
+    for (std::size_t i = 0; i < width * height; i++)
+    {
+        append_big_endian(data, static_cast<std::int16_t>(100 * static_cast<int>(i) - 1000));
+    }
+    writer.write_data(data.data(), data.size());
+
+    cards = table_cards(12, rows, {"J", "4A", "E"});
+    cards.emplace_back(std::string("TTYPE1  = 'ID'"));
+    cards.emplace_back(std::string("TTYPE2  = 'NAME'"));
+    cards.emplace_back(std::string("TTYPE3  = 'FLUX'"));
+    cards.emplace_back(std::string("EXTNAME = 'CATALOG'"));
+    writer.write_header(cards);
+
+    data.clear();
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        append_big_endian(data, static_cast<std::int32_t>(10 * static_cast<int>(row) - 20));
+        std::string name = "s" + std::to_string(row);
+        data += name + std::string(4 - name.size(), ' ');
+        append_big_endian(data, static_cast<float>(row) * 0.5f);
+    }
+    writer.write_data(data.data(), data.size());
+}
+
+void add_primary(hdu_cache_builder& builder)
+{
+    std::fstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    image<bitpix::B16> pixels(file, width, height, 2880);
+    builder.add_image("PRIMARY", pixels);
+}
+
+//values of a dummy HDU occupying a segment of known size
+void add_values(hdu_cache_builder& builder, std::size_t count, double value)
+{
+    std::vector<double> values(count, value);
+    builder.add("VALUES", values.data(), values.size());
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(shared_hdu_cache_test)
+
+BOOST_AUTO_TEST_CASE(publish_and_attach)
+{
+    std::string const name = "io_shared_hdu_cache_test_attach";
+    shared_hdu_cache::remove(name);
+    write_test_file();
+    hdu_cache_key const key(file_name, 0, "raw");
+
+    shared_hdu_cache cache(name);
+    int builds = 0;
+    shared_hdu entry = cache.get_or_publish(key, [&](hdu_cache_builder& builder) {
+        builds++;
+        add_primary(builder);
+    });
+    BOOST_REQUIRE(entry.is_shared());
+    BOOST_TEST(builds == 1);
+    BOOST_TEST(entry.names() == std::vector<std::string>{"PRIMARY"});
+
+    auto pixels = entry.array<std::int16_t>("PRIMARY");
+    BOOST_TEST(pixels.width() == width);
+    BOOST_TEST(pixels.height() == height);
+    BOOST_TEST(pixels.at(2, 3) == 500);
+    BOOST_CHECK_THROW(entry.array<float>("PRIMARY"),
+        boost::astronomy::cache_type_mismatch_exception);
+    BOOST_CHECK_THROW(entry.array<std::int16_t>("IMAGE"),
+        boost::astronomy::column_not_found_exception);
+
+    //another process attaches to the published entry without decoding it again
+    pid_t const child = ::fork();
+    if (child == 0)
+    {
+        int status = 0;
+        try
+        {
+            shared_hdu_cache other(name);
+            shared_hdu attached = other.get_or_publish(key, [&](hdu_cache_builder&) {
+                status = 1;
+            });
+            auto view = attached.array<std::int16_t>("PRIMARY");
+            if (!attached.is_shared() || view.at(2, 3) != 500 || view.size() != width * height)
+            {
+                status = 2;
+            }
+        }
+        catch (...)
+        {
+            status = 3;
+        }
+        ::_exit(status);
+    }
+    int status = -1;
+    BOOST_REQUIRE(::waitpid(child, &status, 0) == child);
+    BOOST_TEST(WIFEXITED(status));
+    BOOST_TEST(WEXITSTATUS(status) == 0);
+
+    BOOST_TEST(cache.find(hdu_cache_key(file_name, 0, "scaled")).empty());
+    cache_statistics statistics = cache.statistics();
+    BOOST_TEST(statistics.entries == 1u);
+    BOOST_TEST(statistics.referenced == 1u);
+    BOOST_TEST(statistics.used_bytes == entry.size_bytes());
+
+    entry.release();
+    BOOST_TEST(cache.statistics().referenced == 0u);
+    BOOST_TEST(!cache.find(key).empty());
+    shared_hdu_cache::remove(name);
+}
+
+BOOST_AUTO_TEST_CASE(table_columns)
+{
+    std::string const name = "io_shared_hdu_cache_test_table";
+    shared_hdu_cache::remove(name);
+    write_test_file();
+
+    shared_hdu_cache cache(name);
+    shared_hdu entry = cache.get_or_publish(hdu_cache_key(file_name, 1),
+        [](hdu_cache_builder& builder) {
+            std::fstream file(file_name, std::ios_base::in | std::ios_base::binary);
+            file.seekg(2 * 2880);
+            binary_table_extension table(file);
+            builder.add_column(table, "ID");
+            builder.add_column(table, "NAME");
+            builder.add_column(table, "FLUX");
+        });
+
+    auto id = entry.array<std::int64_t>("ID");
+    auto text = entry.array<char>("NAME");
+    auto flux = entry.array<double>("FLUX");
+    BOOST_REQUIRE(id.size() == rows);
+    BOOST_TEST(id[4] == 20);
+    BOOST_TEST(text.width() == 4u);
+    BOOST_TEST(string_at(text, 3) == "s3");
+    BOOST_TEST(flux[3] == 1.5);
+    shared_hdu_cache::remove(name);
+}
+
+BOOST_AUTO_TEST_CASE(eviction)
+{
+    std::string const name = "io_shared_hdu_cache_test_eviction";
+    shared_hdu_cache::remove(name);
+    write_test_file();
+
+    //each entry takes 928 bytes, three of them fit
+    shared_hdu_cache cache(name, 3000, 8);
+    auto publish = [&](std::size_t index, std::size_t count) {
+        return cache.get_or_publish(hdu_cache_key(file_name, index),
+            [&](hdu_cache_builder& builder) { add_values(builder, count, double(index)); });
+    };
+
+    publish(0, 100);
+    shared_hdu kept = publish(1, 100);
+    publish(2, 100);
+    BOOST_TEST(cache.statistics().used_bytes == 3 * 928u);
+    BOOST_TEST(!cache.find(hdu_cache_key(file_name, 0)).empty());
+
+    //least recently used entry without references goes first
+    shared_hdu added = publish(3, 100);
+    BOOST_TEST(added.is_shared());
+    BOOST_TEST(cache.find(hdu_cache_key(file_name, 2)).empty());
+    BOOST_TEST(!cache.find(hdu_cache_key(file_name, 0)).empty());
+    BOOST_TEST(!cache.find(hdu_cache_key(file_name, 1)).empty());
+
+    //an entry that can not fit is only published to this process
+    shared_hdu large = publish(4, 1000);
+    BOOST_TEST(!large.is_shared());
+    BOOST_TEST(large.array<double>("VALUES")[999] == 4.0);
+    BOOST_TEST(cache.find(hdu_cache_key(file_name, 4)).empty());
+
+    BOOST_TEST(cache.evict_unused() == 1u);
+    cache_statistics statistics = cache.statistics();
+    BOOST_TEST(statistics.entries == 2u);
+    BOOST_TEST(statistics.referenced == 2u);
+    BOOST_TEST(kept.array<double>("VALUES")[50] == 1.0);
+    shared_hdu_cache::remove(name);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+#define BOOST_TEST_MODULE io_sidecar_cache_test
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/sidecar_cache.hpp>
+
+using namespace boost::astronomy::io;
+namespace fs = boost::filesystem;
+
+namespace {
+
+char const* const file_name = "io_sidecar_cache_test.fits";
+char const* const directory = "io_sidecar_cache_test";
+std::size_t const width = 5;
+std::size_t const height = 3;
+
+//32 bit image with pixel i set to first + i
+void write_test_file(std::int32_t first)
+{
+    fits_writer writer(file_name);
+
+    std::vector<card> cards(5);
+    cards[0].create_card("SIMPLE", true);
+    cards[1].create_card("BITPIX", 32);
+    cards[2].create_card("NAXIS", 2);
+    cards[3].create_card("NAXIS1", width);
+    cards[4].create_card("NAXIS2", height);
+    writer.write_header(cards);
+
+    std::string data;
+    for (std::size_t i = 0; i < width * height; i++)
+    {
+        std::int32_t value = boost::endian::native_to_big(first + static_cast<std::int32_t>(i));
+        data.append(reinterpret_cast<char const*>(&value), sizeof(value));
+    }
+    writer.write_data(data.data(), data.size());
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(sidecar_cache_test)
+
+BOOST_AUTO_TEST_CASE(create_validate_and_rebuild)
+{
+    fs::remove_all(directory);
+    write_test_file(-7);
+    sidecar_cache cache(directory);
+
+    int builds = 0;
+    auto build = [&](hdu_cache_builder& builder) {
+        builds++;
+        std::fstream file(file_name, std::ios_base::in | std::ios_base::binary);
+        image<bitpix::B32> pixels(file, width, height, 2880);
+        builder.add_image("SCALED", pixels, 2.0, 10.0);
+    };
+
+    BOOST_TEST(cache.find(file_name, 0, "scaled").empty());
+    {
+        shared_hdu entry = cache.get_or_create(file_name, 0, "scaled", build);
+        BOOST_TEST(builds == 1);
+        BOOST_TEST(entry.is_shared());
+        auto pixels = entry.array<double>("SCALED");
+        BOOST_TEST(pixels.width() == width);
+        BOOST_TEST(pixels.at(1, 2) == 10.0 + 2.0 * (-7 + 7));
+        BOOST_TEST(reinterpret_cast<std::uintptr_t>(pixels.data()) % 64 == 0u);
+    }
+    BOOST_TEST(fs::exists(cache.sidecar_path(file_name, 0, "scaled")));
+
+    //repeated opens map the sidecar
+    {
+        shared_hdu entry = cache.get_or_create(file_name, 0, "scaled", build);
+        BOOST_TEST(builds == 1);
+        BOOST_TEST(entry.array<double>("SCALED")[14] == 10.0 + 2.0 * 7);
+        BOOST_TEST(!cache.find(file_name, 0, "scaled").empty());
+        BOOST_TEST(cache.find(file_name, 0, "raw").empty());
+    }
+
+    //a changed source invalidates the stamp
+    write_test_file(100);
+    fs::last_write_time(file_name, fs::last_write_time(file_name) + 10);
+    BOOST_TEST(cache.find(file_name, 0, "scaled").empty());
+    {
+        shared_hdu entry = cache.get_or_create(file_name, 0, "scaled", build);
+        BOOST_TEST(builds == 2);
+        BOOST_TEST(entry.array<double>("SCALED")[0] == 210.0);
+    }
+
+    //as does a sidecar written with another byte order
+    {
+        std::fstream sidecar(cache.sidecar_path(file_name, 0, "scaled"),
+            std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+        sidecar.seekp(12);
+        std::uint32_t const swapped = 0x04030201;
+        sidecar.write(reinterpret_cast<char const*>(&swapped), sizeof(swapped));
+    }
+    BOOST_TEST(cache.find(file_name, 0, "scaled").empty());
+    cache.get_or_create(file_name, 0, "scaled", build);
+    BOOST_TEST(builds == 3);
+    BOOST_TEST(!cache.find(file_name, 0, "scaled").empty());
+
+    BOOST_TEST(cache.remove(file_name, 0, "scaled"));
+    BOOST_TEST(!cache.remove(file_name, 0, "scaled"));
+    BOOST_TEST(fs::is_empty(directory));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
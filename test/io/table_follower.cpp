@@ -0,0 +1,187 @@
+#define BOOST_TEST_MODULE io_table_follower_test
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/column_view.hpp>
+#include <boost/astronomy/io/table_follower.hpp>
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+char const* const file_name = "io_table_follower_test.fits";
+std::size_t const table_start = 2880;
+std::size_t const data_start = 2 * 2880;
+
+std::string event_row(std::size_t row)
+{
+    std::int32_t value = static_cast<std::int32_t>(row * 10);
+    char bytes[4];
+    std::memcpy(bytes, &value, 4);
+    std::reverse(bytes, bytes + 4);
+    return std::string(bytes, 4) + (row % 2 ? "odd " : "even");
+}
+
+std::string naxis2_card(std::size_t rows)
+{
+    std::string value = std::to_string(rows);
+    return "NAXIS2  = " + std::string(20 - value.length(), ' ') + value + std::string(50, ' ');
+}
+
+//writes header and initial rows, padding is left out as by a writer still appending
+void create_file(std::size_t rows)
+{
+    std::ofstream file(file_name, std::ios_base::out | std::ios_base::binary);
+    std::vector<std::string> headers[2] = {
+        {
+            "SIMPLE  =                    T",
+            "BITPIX  =                    8",
+            "NAXIS   =                    0",
+            "EXTEND  =                    T"
+        },
+        {
+            "XTENSION= 'BINTABLE'",
+            "BITPIX  =                    8",
+            "NAXIS   =                    2",
+            "NAXIS1  =                    8",
+            naxis2_card(rows),
+            "PCOUNT  =                    0",
+            "GCOUNT  =                    1",
+            "TFIELDS =                    2",
+            "TTYPE1  = 'COUNT   '",
+            "TFORM1  = 'J       '",
+            "TTYPE2  = 'KIND    '",
+            "TFORM2  = '4A      '",
+            "EXTNAME = 'EVENTS  '"
+        }
+    };
+    for (auto const& cards : headers)
+    {
+        std::string block;
+        for (auto const& c : cards)
+        {
+            block += c + std::string(80 - c.length(), ' ');
+        }
+        block += "END" + std::string(77, ' ');
+        block.append(2880 - block.length(), ' ');
+        file.write(block.data(), 2880);
+    }
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        file << event_row(row);
+    }
+}
+
+//appends rows at the end of the data and optionally updates NAXIS2 in place
+void append_rows(std::size_t first, std::size_t count, bool update_header)
+{
+    std::fstream file(file_name, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    file.seekp(static_cast<std::streamoff>(data_start + first * 8));
+    for (std::size_t row = first; row < first + count; row++)
+    {
+        file << event_row(row);
+    }
+    if (update_header)
+    {
+        file.seekp(static_cast<std::streamoff>(table_start + 4 * 80));
+        file << naxis2_card(first + count);
+    }
+}
+
+std::vector<std::int64_t> counts_of(table_follower const& follower, table_batch const& batch)
+{
+    return column_view<std::int64_t>(follower.table(), "COUNT", batch.data.data(), batch.rows)
+        .materialize();
+}
+
+//pads the data to whole blocks and appends an empty image extension, as a writer finishing
+void finish_file(std::size_t rows)
+{
+    std::fstream file(file_name, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    file.seekp(static_cast<std::streamoff>(data_start + rows * 8));
+    file << std::string((2880 - rows * 8 % 2880) % 2880, '\0');
+
+    std::string block;
+    for (std::string const& c : {
+        std::string("XTENSION= 'IMAGE   '"),
+        std::string("BITPIX  =                    8"),
+        std::string("NAXIS   =                    0"),
+        std::string("END")})
+    {
+        block += c + std::string(80 - c.length(), ' ');
+    }
+    file << block << std::string(2880 - block.length(), ' ');
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(table_follower_test)
+
+BOOST_AUTO_TEST_CASE(follow_header)
+{
+    create_file(3);
+    table_follower follower(file_name, table_start);
+    table_batch batch;
+
+    BOOST_REQUIRE(follower.read(batch));
+    BOOST_TEST(batch.first_row == 0u);
+    BOOST_TEST((counts_of(follower, batch) == std::vector<std::int64_t>{0, 10, 20}));
+    BOOST_TEST(!follower.read(batch));
+
+    //rows written before NAXIS2 is updated are not delivered
+    append_rows(3, 4, false);
+    BOOST_TEST(follower.poll() == 0u);
+    append_rows(7, 1, true);
+    BOOST_TEST(follower.poll() == 5u);
+
+    BOOST_REQUIRE(follower.read(batch, 2));
+    BOOST_TEST(batch.first_row == 3u);
+    BOOST_TEST((counts_of(follower, batch) == std::vector<std::int64_t>{30, 40}));
+    BOOST_REQUIRE(follower.read(batch));
+    BOOST_TEST((counts_of(follower, batch) == std::vector<std::int64_t>{50, 60, 70}));
+    BOOST_TEST(column_view<std::string>(follower.table(), "KIND",
+        batch.data.data(), batch.rows)[2] == "odd");
+    BOOST_TEST(follower.consumed() == 8u);
+
+    //a consumer restarting from a saved offset only sees the rows after it
+    table_follower resumed(file_name, table_start, follow_mode::header, 6);
+    BOOST_REQUIRE(resumed.read(batch));
+    BOOST_TEST((counts_of(resumed, batch) == std::vector<std::int64_t>{60, 70}));
+
+    create_file(2);
+    BOOST_CHECK_THROW(follower.poll(), boost::astronomy::table_truncated_exception);
+}
+
+BOOST_AUTO_TEST_CASE(follow_file_size)
+{
+    create_file(2);
+    table_follower follower(file_name, table_start, follow_mode::file_size);
+    table_batch batch;
+    BOOST_REQUIRE(follower.read(batch));
+    BOOST_TEST(batch.rows == 2u);
+
+    append_rows(2, 3, false);
+    BOOST_TEST(follower.wait(std::chrono::milliseconds(100)) == 3u);
+    BOOST_REQUIRE(follower.read(batch));
+    BOOST_TEST((counts_of(follower, batch) == std::vector<std::int64_t>{20, 30, 40}));
+    BOOST_TEST(follower.wait(std::chrono::milliseconds(20)) == 0u);
+
+    //padding and the next HDU written after NAXIS2 are not taken for rows
+    append_rows(5, 2, true);
+    finish_file(7);
+    BOOST_TEST(follower.poll() == 2u);
+    BOOST_REQUIRE(follower.read(batch));
+    BOOST_TEST((counts_of(follower, batch) == std::vector<std::int64_t>{50, 60}));
+    BOOST_TEST(follower.poll() == 0u);
+    BOOST_TEST(follower.consumed() == 7u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
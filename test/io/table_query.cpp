@@ -0,0 +1,271 @@
+#define BOOST_TEST_MODULE io_table_query_test
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/column_view.hpp>
+#include <boost/astronomy/io/table_query.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+std::size_t const objects = 50;
+std::size_t const detections = 1000;
+char const* const file_name = "io_table_query_test.fits";
+
+//object id of detection, some detections reference ids with no object
+std::int32_t detection_object(std::size_t row)
+{
+    return static_cast<std::int32_t>((row * 7) % (objects + 10));
+}
+
+float detection_flux(std::size_t row)
+{
+    return static_cast<float>(row % 13);
+}
+
+void write_test_file()
+{
+    std::ofstream file(file_name, std::ios_base::out | std::ios_base::binary);
+    write_header(file, {
+        "SIMPLE  =                    T",
+        "BITPIX  =                    8",
+        "NAXIS   =                    0",
+        "EXTEND  =                    T"
+    });
+
+    write_header(file, {
+        "XTENSION= 'BINTABLE'",
+        "BITPIX  =                    8",
+        "NAXIS   =                    2",
+        "NAXIS1  =                   12",
+        "NAXIS2  =                   50",
+        "PCOUNT  =                    0",
+        "GCOUNT  =                    1",
+        "TFIELDS =                    2",
+        "TTYPE1  = 'ID      '",
+        "TFORM1  = 'J       '",
+        "TTYPE2  = 'NAME    '",
+        "TFORM2  = '8A      '",
+        "EXTNAME = 'OBJECTS '"
+    });
+    std::string data;
+    for (std::size_t row = 0; row < objects; row++)
+    {
+        append_big_endian(data, static_cast<std::int32_t>(objects - 1 - row));
+        std::string name = "obj" + std::to_string(objects - 1 - row);
+        data += name + std::string(8 - name.length(), ' ');
+    }
+    write_block(file, data, '\0');
+
+    write_header(file, {
+        "XTENSION= 'BINTABLE'",
+        "BITPIX  =                    8",
+        "NAXIS   =                    2",
+        "NAXIS1  =                   16",
+        "NAXIS2  =                 1000",
+        "PCOUNT  =                    0",
+        "GCOUNT  =                    1",
+        "TFIELDS =                    3",
+        "TTYPE1  = 'OBJ_ID  '",
+        "TFORM1  = 'J       '",
+        "TTYPE2  = 'FLUX    '",
+        "TFORM2  = 'E       '",
+        "TTYPE3  = 'MJD     '",
+        "TFORM3  = 'D       '",
+        "EXTNAME = 'DETECT  '"
+    });
+    data.clear();
+    for (std::size_t row = 0; row < detections; row++)
+    {
+        append_big_endian(data, detection_object(row));
+        append_big_endian(data, detection_flux(row));
+        append_big_endian(data, 58000.0 + static_cast<double>(row));
+    }
+    write_block(file, data, '\0');
+}
+
+struct test_tables
+{
+    binary_table_extension object_table;
+    binary_table_extension detection_table;
+};
+
+test_tables read_test_tables()
+{
+    write_test_file();
+    std::fstream file(file_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+    binary_table_extension object_table(file);
+    binary_table_extension detection_table(file);
+    return test_tables{object_table, detection_table};
+}
+
+//one unsigned 'K' column (TZERO = 2^63) holding the given physical values
+binary_table_extension read_unsigned_table(std::vector<std::uint64_t> const& values)
+{
+    char const* const unsigned_name = "io_table_query_unsigned_test.fits";
+    {
+        std::ofstream file(unsigned_name, std::ios_base::out | std::ios_base::binary);
+        write_header(file, {
+            "SIMPLE  =                    T",
+            "BITPIX  =                    8",
+            "NAXIS   =                    0",
+            "EXTEND  =                    T"
+        });
+        write_header(file, {
+            "XTENSION= 'BINTABLE'",
+            "BITPIX  =                    8",
+            "NAXIS   =                    2",
+            "NAXIS1  =                    8",
+            "NAXIS2  =                    " + std::to_string(values.size()),
+            "PCOUNT  =                    0",
+            "GCOUNT  =                    1",
+            "TFIELDS =                    1",
+            "TTYPE1  = 'ID      '",
+            "TFORM1  = 'K       '",
+            "TZERO1  =  9223372036854775808",
+            "EXTNAME = 'UNSIGNED'"
+        });
+        std::string data;
+        for (std::uint64_t value : values)
+        {
+            append_big_endian(data, value ^ (std::uint64_t(1) << 63));
+        }
+        write_block(file, data, '\0');
+    }
+
+    std::fstream file(unsigned_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+    return binary_table_extension(file);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(table_query_test)
+
+BOOST_AUTO_TEST_CASE(column_views)
+{
+    test_tables tables = read_test_tables();
+
+    column_view<std::int64_t> ids(tables.object_table, "ID");
+    column_view<std::string> names(tables.object_table, "NAME");
+    BOOST_REQUIRE(ids.size() == objects);
+    BOOST_TEST(ids[0] == 49);
+    BOOST_TEST(names[0] == "obj49");
+
+    auto subset = names.at_rows({3, 1}).at_rows({1});
+    BOOST_TEST(subset.size() == 1u);
+    BOOST_TEST(subset[0] == "obj48");
+
+    BOOST_CHECK_THROW(column_view<std::int64_t>(tables.object_table, "NAME"),
+        boost::astronomy::invalid_table_colum_format);
+    BOOST_CHECK_THROW(column_view<double>(tables.object_table, "MISSING"),
+        boost::astronomy::column_not_found_exception);
+}
+
+BOOST_AUTO_TEST_CASE(join_and_aggregate)
+{
+    test_tables tables = read_test_tables();
+
+    column_view<std::int64_t> object_id(tables.object_table, "ID");
+    column_view<std::int64_t> detection_object_id(tables.detection_table, "OBJ_ID");
+    column_view<double> flux(tables.detection_table, "FLUX");
+    column_view<double> mjd(tables.detection_table, "MJD");
+
+    std::vector<std::pair<std::size_t, std::size_t>> expected;
+    for (std::size_t d = 0; d < detections; d++)
+    {
+        if (static_cast<std::size_t>(detection_object(d)) < objects)
+        {
+            expected.emplace_back(d, objects - 1 - static_cast<std::size_t>(detection_object(d)));
+        }
+    }
+
+    for (std::size_t threads : {1u, 4u})
+    {
+        join_result joined = hash_join(detection_object_id, object_id, threads);
+
+        std::vector<std::pair<std::size_t, std::size_t>> pairs;
+        for (std::size_t i = 0; i < joined.size(); i++)
+        {
+            pairs.emplace_back(joined.left_rows[i], joined.right_rows[i]);
+        }
+        std::sort(pairs.begin(), pairs.end());
+        BOOST_TEST((pairs == expected));
+
+        auto grouped = group_by(object_id.at_rows(joined.right_rows), {
+            aggregation(aggregate::count, flux.at_rows(joined.left_rows)),
+            aggregation(aggregate::mean, flux.at_rows(joined.left_rows)),
+            aggregation(aggregate::min, mjd.at_rows(joined.left_rows)),
+            aggregation(aggregate::max, mjd.at_rows(joined.left_rows))
+        }, threads);
+
+        std::map<std::int64_t, std::vector<std::size_t>> brute;
+        for (auto const& p : expected)
+        {
+            brute[detection_object(p.first)].push_back(p.first);
+        }
+
+        BOOST_REQUIRE(grouped.keys.size() == brute.size());
+        std::size_t g = 0;
+        for (auto const& group : brute)
+        {
+            double sum = 0;
+            for (auto row : group.second)
+            {
+                sum += detection_flux(row);
+            }
+            BOOST_TEST(grouped.keys[g] == group.first);
+            BOOST_TEST(grouped.counts[g] == group.second.size());
+            BOOST_TEST(grouped.values[0][g] == static_cast<double>(group.second.size()));
+            double const mean = sum / static_cast<double>(group.second.size());
+            BOOST_TEST(std::abs(grouped.values[1][g] - mean) < 1e-9);
+            BOOST_TEST(grouped.values[2][g] == 58000.0 + static_cast<double>(group.second.front()));
+            BOOST_TEST(grouped.values[3][g] == 58000.0 + static_cast<double>(group.second.back()));
+            g++;
+        }
+    }
+
+    BOOST_CHECK_THROW(group_by(object_id, {aggregation(aggregate::sum, flux)}),
+        boost::astronomy::column_length_mismatch_exception);
+}
+
+BOOST_AUTO_TEST_CASE(unsigned_64_bit_keys)
+{
+    std::uint64_t const high = std::uint64_t(1) << 63;
+    std::vector<std::uint64_t> const values = {high + 5, 3, high + 5, ~std::uint64_t(0), 0, 3};
+    binary_table_extension table = read_unsigned_table(values);
+
+    column_view<std::uint64_t> ids(table, "ID");
+    BOOST_TEST((ids.materialize() == values));
+
+    //values above 2^63 - 1 do not fit std::int64_t
+    BOOST_CHECK_THROW(column_view<std::int64_t>(table, "ID"),
+        boost::astronomy::invalid_table_colum_format);
+    BOOST_CHECK_THROW(column_view<std::uint64_t>(read_test_tables().object_table, "ID"),
+        boost::astronomy::invalid_table_colum_format);
+
+    for (std::size_t threads : {1u, 4u})
+    {
+        auto grouped = group_by(ids, {}, threads);
+        BOOST_TEST((grouped.keys ==
+            std::vector<std::uint64_t>{0, 3, high + 5, ~std::uint64_t(0)}));
+        BOOST_TEST((grouped.counts == std::vector<std::size_t>{1, 2, 2, 1}));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,181 @@
+#define BOOST_TEST_MODULE io_table_rewrite_test
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/ascii_table.hpp>
+#include <boost/astronomy/io/column_view.hpp>
+#include <boost/astronomy/io/table_rewrite.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+std::size_t const rows = 300;
+char const* const input_name = "io_table_rewrite_test.fits";
+char const* const output_name = "io_table_rewrite_test_out.fits";
+
+std::string padded(std::string value, std::size_t width)
+{
+    return std::string(width - value.length(), ' ') + value;
+}
+
+void write_test_file()
+{
+    std::ofstream file(input_name, std::ios_base::out | std::ios_base::binary);
+    write_header(file, {
+        "SIMPLE  =                    T",
+        "BITPIX  =                    8",
+        "NAXIS   =                    0",
+        "EXTEND  =                    T"
+    });
+
+    write_header(file, {
+        "XTENSION= 'BINTABLE'",
+        "BITPIX  =                    8",
+        "NAXIS   =                    2",
+        "NAXIS1  =                   22",
+        "NAXIS2  =                  300",
+        "PCOUNT  =                    0",
+        "GCOUNT  =                    1",
+        "TFIELDS =                    4",
+        "TTYPE1  = 'ID      '",
+        "TFORM1  = 'J       '",
+        "TTYPE2  = 'FLUX    '",
+        "TFORM2  = 'I       '",
+        "TSCAL2  =                  0.5",
+        "TUNIT2  = 'Jy      '",
+        "TTYPE3  = 'MJD     '",
+        "TFORM3  = 'D       '",
+        "TTYPE4  = 'NAME    '",
+        "TFORM4  = '8A      '",
+        "EXTNAME = 'CATALOG '",
+        "CHECKSUM= 'hcHjjc9ghcEghc9g'",
+        "DATASUM = '2503531142'"
+    });
+    std::string data;
+    for (std::size_t row = 0; row < rows; row++)
+    {
+        append_big_endian(data, static_cast<std::int32_t>(row));
+        append_big_endian(data, static_cast<std::int16_t>(row * 3));
+        append_big_endian(data, 50000.0 + static_cast<double>(row));
+        std::string name = "src" + std::to_string(row);
+        data += name + std::string(8 - name.length(), ' ');
+    }
+    write_block(file, data, '\0');
+
+    write_header(file, {
+        "XTENSION= 'TABLE   '",
+        "BITPIX  =                    8",
+        "NAXIS   =                    2",
+        "NAXIS1  =                   14",
+        "NAXIS2  =                    3",
+        "PCOUNT  =                    0",
+        "GCOUNT  =                    1",
+        "TFIELDS =                    2",
+        "TTYPE1  = 'N       '",
+        "TBCOL1  =                    1",
+        "TFORM1  = 'I4      '",
+        "TTYPE2  = 'LABEL   '",
+        "TBCOL2  =                    7",
+        "TFORM2  = 'A8      '",
+        "EXTNAME = 'LABELS  '"
+    });
+    data.clear();
+    for (std::size_t row = 0; row < 3; row++)
+    {
+        data += padded(std::to_string(row), 4) + "  " + "label" + std::to_string(row) + "  ";
+    }
+    write_block(file, data, ' ');
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(table_rewrite_test)
+
+BOOST_AUTO_TEST_CASE(projection_and_selection)
+{
+    write_test_file();
+
+    bit_mask selection(rows);
+    for (std::size_t row = 0; row < rows; row += 7)
+    {
+        selection.set(row);
+    }
+
+    {
+        std::fstream file(input_name, std::ios_base::in | std::ios_base::binary);
+        hdu primary(file);
+        rewrite_options options;
+        options.buffer_size = 1000; //several blocks of source rows
+        BOOST_TEST(rewrite_table(file, output_name, {"NAME", "FLUX", "ID"}, selection, options)
+            == selection.count());
+    }
+
+    std::fstream file(output_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+    binary_table_extension table(file);
+    BOOST_REQUIRE(table.naxis(1) == 14u);
+    BOOST_REQUIRE(table.naxis(2) == selection.count());
+    BOOST_TEST(table.value_of<std::size_t>("TFIELDS") == 3u);
+    BOOST_TEST(table.value_of<std::string>("TFORM2") == "'I       '");
+    BOOST_TEST(table.value_of<std::string>("TUNIT2") == "'Jy      '");
+    BOOST_CHECK_THROW(table.value_of<std::string>("TTYPE4"), std::out_of_range);
+    //the sums of the source do not hold for the rewritten data unit
+    BOOST_CHECK_THROW(table.value_of<std::string>("CHECKSUM"), std::out_of_range);
+    BOOST_CHECK_THROW(table.value_of<std::string>("DATASUM"), std::out_of_range);
+
+    auto names = column_view<std::string>(table, "NAME").materialize();
+    auto flux = column_view<double>(table, "FLUX").materialize();
+    auto ids = column_view<std::int64_t>(table, "ID").materialize();
+    for (std::size_t i = 0; i < table.naxis(2); i++)
+    {
+        std::size_t const row = i * 7;
+        BOOST_TEST(ids[i] == static_cast<std::int64_t>(row));
+        BOOST_TEST(flux[i] == 1.5 * static_cast<double>(row));
+        BOOST_TEST(names[i] == "src" + std::to_string(row));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ascii_table_and_next_hdu)
+{
+    write_test_file();
+    {
+        std::fstream file(input_name, std::ios_base::in | std::ios_base::binary);
+        hdu primary(file);
+        fits_writer writer(output_name);
+        writer.write_empty_primary();
+        BOOST_TEST(rewrite_table(file, writer, {}) == rows);
+        BOOST_TEST(rewrite_table(file, writer, {"LABEL"}) == 3u);
+    }
+
+    std::fstream file(output_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+    binary_table_extension copy(file);
+    BOOST_TEST(copy.naxis(1) == 22u);
+    BOOST_TEST(column_view<double>(copy, "MJD")[299] == 50299.0);
+
+    ascii_table labels(file);
+    BOOST_TEST(labels.naxis(1) == 8u);
+    BOOST_TEST(labels.value_of<std::size_t>("TBCOL1") == 1u);
+    BOOST_TEST(std::string(labels.get_data().data(), 24) == "label0  label1  label2  ");
+}
+
+BOOST_AUTO_TEST_CASE(invalid_requests)
+{
+    write_test_file();
+    std::fstream file(input_name, std::ios_base::in | std::ios_base::binary);
+    hdu primary(file);
+    BOOST_CHECK_THROW(rewrite_table(file, output_name, {"ID", "ID"}),
+        boost::astronomy::invalid_table_colum_format);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
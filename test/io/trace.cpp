@@ -0,0 +1,223 @@
+#define BOOST_TEST_MODULE io_trace_test
+#define BOOST_ASTRONOMY_IO_ENABLE_TRACE
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/detail/parallel_for.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/binary_table.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/trace.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+namespace pt = boost::property_tree;
+
+namespace {
+
+char const* const image_name = "io_trace_test_image.fits";
+char const* const table_name = "io_trace_test_table.fits";
+
+//8 bit primary image of 16 x 16 pixels followed by an image extension
+void write_image_file()
+{
+    fits_writer writer(image_name, 1);
+    std::vector<card> cards(6);
+    cards[0].create_card("SIMPLE", true);
+    cards[1].create_card("BITPIX", 8);
+    cards[2].create_card("NAXIS", 2);
+    cards[3].create_card("NAXIS1", 16);
+    cards[4].create_card("NAXIS2", 16);
+    cards[5].create_card("EXTEND", true);
+    writer.write_header(cards);
+    std::string const pixels(256, '\x01');
+    writer.write_data(pixels.data(), pixels.size());
+
+    cards.resize(8);
+    cards[0] = card(std::string("XTENSION= 'IMAGE   '"));
+    cards[5].create_card("PCOUNT", 0);
+    cards[6].create_card("GCOUNT", 1);
+    cards[7] = card(std::string("EXTNAME = 'SECOND'"));
+    writer.write_header(cards);
+    writer.write_data(pixels.data(), pixels.size());
+}
+
+void write_table_file()
+{
+    fits_writer writer(table_name, 1);
+    writer.write_empty_primary();
+    write_int_table(writer, 100, "T", [](std::size_t) { return 0x03030303; });
+}
+
+std::size_t count(std::vector<trace_event> const& events, std::string const& name)
+{
+    return static_cast<std::size_t>(std::count_if(events.begin(), events.end(),
+        [&](trace_event const& e) { return name == e.name; }));
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(trace_test)
+
+BOOST_AUTO_TEST_CASE(io_spans)
+{
+    BOOST_REQUIRE(tracing::enabled());
+    write_image_file();
+    write_table_file();
+    tracing::clear();
+
+    {
+        fits file(image_name);
+        file.read_extensions();
+    }
+    {
+        std::ifstream stream(table_name, std::ios_base::in | std::ios_base::binary);
+        hdu primary(stream);
+        binary_table_extension table(stream);
+        BOOST_REQUIRE(table.get_column("VALUE") != nullptr);
+    }
+
+    std::vector<trace_event> const events = tracing::collect();
+    BOOST_TEST(count(events, "fits::read_primary_hdu") == 1u);
+    BOOST_TEST(count(events, "fits::read_extensions") == 1u);
+    BOOST_TEST(count(events, "hdu::read_header") == 4u);
+    BOOST_TEST(count(events, "image::read_image") == 2u);
+    BOOST_TEST(count(events, "binary_table::get_column") == 1u);
+
+    //headers and pixels are read inside the spans of the fits handle
+    auto const outer = std::find_if(events.begin(), events.end(), [](trace_event const& e) {
+        return std::string(e.name) == "fits::read_primary_hdu";
+    });
+    auto const inner = std::find_if(events.begin(), events.end(), [](trace_event const& e) {
+        return std::string(e.name) == "hdu::read_header";
+    });
+    BOOST_TEST(outer->begin_ns <= inner->begin_ns);
+    BOOST_TEST(inner->end_ns <= outer->end_ns);
+    for (auto const& event : events)
+    {
+        BOOST_TEST(event.begin_ns <= event.end_ns);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(chrome_json)
+{
+    write_image_file();
+    tracing::clear();
+
+    //every worker records on its own ring buffer
+    boost::astronomy::detail::parallel_for(8, 4, [](std::size_t begin, std::size_t end, std::size_t)
+    {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            fits file(image_name);
+            file.read_extensions();
+        }
+    });
+
+    std::vector<trace_event> const events = tracing::collect();
+    std::set<std::uint32_t> threads;
+    for (auto const& event : events)
+    {
+        threads.insert(event.thread);
+    }
+    BOOST_TEST(threads.size() == 4u);
+    BOOST_TEST(count(events, "fits::read_primary_hdu") == 8u);
+
+    std::stringstream json;
+    tracing::write_chrome_json(json);
+    pt::ptree trace;
+    BOOST_REQUIRE_NO_THROW(pt::read_json(json, trace));
+
+    std::size_t spans = 0;
+    std::size_t names = 0;
+    for (auto const& entry : trace.get_child("traceEvents"))
+    {
+        std::string const phase = entry.second.get<std::string>("ph");
+        if (phase == "X")
+        {
+            spans++;
+            BOOST_TEST(entry.second.get<double>("dur") >= 0.0);
+            BOOST_TEST(threads.count(entry.second.get<std::uint32_t>("tid")) == 1u);
+        }
+        else if (phase == "M")
+        {
+            names++;
+        }
+    }
+    BOOST_TEST(spans == events.size());
+    BOOST_TEST(names == threads.size());
+    BOOST_TEST(tracing::write_chrome_json(std::string("io_trace_test.json")));
+}
+
+BOOST_AUTO_TEST_CASE(ring_overwrites_oldest)
+{
+    tracing::clear();
+    std::size_t const spans = BOOST_ASTRONOMY_IO_TRACE_CAPACITY + 10;
+    for (std::size_t i = 0; i < spans; i++)
+    {
+        BOOST_ASTRONOMY_IO_TRACE(i < 10 ? "old" : "new");
+    }
+    std::vector<trace_event> const events = tracing::collect();
+    BOOST_TEST(count(events, "old") == 0u);
+    BOOST_TEST(count(events, "new") == static_cast<std::size_t>(BOOST_ASTRONOMY_IO_TRACE_CAPACITY));
+}
+
+BOOST_AUTO_TEST_CASE(collect_while_tracing)
+{
+    //a thread wrapping its ring many times while it is collected and cleared
+    char const* const names[3] = {"first", "second", "third"};
+    std::uint64_t const spans = 8 * BOOST_ASTRONOMY_IO_TRACE_CAPACITY;
+    std::atomic<std::uint32_t> writer_thread(~std::uint32_t(0));
+    std::thread writer([&]() {
+        detail::trace_ring& ring = detail::thread_ring();
+        writer_thread.store(ring.thread);
+        for (std::uint64_t i = 0; i < spans; i++)
+        {
+            ring.push(names[i % 3], i, i + 1);
+        }
+    });
+
+    bool consistent = true;
+    while (writer_thread.load() == ~std::uint32_t(0))
+    {}
+    for (int pass = 0; pass < 50; pass++)
+    {
+        for (auto const& event : tracing::collect())
+        {
+            if (event.thread == writer_thread.load())
+            {
+                consistent = consistent && event.end_ns == event.begin_ns + 1 &&
+                    event.name == names[event.begin_ns % 3];
+            }
+        }
+        if (pass % 10 == 0)
+        {
+            tracing::clear();
+        }
+    }
+    writer.join();
+    BOOST_TEST(consistent);
+
+    tracing::clear();
+    for (auto const& event : tracing::collect())
+    {
+        BOOST_TEST(event.thread != writer_thread.load());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,237 @@
+#define BOOST_TEST_MODULE io_validate_test
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/header_editor.hpp>
+#include <boost/astronomy/io/validate.hpp>
+
+#include "fixture.hpp"
+
+using namespace boost::astronomy::io;
+namespace fs = boost::filesystem;
+
+namespace {
+
+std::string const root = "io_validate_test";
+std::string const valid_name = root + "/valid.fits";
+
+std::uint64_t const binary_header = 2880;
+std::uint64_t const binary_data = 5760;
+std::uint64_t const ascii_header = 8640;
+std::uint64_t const ascii_data = 11520;
+
+//primary header, a binary table of 100 rows of 'J' and an ASCII table of 10 rows
+void write_valid_file()
+{
+    fs::remove_all(root);
+    fs::create_directories(root);
+    fits_writer writer(valid_name, 1);
+    writer.write_empty_primary();
+
+    write_int_table(writer, 100, "BINARY", [](std::size_t) { return 0x01010101; });
+
+    std::vector<card> cards = table_cards(12, 10, {});
+    cards[0].create_card("XTENSION", std::string("'TABLE'"));
+    cards[7].create_card("TFIELDS", 2);
+    cards.resize(12);
+    cards[8].create_card("TBCOL1", 1);
+    cards[9].create_card("TFORM1", std::string("'I5'"));
+    cards[10].create_card("TBCOL2", 6);
+    cards[11].create_card("TFORM2", std::string("'A7'"));
+    cards.emplace_back(std::string("EXTNAME = 'ASCII'"));
+    writer.write_header(cards);
+
+    //ASCII tables are padded with blanks
+    std::string ascii;
+    for (int row = 0; row < 10; row++)
+    {
+        ascii += "   " + std::to_string(10 + row) + "name   ";
+    }
+    ascii.resize(2880, ' ');
+    writer.write_data(ascii.data(), ascii.size());
+}
+
+std::string read_bytes(std::string const& name)
+{
+    std::ifstream file(name, std::ios_base::in | std::ios_base::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+//copy of the valid file with bytes at offset replaced, or cut at offset when bytes is empty
+std::string damaged(std::string const& name, std::uint64_t offset, std::string const& bytes)
+{
+    std::string contents = read_bytes(valid_name);
+    if (bytes.empty())
+    {
+        contents.resize(static_cast<std::size_t>(offset));
+    }
+    else
+    {
+        contents.replace(static_cast<std::size_t>(offset), bytes.size(), bytes);
+    }
+    std::string const path = root + "/" + name + ".fits";
+    std::ofstream file(path, std::ios_base::out | std::ios_base::binary);
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    return path;
+}
+
+//copy of the valid file with one header edited
+template <typename Edit>
+std::string edited(std::string const& name, std::size_t hdu, Edit edit)
+{
+    std::string const path = root + "/" + name + ".fits";
+    fs::copy_file(valid_name, path, fs::copy_option::overwrite_if_exists);
+    header_editor editor(path, hdu);
+    edit(editor);
+    editor.commit();
+    return path;
+}
+
+//true if the report has a diagnostic of level at offset mentioning keyword
+bool reports(validation_report const& report, severity level, std::uint64_t offset,
+    std::string const& keyword = "")
+{
+    return std::any_of(report.diagnostics.begin(), report.diagnostics.end(),
+        [&](diagnostic const& d) {
+            return d.level == level && d.offset == offset &&
+                (keyword.empty() || d.keyword == keyword);
+        });
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(validate_test)
+
+BOOST_AUTO_TEST_CASE(valid_file)
+{
+    write_valid_file();
+    validation_report const report = validate_file(valid_name);
+    BOOST_TEST(report.valid());
+    BOOST_TEST(report.diagnostics.empty());
+    BOOST_TEST(report.hdus == 3u);
+    BOOST_TEST(report.file_size == ascii_data + 2880);
+}
+
+BOOST_AUTO_TEST_CASE(structure)
+{
+    write_valid_file();
+
+    validation_report report = validate_file(damaged("truncated", ascii_data + 100, ""));
+    BOOST_TEST(!report.valid());
+    BOOST_TEST(report.hdus == 3u);
+    BOOST_TEST(reports(report, severity::error, ascii_data));
+
+    report = validate_file(damaged("partial_block", binary_data + 2880 + 10, ""));
+    BOOST_TEST(reports(report, severity::error, binary_data + 2880));
+
+    //END card of the binary table blanked, its header runs into the data
+    report = validate_file(damaged("no_end", binary_header + 11 * 80, std::string(80, ' ')));
+    BOOST_TEST(!report.valid());
+
+    report = validate_file(damaged("control", binary_header + 3 * 80 + 20, "\x01"));
+    BOOST_TEST(reports(report, severity::error, binary_header + 3 * 80));
+
+    report = validate_file(damaged("keyword", binary_header + 10 * 80, "extname "));
+    BOOST_TEST(reports(report, severity::error, binary_header + 10 * 80));
+
+    report = validate_file(damaged("after_end", binary_header + 20 * 80, "COMMENT"));
+    BOOST_TEST(reports(report, severity::error, binary_header + 20 * 80));
+
+    report = validate_file(damaged("string", binary_header + 10 * 80 + 10, "'BINARY   "));
+    BOOST_TEST(reports(report, severity::error, binary_header + 10 * 80, "EXTNAME"));
+
+    report = validate_file(damaged("not_fits", 0, "SIMPLX"));
+    BOOST_TEST(reports(report, severity::error, 0, "SIMPLE"));
+
+    //padding is only a warning, the file stays readable
+    report = validate_file(damaged("padding", binary_data + 500, "\x07"));
+    BOOST_TEST(report.valid());
+    BOOST_TEST(reports(report, severity::warning, binary_data + 500));
+
+    //sizes of untrusted headers whose product does not fit 64 bits
+    report = validate_file(edited("overflow", 1, [](header_editor& editor) {
+        editor.set("NAXIS2", std::string("4611686018427387904"));
+    }));
+    BOOST_TEST(!report.valid());
+    BOOST_TEST(reports(report, severity::error, binary_header));
+    BOOST_TEST(std::any_of(report.diagnostics.begin(), report.diagnostics.end(),
+        [](diagnostic const& d) { return d.message.find("overflows") != std::string::npos; }));
+
+    report = validate_file(root + "/missing.fits");
+    BOOST_TEST(!report.valid());
+    BOOST_TEST(report.hdus == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(keywords_and_tables)
+{
+    write_valid_file();
+
+    //BITPIX moved after NAXIS
+    card naxis;
+    naxis.create_card("NAXIS", 2);
+    card bitpix;
+    bitpix.create_card("BITPIX", 8);
+    validation_report report = validate_file(damaged("order", binary_header + 80,
+        naxis.raw() + bitpix.raw()));
+    BOOST_TEST(reports(report, severity::error, binary_header + 2 * 80, "BITPIX"));
+
+    report = validate_file(edited("tform", 1, [](header_editor& e) {
+        e.set("TFORM1", std::string("'I'"));
+    }));
+    BOOST_TEST(reports(report, severity::error, binary_header + 3 * 80, "NAXIS1"));
+
+    report = validate_file(edited("bad_tform", 1, [](header_editor& e) {
+        e.set("TFORM1", std::string("'3Z'"));
+    }));
+    BOOST_TEST(reports(report, severity::error, binary_header + 8 * 80, "TFORM1"));
+
+    report = validate_file(edited("tbcol", 2, [](header_editor& e) {
+        e.set("TBCOL2", 9);
+    }));
+    BOOST_TEST(reports(report, severity::error, ascii_header + 10 * 80, "TBCOL2"));
+
+    report = validate_file(edited("missing_tform", 2, [](header_editor& e) {
+        e.remove("TFORM1");
+    }));
+    BOOST_TEST(reports(report, severity::error, ascii_header, "TFORM1"));
+
+    report = validate_file(edited("bad_bitpix", 1, [](header_editor& e) {
+        e.set("BITPIX", 12);
+    }));
+    BOOST_TEST(reports(report, severity::error, binary_header + 80, "BITPIX"));
+    BOOST_TEST(report.hdus == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(many_files)
+{
+    write_valid_file();
+    std::vector<std::string> files;
+    for (std::size_t i = 0; i < 40; i++)
+    {
+        files.push_back(i % 4 == 3 ?
+            damaged("cut" + std::to_string(i), ascii_data + i, "") : valid_name);
+    }
+
+    validation_options options;
+    options.threads = 4;
+    options.read_size = 2880;
+    std::vector<validation_report> const result = validate_files(files, options);
+    BOOST_REQUIRE(result.size() == files.size());
+    for (std::size_t i = 0; i < files.size(); i++)
+    {
+        BOOST_TEST(result[i].file == files[i]);
+        BOOST_TEST(result[i].valid() == (i % 4 != 3));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()